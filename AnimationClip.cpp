@@ -0,0 +1,289 @@
+#include "AnimationClip.h"
+#include "MemoryTracker.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+	//量子化の段階数
+	const float kQuantizeSteps = 65535.0f;
+	//移動のチャンネル
+	const size_t kTranslateChannel = 0;
+	//回転のチャンネル
+	const size_t kRotateChannel = 1;
+	//拡縮のチャンネル
+	const size_t kScaleChannel = 2;
+
+	/// <summary>
+	/// 正規化線形補間(toはfromと近い向きにそろえる)
+	/// </summary>
+	Quaternion Nlerp(const Quaternion& from, const Quaternion& to, float t) {
+		const float sign = from.Dot(to) < 0.0f ? -1.0f : 1.0f;
+		const Quaternion result = {
+			from.x + (to.x * sign - from.x) * t,
+			from.y + (to.y * sign - from.y) * t,
+			from.z + (to.z * sign - from.z) * t,
+			from.w + (to.w * sign - from.w) * t,
+		};
+		return result.Normalize();
+	}
+}
+
+//トラックの追加
+size_t AnimationClip::AddTrack(const TrackDesc& desc) {
+	assert(!isCompressed_);
+	assert(desc.translateTimes.size() == desc.translates.size());
+	assert(desc.rotateTimes.size() == desc.rotates.size());
+	assert(desc.scaleTimes.size() == desc.scales.size());
+
+	//キーの値は成分を並べたfloatの配列にして渡す(構造体の配列をfloatの配列として読むことはできない)
+	std::vector<float> translates;
+	translates.reserve(desc.translates.size() * 3);
+	for (const Vector3& translate : desc.translates) {
+		translates.insert(translates.end(), { translate.x,translate.y,translate.z });
+	}
+	//回転は隣のキーと近い向きにそろえておき、補間のときに向きを確かめずに済ませる
+	std::vector<float> rotates;
+	rotates.reserve(desc.rotates.size() * 4);
+	Quaternion previousRotate = {};
+	for (size_t i = 0; i < desc.rotates.size(); i++) {
+		Quaternion rotate = desc.rotates[i];
+		if (i > 0 && previousRotate.Dot(rotate) < 0.0f) {
+			rotate = { -rotate.x,-rotate.y,-rotate.z,-rotate.w };
+		}
+		rotates.insert(rotates.end(), { rotate.x,rotate.y,rotate.z,rotate.w });
+		previousRotate = rotate;
+	}
+	std::vector<float> scales;
+	scales.reserve(desc.scales.size() * 3);
+	for (const Vector3& scale : desc.scales) {
+		scales.insert(scales.end(), { scale.x,scale.y,scale.z });
+	}
+
+	const float defaultTranslate[3] = { 0.0f,0.0f,0.0f };
+	const float defaultRotate[4] = { 0.0f,0.0f,0.0f,1.0f };
+	const float defaultScale[3] = { 1.0f,1.0f,1.0f };
+	AddChannel(desc.translateTimes, translates.data(), 3, defaultTranslate);
+	AddChannel(desc.rotateTimes, rotates.data(), 4, defaultRotate);
+	AddChannel(desc.scaleTimes, scales.data(), 3, defaultScale);
+	return GetTrackCount() - 1;
+}
+
+//16ビットに量子化する
+void AnimationClip::Compress() {
+	if (isCompressed_) {
+		return;
+	}
+	quantizedValues_.resize(keyValues_.size());
+	for (Channel& channel : channels_) {
+		for (uint32_t component = 0; component < channel.componentCount; component++) {
+			//成分ごとの範囲を求める
+			float minValue = keyValues_[channel.valueOffset + component];
+			float maxValue = minValue;
+			for (uint32_t key = 0; key < channel.keyCount; key++) {
+				const float value = keyValues_[channel.valueOffset + key * channel.componentCount + component];
+				minValue = std::min(minValue, value);
+				maxValue = std::max(maxValue, value);
+			}
+			const float range = maxValue - minValue;
+			channel.rangeMin[component] = minValue;
+			channel.rangeScale[component] = range / kQuantizeSteps;
+
+			//範囲のない成分はすべて0になる
+			const float inverseScale = range > 0.0f ? kQuantizeSteps / range : 0.0f;
+			for (uint32_t key = 0; key < channel.keyCount; key++) {
+				const size_t index = channel.valueOffset + key * channel.componentCount + component;
+				const float quantized = std::round((keyValues_[index] - minValue) * inverseScale);
+				quantizedValues_[index] = static_cast<uint16_t>(std::clamp(quantized, 0.0f, kQuantizeSteps));
+			}
+		}
+	}
+	keyValues_.clear();
+	keyValues_.shrink_to_fit();
+	isCompressed_ = true;
+}
+
+//1トラックの姿勢
+AnimationClip::Pose AnimationClip::Sample(size_t track, float time, uint32_t* cursors) const {
+	const size_t channel = track * kChannelCount;
+	//成分はいったん配列に受け、構造体のメンバへは1つずつ入れる(メンバを配列として書くことはできない)
+	float translate[3] = {};
+	float rotate[4] = {};
+	float scale[3] = {};
+	SampleChannel(channel + kTranslateChannel, time, cursors[channel + kTranslateChannel], translate);
+	SampleChannel(channel + kRotateChannel, time, cursors[channel + kRotateChannel], rotate);
+	SampleChannel(channel + kScaleChannel, time, cursors[channel + kScaleChannel], scale);
+	Pose pose;
+	pose.translate.x = translate[0];
+	pose.translate.y = translate[1];
+	pose.translate.z = translate[2];
+	pose.rotate.x = rotate[0];
+	pose.rotate.y = rotate[1];
+	pose.rotate.z = rotate[2];
+	pose.rotate.w = rotate[3];
+	pose.scale.x = scale[0];
+	pose.scale.y = scale[1];
+	pose.scale.z = scale[2];
+	pose.rotate = pose.rotate.Normalize();
+	return pose;
+}
+
+//まとめて姿勢を求める
+void AnimationClip::SampleBatch(const float* times, uint32_t* cursors, size_t instanceCount, PoseBuffer& output, bool isParallel) const {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kMath);
+	const size_t trackCount = GetTrackCount();
+	const size_t cursorCount = GetCursorCount();
+	ResizePoseBuffer(output, instanceCount * trackCount);
+	auto function = [this, times, cursors, trackCount, cursorCount, &output](size_t begin, size_t end) {
+		for (size_t instance = begin; instance < end; instance++) {
+			uint32_t* instanceCursors = cursors + instance * cursorCount;
+			for (size_t track = 0; track < trackCount; track++) {
+				StorePose(output, instance * trackCount + track, Sample(track, times[instance], instanceCursors));
+			}
+		}
+		};
+	if (!isParallel || instanceCount < kMinBatchSize * 2) {
+		function(0, instanceCount);
+		return;
+	}
+	JobSystem::GetInstance()->ParallelFor(instanceCount, kMinBatchSize, function);
+}
+
+//2つのクリップを混ぜた姿勢をまとめて求める
+void AnimationClip::SampleBlendBatch(const AnimationClip& from, const float* fromTimes, uint32_t* fromCursors,
+	const AnimationClip& to, const float* toTimes, uint32_t* toCursors, const float* weights, size_t instanceCount, PoseBuffer& output, bool isParallel) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kMath);
+	assert(from.GetTrackCount() == to.GetTrackCount());
+	const size_t trackCount = from.GetTrackCount();
+	ResizePoseBuffer(output, instanceCount * trackCount);
+	auto function = [&](size_t begin, size_t end) {
+		for (size_t instance = begin; instance < end; instance++) {
+			uint32_t* instanceFromCursors = fromCursors + instance * from.GetCursorCount();
+			uint32_t* instanceToCursors = toCursors + instance * to.GetCursorCount();
+			for (size_t track = 0; track < trackCount; track++) {
+				const Pose fromPose = from.Sample(track, fromTimes[instance], instanceFromCursors);
+				const Pose toPose = to.Sample(track, toTimes[instance], instanceToCursors);
+				StorePose(output, instance * trackCount + track, Blend(fromPose, toPose, weights[instance]));
+			}
+		}
+		};
+	if (!isParallel || instanceCount < kMinBatchSize * 2) {
+		function(0, instanceCount);
+		return;
+	}
+	JobSystem::GetInstance()->ParallelFor(instanceCount, kMinBatchSize, function);
+}
+
+//2つの姿勢を混ぜる
+AnimationClip::Pose AnimationClip::Blend(const Pose& from, const Pose& to, float weight) {
+	//Vector3::Lerpはstd::lerpで端の値を厳密に合わせる分遅いので、ここでは式のまま補間する
+	return {
+		.scale = from.scale + (to.scale - from.scale) * weight,
+		.rotate = Nlerp(from.rotate, to.rotate, weight),
+		.translate = from.translate + (to.translate - from.translate) * weight,
+	};
+}
+
+//時刻を長さの範囲に収める
+float AnimationClip::WrapTime(float time) const {
+	if (duration_ <= 0.0f) {
+		return 0.0f;
+	}
+	const float wrapped = std::fmod(time, duration_);
+	return wrapped < 0.0f ? wrapped + duration_ : wrapped;
+}
+
+//チャンネルを追加する
+void AnimationClip::AddChannel(const std::vector<float>& times, const float* values, size_t componentCount, const float* defaultValue) {
+	Channel channel = {};
+	channel.keyOffset = static_cast<uint32_t>(keyTimes_.size());
+	channel.valueOffset = static_cast<uint32_t>(keyValues_.size());
+	channel.componentCount = static_cast<uint32_t>(componentCount);
+	//キーがなければ初期値のキーを1つ置き、サンプリングで場合分けしない
+	if (times.empty()) {
+		channel.keyCount = 1;
+		keyTimes_.push_back(0.0f);
+		keyValues_.insert(keyValues_.end(), defaultValue, defaultValue + componentCount);
+	} else {
+		assert(std::is_sorted(times.begin(), times.end()));
+		channel.keyCount = static_cast<uint32_t>(times.size());
+		keyTimes_.insert(keyTimes_.end(), times.begin(), times.end());
+		keyValues_.insert(keyValues_.end(), values, values + times.size() * componentCount);
+		duration_ = std::max(duration_, times.back());
+	}
+	channels_.push_back(channel);
+}
+
+//時刻を挟むキーを探す
+uint32_t AnimationClip::FindKey(const Channel& channel, float time, uint32_t& cursor) const {
+	const float* times = keyTimes_.data() + channel.keyOffset;
+	const uint32_t last = channel.keyCount - 1;
+	uint32_t key = cursor;
+	if (key > last || time < times[key]) {
+		//巻き戻ったときだけ全体から探す
+		const float* upper = std::upper_bound(times, times + channel.keyCount, time);
+		key = upper == times ? 0 : static_cast<uint32_t>(upper - times - 1);
+	} else {
+		//順に再生していれば次のキーまでしか進まない
+		for (uint32_t step = 0; key < last && time >= times[key + 1]; step++) {
+			if (step == kMaxCursorSteps) {
+				const float* upper = std::upper_bound(times + key + 1, times + channel.keyCount, time);
+				key = static_cast<uint32_t>(upper - times - 1);
+				break;
+			}
+			key++;
+		}
+	}
+	cursor = key;
+	return key;
+}
+
+//チャンネルの値を補間して求める
+void AnimationClip::SampleChannel(size_t channelIndex, float time, uint32_t& cursor, float* result) const {
+	const Channel& channel = channels_[channelIndex];
+	const uint32_t key = FindKey(channel, time, cursor);
+	//最後のキーより後は最後のキーの値
+	const uint32_t nextKey = std::min(key + 1, channel.keyCount - 1);
+	const float* times = keyTimes_.data() + channel.keyOffset;
+	const float t = nextKey == key ? 0.0f : std::clamp((time - times[key]) / (times[nextKey] - times[key]), 0.0f, 1.0f);
+	const size_t begin = channel.valueOffset + static_cast<size_t>(key) * channel.componentCount;
+	const size_t end = channel.valueOffset + static_cast<size_t>(nextKey) * channel.componentCount;
+	if (isCompressed_) {
+		//量子化したまま補間してから戻す
+		for (uint32_t i = 0; i < channel.componentCount; i++) {
+			const float quantizedBegin = static_cast<float>(quantizedValues_[begin + i]);
+			const float quantizedEnd = static_cast<float>(quantizedValues_[end + i]);
+			result[i] = channel.rangeMin[i] + (quantizedBegin + (quantizedEnd - quantizedBegin) * t) * channel.rangeScale[i];
+		}
+	} else {
+		for (uint32_t i = 0; i < channel.componentCount; i++) {
+			result[i] = keyValues_[begin + i] + (keyValues_[end + i] - keyValues_[begin + i]) * t;
+		}
+	}
+}
+
+//出力を確保する
+void AnimationClip::ResizePoseBuffer(PoseBuffer& output, size_t count) {
+	for (int i = 0; i < 3; i++) {
+		output.scale[i].resize(count);
+		output.translate[i].resize(count);
+	}
+	for (int i = 0; i < 4; i++) {
+		output.rotate[i].resize(count);
+	}
+}
+
+//出力に書き込む
+void AnimationClip::StorePose(PoseBuffer& output, size_t index, const Pose& pose) {
+	output.scale[0][index] = pose.scale.x;
+	output.scale[1][index] = pose.scale.y;
+	output.scale[2][index] = pose.scale.z;
+	output.rotate[0][index] = pose.rotate.x;
+	output.rotate[1][index] = pose.rotate.y;
+	output.rotate[2][index] = pose.rotate.z;
+	output.rotate[3][index] = pose.rotate.w;
+	output.translate[0][index] = pose.translate.x;
+	output.translate[1][index] = pose.translate.y;
+	output.translate[2][index] = pose.translate.z;
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include "MathData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// キーフレームアニメーション(トラックごとに移動・回転・拡縮のキーを持つ)
+/// </summary>
+/// <remarks>
+/// 全トラックのキーの時刻と値はそれぞれ1本の配列に続けて入れ、チャンネル(トラックの移動・回転・拡縮の1つ)ごとに始まりと数を持つ。
+/// サンプリングは呼び出し側が持つカーソル(チャンネルごとの前回のキー番号)から始めるので、順に再生している間は二分探索せずに済む。
+/// Compressでキーの値を16ビットに量子化できる
+/// </remarks>
+class AnimationClip {
+public://構造体
+	/// <summary>
+	/// トラックを作るときのキー(時刻は昇順)
+	/// </summary>
+	struct TrackDesc {
+		std::vector<float> translateTimes; //移動のキーの時刻(秒)
+		std::vector<Vector3> translates; //移動
+		std::vector<float> rotateTimes; //回転のキーの時刻(秒)
+		std::vector<Quaternion> rotates; //回転
+		std::vector<float> scaleTimes; //拡縮のキーの時刻(秒)
+		std::vector<Vector3> scales; //拡縮
+	};
+
+	/// <summary>
+	/// 1トラック分の姿勢
+	/// </summary>
+	struct Pose {
+		Vector3 scale; //拡縮
+		Quaternion rotate; //回転
+		Vector3 translate; //移動
+	};
+
+	/// <summary>
+	/// 姿勢を成分ごとの配列に並べたもの(インスタンスi、トラックtは i * トラック数 + t 番目)
+	/// </summary>
+	struct PoseBuffer {
+		std::vector<float> scale[3]; //拡縮(x,y,z)
+		std::vector<float> rotate[4]; //回転(x,y,z,w)
+		std::vector<float> translate[3]; //移動(x,y,z)
+	};
+public://メンバ関数
+	/// <summary>
+	/// トラックの追加(キーのないチャンネルは移動0、回転なし、拡縮1になる)
+	/// </summary>
+	/// <returns>トラックの番号</returns>
+	size_t AddTrack(const TrackDesc& desc);
+
+	/// <summary>
+	/// キーの値を16ビットに量子化する(チャンネルの成分ごとに、キーの値の範囲を65535段階に割り当てる)
+	/// </summary>
+	void Compress();
+
+	/// <summary>
+	/// 1トラックの姿勢を求める
+	/// </summary>
+	/// <param name="track">トラックの番号</param>
+	/// <param name="time">時刻(秒、キーの範囲外は端のキーの値)</param>
+	/// <param name="cursors">このインスタンスのカーソル(GetCursorCount個。トラックの分だけ読み書きする)</param>
+	/// <returns>姿勢</returns>
+	Pose Sample(size_t track, float time, uint32_t* cursors) const;
+
+	/// <summary>
+	/// 多数のインスタンスの全トラックの姿勢をまとめて求める
+	/// </summary>
+	/// <param name="times">インスタンスごとの時刻</param>
+	/// <param name="cursors">インスタンスごとのカーソル(インスタンス数 * GetCursorCount個)</param>
+	/// <param name="instanceCount">インスタンス数</param>
+	/// <param name="output">出力(足りなければ確保し直す)</param>
+	/// <param name="isParallel">インスタンスをJobSystemで分担するか</param>
+	void SampleBatch(const float* times, uint32_t* cursors, size_t instanceCount, PoseBuffer& output, bool isParallel = true) const;
+
+	/// <summary>
+	/// 2つのクリップを混ぜた姿勢をまとめて求める(トラック数が同じであること)
+	/// </summary>
+	/// <param name="from">混ぜる前のクリップ</param>
+	/// <param name="fromTimes">fromのインスタンスごとの時刻</param>
+	/// <param name="fromCursors">fromのカーソル</param>
+	/// <param name="to">混ぜた先のクリップ</param>
+	/// <param name="toTimes">toのインスタンスごとの時刻</param>
+	/// <param name="toCursors">toのカーソル</param>
+	/// <param name="weights">インスタンスごとのtoの割合(0～1)</param>
+	/// <param name="instanceCount">インスタンス数</param>
+	/// <param name="output">出力(足りなければ確保し直す)</param>
+	/// <param name="isParallel">インスタンスをJobSystemで分担するか</param>
+	static void SampleBlendBatch(const AnimationClip& from, const float* fromTimes, uint32_t* fromCursors,
+		const AnimationClip& to, const float* toTimes, uint32_t* toCursors, const float* weights, size_t instanceCount, PoseBuffer& output, bool isParallel = true);
+
+	/// <summary>
+	/// 2つの姿勢を混ぜる(回転は近い向き同士の正規化線形補間)
+	/// </summary>
+	/// <param name="from">混ぜる前の姿勢</param>
+	/// <param name="to">混ぜた先の姿勢</param>
+	/// <param name="weight">toの割合(0～1)</param>
+	/// <returns>姿勢</returns>
+	static Pose Blend(const Pose& from, const Pose& to, float weight);
+
+	/// <summary>
+	/// ループ再生のために時刻を長さの範囲に収める
+	/// </summary>
+	float WrapTime(float time) const;
+
+	/// <summary>
+	/// トラック数のゲッター
+	/// </summary>
+	size_t GetTrackCount() const { return channels_.size() / kChannelCount; }
+
+	/// <summary>
+	/// インスタンス1つに必要なカーソルの数のゲッター
+	/// </summary>
+	size_t GetCursorCount() const { return channels_.size(); }
+
+	/// <summary>
+	/// 長さ(最後のキーの時刻)のゲッター
+	/// </summary>
+	float GetDuration() const { return duration_; }
+
+	/// <summary>
+	/// 量子化したか
+	/// </summary>
+	bool IsCompressed() const { return isCompressed_; }
+
+	/// <summary>
+	/// キーの値に使っているバイト数のゲッター
+	/// </summary>
+	size_t GetKeyValueBytes() const { return keyValues_.size() * sizeof(float) + quantizedValues_.size() * sizeof(uint16_t); }
+public://定数
+	//1トラックのチャンネル数(移動・回転・拡縮)
+	static inline const size_t kChannelCount = 3;
+	//1区間の最小のインスタンス数
+	static inline const size_t kMinBatchSize = 256;
+	//カーソルから1つずつ進める最大の数(超えたら残りを二分探索する)
+	static inline const uint32_t kMaxCursorSteps = 4;
+private://構造体
+	/// <summary>
+	/// チャンネル(トラックの移動・回転・拡縮のどれか1つ)
+	/// </summary>
+	struct Channel {
+		uint32_t keyOffset; //キーの時刻の始まり
+		uint32_t keyCount; //キーの数
+		uint32_t valueOffset; //キーの値の始まり
+		uint32_t componentCount; //1キーの成分数(3か4)
+		float rangeMin[4]; //量子化した値の最小
+		float rangeScale[4]; //量子化した値1あたりの大きさ
+	};
+private://メンバ関数
+	/// <summary>
+	/// チャンネルを追加する
+	/// </summary>
+	void AddChannel(const std::vector<float>& times, const float* values, size_t componentCount, const float* defaultValue);
+
+	/// <summary>
+	/// 時刻を挟むキーを探す(カーソルから先へ進め、戻ったときだけ二分探索する)
+	/// </summary>
+	/// <returns>前のキーの番号(チャンネルの中での番号)</returns>
+	uint32_t FindKey(const Channel& channel, float time, uint32_t& cursor) const;
+
+	/// <summary>
+	/// チャンネルの値を補間して求める
+	/// </summary>
+	/// <param name="result">値(成分数分書き込む)</param>
+	void SampleChannel(size_t channelIndex, float time, uint32_t& cursor, float* result) const;
+
+	/// <summary>
+	/// 出力を確保する
+	/// </summary>
+	static void ResizePoseBuffer(PoseBuffer& output, size_t count);
+
+	/// <summary>
+	/// 出力に書き込む
+	/// </summary>
+	static void StorePose(PoseBuffer& output, size_t index, const Pose& pose);
+private://メンバ変数
+	std::vector<Channel> channels_; //チャンネル(トラックごとに移動・回転・拡縮の順)
+	std::vector<float> keyTimes_; //全チャンネルのキーの時刻
+	std::vector<float> keyValues_; //全チャンネルのキーの値(量子化したら空になる)
+	std::vector<uint16_t> quantizedValues_; //量子化したキーの値
+	float duration_ = 0.0f; //長さ
+	bool isCompressed_ = false; //量子化したか
+};
@@ -0,0 +1,401 @@
+#include "AssetArchive.h"
+#include "MemoryTracker.h"
+#include "Lz4.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace {
+	/// <summary>
+	/// 先頭の"./"を除く
+	/// </summary>
+	std::string_view SkipCurrentDirectory(std::string_view path) {
+		while (path.size() >= 2 && path[0] == '.' && (path[1] == '/' || path[1] == '\\')) {
+			path.remove_prefix(2);
+		}
+		return path;
+	}
+
+	/// <summary>
+	/// 1文字を小文字と/にそろえる
+	/// </summary>
+	char NormalizeChar(char c) {
+		if (c == '\\') {
+			return '/';
+		}
+		return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+
+	/// <summary>
+	/// そろえたパスと、そろえていないパスが同じか
+	/// </summary>
+	bool IsSamePath(std::string_view normalizedPath, std::string_view path) {
+		path = SkipCurrentDirectory(path);
+		if (normalizedPath.size() != path.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < path.size(); i++) {
+			if (normalizedPath[i] != NormalizeChar(path[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 出力を揃える位置まで0で埋める
+	/// </summary>
+	void WritePadding(std::ofstream& output, uint64_t& offset, uint64_t alignment) {
+		static const char kZeros[512] = {};
+		uint64_t padding = (alignment - offset % alignment) % alignment;
+		offset += padding;
+		while (padding > 0) {
+			const uint64_t count = padding < sizeof(kZeros) ? padding : sizeof(kZeros);
+			output.write(kZeros, static_cast<std::streamsize>(count));
+			padding -= count;
+		}
+	}
+}
+
+//デストラクタ
+AssetArchive::~AssetArchive() {
+	Close();
+}
+
+//パスのハッシュ
+uint64_t AssetArchive::HashPath(std::string_view path) {
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for (char c : SkipCurrentDirectory(path)) {
+		hash ^= static_cast<uint8_t>(NormalizeChar(c));
+		hash *= 0x100000001B3ull;
+	}
+	return hash;
+}
+
+//パスを小文字と/にそろえる
+std::string AssetArchive::NormalizePath(std::string_view path) {
+	path = SkipCurrentDirectory(path);
+	std::string result(path.size(), '\0');
+	std::transform(path.begin(), path.end(), result.begin(), NormalizeChar);
+	return result;
+}
+
+//フォルダの中のファイルをまとめて書き出す
+bool AssetArchive::Pack(const char* filePath, const PackDesc& desc) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kAssets);
+	if (!std::has_single_bit(desc.alignment)) {
+		return false;
+	}
+
+	//並びを決めておき、同じフォルダからは同じファイルができるようにする
+	std::error_code error;
+	std::vector<std::pair<std::string, std::filesystem::path>> files;
+	for (std::filesystem::recursive_directory_iterator it(desc.rootDirectory, error), end; !error && it != end; it.increment(error)) {
+		if (it->is_regular_file()) {
+			const std::string relativePath = std::filesystem::relative(it->path(), desc.rootDirectory).generic_string();
+			files.emplace_back(NormalizePath(relativePath), it->path());
+		}
+	}
+	if (error || files.size() >= kEmptyBucket) {
+		return false;
+	}
+	std::sort(files.begin(), files.end());
+	if (std::adjacent_find(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first == b.first; }) != files.end()) {
+		//大文字・小文字だけが違うパスは区別できない
+		return false;
+	}
+
+	std::ofstream output(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!output.is_open()) {
+		return false;
+	}
+	FileHeader header = {};
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	uint64_t offset = sizeof(header);
+
+	std::vector<Entry> entries(files.size());
+	std::string strings;
+	std::vector<uint8_t> content;
+	std::vector<uint8_t> compressed;
+	for (size_t i = 0; i < files.size(); i++) {
+		std::ifstream input(files[i].second, std::ios::in | std::ios::binary);
+		if (!input.is_open()) {
+			return false;
+		}
+		content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+
+		//圧縮しても1/8以上小さくならないもの(画像など)と空のものはそのまま置き、割り当てたメモリを直接使う
+		const uint8_t* stored = content.data();
+		size_t storedSize = content.size();
+		uint32_t flags = 0;
+		if (desc.isCompressionEnabled && !content.empty() && content.size() <= kMaxDecodedSize) {
+			compressed.resize(Lz4::GetMaxCompressedSize(content.size()));
+			const size_t compressedSize = Lz4::Compress(content.data(), content.size(), compressed.data());
+			if (compressedSize < content.size() - content.size() / 8) {
+				stored = compressed.data();
+				storedSize = compressedSize;
+				flags |= kCompressedFlag;
+			}
+		}
+
+		WritePadding(output, offset, desc.alignment);
+		output.write(reinterpret_cast<const char*>(stored), static_cast<std::streamsize>(storedSize));
+		entries[i] = {
+			.pathHash = HashPath(files[i].first),
+			.offset = offset,
+			.storedSize = storedSize,
+			.size = content.size(),
+			.pathOffset = static_cast<uint32_t>(strings.size()),
+			.pathLength = static_cast<uint32_t>(files[i].first.size()),
+			.flags = flags,
+			.reserved = 0,
+		};
+		strings += files[i].first;
+		offset += storedSize;
+	}
+
+	//ハッシュ表は半分以上を空けて、探す回数を1,2回に抑える
+	const uint32_t bucketCount = std::bit_ceil(static_cast<uint32_t>(entries.size()) * 2 + 1);
+	std::vector<uint32_t> buckets(bucketCount, kEmptyBucket);
+	for (size_t i = 0; i < entries.size(); i++) {
+		size_t bucket = entries[i].pathHash & (bucketCount - 1);
+		while (buckets[bucket] != kEmptyBucket) {
+			bucket = (bucket + 1) & (bucketCount - 1);
+		}
+		buckets[bucket] = static_cast<uint32_t>(i);
+	}
+
+	WritePadding(output, offset, alignof(Entry));
+	header = {
+		.magic = kMagic,
+		.version = kVersion,
+		.entryCount = static_cast<uint32_t>(entries.size()),
+		.bucketCount = bucketCount,
+		.entriesOffset = offset,
+		.bucketsOffset = offset + entries.size() * sizeof(Entry),
+		.stringsOffset = offset + entries.size() * sizeof(Entry) + buckets.size() * sizeof(uint32_t),
+		.stringsSize = strings.size(),
+	};
+	output.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+	output.write(reinterpret_cast<const char*>(buckets.data()), static_cast<std::streamsize>(buckets.size() * sizeof(uint32_t)));
+	output.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+	//位置が決まったのでヘッダを書き直す
+	output.seekp(0);
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	return output.good();
+}
+
+//開く
+bool AssetArchive::Open(const char* filePath) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kAssets);
+	Close();
+	if (!file_.Open(filePath)) {
+		return false;
+	}
+	const uint8_t* data = file_.GetData();
+	const size_t size = file_.GetSize();
+	FileHeader header = {};
+	if (size < sizeof(header)) {
+		Close();
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+
+	//表は割り当てたメモリをそのまま使うので、範囲と揃え方を確かめておく
+	const bool isValid = header.magic == kMagic && header.version == kVersion &&
+		std::has_single_bit(header.bucketCount) && header.bucketCount > header.entryCount &&
+		header.entriesOffset % alignof(Entry) == 0 && header.bucketsOffset % alignof(uint32_t) == 0 &&
+		header.entriesOffset <= size && (size - header.entriesOffset) / sizeof(Entry) >= header.entryCount &&
+		header.bucketsOffset <= size && (size - header.bucketsOffset) / sizeof(uint32_t) >= header.bucketCount &&
+		header.stringsOffset <= size && size - header.stringsOffset >= header.stringsSize;
+	if (!isValid) {
+		Close();
+		return false;
+	}
+	//展開する大きさは信用せずに確保するので、ここで上限と圧縮したバイト数との釣り合いも確かめる
+	const Entry* entries = reinterpret_cast<const Entry*>(data + header.entriesOffset);
+	for (size_t i = 0; i < header.entryCount; i++) {
+		const Entry& e = entries[i];
+		const bool isCompressed = (e.flags & kCompressedFlag) != 0;
+		const bool isEntryValid = e.offset <= size && size - e.offset >= e.storedSize &&
+			e.pathOffset <= header.stringsSize && header.stringsSize - e.pathOffset >= e.pathLength &&
+			(isCompressed ? e.size <= kMaxDecodedSize && e.size / kMaxCompressionRatio <= e.storedSize : e.size == e.storedSize);
+		if (!isEntryValid) {
+			Close();
+			return false;
+		}
+	}
+	entries_ = entries;
+	buckets_ = reinterpret_cast<const uint32_t*>(data + header.bucketsOffset);
+	strings_ = reinterpret_cast<const char*>(data + header.stringsOffset);
+	entryCount_ = header.entryCount;
+	bucketMask_ = header.bucketCount - 1;
+	decodedEntries_ = std::make_unique<DecodedEntry[]>(entryCount_);
+	isExiting_ = false;
+	worker_ = std::thread(&AssetArchive::WorkerMain, this);
+	return true;
+}
+
+//閉じる
+void AssetArchive::Close() {
+	if (worker_.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			isExiting_ = true;
+		}
+		queueCondition_.notify_all();
+		worker_.join();
+	}
+	queue_.clear();
+	decodedEntries_.reset();
+	entries_ = nullptr;
+	buckets_ = nullptr;
+	strings_ = nullptr;
+	entryCount_ = 0;
+	bucketMask_ = 0;
+	file_.Close();
+}
+
+//パスでエントリを探す
+size_t AssetArchive::Find(std::string_view path) const {
+	if (entryCount_ == 0) {
+		return kNotFound;
+	}
+	//Openではハッシュ表の中身までは確かめないので、空きがなくても一周で打ち切る
+	const uint64_t hash = HashPath(path);
+	size_t bucket = hash & bucketMask_;
+	for (size_t step = 0; step <= bucketMask_; step++, bucket = (bucket + 1) & bucketMask_) {
+		const uint32_t entry = buckets_[bucket];
+		if (entry >= entryCount_) {
+			return kNotFound;
+		}
+		if (entries_[entry].pathHash == hash && IsSamePath(GetEntryInfo(entry).path, path)) {
+			return entry;
+		}
+	}
+	return kNotFound;
+}
+
+//エントリの情報のゲッター
+AssetArchive::EntryInfo AssetArchive::GetEntryInfo(size_t entry) const {
+	assert(entry < entryCount_);
+	const Entry& e = entries_[entry];
+	return {
+		.path = std::string_view(strings_ + e.pathOffset, e.pathLength),
+		.size = e.size,
+		.storedSize = e.storedSize,
+		.isCompressed = (e.flags & kCompressedFlag) != 0,
+	};
+}
+
+//中身のゲッター
+std::span<const uint8_t> AssetArchive::Get(std::string_view path) {
+	const size_t entry = Find(path);
+	return entry != kNotFound ? GetEntry(entry) : std::span<const uint8_t>();
+}
+
+//中身のゲッター(番号で指定)
+std::span<const uint8_t> AssetArchive::GetEntry(size_t entry) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kAssets);
+	if (entry >= entryCount_) {
+		return {};
+	}
+	const Entry& e = entries_[entry];
+	if ((e.flags & kCompressedFlag) == 0) {
+		return std::span<const uint8_t>(file_.GetData() + e.offset, static_cast<size_t>(e.size));
+	}
+
+	DecodedEntry& decoded = decodedEntries_[entry];
+	State state = decoded.state.load(std::memory_order_acquire);
+	if (state != State::kReady) {
+		//展開は裏のスレッドに任せ、呼び出し側は待つだけにする(待っている間に先読みしたものより先に展開させる)
+		std::unique_lock<std::mutex> lock(mutex_);
+		state = State::kNotLoaded;
+		if (decoded.state.compare_exchange_strong(state, State::kQueued, std::memory_order_acq_rel)) {
+			queue_.push_front(entry);
+			queueCondition_.notify_one();
+		} else if (state == State::kQueued) {
+			const auto it = std::find(queue_.begin(), queue_.end(), entry);
+			if (it != queue_.end()) {
+				queue_.erase(it);
+				queue_.push_front(entry);
+			}
+		}
+		readyCondition_.wait(lock, [&]() {
+			state = decoded.state.load(std::memory_order_acquire);
+			return state == State::kReady || state == State::kFailed;
+			});
+	}
+	if (state != State::kReady) {
+		return {};
+	}
+	return std::span<const uint8_t>(decoded.data.get(), static_cast<size_t>(e.size));
+}
+
+//裏のスレッドで展開しておく
+void AssetArchive::Prefetch(std::string_view path) {
+	const size_t entry = Find(path);
+	if (entry != kNotFound) {
+		PrefetchEntry(entry);
+	}
+}
+
+//裏のスレッドで展開しておく(番号で指定)
+void AssetArchive::PrefetchEntry(size_t entry) {
+	if (entry >= entryCount_ || (entries_[entry].flags & kCompressedFlag) == 0) {
+		return;
+	}
+	State expected = State::kNotLoaded;
+	if (!decodedEntries_[entry].state.compare_exchange_strong(expected, State::kQueued, std::memory_order_acq_rel)) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		queue_.push_back(entry);
+	}
+	queueCondition_.notify_one();
+}
+
+//圧縮したエントリを展開する
+void AssetArchive::Decode(size_t entry) {
+	const Entry& e = entries_[entry];
+	DecodedEntry& decoded = decodedEntries_[entry];
+	//位置と大きさはOpenで確かめてある
+	std::unique_ptr<uint8_t[]> data(new uint8_t[static_cast<size_t>(e.size)]);
+	const bool isDecoded = Lz4::Decompress(file_.GetData() + e.offset, static_cast<size_t>(e.storedSize), data.get(), static_cast<size_t>(e.size));
+	if (isDecoded) {
+		decoded.data = std::move(data);
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		decoded.state.store(isDecoded ? State::kReady : State::kFailed, std::memory_order_release);
+	}
+	readyCondition_.notify_all();
+}
+
+//展開用のスレッドの処理
+void AssetArchive::WorkerMain() {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kAssets);
+	for (;;) {
+		size_t entry = 0;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			queueCondition_.wait(lock, [this]() { return isExiting_ || !queue_.empty(); });
+			if (isExiting_) {
+				return;
+			}
+			entry = queue_.front();
+			queue_.pop_front();
+		}
+		State expected = State::kQueued;
+		if (decodedEntries_[entry].state.compare_exchange_strong(expected, State::kDecoding, std::memory_order_acq_rel)) {
+			Decode(entry);
+		}
+	}
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include "MappedFile.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+/// <summary>
+/// アセットをまとめた1つのファイル(NoviceResourcesなどのフォルダから作る)
+/// </summary>
+/// <remarks>
+/// ファイルは先頭のヘッダ、揃えて並べた中身、エントリの表、パスのハッシュ表、パスの文字列の順に並ぶ。
+/// 開くときはメモリに割り当ててヘッダを確かめるだけで、探すのはハッシュ表を引くだけ。
+/// 圧縮していない中身は割り当てたメモリをそのまま返すので、読むのは触ったページだけになる。
+/// LZ4で圧縮した中身は裏のスレッドで展開して閉じるまで持っておく(Prefetchしておけば使う前に展開を始める)。
+/// 開くときにエントリの位置と大きさを確かめるので、壊れたファイルでも範囲外を読んだり大きすぎる確保をしたりしない。
+/// パスは大文字・小文字と区切り文字(\と/)を区別しない
+/// </remarks>
+class AssetArchive {
+public://構造体
+	/// <summary>
+	/// 作るときの設定
+	/// </summary>
+	struct PackDesc {
+		std::string rootDirectory; //まとめるフォルダ(パスはここからの相対パスになる)
+		uint32_t alignment = 64; //中身の先頭を揃えるバイト数(2のべき乗。GPUに直接送るなら512など)
+		bool isCompressionEnabled = false; //LZ4で圧縮するか(小さくならないものは圧縮しない)
+	};
+
+	/// <summary>
+	/// エントリの情報
+	/// </summary>
+	struct EntryInfo {
+		std::string_view path; //パス(小文字、区切りは/)
+		uint64_t size; //元のバイト数
+		uint64_t storedSize; //ファイルの中でのバイト数
+		bool isCompressed; //圧縮しているか
+	};
+public://メンバ関数
+	/// <summary>
+	/// デストラクタ(開いていれば閉じる)
+	/// </summary>
+	~AssetArchive();
+
+	/// <summary>
+	/// フォルダの中のファイルをまとめて書き出す
+	/// </summary>
+	/// <param name="filePath">出力先</param>
+	/// <param name="desc">設定</param>
+	/// <returns>書き出せたか</returns>
+	static bool Pack(const char* filePath, const PackDesc& desc);
+
+	/// <summary>
+	/// 開く(展開用のスレッドも始める)
+	/// </summary>
+	/// <param name="filePath">Packで作ったファイル</param>
+	/// <returns>読めるファイルだったか</returns>
+	bool Open(const char* filePath);
+
+	/// <summary>
+	/// 閉じる(返した中身は使えなくなる)
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// エントリ数のゲッター
+	/// </summary>
+	size_t GetEntryCount() const { return entryCount_; }
+
+	/// <summary>
+	/// パスでエントリを探す
+	/// </summary>
+	/// <param name="path">パス</param>
+	/// <returns>エントリの番号(なければkNotFound)</returns>
+	size_t Find(std::string_view path) const;
+
+	/// <summary>
+	/// エントリの情報のゲッター
+	/// </summary>
+	/// <param name="entry">エントリの番号</param>
+	EntryInfo GetEntryInfo(size_t entry) const;
+
+	/// <summary>
+	/// 中身のゲッター(圧縮していれば裏のスレッドに先に展開させ、終わるまで待つ)
+	/// </summary>
+	/// <param name="path">パス</param>
+	/// <returns>中身(なければ空。閉じるまで有効)</returns>
+	std::span<const uint8_t> Get(std::string_view path);
+
+	/// <summary>
+	/// 中身のゲッター(番号で指定)
+	/// </summary>
+	/// <param name="entry">エントリの番号</param>
+	std::span<const uint8_t> GetEntry(size_t entry);
+
+	/// <summary>
+	/// 裏のスレッドで展開しておく(圧縮していなければ何もしない)
+	/// </summary>
+	/// <param name="path">パス</param>
+	void Prefetch(std::string_view path);
+
+	/// <summary>
+	/// 裏のスレッドで展開しておく(番号で指定)
+	/// </summary>
+	/// <param name="entry">エントリの番号</param>
+	void PrefetchEntry(size_t entry);
+
+	/// <summary>
+	/// パスのハッシュ(大文字・小文字と区切り文字を区別せず、先頭の"./"は除く)
+	/// </summary>
+	/// <param name="path">パス</param>
+	static uint64_t HashPath(std::string_view path);
+public://定数
+	//見つからないことを表す番号
+	static inline const size_t kNotFound = SIZE_MAX;
+	//ファイルの識別子
+	static inline const uint32_t kMagic = 0x5241544D; //"MTAR"
+	//ファイルの版
+	static inline const uint32_t kVersion = 1;
+private://列挙型
+	/// <summary>
+	/// 圧縮したエントリの状態
+	/// </summary>
+	enum class State : uint8_t {
+		kNotLoaded, //展開していない
+		kQueued,    //展開を待っている
+		kDecoding,  //展開中
+		kReady,     //展開した
+		kFailed,    //壊れていた
+	};
+private://構造体
+	/// <summary>
+	/// ファイルの先頭
+	/// </summary>
+	struct FileHeader {
+		uint32_t magic; //識別子
+		uint32_t version; //版
+		uint32_t entryCount; //エントリ数
+		uint32_t bucketCount; //ハッシュ表の大きさ(2のべき乗)
+		uint64_t entriesOffset; //エントリの表の位置
+		uint64_t bucketsOffset; //ハッシュ表の位置
+		uint64_t stringsOffset; //パスの文字列の位置
+		uint64_t stringsSize; //パスの文字列のバイト数
+	};
+
+	/// <summary>
+	/// エントリ
+	/// </summary>
+	struct Entry {
+		uint64_t pathHash; //パスのハッシュ
+		uint64_t offset; //中身の位置
+		uint64_t storedSize; //ファイルの中でのバイト数
+		uint64_t size; //元のバイト数
+		uint32_t pathOffset; //パスの位置(文字列の中で)
+		uint32_t pathLength; //パスのバイト数
+		uint32_t flags; //kCompressedFlagなど
+		uint32_t reserved; //予約
+	};
+
+	/// <summary>
+	/// 圧縮したエントリの展開結果
+	/// </summary>
+	struct DecodedEntry {
+		std::atomic<State> state = State::kNotLoaded; //状態
+		std::unique_ptr<uint8_t[]> data; //展開した中身(kReadyの間だけ有効)
+	};
+private://定数
+	//圧縮しているエントリ
+	static inline const uint32_t kCompressedFlag = 1;
+	//ハッシュ表の空き
+	static inline const uint32_t kEmptyBucket = UINT32_MAX;
+	//圧縮するエントリの元のバイト数の上限(展開するときにこの大きさまで確保する)
+	static inline const uint64_t kMaxDecodedSize = 1ull << 30;
+	//LZ4で縮む割合の上限(一致長を延ばす1バイトで最大255バイト)
+	static inline const uint64_t kMaxCompressionRatio = 255;
+private://メンバ関数
+	/// <summary>
+	/// パスを小文字と/にそろえる
+	/// </summary>
+	static std::string NormalizePath(std::string_view path);
+
+	/// <summary>
+	/// 圧縮したエントリを展開する
+	/// </summary>
+	void Decode(size_t entry);
+
+	/// <summary>
+	/// 展開用のスレッドの処理
+	/// </summary>
+	void WorkerMain();
+private://メンバ変数
+	MappedFile file_; //割り当てたファイル
+	const Entry* entries_ = nullptr; //エントリの表
+	const uint32_t* buckets_ = nullptr; //ハッシュ表(エントリの番号)
+	const char* strings_ = nullptr; //パスの文字列
+	size_t entryCount_ = 0; //エントリ数
+	size_t bucketMask_ = 0; //ハッシュ表の大きさ-1
+	std::unique_ptr<DecodedEntry[]> decodedEntries_; //圧縮したエントリの展開結果
+
+	std::thread worker_; //展開用のスレッド
+	std::mutex mutex_; //以下の状態を守る
+	std::condition_variable queueCondition_; //展開を頼んだらスレッドを起こす
+	std::condition_variable readyCondition_; //展開し終えたら待っている側を起こす
+	std::deque<size_t> queue_; //展開を待っているエントリ
+	bool isExiting_ = false; //終了中か
+};
@@ -0,0 +1,62 @@
+#include "AssetArchive.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// フォルダの中のファイルをAssetArchiveの1つのファイルにまとめる
+// 使い方: MT_Study_asset_packer 入力フォルダ 出力ファイル [--compress] [--align バイト数]
+// 例: MT_Study_asset_packer NoviceResources NoviceResources.pak --compress
+
+int main(int argc, char** argv) {
+	AssetArchive::PackDesc desc;
+	std::string outputPath;
+	bool isUsageError = false;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--compress") {
+			desc.isCompressionEnabled = true;
+		} else if (arg == "--align" && i + 1 < argc) {
+			desc.alignment = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		} else if (desc.rootDirectory.empty() && arg.rfind("--", 0) != 0) {
+			desc.rootDirectory = arg;
+		} else if (outputPath.empty() && arg.rfind("--", 0) != 0) {
+			outputPath = arg;
+		} else {
+			isUsageError = true;
+		}
+	}
+	if (isUsageError || desc.rootDirectory.empty() || outputPath.empty()) {
+		std::cerr << "usage: " << argv[0] << " input_directory output [--compress] [--align bytes]" << std::endl;
+		return 1;
+	}
+
+	if (!AssetArchive::Pack(outputPath.c_str(), desc)) {
+		std::cerr << "failed to pack " << desc.rootDirectory << " into " << outputPath
+			<< " (alignment must be a power of two, and paths must differ by more than case)" << std::endl;
+		return 1;
+	}
+
+	//書き出したものを開き直して中身を表示する
+	AssetArchive archive;
+	if (!archive.Open(outputPath.c_str())) {
+		std::cerr << "failed to open " << outputPath << std::endl;
+		return 1;
+	}
+	uint64_t totalSize = 0;
+	uint64_t totalStoredSize = 0;
+	char line[512];
+	for (size_t i = 0; i < archive.GetEntryCount(); i++) {
+		const AssetArchive::EntryInfo info = archive.GetEntryInfo(i);
+		std::snprintf(line, sizeof(line), "%10llu -> %10llu %s %.*s",
+			static_cast<unsigned long long>(info.size), static_cast<unsigned long long>(info.storedSize),
+			info.isCompressed ? "lz4 " : "raw ", static_cast<int>(info.path.size()), info.path.data());
+		std::cout << line << std::endl;
+		totalSize += info.size;
+		totalStoredSize += info.storedSize;
+	}
+	std::snprintf(line, sizeof(line), "%zu entries, %llu -> %llu bytes",
+		archive.GetEntryCount(), static_cast<unsigned long long>(totalSize), static_cast<unsigned long long>(totalStoredSize));
+	std::cout << line << std::endl;
+	return 0;
+}
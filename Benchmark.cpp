@@ -0,0 +1,1920 @@
+#include "MathData.h"
+#include "Rendering.h"
+#include "Camera.h"
+#include "Primitive.h"
+#include "Collision.h"
+#include "DynamicAABBTree.h"
+#include "SpatialHashGrid.h"
+#include "JobSystem.h"
+#include "Gjk.h"
+#include "ContinuousCollision.h"
+#include "Picking.h"
+#include "RigidBodyWorld.h"
+#include "ContactSolver.h"
+#include "ParticleSystem.h"
+#include "TransformHierarchy.h"
+#include "EntityManager.h"
+#include "AnimationClip.h"
+#include "Spline.h"
+#include "DebugText.h"
+#include "KeyBitset.h"
+#include "InputEventQueue.h"
+#include "DrawBackend.h"
+#include "DrawCapture.h"
+#include "ObjLoader.h"
+#include "Lz4.h"
+#include "AssetArchive.h"
+#include "FrameAllocator.h"
+#include "PoolAllocator.h"
+#include "SmallHashMap.h"
+#include "MemoryTracker.h"
+#include "BoundingVolume.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 使い方: MT_Study_bench [--json 出力先] [--filter 名前の一部] [--min-time-ms 計測時間] [--label ラベル]
+// JSONを保存しておけばコミット間で結果を比較できる
+
+#ifdef MT_MEMORY_TRACKING
+namespace {
+	//MemoryTrackerがグローバルなnewを置き換えているので、その集計を使う
+	uint64_t LoadAllocationCount() { return MemoryTracker::GetAllocationCount(); }
+	uint64_t LoadAllocationBytes() { return MemoryTracker::GetAllocationBytes(); }
+}
+#else
+namespace {
+	//確保の回数と量(グローバルなnewを置き換えて数える)
+	std::atomic<uint64_t> allocationCount = 0;
+	std::atomic<uint64_t> allocationBytes = 0;
+
+	uint64_t LoadAllocationCount() { return allocationCount.load(std::memory_order_relaxed); }
+	uint64_t LoadAllocationBytes() { return allocationBytes.load(std::memory_order_relaxed); }
+}
+
+void* operator new(size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocationBytes.fetch_add(size, std::memory_order_relaxed);
+	if (void* p = std::malloc(size == 0 ? 1 : size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+	std::free(p);
+}
+#endif // MT_MEMORY_TRACKING
+
+namespace {
+	/// <summary>
+	/// 最適化で計算を消されないようにする
+	/// </summary>
+	/// <param name="value">値</param>
+	template<class T>
+	inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static const void* volatile sink = nullptr;
+		sink = &value;
+#endif
+	}
+
+	/// <summary>
+	/// ベンチマークの結果
+	/// </summary>
+	struct BenchmarkResult {
+		std::string name; //名前
+		uint64_t iterations = 0; //繰り返し回数
+		double nsPerOp = 0.0; //1回あたりの時間(ns)
+		double opsPerSecond = 0.0; //1秒あたりの回数
+		uint64_t itemsPerOp = 0; //1回あたりの要素数(線の本数など)
+		double itemsPerSecond = 0.0; //1秒あたりの要素数
+		double allocationsPerOp = 0.0; //1回あたりの確保回数
+		double bytesPerOp = 0.0; //1回あたりの確保量
+	};
+
+	/// <summary>
+	/// ベンチマークの実行
+	/// </summary>
+	class BenchmarkRunner {
+	public://メンバ関数
+		/// <summary>
+		/// コンストラクタ
+		/// </summary>
+		/// <param name="minTimeMs">1つあたりの最低計測時間(ms)</param>
+		/// <param name="filter">名前にこの文字列を含むものだけ実行する</param>
+		BenchmarkRunner(double minTimeMs, std::string filter)
+			: minTimeMs_(minTimeMs), filter_(std::move(filter)) {
+		}
+
+		/// <summary>
+		/// 実行
+		/// </summary>
+		/// <param name="name">名前</param>
+		/// <param name="itemsPerOp">1回あたりの要素数</param>
+		/// <param name="body">iterations回処理を行う関数</param>
+		template<class Body>
+		void Run(const char* name, uint64_t itemsPerOp, Body body) {
+			if (!IsSelected(name)) {
+				return;
+			}
+
+			//最低計測時間に届くまで回数を増やす
+			uint64_t iterations = 1;
+			double elapsedNs = 0.0;
+			uint64_t allocations = 0;
+			uint64_t bytes = 0;
+			for (;;) {
+				uint64_t startCount = LoadAllocationCount();
+				uint64_t startBytes = LoadAllocationBytes();
+				auto start = std::chrono::steady_clock::now();
+				body(iterations);
+				auto end = std::chrono::steady_clock::now();
+				elapsedNs = std::chrono::duration<double, std::nano>(end - start).count();
+				allocations = LoadAllocationCount() - startCount;
+				bytes = LoadAllocationBytes() - startBytes;
+				if (elapsedNs >= minTimeMs_ * 1.0e6 || iterations >= (1ull << 40)) {
+					break;
+				}
+				//目標時間から次の回数を見積もる(伸ばしすぎないように10倍まで)
+				double scale = elapsedNs > 0.0 ? (minTimeMs_ * 1.0e6 * 1.2) / elapsedNs : 10.0;
+				scale = scale < 2.0 ? 2.0 : (scale > 10.0 ? 10.0 : scale);
+				iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale) + 1;
+			}
+
+			BenchmarkResult result;
+			result.name = name;
+			result.iterations = iterations;
+			result.nsPerOp = elapsedNs / static_cast<double>(iterations);
+			result.opsPerSecond = 1.0e9 / result.nsPerOp;
+			result.itemsPerOp = itemsPerOp;
+			result.itemsPerSecond = result.opsPerSecond * static_cast<double>(itemsPerOp);
+			result.allocationsPerOp = static_cast<double>(allocations) / static_cast<double>(iterations);
+			result.bytesPerOp = static_cast<double>(bytes) / static_cast<double>(iterations);
+			Print(result);
+			results_.push_back(result);
+		}
+
+		/// <summary>
+		/// 実行するものかどうか(ファイルを書き出すような準備を、実行しないときに省くため)
+		/// </summary>
+		/// <param name="name">名前</param>
+		bool IsSelected(const char* name) const {
+			return filter_.empty() || std::string(name).find(filter_) != std::string::npos;
+		}
+
+		/// <summary>
+		/// 結果をJSONで書き出す
+		/// </summary>
+		/// <param name="filePath">出力先</param>
+		/// <param name="label">ラベル(コミット名など)</param>
+		/// <returns>書き出せたかどうか</returns>
+		bool WriteJson(const char* filePath, const std::string& label) const {
+			std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+			if (!file.is_open()) {
+				return false;
+			}
+			file << "{\n  \"label\": \"" << label << "\",\n  \"benchmarks\": [\n";
+			for (size_t i = 0; i < results_.size(); i++) {
+				const BenchmarkResult& r = results_[i];
+				file << "    {\"name\": \"" << r.name << "\""
+					<< ", \"iterations\": " << r.iterations
+					<< ", \"ns_per_op\": " << r.nsPerOp
+					<< ", \"ops_per_second\": " << r.opsPerSecond
+					<< ", \"items_per_op\": " << r.itemsPerOp
+					<< ", \"items_per_second\": " << r.itemsPerSecond
+					<< ", \"allocations_per_op\": " << r.allocationsPerOp
+					<< ", \"bytes_per_op\": " << r.bytesPerOp << "}"
+					<< (i + 1 < results_.size() ? ",\n" : "\n");
+			}
+			file << "  ]\n}\n";
+			return file.good();
+		}
+	private://メンバ関数
+		/// <summary>
+		/// 結果の表示
+		/// </summary>
+		/// <param name="result">結果</param>
+		static void Print(const BenchmarkResult& result) {
+			char line[256];
+			std::snprintf(line, sizeof(line), "%-40s %12.2f ns/op %14.0f op/s %14.0f items/s %8.2f allocs/op %10.1f B/op",
+				result.name.c_str(), result.nsPerOp, result.opsPerSecond, result.itemsPerSecond,
+				result.allocationsPerOp, result.bytesPerOp);
+			std::cout << line << std::endl;
+		}
+	private://メンバ変数
+		double minTimeMs_; //1つあたりの最低計測時間(ms)
+		std::string filter_; //名前のフィルタ
+		std::vector<BenchmarkResult> results_; //結果
+	};
+
+	//入力データの数(2のべき乗)
+	const size_t kInputCount = 256;
+
+	/// <summary>
+	/// 計算に使う入力データ
+	/// </summary>
+	struct BenchmarkInput {
+		std::vector<Vector3> vectors; //ベクトル
+		std::vector<Matrix4x4> matrices; //アフィン行列
+	};
+
+	/// <summary>
+	/// 入力データの作成
+	/// </summary>
+	/// <returns>入力データ</returns>
+	BenchmarkInput MakeInput() {
+		std::mt19937 engine(12345);
+		std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+		BenchmarkInput input;
+		for (size_t i = 0; i < kInputCount; i++) {
+			input.vectors.push_back({ distribution(engine), distribution(engine), distribution(engine) });
+		}
+		for (size_t i = 0; i < kInputCount; i++) {
+			Vector3 rotate = { distribution(engine), distribution(engine), distribution(engine) };
+			Vector3 translate = { distribution(engine), distribution(engine), distribution(engine) };
+			input.matrices.push_back(Rendering::MakeAffineMatrix(Vector3::MakeAllOne(), rotate, translate));
+		}
+		return input;
+	}
+
+	/// <summary>
+	/// 数学関数のベンチマーク
+	/// </summary>
+	/// <param name="runner">実行</param>
+	/// <param name="input">入力データ</param>
+	void RunMathBenchmarks(BenchmarkRunner& runner, const BenchmarkInput& input) {
+		const size_t kMask = kInputCount - 1;
+
+		runner.Run("Matrix4x4::operator*", 1, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				Matrix4x4 result = input.matrices[i & kMask] * input.matrices[(i + 1) & kMask];
+				DoNotOptimize(result);
+			}
+			});
+
+		runner.Run("Matrix4x4::Inverse", 1, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				Matrix4x4 result = input.matrices[i & kMask].Inverse();
+				DoNotOptimize(result);
+			}
+			});
+
+		runner.Run("Rendering::Transform", 1, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				Vector3 result = Rendering::Transform(input.vectors[i & kMask], input.matrices[(i >> 8) & kMask]);
+				DoNotOptimize(result);
+			}
+			});
+
+		runner.Run("Rendering::MakeAffineMatrix", 1, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				Matrix4x4 result = Rendering::MakeAffineMatrix(Vector3::MakeAllOne(), input.vectors[i & kMask], input.vectors[(i + 1) & kMask]);
+				DoNotOptimize(result);
+			}
+			});
+
+		runner.Run("Rendering::MakeRotateXYZMatrix", 1, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				Matrix4x4 result = Rendering::MakeRotateXYZMatrix(input.vectors[i & kMask]);
+				DoNotOptimize(result);
+			}
+			});
+
+		runner.Run("Rendering::DirectionToDirection", 1, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				Matrix4x4 result = Rendering::DirectionToDirection(input.vectors[i & kMask], input.vectors[(i + 1) & kMask]);
+				DoNotOptimize(result);
+			}
+			});
+	}
+
+	/// <summary>
+	/// 描画ループのベンチマーク(描画は何もしない描画先に流す)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunPrimitiveBenchmarks(BenchmarkRunner& runner) {
+		//main.cppと同じカメラ
+		Camera camera;
+		camera.Initialize(1280.0f, 720.0f);
+		camera.SetRotate({ 0.26f,0.0f,0.0f });
+		camera.SetTranslate({ 0.0f,1.9f,-6.49f });
+		camera.Update();
+		Matrix4x4 viewProjectionMatrix = camera.GetViewProjectionMatrix();
+		Matrix4x4 viewportMatrix = camera.GetViewportMatrix();
+
+		//1回あたりの線の本数を数えておく
+		NullDrawBackend countBackend;
+		Primitive::DrawGrid(viewProjectionMatrix, viewportMatrix, countBackend);
+		uint64_t gridLines = countBackend.GetLineCount();
+		Primitive::DrawSphere({ .center{},.radius = 1.0f }, viewProjectionMatrix, viewportMatrix, countBackend);
+		uint64_t sphereLines = countBackend.GetLineCount() - gridLines;
+
+		runner.Run("Primitive::DrawGrid", gridLines, [&](uint64_t iterations) {
+			NullDrawBackend backend;
+			for (uint64_t i = 0; i < iterations; i++) {
+				Primitive::DrawGrid(viewProjectionMatrix, viewportMatrix, backend);
+			}
+			DoNotOptimize(backend.GetChecksum());
+			});
+
+		runner.Run("Primitive::DrawSphere", sphereLines, [&](uint64_t iterations) {
+			NullDrawBackend backend;
+			SphereData sphereData = { .center{},.radius = 1.0f };
+			for (uint64_t i = 0; i < iterations; i++) {
+				Primitive::DrawSphere(sphereData, viewProjectionMatrix, viewportMatrix, backend);
+			}
+			DoNotOptimize(backend.GetChecksum());
+			});
+	}
+
+	/// <summary>
+	/// 衝突判定のベンチマーク(1対1の判定を繰り返す場合と一括判定の比較)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunCollisionBenchmarks(BenchmarkRunner& runner) {
+		const size_t kShapeCount = 1024;
+		std::mt19937 engine(54321);
+		std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> size(0.1f, 1.0f);
+
+		std::vector<SphereData> spheres;
+		std::vector<OBB> obbs;
+		SphereSet sphereSet;
+		OBBSet obbSet;
+		for (size_t i = 0; i < kShapeCount; i++) {
+			SphereData sphere = { .center{ position(engine), position(engine), position(engine) },.radius = size(engine) };
+			spheres.push_back(sphere);
+			sphereSet.Add(sphere);
+
+			OBB obb = {};
+			obb.center = { position(engine), position(engine), position(engine) };
+			Rendering::MakeOBBRotateMatrix(obb.orientations, { position(engine), position(engine), position(engine) });
+			obb.size = { size(engine), size(engine), size(engine) };
+			obbs.push_back(obb);
+			obbSet.Add(obb);
+		}
+		std::vector<uint8_t> hits(kShapeCount);
+		SphereData querySphere = { .center{ 1.0f, 0.5f, -0.5f },.radius = 2.0f };
+		OBB queryOBB = obbs[0];
+		queryOBB.size = { 2.0f, 2.0f, 2.0f };
+
+		runner.Run("Collision::IsCollision(Sphere,Sphere)x1024", kShapeCount, [&](uint64_t iterations) {
+			size_t count = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (const SphereData& sphere : spheres) {
+					count += Collision::IsCollision(querySphere, sphere);
+				}
+			}
+			DoNotOptimize(count);
+			});
+
+		runner.Run("Collision::IsCollisionBatch(Sphere,SphereSet)", kShapeCount, [&](uint64_t iterations) {
+			size_t count = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				count += Collision::IsCollisionBatch(querySphere, sphereSet, hits.data());
+			}
+			DoNotOptimize(count);
+			});
+
+		runner.Run("Collision::IsCollision(OBB,OBB)x1024", kShapeCount, [&](uint64_t iterations) {
+			size_t count = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (const OBB& obb : obbs) {
+					count += Collision::IsCollision(queryOBB, obb);
+				}
+			}
+			DoNotOptimize(count);
+			});
+
+		runner.Run("Collision::IsCollisionBatch(OBB,OBBSet)", kShapeCount, [&](uint64_t iterations) {
+			size_t count = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				count += Collision::IsCollisionBatch(queryOBB, obbSet, hits.data());
+			}
+			DoNotOptimize(count);
+			});
+	}
+
+	/// <summary>
+	/// ブロードフェーズのベンチマーク(動く球の総当たりと動的AABB木の比較)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunBroadPhaseBenchmarks(BenchmarkRunner& runner) {
+		const size_t kSphereCount = 4096;
+		std::mt19937 engine(13579);
+		std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+		std::uniform_real_distribution<float> size(0.2f, 1.0f);
+		std::uniform_real_distribution<float> speed(-0.05f, 0.05f);
+
+		std::vector<SphereData> spheres(kSphereCount);
+		std::vector<Vector3> velocities(kSphereCount);
+		for (size_t i = 0; i < kSphereCount; i++) {
+			spheres[i] = { .center{ position(engine), position(engine), position(engine) },.radius = size(engine) };
+			velocities[i] = { speed(engine), speed(engine), speed(engine) };
+		}
+
+		//端で跳ね返しながら動かす(速度も書き換えるので、実行ごとに写しを使って同じ動きから始める)
+		auto step = [](std::vector<SphereData>& targets, std::vector<Vector3>& targetVelocities, size_t index) {
+			Vector3& velocity = targetVelocities[index];
+			Vector3& center = targets[index].center;
+			center += velocity;
+			if (center.x < -40.0f || 40.0f < center.x) { velocity.x = -velocity.x; }
+			if (center.y < -40.0f || 40.0f < center.y) { velocity.y = -velocity.y; }
+			if (center.z < -40.0f || 40.0f < center.z) { velocity.z = -velocity.z; }
+			};
+
+		//総当たりで重なっている組を求める
+		auto bruteForcePairs = [](const std::vector<AABB>& aabbs, std::vector<DynamicAABBTree::ProxyPair>* pairs) {
+			size_t pairCount = 0;
+			for (size_t a = 0; a < aabbs.size(); a++) {
+				for (size_t b = a + 1; b < aabbs.size(); b++) {
+					const bool isHit = Collision::IsCollision(aabbs[a], aabbs[b]);
+					pairCount += isHit;
+					if (isHit && pairs) {
+						pairs->push_back({ static_cast<int32_t>(a),static_cast<int32_t>(b) });
+					}
+				}
+			}
+			return pairCount;
+			};
+
+		//木の候補の組から、実際に重なっている組を求める(総当たりと同じ結果になる)
+		auto treePairs = [](const DynamicAABBTree& tree, const std::vector<AABB>& aabbs, std::vector<DynamicAABBTree::ProxyPair>& candidates,
+			std::vector<DynamicAABBTree::ProxyPair>* pairs) {
+			tree.QueryAllPairs(candidates);
+			size_t pairCount = 0;
+			for (const DynamicAABBTree::ProxyPair& candidate : candidates) {
+				const uint32_t a = tree.GetUserData(candidate.proxyA);
+				const uint32_t b = tree.GetUserData(candidate.proxyB);
+				const bool isHit = Collision::IsCollision(aabbs[a], aabbs[b]);
+				pairCount += isHit;
+				if (isHit && pairs) {
+					pairs->push_back({ static_cast<int32_t>(std::min(a, b)),static_cast<int32_t>(std::max(a, b)) });
+				}
+			}
+			return pairCount;
+			};
+
+		//1ステップ目の組が両方で同じになるか確かめる
+		{
+			std::vector<SphereData> moving = spheres;
+			std::vector<Vector3> movingVelocities = velocities;
+			std::vector<AABB> aabbs(kSphereCount);
+			DynamicAABBTree tree;
+			std::vector<int32_t> proxies(kSphereCount);
+			for (size_t j = 0; j < kSphereCount; j++) {
+				proxies[j] = tree.CreateProxy(Collision::ComputeAABB(moving[j]), static_cast<uint32_t>(j));
+			}
+			for (size_t j = 0; j < kSphereCount; j++) {
+				step(moving, movingVelocities, j);
+				aabbs[j] = Collision::ComputeAABB(moving[j]);
+				tree.MoveProxy(proxies[j], aabbs[j], movingVelocities[j]);
+			}
+			std::vector<DynamicAABBTree::ProxyPair> expected;
+			std::vector<DynamicAABBTree::ProxyPair> actual;
+			std::vector<DynamicAABBTree::ProxyPair> candidates;
+			bruteForcePairs(aabbs, &expected);
+			treePairs(tree, aabbs, candidates, &actual);
+			auto less = [](const DynamicAABBTree::ProxyPair& l, const DynamicAABBTree::ProxyPair& r) {
+				return l.proxyA != r.proxyA ? l.proxyA < r.proxyA : l.proxyB < r.proxyB;
+				};
+			std::sort(actual.begin(), actual.end(), less);
+			const bool isSame = expected.size() == actual.size() && std::equal(expected.begin(), expected.end(), actual.begin(),
+				[](const DynamicAABBTree::ProxyPair& l, const DynamicAABBTree::ProxyPair& r) { return l.proxyA == r.proxyA && l.proxyB == r.proxyB; });
+			if (!isSame) {
+				std::cerr << "BroadPhase pair mismatch: " << expected.size() << " vs " << actual.size() << std::endl;
+			}
+		}
+
+		runner.Run("BroadPhase::BruteForce x4096", kSphereCount, [&](uint64_t iterations) {
+			std::vector<SphereData> moving = spheres;
+			std::vector<Vector3> movingVelocities = velocities;
+			std::vector<AABB> aabbs(kSphereCount);
+			size_t pairCount = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t j = 0; j < kSphereCount; j++) {
+					step(moving, movingVelocities, j);
+					aabbs[j] = Collision::ComputeAABB(moving[j]);
+				}
+				pairCount += bruteForcePairs(aabbs, nullptr);
+			}
+			DoNotOptimize(pairCount);
+			});
+
+		runner.Run("BroadPhase::DynamicAABBTree x4096", kSphereCount, [&](uint64_t iterations) {
+			std::vector<SphereData> moving = spheres;
+			std::vector<Vector3> movingVelocities = velocities;
+			std::vector<AABB> aabbs(kSphereCount);
+			DynamicAABBTree tree;
+			std::vector<int32_t> proxies(kSphereCount);
+			for (size_t j = 0; j < kSphereCount; j++) {
+				proxies[j] = tree.CreateProxy(Collision::ComputeAABB(moving[j]), static_cast<uint32_t>(j));
+			}
+			std::vector<DynamicAABBTree::ProxyPair> candidates;
+			size_t pairCount = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t j = 0; j < kSphereCount; j++) {
+					step(moving, movingVelocities, j);
+					aabbs[j] = Collision::ComputeAABB(moving[j]);
+					tree.MoveProxy(proxies[j], aabbs[j], movingVelocities[j]);
+				}
+				pairCount += treePairs(tree, aabbs, candidates, nullptr);
+			}
+			DoNotOptimize(pairCount);
+			});
+	}
+
+	/// <summary>
+	/// 近傍探索のベンチマーク(総当たりと一様グリッドの比較)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunNeighborBenchmarks(BenchmarkRunner& runner) {
+		//密度が同じになるように箱の大きさを決める(1球あたりの近傍が数個)
+		auto makeSpheres = [](size_t count) {
+			std::mt19937 engine(24680);
+			float extent = 0.5f * std::cbrt(static_cast<float>(count));
+			std::uniform_real_distribution<float> position(-extent, extent);
+			std::uniform_real_distribution<float> size(0.2f, 0.25f);
+			SphereSet spheres;
+			for (size_t i = 0; i < count; i++) {
+				spheres.Add({ .center{ position(engine), position(engine), position(engine) },.radius = size(engine) });
+			}
+			return spheres;
+			};
+		const size_t kSmallCount = 4096;
+		const size_t kLargeCount = 100000;
+		SphereSet smallSet = makeSpheres(kSmallCount);
+		SphereSet largeSet = makeSpheres(kLargeCount);
+		std::vector<uint8_t> hits(kSmallCount);
+
+		runner.Run("Neighbor::BruteForce x4096", kSmallCount, [&](uint64_t iterations) {
+			size_t pairCount = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t j = 0; j < kSmallCount; j++) {
+					SphereData sphere = { .center{ smallSet.center[0][j], smallSet.center[1][j], smallSet.center[2][j] },.radius = smallSet.radius[j] };
+					pairCount += Collision::IsCollisionBatch(sphere, smallSet, hits.data()) - 1;
+				}
+			}
+			DoNotOptimize(pairCount / 2);
+			});
+
+		//作り直しと組の探索を毎回行う
+		auto runGrid = [&](const char* name, const SphereSet& spheres, bool isParallel) {
+			runner.Run(name, spheres.Size(), [&](uint64_t iterations) {
+				SpatialHashGrid grid;
+				std::vector<SpatialHashGrid::NeighborPair> pairs;
+				size_t pairCount = 0;
+				for (uint64_t i = 0; i < iterations; i++) {
+					grid.Build(spheres, 0.0f, isParallel);
+					grid.FindPairs(pairs, isParallel);
+					pairCount += pairs.size();
+				}
+				DoNotOptimize(pairCount);
+				});
+			};
+		runGrid("Neighbor::SpatialHashGrid x4096", smallSet, false);
+		runGrid("Neighbor::SpatialHashGrid x100000", largeSet, false);
+		runGrid("Neighbor::SpatialHashGrid(parallel) x100000", largeSet, true);
+	}
+
+	/// <summary>
+	/// GJK/EPAのベンチマーク(OBBの組で分離軸判定と比較)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunGjkBenchmarks(BenchmarkRunner& runner) {
+		const size_t kPairCount = 1024;
+		std::mt19937 engine(97531);
+		std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+		std::uniform_real_distribution<float> size(0.3f, 1.2f);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+		std::vector<OBB> obbsA(kPairCount);
+		std::vector<OBB> obbsB(kPairCount);
+		for (size_t i = 0; i < kPairCount; i++) {
+			for (OBB* obb : { &obbsA[i], &obbsB[i] }) {
+				obb->center = { position(engine), position(engine), position(engine) };
+				Rendering::MakeOBBRotateMatrix(obb->orientations, { angle(engine), angle(engine), angle(engine) });
+				obb->size = { size(engine), size(engine), size(engine) };
+			}
+		}
+
+		runner.Run("Gjk::SAT(OBB,OBB) x1024", kPairCount, [&](uint64_t iterations) {
+			size_t count = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t j = 0; j < kPairCount; j++) {
+					count += Collision::IsCollision(obbsA[j], obbsB[j]);
+				}
+			}
+			DoNotOptimize(count);
+			});
+
+		runner.Run("Gjk::IsIntersecting(OBB,OBB) x1024", kPairCount, [&](uint64_t iterations) {
+			size_t count = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t j = 0; j < kPairCount; j++) {
+					count += Gjk::IsIntersecting(OBBSupport(obbsA[j]), OBBSupport(obbsB[j]));
+				}
+			}
+			DoNotOptimize(count);
+			});
+
+		//前回の単体から始める(動いていない組なので持続接触の上限の速さ)
+		runner.Run("Gjk::IsIntersecting(OBB,OBB,warm) x1024", kPairCount, [&](uint64_t iterations) {
+			std::vector<Gjk::Cache> caches(kPairCount);
+			size_t count = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t j = 0; j < kPairCount; j++) {
+					count += Gjk::IsIntersecting(OBBSupport(obbsA[j]), OBBSupport(obbsB[j]), &caches[j]);
+				}
+			}
+			DoNotOptimize(count);
+			});
+
+		runner.Run("Gjk::Penetration(OBB,OBB,warm) x1024", kPairCount, [&](uint64_t iterations) {
+			std::vector<Gjk::Cache> caches(kPairCount);
+			float depth = 0.0f;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t j = 0; j < kPairCount; j++) {
+					depth += Gjk::Penetration(OBBSupport(obbsA[j]), OBBSupport(obbsB[j]), &caches[j]).depth;
+				}
+			}
+			DoNotOptimize(depth);
+			});
+	}
+
+	/// <summary>
+	/// 速い球と薄い壁のベンチマーク(8分割の離散判定と連続判定1回の比較)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunContinuousBenchmarks(BenchmarkRunner& runner) {
+		const size_t kWallCount = 1024;
+		const size_t kSphereCount = 256;
+		const int kSubstepCount = 8;
+		std::mt19937 engine(24680);
+		std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> speed(-3.0f, 3.0f);
+
+		OBBSet walls;
+		DynamicAABBTree tree;
+		for (size_t i = 0; i < kWallCount; i++) {
+			OBB wall = {};
+			wall.center = { position(engine), position(engine), position(engine) };
+			Rendering::MakeOBBRotateMatrix(wall.orientations, { angle(engine), angle(engine), angle(engine) });
+			wall.size = { 2.0f, 2.0f, 0.05f };
+			walls.Add(wall);
+			tree.CreateProxy(Collision::ComputeAABB(wall), static_cast<uint32_t>(i));
+		}
+		std::vector<SphereData> spheres(kSphereCount);
+		std::vector<Vector3> displacements(kSphereCount);
+		for (size_t i = 0; i < kSphereCount; i++) {
+			spheres[i] = { .center{ position(engine), position(engine), position(engine) },.radius = 0.2f };
+			displacements[i] = { speed(engine), speed(engine), speed(engine) };
+		}
+
+		auto getWall = [&](uint32_t index) {
+			OBB wall = {};
+			wall.center = { walls.center[0][index], walls.center[1][index], walls.center[2][index] };
+			for (int axis = 0; axis < 3; axis++) {
+				wall.orientations[axis] = { walls.orientations[axis][0][index], walls.orientations[axis][1][index], walls.orientations[axis][2][index] };
+			}
+			wall.size = { walls.size[0][index], walls.size[1][index], walls.size[2][index] };
+			return wall;
+			};
+
+		//分割ごとに木を引いて離散判定する(分割の間を抜けることはある)
+		runner.Run("Continuous::Substep8(Sphere,OBB) x256", kSphereCount, [&](uint64_t iterations) {
+			size_t hitCount = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t j = 0; j < kSphereCount; j++) {
+					for (int step = 1; step <= kSubstepCount; step++) {
+						SphereData moved = { spheres[j].center + displacements[j] * (static_cast<float>(step) / kSubstepCount), spheres[j].radius };
+						bool isHit = false;
+						tree.Query(Collision::ComputeAABB(moved), [&](int32_t proxyId) {
+							isHit = Collision::IsCollision(moved, getWall(tree.GetUserData(proxyId)));
+							return !isHit;
+							});
+						if (isHit) {
+							hitCount++;
+							break;
+						}
+					}
+				}
+			}
+			DoNotOptimize(hitCount);
+			});
+
+		//通る範囲で一度だけ木を引いて、候補をまとめて掃引する
+		runner.Run("Continuous::SweepSphereBatch(OBB) x256", kSphereCount, [&](uint64_t iterations) {
+			std::vector<uint32_t> candidates;
+			size_t hitCount = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t j = 0; j < kSphereCount; j++) {
+					candidates.clear();
+					tree.Query(ContinuousCollision::ComputeSweptAABB(spheres[j], displacements[j]), [&](int32_t proxyId) {
+						candidates.push_back(tree.GetUserData(proxyId));
+						return true;
+						});
+					ContinuousCollision::SweepResult result = {};
+					hitCount += ContinuousCollision::SweepSphereBatch(spheres[j], displacements[j], walls,
+						candidates.data(), candidates.size(), result) != ContinuousCollision::kNoHit;
+				}
+			}
+			DoNotOptimize(hitCount);
+			});
+	}
+
+	/// <summary>
+	/// マウスでのピッキングのベンチマーク(5万個の球に視線を当てる)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunPickingBenchmarks(BenchmarkRunner& runner) {
+		const size_t kSphereCount = 50000;
+		const size_t kRayCount = 64;
+		std::mt19937 engine(11235);
+		std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+		std::uniform_real_distribution<float> size(0.1f, 0.5f);
+		std::uniform_real_distribution<float> screen(0.0f, 1.0f);
+
+		SphereSet spheres;
+		std::vector<SphereData> sphereList(kSphereCount);
+		DynamicAABBTree tree;
+		for (size_t i = 0; i < kSphereCount; i++) {
+			sphereList[i] = { .center{ position(engine), position(engine), position(engine) },.radius = size(engine) };
+			spheres.Add(sphereList[i]);
+			tree.CreateProxy(Collision::ComputeAABB(sphereList[i]), static_cast<uint32_t>(i));
+		}
+
+		//画面上のばらばらな位置からの視線
+		Camera camera;
+		camera.Initialize(1280.0f, 720.0f);
+		camera.SetTranslate({ 0.0f,0.0f,-80.0f });
+		camera.Update();
+		std::vector<Ray> rays(kRayCount);
+		for (Ray& ray : rays) {
+			ray = camera.ScreenToRay(screen(engine) * 1280.0f, screen(engine) * 720.0f);
+		}
+
+		runner.Run("Picking::RayCast(Sphere) x50000", kSphereCount, [&](uint64_t iterations) {
+			uint32_t picked = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				const Ray& ray = rays[i % kRayCount];
+				float nearest = std::numeric_limits<float>::infinity();
+				Picking::RayHit hit = {};
+				for (size_t j = 0; j < kSphereCount; j++) {
+					if (Picking::RayCast(ray, sphereList[j], hit) && hit.distance < nearest) {
+						nearest = hit.distance;
+						picked = static_cast<uint32_t>(j);
+					}
+				}
+			}
+			DoNotOptimize(picked);
+			});
+
+		runner.Run("Picking::RayCastBatch(SphereSet) x50000", kSphereCount, [&](uint64_t iterations) {
+			uint32_t picked = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				Picking::RayHit hit = {};
+				picked += Picking::RayCastBatch(rays[i % kRayCount], spheres, hit);
+			}
+			DoNotOptimize(picked);
+			});
+
+		runner.Run("Picking::Pick(DynamicAABBTree) x50000", kSphereCount, [&](uint64_t iterations) {
+			uint32_t picked = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				Picking::RayHit hit = {};
+				picked += Picking::Pick(rays[i % kRayCount], 100.0f, tree, spheres, hit);
+			}
+			DoNotOptimize(picked);
+			});
+	}
+
+	/// <summary>
+	/// 剛体の積分のベンチマーク(10万個)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunRigidBodyBenchmarks(BenchmarkRunner& runner) {
+		const size_t kBodyCount = 100000;
+		std::mt19937 engine(31415);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> speed(-5.0f, 5.0f);
+
+		RigidBodyWorld world;
+		for (size_t i = 0; i < kBodyCount; i++) {
+			RigidBodyWorld::BodyDesc desc;
+			desc.position = { position(engine), position(engine), position(engine) };
+			desc.velocity = { speed(engine), speed(engine), speed(engine) };
+			desc.angularVelocity = { speed(engine), speed(engine), speed(engine) };
+			desc.linearDamping = 0.1f;
+			desc.angularDamping = 0.1f;
+			world.AddBody(desc);
+		}
+
+		runner.Run("RigidBodyWorld::Step(serial) x100000", kBodyCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				world.Step(1.0f / 60.0f, false);
+			}
+			});
+
+		runner.Run("RigidBodyWorld::Step(parallel) x100000", kBodyCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				world.Step(1.0f / 60.0f, true);
+			}
+			});
+	}
+
+	/// <summary>
+	/// 接触ソルバーのベンチマーク(箱の山400個、起きている場合と眠っている場合)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunContactBenchmarks(BenchmarkRunner& runner) {
+		//床に3段の箱の山を20x20並べる(山ごとに別のアイランドになる)
+		const int kStackCount = 20;
+		const int kStackHeight = 3;
+		RigidBodyWorld world;
+		ContactSolver solver;
+		RigidBodyWorld::BodyDesc groundDesc;
+		groundDesc.position = { 0.0f,-1.0f,0.0f };
+		groundDesc.mass = 0.0f;
+		solver.AddBox(world, world.AddBody(groundDesc), { 40.0f,1.0f,40.0f });
+		std::vector<RigidBodyWorld::BodyHandle> bodies;
+		for (int x = 0; x < kStackCount; x++) {
+			for (int z = 0; z < kStackCount; z++) {
+				for (int y = 0; y < kStackHeight; y++) {
+					RigidBodyWorld::BodyDesc desc;
+					desc.position = { static_cast<float>(x) * 3.0f - 30.0f,0.5f + static_cast<float>(y) * 1.01f,static_cast<float>(z) * 3.0f - 30.0f };
+					desc.inertia = 1.0f / 6.0f;
+					bodies.push_back(world.AddBody(desc));
+					solver.AddBox(world, bodies.back(), { 0.5f,0.5f,0.5f });
+				}
+			}
+		}
+		//落ち着くまで進めておく
+		for (int i = 0; i < 60; i++) {
+			solver.Step(world, 1.0f / 60.0f);
+		}
+
+		runner.Run("ContactSolver::Step(awake) x1200", bodies.size(), [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (RigidBodyWorld::BodyHandle body : bodies) {
+					world.SetAwake(body, true);
+				}
+				solver.Step(world, 1.0f / 60.0f);
+			}
+			});
+
+		//眠ったアイランドは接触点も拘束も作り直さない
+		for (int i = 0; i < 60; i++) {
+			solver.Step(world, 1.0f / 60.0f);
+		}
+		runner.Run("ContactSolver::Step(sleeping) x1200", bodies.size(), [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				solver.Step(world, 1.0f / 60.0f);
+			}
+			});
+	}
+
+	/// <summary>
+	/// パーティクルのベンチマーク(20万個の更新と描画、1個ずつビルボード行列を作る場合との比較)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunParticleBenchmarks(BenchmarkRunner& runner) {
+		const size_t kParticleCount = 200000;
+		Camera camera;
+		camera.Initialize(1280.0f, 720.0f);
+		camera.SetRotate({ 0.26f,0.0f,0.0f });
+		camera.SetTranslate({ 0.0f,1.9f,-6.49f });
+		camera.Update();
+		const Matrix4x4 cameraWorldMatrix = camera.GetWorldMatrix();
+		const Matrix4x4 viewProjectionMatrix = camera.GetViewProjectionMatrix();
+		const Matrix4x4 viewportMatrix = camera.GetViewportMatrix();
+
+		//寿命が尽きる分を発生し続けて20万個前後に保つ
+		ParticleSystem particles;
+		particles.Initialize(kParticleCount, 2718);
+		ParticleSystem::Emitter emitter;
+		emitter.position = { 0.0f,1.0f,0.0f };
+		emitter.positionRange = { 2.0f,0.5f,2.0f };
+		emitter.velocity = { 0.0f,3.0f,0.0f };
+		emitter.velocityRange = { 1.5f,1.0f,1.5f };
+		emitter.minLifeTime = 1.0f;
+		emitter.maxLifeTime = 3.0f;
+		emitter.startSize = 0.02f;
+		emitter.endSize = 0.005f;
+		emitter.rate = static_cast<float>(kParticleCount) / 2.0f;
+		particles.Emit(particles.AddEmitter(emitter), kParticleCount);
+
+		runner.Run("ParticleSystem::Update x200000", kParticleCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				particles.Update(1.0f / 60.0f);
+			}
+			DoNotOptimize(particles.GetCount());
+			});
+
+		runner.Run("ParticleSystem::Draw(billboard) x200000", kParticleCount, [&](uint64_t iterations) {
+			NullDrawBackend backend;
+			for (uint64_t i = 0; i < iterations; i++) {
+				particles.Draw(cameraWorldMatrix, viewProjectionMatrix, viewportMatrix, backend);
+			}
+			DoNotOptimize(backend.GetChecksum());
+			});
+
+		particles.SetSortEnabled(true);
+		runner.Run("ParticleSystem::Draw(billboard,sorted) x200000", kParticleCount, [&](uint64_t iterations) {
+			NullDrawBackend backend;
+			for (uint64_t i = 0; i < iterations; i++) {
+				particles.Draw(cameraWorldMatrix, viewProjectionMatrix, viewportMatrix, backend);
+			}
+			DoNotOptimize(backend.GetChecksum());
+			});
+		particles.SetSortEnabled(false);
+
+		//1個ずつビルボード行列を作り、4頂点を変換する場合
+		const Matrix4x4 viewProjectionViewportMatrix = viewProjectionMatrix * viewportMatrix;
+		runner.Run("MakeBillboardMatrix per particle x200000", kParticleCount, [&](uint64_t iterations) {
+			NullDrawBackend backend;
+			const Vector3 corners[4] = { { 1.0f,1.0f,0.0f },{ -1.0f,1.0f,0.0f },{ -1.0f,-1.0f,0.0f },{ 1.0f,-1.0f,0.0f } };
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t p = 0; p < particles.GetCount(); p++) {
+					Matrix4x4 worldMatrix = Rendering::MakeScaleMatrix({ 0.02f,0.02f,0.02f }) *
+						Rendering::MakeBillboardMatrix(cameraWorldMatrix, { 0.0f,0.0f,0.0f }) * Rendering::MakeTranslateMatrix(particles.GetPosition(p));
+					Matrix4x4 matrix = worldMatrix * viewProjectionViewportMatrix;
+					Vector3 screen[4];
+					for (int k = 0; k < 4; k++) {
+						screen[k] = Rendering::Transform(corners[k], matrix);
+					}
+					backend.DrawTriangle(static_cast<int32_t>(screen[0].x), static_cast<int32_t>(screen[0].y), static_cast<int32_t>(screen[1].x),
+						static_cast<int32_t>(screen[1].y), static_cast<int32_t>(screen[2].x), static_cast<int32_t>(screen[2].y), 0xFFFFFFFF);
+					backend.DrawTriangle(static_cast<int32_t>(screen[0].x), static_cast<int32_t>(screen[0].y), static_cast<int32_t>(screen[2].x),
+						static_cast<int32_t>(screen[2].y), static_cast<int32_t>(screen[3].x), static_cast<int32_t>(screen[3].y), 0xFFFFFFFF);
+				}
+			}
+			DoNotOptimize(backend.GetChecksum());
+			});
+	}
+
+	/// <summary>
+	/// トランスフォームの階層のベンチマーク(関節のあるモデル1024体のうち、少しだけ動かす場合と全部動かす場合)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunTransformHierarchyBenchmarks(BenchmarkRunner& runner) {
+		const size_t kModelCount = 1024;
+		const size_t kJointCount = 32;
+		const size_t kMovingModelCount = 10;
+		const size_t kNodeCount = kModelCount * kJointCount;
+
+		//根から4本の腕を伸ばし、腕ごとに関節をつなげる
+		TransformHierarchy hierarchy;
+		std::vector<TransformHierarchy::NodeHandle> roots;
+		std::vector<TransformHierarchy::NodeHandle> nodes;
+		for (size_t model = 0; model < kModelCount; model++) {
+			const TransformHierarchy::NodeHandle root = hierarchy.CreateNode({}, { 1.0f,1.0f,1.0f }, { 0.0f,0.0f,0.0f },
+				{ static_cast<float>(model % 32) * 2.0f,0.0f,static_cast<float>(model / 32) * 2.0f });
+			roots.push_back(root);
+			nodes.push_back(root);
+			for (size_t arm = 0; arm < 4; arm++) {
+				TransformHierarchy::NodeHandle parent = root;
+				for (size_t joint = 1; joint < kJointCount / 4; joint++) {
+					parent = hierarchy.CreateNode(parent, { 1.0f,1.0f,1.0f }, { 0.0f,0.1f * static_cast<float>(arm),0.2f }, { 0.3f,0.0f,0.0f });
+					nodes.push_back(parent);
+				}
+			}
+		}
+		hierarchy.UpdateWorldMatrices();
+
+		float angle = 0.0f;
+		runner.Run("TransformHierarchy::UpdateWorldMatrices(10 models moved) x32768", kNodeCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				angle += 0.01f;
+				for (size_t model = 0; model < kMovingModelCount; model++) {
+					hierarchy.SetRotate(roots[model * (kModelCount / kMovingModelCount)], { 0.0f,angle,0.0f });
+				}
+				hierarchy.UpdateWorldMatrices();
+			}
+			DoNotOptimize(hierarchy.GetWorldMatrix(nodes.back()));
+			});
+
+		runner.Run("TransformHierarchy::UpdateWorldMatrices(all moved) x32768", kNodeCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				angle += 0.01f;
+				for (const TransformHierarchy::NodeHandle& root : roots) {
+					hierarchy.SetRotate(root, { 0.0f,angle,0.0f });
+				}
+				hierarchy.UpdateWorldMatrices();
+			}
+			DoNotOptimize(hierarchy.GetWorldMatrix(nodes.back()));
+			});
+
+		//階層を使わず、毎フレーム全部の行列をMakeAffineMatrixで作り直す場合
+		std::vector<Matrix4x4> worldMatrices(kNodeCount);
+		runner.Run("MakeAffineMatrix per node x32768", kNodeCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t n = 0; n < kNodeCount; n++) {
+					worldMatrices[n] = Rendering::MakeAffineMatrix(hierarchy.GetScale(nodes[n]), hierarchy.GetRotate(nodes[n]), hierarchy.GetTranslate(nodes[n]));
+				}
+			}
+			DoNotOptimize(worldMatrices.back());
+			});
+	}
+
+	/// <summary>
+	/// 1個ずつ確保して仮想関数で更新するオブジェクト(エンティティの比較用)
+	/// </summary>
+	class BenchmarkObject {
+	public://メンバ関数
+		/// <summary>
+		/// デストラクタ
+		/// </summary>
+		virtual ~BenchmarkObject() = default;
+
+		/// <summary>
+		/// 更新
+		/// </summary>
+		/// <param name="deltaTime">経過時間(秒)</param>
+		virtual void Update(float deltaTime) = 0;
+	};
+
+	/// <summary>
+	/// 速度で動くオブジェクト
+	/// </summary>
+	class BenchmarkMovingObject : public BenchmarkObject {
+	public://メンバ関数
+		/// <summary>
+		/// 更新
+		/// </summary>
+		/// <param name="deltaTime">経過時間(秒)</param>
+		void Update(float deltaTime) override {
+			transform.translate += physics.velocity * deltaTime;
+			transform.rotate += physics.angularVelocity * deltaTime;
+			transform.worldMatrix = Rendering::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+		}
+	public://メンバ変数
+		EntityManager::TransformComponent transform; //位置・姿勢・大きさ
+		EntityManager::PhysicsComponent physics; //動き
+		EntityManager::RenderComponent render; //描画
+	};
+
+	/// <summary>
+	/// エンティティのベンチマーク(10万個を移動させてワールド行列を作る。チャンクごとのクエリと、1個ずつの仮想関数との比較)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunEntityBenchmarks(BenchmarkRunner& runner) {
+		const size_t kEntityCount = 100000;
+		const float kDeltaTime = 1.0f / 60.0f;
+		std::mt19937 engine(1618);
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+		//動くものと止まっているもの、描画するものとしないものを混ぜる
+		EntityManager entityManager;
+		std::vector<std::unique_ptr<BenchmarkObject>> objects;
+		for (size_t i = 0; i < kEntityCount; i++) {
+			const Vector3 velocity = { distribution(engine),distribution(engine),distribution(engine) };
+			uint32_t componentMask = EntityManager::kTransform | EntityManager::kPhysics;
+			componentMask |= (i % 2 == 0) ? EntityManager::kRender : 0;
+			componentMask |= (i % 3 == 0) ? EntityManager::kBounds : 0;
+			const EntityManager::Entity entity = entityManager.CreateEntity(componentMask);
+			entityManager.GetPhysics(entity).velocity = velocity;
+			entityManager.CreateEntity(EntityManager::kTransform | EntityManager::kRender);
+
+			std::unique_ptr<BenchmarkMovingObject> object = std::make_unique<BenchmarkMovingObject>();
+			object->physics.velocity = velocity;
+			objects.push_back(std::move(object));
+		}
+		//作った順のままだとヒープ上でも並んでしまうので、実際のシーンのように散らばらせる
+		std::shuffle(objects.begin(), objects.end(), engine);
+
+		//位置を進めてワールド行列を作る
+		auto integrate = [kDeltaTime](const EntityManager::ChunkView& view) {
+			for (size_t i = 0; i < view.count; i++) {
+				EntityManager::TransformComponent& transform = view.transforms[i];
+				transform.translate += view.physics[i].velocity * kDeltaTime;
+				transform.rotate += view.physics[i].angularVelocity * kDeltaTime;
+				transform.worldMatrix = Rendering::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+			}
+			};
+
+		runner.Run("EntityManager::Query(transform,physics) x100000", kEntityCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				entityManager.Query(EntityManager::kTransform | EntityManager::kPhysics, integrate);
+			}
+			});
+
+		runner.Run("EntityManager::ParallelQuery(transform,physics) x100000", kEntityCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				entityManager.ParallelQuery(EntityManager::kTransform | EntityManager::kPhysics, integrate);
+			}
+			});
+
+		runner.Run("virtual Update per object x100000", kEntityCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (const std::unique_ptr<BenchmarkObject>& object : objects) {
+					object->Update(kDeltaTime);
+				}
+			}
+			DoNotOptimize(objects.front());
+			});
+	}
+
+	/// <summary>
+	/// アニメーションのベンチマーク(30トラックのクリップを2000体分。カーソルで順に再生する場合と毎回探す場合、量子化、2つのクリップの混合)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunAnimationBenchmarks(BenchmarkRunner& runner) {
+		const size_t kInstanceCount = 2000;
+		const size_t kTrackCount = 30;
+		const size_t kKeyCount = 120;
+		const float kDuration = 4.0f;
+		const float kDeltaTime = 1.0f / 60.0f;
+		std::mt19937 engine(4669);
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+		//30fpsでキーを打ったクリップを2つ作る
+		auto makeClip = [&]() {
+			AnimationClip clip;
+			for (size_t track = 0; track < kTrackCount; track++) {
+				AnimationClip::TrackDesc desc;
+				for (size_t key = 0; key < kKeyCount; key++) {
+					const float time = kDuration * static_cast<float>(key) / static_cast<float>(kKeyCount - 1);
+					desc.translateTimes.push_back(time);
+					desc.translates.push_back({ distribution(engine),distribution(engine),distribution(engine) });
+					desc.rotateTimes.push_back(time);
+					desc.rotates.push_back(Quaternion::MakeRotateXYZ({ distribution(engine),distribution(engine),distribution(engine) }));
+				}
+				clip.AddTrack(desc);
+			}
+			return clip;
+			};
+		AnimationClip walk = makeClip();
+		AnimationClip run = makeClip();
+
+		//インスタンスごとに再生位置をずらす
+		std::vector<float> times(kInstanceCount);
+		for (size_t i = 0; i < kInstanceCount; i++) {
+			times[i] = kDuration * static_cast<float>(i) / static_cast<float>(kInstanceCount);
+		}
+		std::vector<float> weights(kInstanceCount, 0.5f);
+		std::vector<uint32_t> walkCursors(kInstanceCount * walk.GetCursorCount(), 0);
+		std::vector<uint32_t> runCursors(kInstanceCount * run.GetCursorCount(), 0);
+		AnimationClip::PoseBuffer poses;
+		auto advance = [&]() {
+			for (float& time : times) {
+				time = walk.WrapTime(time + kDeltaTime);
+			}
+			};
+
+		runner.Run("AnimationClip::SampleBatch x2000x30", kInstanceCount * kTrackCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				advance();
+				walk.SampleBatch(times.data(), walkCursors.data(), kInstanceCount, poses);
+			}
+			DoNotOptimize(poses.rotate[3].back());
+			});
+
+		//カーソルを使わず、毎回キーを二分探索する場合
+		runner.Run("AnimationClip::SampleBatch(no cursor) x2000x30", kInstanceCount * kTrackCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				advance();
+				std::fill(walkCursors.begin(), walkCursors.end(), 0xFFFFFFFFu);
+				walk.SampleBatch(times.data(), walkCursors.data(), kInstanceCount, poses);
+			}
+			DoNotOptimize(poses.rotate[3].back());
+			});
+
+		runner.Run("AnimationClip::SampleBlendBatch x2000x30", kInstanceCount * kTrackCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				advance();
+				AnimationClip::SampleBlendBatch(walk, times.data(), walkCursors.data(), run, times.data(), runCursors.data(), weights.data(), kInstanceCount, poses);
+			}
+			DoNotOptimize(poses.rotate[3].back());
+			});
+
+		walk.Compress();
+		runner.Run("AnimationClip::SampleBatch(compressed) x2000x30", kInstanceCount * kTrackCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				advance();
+				walk.SampleBatch(times.data(), walkCursors.data(), kInstanceCount, poses);
+			}
+			DoNotOptimize(poses.rotate[3].back());
+			});
+	}
+
+	/// <summary>
+	/// スプラインのベンチマーク(道のりでの評価を表で引く場合と二分探索する場合、描画用の点と向きの取り出し)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunSplineBenchmarks(BenchmarkRunner& runner) {
+		const size_t kControlPointCount = 64;
+		const size_t kQueryCount = 100000;
+		const size_t kSampleCount = 2000;
+		std::mt19937 engine(1597);
+		std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+		std::vector<Vector3> controlPoints(kControlPointCount);
+		for (size_t i = 0; i < kControlPointCount; i++) {
+			controlPoints[i] = { distribution(engine),distribution(engine) * 0.5f,static_cast<float>(i) * 2.0f };
+		}
+		Spline spline;
+		spline.Initialize(Spline::Type::kCatmullRom, controlPoints);
+
+		//一定の速さで進めたときの道のり
+		std::vector<float> distances(kQueryCount);
+		for (size_t i = 0; i < kQueryCount; i++) {
+			distances[i] = spline.GetLength() * static_cast<float>(i) / static_cast<float>(kQueryCount);
+		}
+
+		runner.Run("Spline::EvaluateByDistance x100000", kQueryCount, [&](uint64_t iterations) {
+			Vector3 sum = {};
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (float distance : distances) {
+					sum += spline.EvaluateByDistance(distance);
+				}
+			}
+			DoNotOptimize(sum);
+			});
+
+		//媒介変数ごとの道のりの表を毎回二分探索する場合
+		const size_t kTableSize = spline.GetSegmentCount() * Spline::kTableResolution;
+		std::vector<float> cumulative(kTableSize + 1, 0.0f);
+		for (size_t i = 1; i <= kTableSize; i++) {
+			const Vector3 delta = spline.Evaluate(static_cast<float>(i) / static_cast<float>(Spline::kTableResolution)) -
+				spline.Evaluate(static_cast<float>(i - 1) / static_cast<float>(Spline::kTableResolution));
+			cumulative[i] = cumulative[i - 1] + std::sqrt(delta.Dot(delta));
+		}
+		runner.Run("Spline evaluate by binary search x100000", kQueryCount, [&](uint64_t iterations) {
+			Vector3 sum = {};
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (float distance : distances) {
+					const size_t upper = static_cast<size_t>(std::upper_bound(cumulative.begin(), cumulative.end(), distance) - cumulative.begin());
+					const size_t index = std::clamp(upper, static_cast<size_t>(1), kTableSize) - 1;
+					const float length = cumulative[index + 1] - cumulative[index];
+					const float fraction = length > 0.0f ? (distance - cumulative[index]) / length : 0.0f;
+					sum += spline.Evaluate((static_cast<float>(index) + fraction) / static_cast<float>(Spline::kTableResolution));
+				}
+			}
+			DoNotOptimize(sum);
+			});
+
+		//等間隔の点を取って折れ線で描く
+		Camera camera;
+		camera.Initialize(1280.0f, 720.0f);
+		camera.SetTranslate({ 0.0f,20.0f,-40.0f });
+		camera.SetRotate({ 0.4f,0.0f,0.0f });
+		camera.Update();
+		const Matrix4x4 viewProjectionMatrix = camera.GetViewProjectionMatrix();
+		const Matrix4x4 viewportMatrix = camera.GetViewportMatrix();
+		std::vector<Vector3> points(kSampleCount);
+		runner.Run("Spline::SamplePoints+DrawPolyline x2000", kSampleCount, [&](uint64_t iterations) {
+			NullDrawBackend backend;
+			for (uint64_t i = 0; i < iterations; i++) {
+				spline.SamplePoints(points);
+				Primitive::DrawPolyline(points, 0xFFFFFFFF, viewProjectionMatrix, viewportMatrix, backend);
+			}
+			DoNotOptimize(backend.GetChecksum());
+			});
+
+		std::vector<Spline::Frame> frames(kSampleCount);
+		runner.Run("Spline::MakeFrames(parallel transport) x2000", kSampleCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				spline.MakeFrames(frames, Spline::FrameMode::kParallelTransport);
+			}
+			DoNotOptimize(frames.back().normal);
+			});
+	}
+
+	/// <summary>
+	/// デバッグ表示のベンチマーク(行列300個。値が変わらずキャッシュから出す場合と毎フレーム変わる場合、要素ごとのsnprintf)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunDebugTextBenchmarks(BenchmarkRunner& runner) {
+		const size_t kMatrixCount = 300;
+		std::mt19937 engine(2718);
+		std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+		std::vector<Matrix4x4> matrices(kMatrixCount);
+		for (Matrix4x4& matrix : matrices) {
+			for (auto& row : matrix.m) {
+				for (float& value : row) {
+					value = distribution(engine);
+				}
+			}
+		}
+		std::vector<const char*> labels(kMatrixCount, "matrix");
+		DebugText debugText;
+
+		runner.Run("DebugText::AddMatrixTable(cached) x300", kMatrixCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				debugText.BeginFrame();
+				debugText.AddMatrixTable(0, 0, matrices, labels, 4);
+			}
+			DoNotOptimize(debugText.GetLines().back());
+			});
+
+		//毎フレーム値が変わり、すべて書式化し直す場合
+		runner.Run("DebugText::AddMatrixTable(changing) x300", kMatrixCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				matrices[0].m[3][3] += 1.0f;
+				for (Matrix4x4& matrix : matrices) {
+					matrix.m[3][3] = matrices[0].m[3][3];
+				}
+				debugText.BeginFrame();
+				debugText.AddMatrixTable(0, 0, matrices, labels, 4);
+			}
+			DoNotOptimize(debugText.GetLines().back());
+			});
+
+		//以前のScreenPrintfと同じく、要素ごとに"%6.02f"で書式化する場合
+		runner.Run("snprintf per element x300", kMatrixCount, [&](uint64_t iterations) {
+			char buffer[32];
+			uint32_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (const Matrix4x4& matrix : matrices) {
+					checksum += static_cast<uint32_t>(std::snprintf(buffer, sizeof(buffer), "%s", labels[0]));
+					for (int row = 0; row < 4; row++) {
+						for (int column = 0; column < 4; column++) {
+							checksum += static_cast<uint32_t>(std::snprintf(buffer, sizeof(buffer), "%6.02f", matrix.m[row][column]));
+						}
+					}
+				}
+			}
+			DoNotOptimize(checksum);
+			});
+	}
+
+	/// <summary>
+	/// 入力のベンチマーク(256キーの押した瞬間の判定をビット列で行う場合と1バイトずつの場合、待ち行列の受け渡し)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunInputBenchmarks(BenchmarkRunner& runner) {
+		const size_t kFrameCount = 1024;
+		std::mt19937 engine(1123);
+		//フレームごとのNovice::GetHitKeyStateAllの結果(押しているキーは数個)
+		std::vector<char> frames(kFrameCount * KeyBitset::kKeyCount, 0);
+		for (size_t frame = 0; frame < kFrameCount; frame++) {
+			for (int i = 0; i < 4; i++) {
+				frames[frame * KeyBitset::kKeyCount + engine() % KeyBitset::kKeyCount] = static_cast<char>(0x80);
+			}
+		}
+
+		//測る前に、ビット列で求めた状態と押した・離したキーが1バイトずつ比べた結果と同じか確かめる
+		{
+			KeyBitset previous;
+			KeyBitset pressed;
+			KeyBitset released;
+			const char* preKeys = nullptr;
+			bool isSame = true;
+			for (size_t frame = 0; frame < kFrameCount && isSame; frame++) {
+				const char* keys = frames.data() + frame * KeyBitset::kKeyCount;
+				const KeyBitset current = KeyBitset::FromKeyArray(keys);
+				KeyBitset::DetectEdges(previous, current, pressed, released);
+				for (size_t key = 0; key < KeyBitset::kKeyCount; key++) {
+					const bool isPressing = keys[key] != 0;
+					const bool wasPressing = preKeys != nullptr && preKeys[key] != 0;
+					isSame &= current.Test(key) == isPressing &&
+						pressed.Test(key) == (isPressing && !wasPressing) && released.Test(key) == (!isPressing && wasPressing);
+				}
+				previous = current;
+				preKeys = keys;
+			}
+			if (!isSame) {
+				std::cerr << "KeyBitset edge mismatch" << std::endl;
+			}
+		}
+
+		runner.Run("KeyBitset::FromKeyArray+DetectEdges x1024", kFrameCount, [&](uint64_t iterations) {
+			KeyBitset previous;
+			KeyBitset pressed;
+			KeyBitset released;
+			uint64_t pressedCount = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t frame = 0; frame < kFrameCount; frame++) {
+					const KeyBitset current = KeyBitset::FromKeyArray(frames.data() + frame * KeyBitset::kKeyCount);
+					KeyBitset::DetectEdges(previous, current, pressed, released);
+					pressedCount += pressed.Any();
+					previous = current;
+				}
+			}
+			DoNotOptimize(pressedCount);
+			});
+
+		//以前のInputと同じく、256バイトの配列を2つ持ってキーごとに比べる場合
+		runner.Run("char[256] memcpy+per-key compare x1024", kFrameCount, [&](uint64_t iterations) {
+			char keys[KeyBitset::kKeyCount] = {};
+			char preKeys[KeyBitset::kKeyCount] = {};
+			uint64_t pressedCount = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t frame = 0; frame < kFrameCount; frame++) {
+					std::memcpy(preKeys, keys, sizeof(keys));
+					std::memcpy(keys, frames.data() + frame * KeyBitset::kKeyCount, sizeof(keys));
+					bool isAnyPressed = false;
+					for (size_t key = 0; key < KeyBitset::kKeyCount; key++) {
+						isAnyPressed |= keys[key] != 0 && preKeys[key] == 0;
+					}
+					pressedCount += isAnyPressed;
+				}
+			}
+			DoNotOptimize(pressedCount);
+			});
+
+		InputEventQueue queue;
+		runner.Run("InputEventQueue Push+Pop x1024", kFrameCount, [&](uint64_t iterations) {
+			uint64_t sum = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (size_t event = 0; event < kFrameCount; event++) {
+					queue.Push({ .timestamp = event,.key = static_cast<uint32_t>(event % KeyBitset::kKeyCount),.isPressed = true });
+				}
+				InputEvent event;
+				while (queue.Pop(event)) {
+					sum += event.key;
+				}
+			}
+			DoNotOptimize(sum);
+			});
+	}
+	/// <summary>
+	/// 描画命令の記録・再生のベンチマーク(main.cppと同じグリッドと球と文字列を1フレームとする)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunDrawCaptureBenchmarks(BenchmarkRunner& runner) {
+		const char* const kRecordName = "DrawCapture record frame";
+		const char* const kReplayName = "DrawCaptureReader::Replay frame";
+		if (!runner.IsSelected(kRecordName) && !runner.IsSelected(kReplayName)) {
+			return;
+		}
+		Camera camera;
+		camera.Initialize(1280.0f, 720.0f);
+		camera.SetRotate({ 0.26f,0.0f,0.0f });
+		camera.SetTranslate({ 0.0f,1.9f,-6.49f });
+		camera.Update();
+		const Matrix4x4 viewProjectionMatrix = camera.GetViewProjectionMatrix();
+		const Matrix4x4 viewportMatrix = camera.GetViewportMatrix();
+		const SphereData sphereData = { .center{},.radius = 1.0f };
+		auto drawFrame = [&](DrawBackend& backend) {
+			Primitive::DrawGrid(viewProjectionMatrix, viewportMatrix, backend);
+			Primitive::DrawSphere(sphereData, viewProjectionMatrix, viewportMatrix, backend);
+			backend.DrawString(0, 660, "transform:1234 mul:56 inv:7");
+			backend.DrawString(0, 680, "line:452 tri:0 length:123456px");
+			backend.DrawString(0, 700, "culled:0 clipped:12 printf:15");
+		};
+
+		NullDrawBackend directBackend;
+		drawFrame(directBackend);
+		const uint64_t commandCount = directBackend.GetLineCount() + directBackend.GetTriangleCount() + directBackend.GetStringCount();
+		const std::string filePath = (std::filesystem::temp_directory_path() / "mt_study_bench_capture.bin").string();
+
+		runner.Run(kRecordName, commandCount, [&](uint64_t iterations) {
+			NullDrawBackend backend;
+			DrawCapture capture(backend);
+			capture.Start(filePath.c_str());
+			for (uint64_t i = 0; i < iterations; i++) {
+				capture.BeginFrame(camera);
+				drawFrame(capture);
+				capture.EndFrame();
+			}
+			capture.Stop();
+			DoNotOptimize(backend.GetChecksum());
+			});
+
+		if (!runner.IsSelected(kReplayName)) {
+			std::filesystem::remove(filePath);
+			return;
+		}
+
+		//再生用に決まった数のフレームを記録し、描画したものと同じになるか確かめる
+		const size_t kFrameCount = 64;
+		{
+			NullDrawBackend backend;
+			DrawCapture capture(backend);
+			capture.Start(filePath.c_str());
+			for (size_t i = 0; i < kFrameCount; i++) {
+				capture.BeginFrame(camera);
+				drawFrame(capture);
+				capture.EndFrame();
+			}
+			capture.Stop();
+			std::cout << "  capture: " << capture.GetByteCount() / kFrameCount << " bytes/frame, "
+				<< commandCount << " commands/frame" << std::endl;
+		}
+		DrawCaptureReader reader;
+		if (!reader.Open(filePath.c_str()) || reader.GetFrameCount() != kFrameCount) {
+			std::cerr << "failed to read " << filePath << std::endl;
+			return;
+		}
+		NullDrawBackend replayBackend;
+		reader.Replay(0, replayBackend);
+		if (replayBackend.GetChecksum() != directBackend.GetChecksum()) {
+			std::cerr << "DrawCaptureReader::Replay mismatch" << std::endl;
+		}
+
+		runner.Run(kReplayName, commandCount, [&](uint64_t iterations) {
+			NullDrawBackend backend;
+			for (uint64_t i = 0; i < iterations; i++) {
+				reader.Replay(i % kFrameCount, backend);
+			}
+			DoNotOptimize(backend.GetChecksum());
+			});
+
+		reader.Close();
+		std::filesystem::remove(filePath);
+	}
+	/// <summary>
+	/// OBJの読み込みのベンチマーク(UV球をOBJに書き出して読む)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunObjLoaderBenchmarks(BenchmarkRunner& runner) {
+		const char* const kLoadObjName = "ObjLoader::LoadObj sphere";
+		const char* const kLoadCacheName = "ObjLoader::LoadCache sphere";
+		if (!runner.IsSelected(kLoadObjName) && !runner.IsSelected(kLoadCacheName)) {
+			return;
+		}
+		//経度・緯度の分割数(四角形の面で書き、半分ずつ別のマテリアルにする)
+		const int kSegmentCount = 256;
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		const std::string objPath = (directory / "mt_study_bench_sphere.obj").string();
+		const std::string mtlPath = (directory / "mt_study_bench_sphere.mtl").string();
+		const std::string cachePath = objPath + ObjLoader::kCacheExtension;
+		{
+			std::ofstream mtl(mtlPath, std::ios::out | std::ios::trunc);
+			mtl << "newmtl Red\nKd 0.8 0.1 0.1\nnewmtl Blue\nKd 0.1 0.1 0.8\nmap_Kd blue.png\n";
+			std::ofstream obj(objPath, std::ios::out | std::ios::trunc);
+			obj << "mtllib mt_study_bench_sphere.mtl\no Sphere\n";
+			char line[128];
+			const float kPi = 3.14159265f;
+			for (int lat = 0; lat <= kSegmentCount; lat++) {
+				for (int lon = 0; lon <= kSegmentCount; lon++) {
+					const float theta = kPi * static_cast<float>(lat) / kSegmentCount;
+					const float phi = 2.0f * kPi * static_cast<float>(lon) / kSegmentCount;
+					const Vector3 normal = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+					std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n",
+						normal.x, normal.y, normal.z, static_cast<float>(lon) / kSegmentCount, static_cast<float>(lat) / kSegmentCount,
+						normal.x, normal.y, normal.z);
+					obj << line;
+				}
+			}
+			for (int lat = 0; lat < kSegmentCount; lat++) {
+				if (lat == 0 || lat == kSegmentCount / 2) {
+					obj << (lat == 0 ? "usemtl Red\n" : "usemtl Blue\n");
+				}
+				for (int lon = 0; lon < kSegmentCount; lon++) {
+					const int v0 = lat * (kSegmentCount + 1) + lon + 1;
+					const int v1 = v0 + kSegmentCount + 1;
+					std::snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n",
+						v0, v0, v0, v1, v1, v1, v1 + 1, v1 + 1, v1 + 1, v0 + 1, v0 + 1, v0 + 1);
+					obj << line;
+				}
+			}
+		}
+		const uint64_t triangleCount = static_cast<uint64_t>(kSegmentCount) * kSegmentCount * 2;
+
+		ObjLoader::Mesh mesh;
+		if (!ObjLoader::LoadObj(objPath.c_str(), mesh) || mesh.indices.size() != triangleCount * 3 || mesh.subMeshes.size() != 2) {
+			std::cerr << "failed to load " << objPath << std::endl;
+			return;
+		}
+		std::cout << "  obj: " << std::filesystem::file_size(objPath) / 1024 << " KiB, " << mesh.vertices.size() << " vertices, "
+			<< triangleCount << " triangles" << std::endl;
+
+		runner.Run(kLoadObjName, triangleCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				ObjLoader::LoadObj(objPath.c_str(), mesh);
+				DoNotOptimize(mesh.indices.data());
+			}
+			});
+
+		ObjLoader::WriteCache(cachePath.c_str(), objPath.c_str(), mesh);
+		runner.Run(kLoadCacheName, triangleCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				ObjLoader::LoadCache(cachePath.c_str(), objPath.c_str(), mesh);
+				DoNotOptimize(mesh.indices.data());
+			}
+			});
+
+		std::filesystem::remove(objPath);
+		std::filesystem::remove(mtlPath);
+		std::filesystem::remove(cachePath);
+	}
+	/// <summary>
+	/// アセットをまとめたファイルのベンチマーク(ばらばらのファイルを1つずつ開く場合との比較)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunAssetArchiveBenchmarks(BenchmarkRunner& runner) {
+		const char* const kCompressName = "Lz4::Compress shader";
+		const char* const kDecompressName = "Lz4::Decompress shader";
+		const char* const kOpenGetName = "AssetArchive Open+Get x256";
+		const char* const kFindName = "AssetArchive::Find x256";
+		const char* const kLooseName = "ifstream loose files x256";
+		const bool isLz4Selected = runner.IsSelected(kCompressName) || runner.IsSelected(kDecompressName);
+		const bool isArchiveSelected = runner.IsSelected(kOpenGetName) || runner.IsSelected(kFindName) || runner.IsSelected(kLooseName);
+		if (!isLz4Selected && !isArchiveSelected) {
+			return;
+		}
+
+		//シェーダーのような文字列のファイルの中身を作る
+		const size_t kFileCount = 256;
+		std::vector<std::string> paths;
+		std::vector<std::string> contents;
+		std::mt19937 engine(46);
+		for (size_t i = 0; i < kFileCount; i++) {
+			std::string content;
+			for (int line = 0; line < 128; line++) {
+				content += "float4 value" + std::to_string(engine() % 64) + " = mul(gTransformationMatrix, input.position" + std::to_string(engine() % 8) + ");\n";
+			}
+			paths.push_back("shaders/Shader" + std::to_string(i) + ".hlsl");
+			contents.push_back(std::move(content));
+		}
+
+		if (isLz4Selected) {
+			const std::vector<uint8_t> source(contents[0].begin(), contents[0].end());
+			std::vector<uint8_t> compressed(Lz4::GetMaxCompressedSize(source.size()));
+			const size_t compressedSize = Lz4::Compress(source.data(), source.size(), compressed.data());
+			std::vector<uint8_t> decompressed(source.size());
+			if (!Lz4::Decompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size()) || decompressed != source) {
+				std::cerr << "Lz4 round trip mismatch" << std::endl;
+			}
+			std::cout << "  lz4: " << source.size() << " -> " << compressedSize << " bytes" << std::endl;
+
+			runner.Run(kCompressName, source.size(), [&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; i++) {
+					DoNotOptimize(Lz4::Compress(source.data(), source.size(), compressed.data()));
+				}
+				});
+
+			runner.Run(kDecompressName, source.size(), [&](uint64_t iterations) {
+				for (uint64_t i = 0; i < iterations; i++) {
+					DoNotOptimize(Lz4::Decompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size()));
+				}
+				});
+		}
+		if (!isArchiveSelected) {
+			return;
+		}
+
+		//ばらばらのファイルとして書き出し、まとめたファイルを作る
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "mt_study_bench_assets";
+		const std::string archivePath = (std::filesystem::temp_directory_path() / "mt_study_bench_assets.pak").string();
+		std::filesystem::create_directories(directory / "shaders");
+		for (size_t i = 0; i < kFileCount; i++) {
+			std::ofstream file(directory / paths[i], std::ios::out | std::ios::binary | std::ios::trunc);
+			file << contents[i];
+		}
+		if (!AssetArchive::Pack(archivePath.c_str(), { .rootDirectory = directory.string(),.alignment = 64,.isCompressionEnabled = true })) {
+			std::cerr << "failed to pack " << directory << std::endl;
+			return;
+		}
+
+		//開いた直後(展開していない状態)から全ファイルを取り出す
+		runner.Run(kOpenGetName, kFileCount, [&](uint64_t iterations) {
+			uint64_t total = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				AssetArchive archive;
+				archive.Open(archivePath.c_str());
+				for (const std::string& path : paths) {
+					total += archive.Get(path).size();
+				}
+			}
+			DoNotOptimize(total);
+			});
+
+		AssetArchive archive;
+		archive.Open(archivePath.c_str());
+		runner.Run(kFindName, kFileCount, [&](uint64_t iterations) {
+			uint64_t total = 0;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (const std::string& path : paths) {
+					total += archive.Find(path);
+				}
+			}
+			DoNotOptimize(total);
+			});
+		archive.Close();
+
+		//ばらばらのファイルを1つずつ開いて読む場合
+		runner.Run(kLooseName, kFileCount, [&](uint64_t iterations) {
+			uint64_t total = 0;
+			std::vector<char> content;
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (const std::string& path : paths) {
+					std::ifstream file(directory / path, std::ios::in | std::ios::binary);
+					content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+					total += content.size();
+				}
+			}
+			DoNotOptimize(total);
+			});
+
+		std::filesystem::remove_all(directory);
+		std::filesystem::remove(archivePath);
+	}
+	/// <summary>
+	/// フレーム用の確保のベンチマーク(1フレームの一時的なリストと表をヒープで作る場合との比較)
+	/// </summary>
+	/// <param name="runner">実行</param>
+	void RunFrameAllocatorBenchmarks(BenchmarkRunner& runner) {
+		const size_t kVertexCount = 1024;
+		const uint32_t kEntityCount = 256;
+		struct TransientObject {
+			Vector3 position;
+			Vector3 velocity;
+			uint32_t id;
+		};
+
+		runner.Run("Frame transient std::vector+unordered_map", kVertexCount + kEntityCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				std::vector<Vector3> vertices;
+				for (size_t v = 0; v < kVertexCount; v++) {
+					vertices.push_back({ static_cast<float>(v), static_cast<float>(i), 0.0f });
+				}
+				std::unordered_map<uint32_t, uint32_t> slots;
+				for (uint32_t e = 0; e < kEntityCount; e++) {
+					slots[e * 7919u] = e;
+				}
+				DoNotOptimize(vertices.data());
+				DoNotOptimize(slots.size());
+			}
+			});
+
+		FrameAllocator* frameAllocator = FrameAllocator::GetInstance();
+		runner.Run("Frame transient FrameVector+FrameHashMap", kVertexCount + kEntityCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				{
+					FrameArena& arena = frameAllocator->GetThreadArena();
+					FrameVector<Vector3> vertices{ ArenaAllocator<Vector3>(arena) };
+					for (size_t v = 0; v < kVertexCount; v++) {
+						vertices.push_back({ static_cast<float>(v), static_cast<float>(i), 0.0f });
+					}
+					FrameHashMap<uint32_t, uint32_t> slots{ ArenaAllocator<std::pair<uint32_t, uint32_t>>(arena) };
+					for (uint32_t e = 0; e < kEntityCount; e++) {
+						slots[e * 7919u] = e;
+					}
+					DoNotOptimize(vertices.data());
+					DoNotOptimize(slots.GetSize());
+				}
+				frameAllocator->EndFrame();
+			}
+			});
+
+		runner.Run("Objects new/delete x256", kEntityCount, [&](uint64_t iterations) {
+			std::vector<TransientObject*> objects(kEntityCount);
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (uint32_t e = 0; e < kEntityCount; e++) {
+					objects[e] = new TransientObject{ .position = {},.velocity = {},.id = e };
+				}
+				DoNotOptimize(objects.data());
+				for (TransientObject* object : objects) {
+					delete object;
+				}
+			}
+			});
+
+		ObjectPool<TransientObject> pool;
+		pool.Reserve(kEntityCount);
+		runner.Run("Objects ObjectPool x256", kEntityCount, [&](uint64_t iterations) {
+			std::vector<TransientObject*> objects(kEntityCount);
+			for (uint64_t i = 0; i < iterations; i++) {
+				for (uint32_t e = 0; e < kEntityCount; e++) {
+					objects[e] = pool.Create(TransientObject{ .position = {},.velocity = {},.id = e });
+				}
+				DoNotOptimize(objects.data());
+				for (TransientObject* object : objects) {
+					pool.Destroy(object);
+				}
+			}
+			});
+	}
+	void RunBoundingVolumeBenchmarks(BenchmarkRunner& runner) {
+		const size_t kPointCount = 1 << 20;
+		const size_t kMinimumSpherePointCount = 1 << 14;
+		std::mt19937 engine(24680);
+		std::normal_distribution<float> distribution(0.0f, 1.0f);
+		std::vector<Vector3> points(kPointCount);
+		for (Vector3& point : points) {
+			point = { distribution(engine) * 4.0f + 1.0f, distribution(engine) - 2.0f, distribution(engine) * 2.0f };
+		}
+
+		runner.Run("AABB 1M points scalar", kPointCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				AABB aabb = { points[0], points[0] };
+				for (const Vector3& point : points) {
+					aabb.min = { std::min(aabb.min.x, point.x), std::min(aabb.min.y, point.y), std::min(aabb.min.z, point.z) };
+					aabb.max = { std::max(aabb.max.x, point.x), std::max(aabb.max.y, point.y), std::max(aabb.max.z, point.z) };
+				}
+				DoNotOptimize(aabb);
+			}
+			});
+
+		runner.Run("AABB 1M points BoundingVolume", kPointCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				AABB aabb = BoundingVolume::ComputeAABB(points);
+				DoNotOptimize(aabb);
+			}
+			});
+
+		runner.Run("Sphere 1M points Ritter", kPointCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				SphereData sphere = BoundingVolume::ComputeSphere(points);
+				DoNotOptimize(sphere);
+			}
+			});
+
+		runner.Run("Sphere 16K points Welzl", kMinimumSpherePointCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				SphereData sphere = BoundingVolume::ComputeMinimumSphere(std::span<const Vector3>(points.data(), kMinimumSpherePointCount));
+				DoNotOptimize(sphere);
+			}
+			});
+
+		runner.Run("OBB 1M points PCA", kPointCount, [&](uint64_t iterations) {
+			for (uint64_t i = 0; i < iterations; i++) {
+				OBB obb = BoundingVolume::ComputeOBB(points);
+				DoNotOptimize(obb);
+			}
+			});
+	}
+}
+
+int main(int argc, char** argv) {
+	std::string jsonPath;
+	std::string filter;
+	std::string label;
+	double minTimeMs = 200.0;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--json" && i + 1 < argc) {
+			jsonPath = argv[++i];
+		} else if (arg == "--filter" && i + 1 < argc) {
+			filter = argv[++i];
+		} else if (arg == "--min-time-ms" && i + 1 < argc) {
+			minTimeMs = std::atof(argv[++i]);
+		} else if (arg == "--label" && i + 1 < argc) {
+			label = argv[++i];
+		} else {
+			std::cerr << "usage: " << argv[0] << " [--json path] [--filter name] [--min-time-ms ms] [--label label]" << std::endl;
+			return 1;
+		}
+	}
+
+	BenchmarkRunner runner(minTimeMs, filter);
+	BenchmarkInput input = MakeInput();
+	RunMathBenchmarks(runner, input);
+	RunPrimitiveBenchmarks(runner);
+	RunCollisionBenchmarks(runner);
+	RunBroadPhaseBenchmarks(runner);
+	RunNeighborBenchmarks(runner);
+	RunGjkBenchmarks(runner);
+	RunContinuousBenchmarks(runner);
+	RunPickingBenchmarks(runner);
+	RunRigidBodyBenchmarks(runner);
+	RunContactBenchmarks(runner);
+	RunParticleBenchmarks(runner);
+	RunTransformHierarchyBenchmarks(runner);
+	RunEntityBenchmarks(runner);
+	RunAnimationBenchmarks(runner);
+	RunSplineBenchmarks(runner);
+	RunDebugTextBenchmarks(runner);
+	RunInputBenchmarks(runner);
+	RunDrawCaptureBenchmarks(runner);
+	RunObjLoaderBenchmarks(runner);
+	RunAssetArchiveBenchmarks(runner);
+	RunFrameAllocatorBenchmarks(runner);
+	RunBoundingVolumeBenchmarks(runner);
+	JobSystem::GetInstance()->Finalize();
+	FrameAllocator::GetInstance()->Finalize();
+
+	if (!jsonPath.empty() && !runner.WriteJson(jsonPath.c_str(), label)) {
+		std::cerr << "failed to write " << jsonPath << std::endl;
+		return 1;
+	}
+	return 0;
+}
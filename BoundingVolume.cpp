@@ -0,0 +1,686 @@
+#include "BoundingVolume.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace {
+	static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3はfloatを3つ隙間なく並べる");
+
+	//まとめて処理する点の数(24個のfloatでx,y,zの並びがそろう)
+	const size_t kBlockPoints = 8;
+	//まとめて処理するfloatの数
+	const size_t kBlockFloats = kBlockPoints * 3;
+	//Welzlの方法で内側とみなす半径の比(丸め誤差で同じ点を外側と判定し続けないように)
+	const double kContainEpsilon = 1.0e-6;
+	//ヤコビ法の最大の反復回数
+	const int kMaxJacobiSweeps = 16;
+	//積の和をfloatで足してからdoubleへ移すまでのブロック数
+	const size_t kMomentFlushBlocks = 32;
+
+	/// <summary>
+	/// 倍精度の3次元ベクトル(Welzlの方法とOBBの主成分の計算用)
+	/// </summary>
+	struct Double3 {
+		double x;
+		double y;
+		double z;
+
+		Double3 operator+(const Double3& v) const { return { x + v.x, y + v.y, z + v.z }; }
+		Double3 operator-(const Double3& v) const { return { x - v.x, y - v.y, z - v.z }; }
+		Double3 operator*(double s) const { return { x * s, y * s, z * s }; }
+		double Dot(const Double3& v) const { return x * v.x + y * v.y + z * v.z; }
+		Double3 Cross(const Double3& v) const { return { y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x }; }
+	};
+
+	/// <summary>
+	/// 倍精度の球
+	/// </summary>
+	struct DoubleSphere {
+		Double3 center;
+		double radius;
+
+		/// <summary>
+		/// 点を含むか(丸め誤差の分だけ広く見る)
+		/// </summary>
+		bool Contains(const Double3& point) const {
+			const Double3 diff = point - center;
+			const double limit = radius * (1.0 + kContainEpsilon);
+			return diff.Dot(diff) <= limit * limit;
+		}
+	};
+
+	/// <summary>
+	/// 区間に分けて順番か並列に処理する
+	/// </summary>
+	template<class Function>
+	void ForEachRange(size_t count, bool isParallel, Function function) {
+		if (!isParallel || count < BoundingVolume::kMinBatchSize * 2) {
+			function(0, count);
+			return;
+		}
+		JobSystem::GetInstance()->ParallelFor(count, BoundingVolume::kMinBatchSize, function);
+	}
+
+	/// <summary>
+	/// [begin, end)の点の最小・最大をminとmaxに足し込む
+	/// </summary>
+	/// <param name="values">点(x,y,zの順に並んだfloat)</param>
+	void AccumulateAABB(const float* values, size_t begin, size_t end, float min[3], float max[3]) {
+		//成分の並びがそろった24本の最小・最大を分岐なしで取る
+		float blockMin[kBlockFloats];
+		float blockMax[kBlockFloats];
+		for (size_t j = 0; j < kBlockFloats; j++) {
+			blockMin[j] = min[j % 3];
+			blockMax[j] = max[j % 3];
+		}
+		size_t i = begin;
+		for (; i + kBlockPoints <= end; i += kBlockPoints) {
+			const float* block = values + i * 3;
+			for (size_t j = 0; j < kBlockFloats; j++) {
+				blockMin[j] = block[j] < blockMin[j] ? block[j] : blockMin[j];
+				blockMax[j] = block[j] > blockMax[j] ? block[j] : blockMax[j];
+			}
+		}
+		for (; i < end; i++) {
+			for (size_t j = 0; j < 3; j++) {
+				const float value = values[i * 3 + j];
+				blockMin[j] = value < blockMin[j] ? value : blockMin[j];
+				blockMax[j] = value > blockMax[j] ? value : blockMax[j];
+			}
+		}
+		for (size_t j = 0; j < kBlockFloats; j++) {
+			min[j % 3] = blockMin[j] < min[j % 3] ? blockMin[j] : min[j % 3];
+			max[j % 3] = blockMax[j] > max[j % 3] ? blockMax[j] : max[j % 3];
+		}
+	}
+
+	/// <summary>
+	/// 点が外側にあれば球を広げる(Ritterの方法)
+	/// </summary>
+	inline void GrowSphere(SphereData& sphere, const float* point) {
+		const float dx = point[0] - sphere.center.x;
+		const float dy = point[1] - sphere.center.y;
+		const float dz = point[2] - sphere.center.z;
+		const float distanceSquared = dx * dx + dy * dy + dz * dz;
+		if (distanceSquared <= sphere.radius * sphere.radius) {
+			return;
+		}
+		//反対側の端を残したまま点に届くように、中心を点の方へずらす
+		const float distance = std::sqrt(distanceSquared);
+		const float radius = (sphere.radius + distance) * 0.5f;
+		const float t = (radius - sphere.radius) / distance;
+		sphere.center.x += dx * t;
+		sphere.center.y += dy * t;
+		sphere.center.z += dz * t;
+		sphere.radius = radius;
+	}
+
+	/// <summary>
+	/// [begin, end)の点が入るように球を広げる
+	/// </summary>
+	void GrowSphereRange(const float* values, size_t begin, size_t end, SphereData& sphere) {
+		size_t i = begin;
+		for (; i + kBlockPoints <= end; i += kBlockPoints) {
+			//8点の距離の2乗の最大を分岐なしで求め、すべて内側なら飛ばす(広げるのは最初のうちだけ)
+			const float* block = values + i * 3;
+			float maxDistanceSquared = 0.0f;
+			for (size_t j = 0; j < kBlockPoints; j++) {
+				const float dx = block[j * 3 + 0] - sphere.center.x;
+				const float dy = block[j * 3 + 1] - sphere.center.y;
+				const float dz = block[j * 3 + 2] - sphere.center.z;
+				const float distanceSquared = dx * dx + dy * dy + dz * dz;
+				maxDistanceSquared = distanceSquared > maxDistanceSquared ? distanceSquared : maxDistanceSquared;
+			}
+			if (maxDistanceSquared <= sphere.radius * sphere.radius) {
+				continue;
+			}
+			for (size_t j = 0; j < kBlockPoints; j++) {
+				GrowSphere(sphere, block + j * 3);
+			}
+		}
+		for (; i < end; i++) {
+			GrowSphere(sphere, values + i * 3);
+		}
+	}
+
+	/// <summary>
+	/// [begin, end)で各軸の最小・最大の点を探す
+	/// </summary>
+	/// <param name="minIndex">軸ごとに最小の点の番号</param>
+	/// <param name="maxIndex">軸ごとに最大の点の番号</param>
+	void FindExtremes(const float* values, size_t begin, size_t end, size_t minIndex[3], size_t maxIndex[3]) {
+		//24本のレーンごとに最小・最大の値と、それが何番目のブロックかを分岐なしで覚える
+		const size_t blockCount = (end - begin) / kBlockPoints;
+		assert(blockCount <= UINT32_MAX);
+		float laneMin[kBlockFloats];
+		float laneMax[kBlockFloats];
+		uint32_t laneMinBlock[kBlockFloats] = {};
+		uint32_t laneMaxBlock[kBlockFloats] = {};
+		const float* first = values + begin * 3;
+		for (size_t j = 0; j < kBlockFloats; j++) {
+			laneMin[j] = blockCount > 0 ? first[j] : first[j % 3];
+			laneMax[j] = laneMin[j];
+		}
+		for (uint32_t block = 1; block < blockCount; block++) {
+			const float* points = first + static_cast<size_t>(block) * kBlockFloats;
+			for (size_t j = 0; j < kBlockFloats; j++) {
+				const bool isMin = points[j] < laneMin[j];
+				const bool isMax = points[j] > laneMax[j];
+				laneMin[j] = isMin ? points[j] : laneMin[j];
+				laneMinBlock[j] = isMin ? block : laneMinBlock[j];
+				laneMax[j] = isMax ? points[j] : laneMax[j];
+				laneMaxBlock[j] = isMax ? block : laneMaxBlock[j];
+			}
+		}
+
+		//レーンと余りの点から選ぶ
+		for (size_t axis = 0; axis < 3; axis++) {
+			minIndex[axis] = begin;
+			maxIndex[axis] = begin;
+		}
+		for (size_t j = 0; blockCount > 0 && j < kBlockFloats; j++) {
+			const size_t axis = j % 3;
+			const size_t minPoint = begin + laneMinBlock[j] * kBlockPoints + j / 3;
+			const size_t maxPoint = begin + laneMaxBlock[j] * kBlockPoints + j / 3;
+			minIndex[axis] = values[minPoint * 3 + axis] < values[minIndex[axis] * 3 + axis] ? minPoint : minIndex[axis];
+			maxIndex[axis] = values[maxPoint * 3 + axis] > values[maxIndex[axis] * 3 + axis] ? maxPoint : maxIndex[axis];
+		}
+		for (size_t i = begin + blockCount * kBlockPoints; i < end; i++) {
+			for (size_t axis = 0; axis < 3; axis++) {
+				minIndex[axis] = values[i * 3 + axis] < values[minIndex[axis] * 3 + axis] ? i : minIndex[axis];
+				maxIndex[axis] = values[i * 3 + axis] > values[maxIndex[axis] * 3 + axis] ? i : maxIndex[axis];
+			}
+		}
+	}
+
+	/// <summary>
+	/// 2点を直径の両端とする球
+	/// </summary>
+	DoubleSphere MakeSphere(const Double3& a, const Double3& b) {
+		const Double3 center = (a + b) * 0.5;
+		const Double3 diff = a - center;
+		return { center, std::sqrt(diff.Dot(diff)) };
+	}
+
+	/// <summary>
+	/// 3点を通る最小の球(3点の外接円)
+	/// </summary>
+	DoubleSphere MakeSphere(const Double3& a, const Double3& b, const Double3& c) {
+		const Double3 ab = b - a;
+		const Double3 ac = c - a;
+		const Double3 normal = ab.Cross(ac);
+		const double denominator = 2.0 * normal.Dot(normal);
+		//一直線に並んでいれば、最も離れた2点の球にする
+		if (denominator <= std::numeric_limits<double>::epsilon() * ab.Dot(ab) * ac.Dot(ac)) {
+			const DoubleSphere candidates[3] = { MakeSphere(a, b), MakeSphere(a, c), MakeSphere(b, c) };
+			return *std::max_element(std::begin(candidates), std::end(candidates),
+				[](const DoubleSphere& lhs, const DoubleSphere& rhs) { return lhs.radius < rhs.radius; });
+		}
+		const Double3 offset = (normal.Cross(ab) * ac.Dot(ac) + ac.Cross(normal) * ab.Dot(ab)) * (1.0 / denominator);
+		return { a + offset, std::sqrt(offset.Dot(offset)) };
+	}
+
+	/// <summary>
+	/// 4点を通る球(4点の外接球)
+	/// </summary>
+	DoubleSphere MakeSphere(const Double3& a, const Double3& b, const Double3& c, const Double3& d) {
+		const Double3 u = b - a;
+		const Double3 v = c - a;
+		const Double3 w = d - a;
+		const double determinant = 2.0 * u.Dot(v.Cross(w));
+		const double scale = std::sqrt(u.Dot(u) * v.Dot(v) * w.Dot(w));
+		//同じ平面にあれば、4点を含む3点の外接円のうち最小のものにする
+		if (std::fabs(determinant) <= 1.0e-12 * scale) {
+			const DoubleSphere candidates[4] = { MakeSphere(a, b, c), MakeSphere(a, b, d), MakeSphere(a, c, d), MakeSphere(b, c, d) };
+			const Double3 points[4] = { a, b, c, d };
+			DoubleSphere best = { a, std::numeric_limits<double>::max() };
+			for (const DoubleSphere& candidate : candidates) {
+				if (candidate.radius < best.radius &&
+					std::all_of(std::begin(points), std::end(points), [&](const Double3& point) { return candidate.Contains(point); })) {
+					best = candidate;
+				}
+			}
+			return best;
+		}
+		const Double3 offset = (v.Cross(w) * u.Dot(u) + w.Cross(u) * v.Dot(v) + u.Cross(v) * w.Dot(w)) * (1.0 / determinant);
+		return { a + offset, std::sqrt(offset.Dot(offset)) };
+	}
+
+	/// <summary>
+	/// 対称行列の固有値と固有ベクトル(ヤコビ法)
+	/// </summary>
+	/// <param name="matrix">対称行列(対角に固有値が残る)</param>
+	/// <param name="vectors">固有ベクトル(列)</param>
+	void Jacobi(double matrix[3][3], double vectors[3][3]) {
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				vectors[i][j] = i == j ? 1.0 : 0.0;
+			}
+		}
+		const double scale = std::fabs(matrix[0][0]) + std::fabs(matrix[1][1]) + std::fabs(matrix[2][2]);
+		for (int sweep = 0; sweep < kMaxJacobiSweeps; sweep++) {
+			const double offDiagonal = std::fabs(matrix[0][1]) + std::fabs(matrix[0][2]) + std::fabs(matrix[1][2]);
+			if (offDiagonal <= 1.0e-15 * scale) {
+				return;
+			}
+			const int pairs[3][2] = { { 0,1 }, { 0,2 }, { 1,2 } };
+			for (const int(&pair)[2] : pairs) {
+				const int p = pair[0];
+				const int q = pair[1];
+				if (matrix[p][q] == 0.0) {
+					continue;
+				}
+				//matrix[p][q]を0にする回転
+				const double theta = (matrix[q][q] - matrix[p][p]) / (2.0 * matrix[p][q]);
+				const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+				const double c = 1.0 / std::sqrt(t * t + 1.0);
+				const double s = t * c;
+				for (int k = 0; k < 3; k++) {
+					const double kp = matrix[k][p];
+					const double kq = matrix[k][q];
+					matrix[k][p] = c * kp - s * kq;
+					matrix[k][q] = s * kp + c * kq;
+				}
+				for (int k = 0; k < 3; k++) {
+					const double pk = matrix[p][k];
+					const double qk = matrix[q][k];
+					matrix[p][k] = c * pk - s * qk;
+					matrix[q][k] = s * pk + c * qk;
+				}
+				for (int k = 0; k < 3; k++) {
+					const double kp = vectors[k][p];
+					const double kq = vectors[k][q];
+					vectors[k][p] = c * kp - s * kq;
+					vectors[k][q] = s * kp + c * kq;
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// 共分散行列の固有ベクトルを軸にする(分散の大きい順、右手系)
+	/// </summary>
+	/// <param name="covariance">共分散行列</param>
+	/// <param name="orientations">軸</param>
+	void MakePrincipalAxes(double covariance[3][3], Vector3 orientations[3]) {
+		double vectors[3][3];
+		Jacobi(covariance, vectors);
+		int order[3] = { 0,1,2 };
+		std::sort(std::begin(order), std::end(order), [&](int lhs, int rhs) { return covariance[lhs][lhs] > covariance[rhs][rhs]; });
+		Double3 axes[2];
+		for (int i = 0; i < 2; i++) {
+			const Double3 axis = { vectors[0][order[i]], vectors[1][order[i]], vectors[2][order[i]] };
+			axes[i] = axis * (1.0 / std::sqrt(axis.Dot(axis)));
+		}
+		//3本目は外積にして、MakeOBBRotateMatrixと同じく回転行列(行列式が1)の行にする
+		const Double3 third = axes[0].Cross(axes[1]);
+		orientations[0] = { static_cast<float>(axes[0].x), static_cast<float>(axes[0].y), static_cast<float>(axes[0].z) };
+		orientations[1] = { static_cast<float>(axes[1].x), static_cast<float>(axes[1].y), static_cast<float>(axes[1].z) };
+		orientations[2] = { static_cast<float>(third.x), static_cast<float>(third.y), static_cast<float>(third.z) };
+	}
+
+	/// <summary>
+	/// [begin, end)の点を軸に投影した最小・最大をminとmaxに足し込む
+	/// </summary>
+	void AccumulateProjection(const float* values, size_t begin, size_t end, const Vector3 orientations[3], float min[3], float max[3]) {
+		//8点ずつx,y,zに分けてから投影し、軸ごとに8本のレーンで最小・最大を取る
+		float laneMin[3][kBlockPoints];
+		float laneMax[3][kBlockPoints];
+		for (size_t axis = 0; axis < 3; axis++) {
+			for (size_t j = 0; j < kBlockPoints; j++) {
+				laneMin[axis][j] = min[axis];
+				laneMax[axis][j] = max[axis];
+			}
+		}
+		size_t i = begin;
+		for (; i + kBlockPoints <= end; i += kBlockPoints) {
+			const float* block = values + i * 3;
+			float x[kBlockPoints];
+			float y[kBlockPoints];
+			float z[kBlockPoints];
+			for (size_t j = 0; j < kBlockPoints; j++) {
+				x[j] = block[j * 3 + 0];
+				y[j] = block[j * 3 + 1];
+				z[j] = block[j * 3 + 2];
+			}
+			for (size_t axis = 0; axis < 3; axis++) {
+				const Vector3& orientation = orientations[axis];
+				for (size_t j = 0; j < kBlockPoints; j++) {
+					const float projection = x[j] * orientation.x + y[j] * orientation.y + z[j] * orientation.z;
+					laneMin[axis][j] = projection < laneMin[axis][j] ? projection : laneMin[axis][j];
+					laneMax[axis][j] = projection > laneMax[axis][j] ? projection : laneMax[axis][j];
+				}
+			}
+		}
+		for (; i < end; i++) {
+			for (size_t axis = 0; axis < 3; axis++) {
+				const float projection = values[i * 3 + 0] * orientations[axis].x + values[i * 3 + 1] * orientations[axis].y + values[i * 3 + 2] * orientations[axis].z;
+				laneMin[axis][0] = projection < laneMin[axis][0] ? projection : laneMin[axis][0];
+				laneMax[axis][0] = projection > laneMax[axis][0] ? projection : laneMax[axis][0];
+			}
+		}
+		for (size_t axis = 0; axis < 3; axis++) {
+			for (size_t j = 0; j < kBlockPoints; j++) {
+				min[axis] = laneMin[axis][j] < min[axis] ? laneMin[axis][j] : min[axis];
+				max[axis] = laneMax[axis][j] > max[axis] ? laneMax[axis][j] : max[axis];
+			}
+		}
+	}
+
+	/// <summary>
+	/// [begin, end)の点の和と積の和(originからの差)をsumとproductに足し込む
+	/// </summary>
+	/// <param name="product">xx,xy,xz,yy,yz,zzの順</param>
+	void AccumulateMoments(const float* values, size_t begin, size_t end, const float origin[3], double sum[3], double product[6]) {
+		//x,y,zが並んだまま、同じレーン(xx,yy,zz)、1つ隣(xy,yz)、2つ隣(xz)の積をレーンごとにfloatで足し、
+		//誤差がたまらないようにkMomentFlushBlocksごとにdoubleへ移す(2つ隣まで読むので最後のブロックは余りに回す)
+		float originLanes[kBlockFloats + 2];
+		for (size_t j = 0; j < kBlockFloats + 2; j++) {
+			originLanes[j] = origin[j % 3];
+		}
+		size_t i = begin;
+		while (i + kBlockPoints < end) {
+			float laneSum[kBlockFloats] = {};
+			float laneSquare[kBlockFloats] = {};
+			float laneNext[kBlockFloats] = {};
+			float laneSecond[kBlockFloats] = {};
+			for (size_t block = 0; block < kMomentFlushBlocks && i + kBlockPoints < end; block++, i += kBlockPoints) {
+				const float* points = values + i * 3;
+				float diff[kBlockFloats + 2];
+				for (size_t j = 0; j < kBlockFloats + 2; j++) {
+					diff[j] = points[j] - originLanes[j];
+				}
+				for (size_t j = 0; j < kBlockFloats; j++) {
+					laneSum[j] += diff[j];
+					laneSquare[j] += diff[j] * diff[j];
+					laneNext[j] += diff[j] * diff[j + 1];
+					laneSecond[j] += diff[j] * diff[j + 2];
+				}
+			}
+			for (size_t j = 0; j < kBlockFloats; j += 3) {
+				sum[0] += laneSum[j + 0];
+				sum[1] += laneSum[j + 1];
+				sum[2] += laneSum[j + 2];
+				product[0] += laneSquare[j + 0];
+				product[1] += laneNext[j + 0];
+				product[2] += laneSecond[j + 0];
+				product[3] += laneSquare[j + 1];
+				product[4] += laneNext[j + 1];
+				product[5] += laneSquare[j + 2];
+			}
+		}
+		for (; i < end; i++) {
+			const double x = static_cast<double>(values[i * 3 + 0]) - origin[0];
+			const double y = static_cast<double>(values[i * 3 + 1]) - origin[1];
+			const double z = static_cast<double>(values[i * 3 + 2]) - origin[2];
+			sum[0] += x;
+			sum[1] += y;
+			sum[2] += z;
+			product[0] += x * x;
+			product[1] += x * y;
+			product[2] += x * z;
+			product[3] += y * y;
+			product[4] += y * z;
+			product[5] += z * z;
+		}
+	}
+
+	/// <summary>
+	/// 軸と投影の範囲からOBBを作る
+	/// </summary>
+	OBB MakeOBB(const Vector3 orientations[3], const float min[3], const float max[3]) {
+		OBB obb = {};
+		for (int axis = 0; axis < 3; axis++) {
+			const float middle = (min[axis] + max[axis]) * 0.5f;
+			obb.orientations[axis] = orientations[axis];
+			obb.center.x += orientations[axis].x * middle;
+			obb.center.y += orientations[axis].y * middle;
+			obb.center.z += orientations[axis].z * middle;
+		}
+		obb.size = { (max[0] - min[0]) * 0.5f, (max[1] - min[1]) * 0.5f, (max[2] - min[2]) * 0.5f };
+		return obb;
+	}
+
+	/// <summary>
+	/// OBBの8個の頂点
+	/// </summary>
+	void GetCorners(const OBB& obb, Vector3* corners) {
+		for (int i = 0; i < 8; i++) {
+			const float signs[3] = { (i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f };
+			Vector3 corner = obb.center;
+			for (int axis = 0; axis < 3; axis++) {
+				const float extent = signs[axis] * (axis == 0 ? obb.size.x : axis == 1 ? obb.size.y : obb.size.z);
+				corner.x += obb.orientations[axis].x * extent;
+				corner.y += obb.orientations[axis].y * extent;
+				corner.z += obb.orientations[axis].z * extent;
+			}
+			corners[i] = corner;
+		}
+	}
+}
+
+//点を囲むAABB
+AABB BoundingVolume::ComputeAABB(std::span<const Vector3> points, bool isParallel) {
+	const float kMax = std::numeric_limits<float>::max();
+	float min[3] = { kMax,kMax,kMax };
+	float max[3] = { -kMax,-kMax,-kMax };
+	const float* values = reinterpret_cast<const float*>(points.data());
+	std::mutex mutex;
+	ForEachRange(points.size(), isParallel, [&](size_t begin, size_t end) {
+		float rangeMin[3] = { kMax,kMax,kMax };
+		float rangeMax[3] = { -kMax,-kMax,-kMax };
+		AccumulateAABB(values, begin, end, rangeMin, rangeMax);
+		std::lock_guard<std::mutex> lock(mutex);
+		for (int i = 0; i < 3; i++) {
+			min[i] = std::min(min[i], rangeMin[i]);
+			max[i] = std::max(max[i], rangeMax[i]);
+		}
+		});
+	return { { min[0],min[1],min[2] }, { max[0],max[1],max[2] } };
+}
+
+//点を囲む球(Ritterの方法)
+SphereData BoundingVolume::ComputeSphere(std::span<const Vector3> points, bool isParallel) {
+	if (points.empty()) {
+		return {};
+	}
+	const float* values = reinterpret_cast<const float*>(points.data());
+
+	//各軸で最小・最大の点を探す
+	size_t minIndex[3] = {};
+	size_t maxIndex[3] = {};
+	std::mutex mutex;
+	ForEachRange(points.size(), isParallel, [&](size_t begin, size_t end) {
+		size_t rangeMin[3];
+		size_t rangeMax[3];
+		FindExtremes(values, begin, end, rangeMin, rangeMax);
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t axis = 0; axis < 3; axis++) {
+			minIndex[axis] = values[rangeMin[axis] * 3 + axis] < values[minIndex[axis] * 3 + axis] ? rangeMin[axis] : minIndex[axis];
+			maxIndex[axis] = values[rangeMax[axis] * 3 + axis] > values[maxIndex[axis] * 3 + axis] ? rangeMax[axis] : maxIndex[axis];
+		}
+		});
+
+	//最も離れた組を直径にした球から始める
+	SphereData initialSphere = {};
+	float maxDistanceSquared = -1.0f;
+	for (size_t axis = 0; axis < 3; axis++) {
+		const Vector3& a = points[minIndex[axis]];
+		const Vector3& b = points[maxIndex[axis]];
+		const Vector3 diff = { b.x - a.x, b.y - a.y, b.z - a.z };
+		const float distanceSquared = diff.x * diff.x + diff.y * diff.y + diff.z * diff.z;
+		if (distanceSquared > maxDistanceSquared) {
+			maxDistanceSquared = distanceSquared;
+			initialSphere.center = { (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f };
+			initialSphere.radius = std::sqrt(distanceSquared) * 0.5f;
+		}
+	}
+
+	//区間ごとに広げてからまとめる
+	SphereData sphere = initialSphere;
+	ForEachRange(points.size(), isParallel, [&](size_t begin, size_t end) {
+		SphereData rangeSphere = initialSphere;
+		GrowSphereRange(values, begin, end, rangeSphere);
+		std::lock_guard<std::mutex> lock(mutex);
+		sphere = Merge(sphere, rangeSphere);
+		});
+	return sphere;
+}
+
+//点を囲む最小の球(Welzlの方法)
+SphereData BoundingVolume::ComputeMinimumSphere(std::span<const Vector3> points) {
+	if (points.empty()) {
+		return {};
+	}
+	//並べ替えると期待値で線形時間になる(同じ結果になるように乱数の種は固定する)
+	std::vector<Double3> shuffled(points.size());
+	for (size_t i = 0; i < points.size(); i++) {
+		shuffled[i] = { points[i].x, points[i].y, points[i].z };
+	}
+	std::mt19937 engine(0);
+	std::shuffle(shuffled.begin(), shuffled.end(), engine);
+
+	//外側の点が見つかるたびに、その点を表面に乗せた球を作り直す
+	DoubleSphere sphere = { shuffled[0], 0.0 };
+	for (size_t i = 1; i < shuffled.size(); i++) {
+		if (sphere.Contains(shuffled[i])) {
+			continue;
+		}
+		sphere = { shuffled[i], 0.0 };
+		for (size_t j = 0; j < i; j++) {
+			if (sphere.Contains(shuffled[j])) {
+				continue;
+			}
+			sphere = MakeSphere(shuffled[i], shuffled[j]);
+			for (size_t k = 0; k < j; k++) {
+				if (sphere.Contains(shuffled[k])) {
+					continue;
+				}
+				sphere = MakeSphere(shuffled[i], shuffled[j], shuffled[k]);
+				for (size_t l = 0; l < k; l++) {
+					if (!sphere.Contains(shuffled[l])) {
+						sphere = MakeSphere(shuffled[i], shuffled[j], shuffled[k], shuffled[l]);
+					}
+				}
+			}
+		}
+	}
+	//floatに丸めても外に出ないように半径を少し広げる
+	const SphereData result = {
+		{ static_cast<float>(sphere.center.x), static_cast<float>(sphere.center.y), static_cast<float>(sphere.center.z) },
+		static_cast<float>(sphere.radius * (1.0 + kContainEpsilon)),
+	};
+	return result;
+}
+
+//点を囲むOBB
+OBB BoundingVolume::ComputeOBB(std::span<const Vector3> points, bool isParallel) {
+	if (points.empty()) {
+		OBB obb = {};
+		obb.orientations[0] = { 1.0f,0.0f,0.0f };
+		obb.orientations[1] = { 0.0f,1.0f,0.0f };
+		obb.orientations[2] = { 0.0f,0.0f,1.0f };
+		return obb;
+	}
+	const float* values = reinterpret_cast<const float*>(points.data());
+
+	//共分散行列(桁落ちを防ぐため、最初の点からの差で集計する)
+	const float origin[3] = { points[0].x, points[0].y, points[0].z };
+	double sum[3] = {};
+	double product[6] = {};
+	std::mutex mutex;
+	ForEachRange(points.size(), isParallel, [&](size_t begin, size_t end) {
+		double rangeSum[3] = {};
+		double rangeProduct[6] = {};
+		AccumulateMoments(values, begin, end, origin, rangeSum, rangeProduct);
+		std::lock_guard<std::mutex> lock(mutex);
+		for (int i = 0; i < 3; i++) {
+			sum[i] += rangeSum[i];
+		}
+		for (int i = 0; i < 6; i++) {
+			product[i] += rangeProduct[i];
+		}
+		});
+	const double inverseCount = 1.0 / static_cast<double>(points.size());
+	const double mean[3] = { sum[0] * inverseCount, sum[1] * inverseCount, sum[2] * inverseCount };
+	double covariance[3][3];
+	covariance[0][0] = product[0] * inverseCount - mean[0] * mean[0];
+	covariance[0][1] = covariance[1][0] = product[1] * inverseCount - mean[0] * mean[1];
+	covariance[0][2] = covariance[2][0] = product[2] * inverseCount - mean[0] * mean[2];
+	covariance[1][1] = product[3] * inverseCount - mean[1] * mean[1];
+	covariance[1][2] = covariance[2][1] = product[4] * inverseCount - mean[1] * mean[2];
+	covariance[2][2] = product[5] * inverseCount - mean[2] * mean[2];
+	Vector3 orientations[3];
+	MakePrincipalAxes(covariance, orientations);
+
+	//軸に投影した範囲
+	const float kMax = std::numeric_limits<float>::max();
+	float min[3] = { kMax,kMax,kMax };
+	float max[3] = { -kMax,-kMax,-kMax };
+	ForEachRange(points.size(), isParallel, [&](size_t begin, size_t end) {
+		float rangeMin[3] = { kMax,kMax,kMax };
+		float rangeMax[3] = { -kMax,-kMax,-kMax };
+		AccumulateProjection(values, begin, end, orientations, rangeMin, rangeMax);
+		std::lock_guard<std::mutex> lock(mutex);
+		for (int i = 0; i < 3; i++) {
+			min[i] = std::min(min[i], rangeMin[i]);
+			max[i] = std::max(max[i], rangeMax[i]);
+		}
+		});
+	return MakeOBB(orientations, min, max);
+}
+
+//2つのAABBを囲むAABB
+AABB BoundingVolume::Merge(const AABB& aabb1, const AABB& aabb2) {
+	return {
+		{ std::min(aabb1.min.x, aabb2.min.x), std::min(aabb1.min.y, aabb2.min.y), std::min(aabb1.min.z, aabb2.min.z) },
+		{ std::max(aabb1.max.x, aabb2.max.x), std::max(aabb1.max.y, aabb2.max.y), std::max(aabb1.max.z, aabb2.max.z) },
+	};
+}
+
+//2つの球を囲む最小の球
+SphereData BoundingVolume::Merge(const SphereData& sphere1, const SphereData& sphere2) {
+	const Vector3 diff = { sphere2.center.x - sphere1.center.x, sphere2.center.y - sphere1.center.y, sphere2.center.z - sphere1.center.z };
+	const float distance = std::sqrt(diff.x * diff.x + diff.y * diff.y + diff.z * diff.z);
+	//片方がもう片方に入っていればそのまま
+	if (distance + sphere2.radius <= sphere1.radius) {
+		return sphere1;
+	}
+	if (distance + sphere1.radius <= sphere2.radius) {
+		return sphere2;
+	}
+	const float radius = (distance + sphere1.radius + sphere2.radius) * 0.5f;
+	const float t = (radius - sphere1.radius) / distance;
+	return { { sphere1.center.x + diff.x * t, sphere1.center.y + diff.y * t, sphere1.center.z + diff.z * t }, radius };
+}
+
+//2つのOBBを囲むOBB
+OBB BoundingVolume::Merge(const OBB& obb1, const OBB& obb2) {
+	Vector3 corners[16];
+	GetCorners(obb1, corners);
+	GetCorners(obb2, corners + 8);
+	const float* values = reinterpret_cast<const float*>(corners);
+
+	//それぞれの軸と、頂点の主成分の軸で囲んでみて体積が最小のものにする
+	const OBB principal = ComputeOBB(corners, false);
+	OBB best = principal;
+	float bestVolume = principal.size.x * principal.size.y * principal.size.z;
+	for (const Vector3* orientations : { obb1.orientations, obb2.orientations }) {
+		const float kMax = std::numeric_limits<float>::max();
+		float min[3] = { kMax,kMax,kMax };
+		float max[3] = { -kMax,-kMax,-kMax };
+		AccumulateProjection(values, 0, 16, orientations, min, max);
+		const float volume = (max[0] - min[0]) * (max[1] - min[1]) * (max[2] - min[2]) * 0.125f;
+		if (volume < bestVolume) {
+			bestVolume = volume;
+			best = MakeOBB(orientations, min, max);
+		}
+	}
+	return best;
+}
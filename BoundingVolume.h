@@ -0,0 +1,65 @@
+#pragma once
+#include "Shape.h"
+#include <cstddef>
+#include <span>
+
+/// <summary>
+/// 点の集合から境界ボリューム(AABB・球・OBB)を作る
+/// </summary>
+/// <remarks>
+/// 点はVector3を並べたもの(メッシュの頂点など)をそのまま受け取る。
+/// AABBは8点ずつ(24個のfloat)をまとめて、成分の並びがそろった最小・最大を分岐なしで取るのでベクトル化される。
+/// 球はRitterの方法(速いが少し大きい)とWelzlの方法(最小だが遅い)、OBBは共分散行列の主成分の向きで作る。
+/// 点が多ければJobSystemで区間に分けて並列に求め、区間ごとの結果をMergeでまとめる
+/// </remarks>
+class BoundingVolume {
+public://メンバ関数
+	/// <summary>
+	/// 点を囲むAABB
+	/// </summary>
+	/// <param name="points">点</param>
+	/// <param name="isParallel">点が多ければ並列に求めるか</param>
+	/// <returns>AABB(点がなければminが最大値、maxが最小値の空の箱。Mergeしても相手が変わらない)</returns>
+	static AABB ComputeAABB(std::span<const Vector3> points, bool isParallel = true);
+
+	/// <summary>
+	/// 点を囲む球(Ritterの方法。最小の球より5~20%ほど大きい)
+	/// </summary>
+	/// <param name="points">点</param>
+	/// <param name="isParallel">点が多ければ並列に求めるか</param>
+	/// <returns>球(点がなければ原点で半径0)</returns>
+	static SphereData ComputeSphere(std::span<const Vector3> points, bool isParallel = true);
+
+	/// <summary>
+	/// 点を囲む最小の球(Welzlの方法。点を並べ替えた写しを作るので、読み込み時などに使う)
+	/// </summary>
+	/// <param name="points">点</param>
+	/// <returns>球(点がなければ原点で半径0)</returns>
+	static SphereData ComputeMinimumSphere(std::span<const Vector3> points);
+
+	/// <summary>
+	/// 点を囲むOBB(共分散行列の固有ベクトルを軸にする)
+	/// </summary>
+	/// <param name="points">点</param>
+	/// <param name="isParallel">点が多ければ並列に求めるか</param>
+	/// <returns>OBB(軸はMakeOBBRotateMatrixと同じく右手系の回転行列の行。点がなければ原点で大きさ0)</returns>
+	static OBB ComputeOBB(std::span<const Vector3> points, bool isParallel = true);
+
+	/// <summary>
+	/// 2つのAABBを囲むAABB
+	/// </summary>
+	static AABB Merge(const AABB& aabb1, const AABB& aabb2);
+
+	/// <summary>
+	/// 2つの球を囲む最小の球
+	/// </summary>
+	static SphereData Merge(const SphereData& sphere1, const SphereData& sphere2);
+
+	/// <summary>
+	/// 2つのOBBを囲むOBB(それぞれの軸と16個の頂点の主成分の軸のうち、体積が最小になるもの)
+	/// </summary>
+	static OBB Merge(const OBB& obb1, const OBB& obb2);
+public://定数
+	//並列にするときの1区間の最小の点数
+	static inline const size_t kMinBatchSize = 65536;
+};
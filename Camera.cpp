@@ -1,16 +1,37 @@
 #include "Camera.h"
 #include "Rendering.h"
 
+namespace {
+	/// <summary>
+	/// 同じベクトルか
+	/// </summary>
+	bool IsSame(const Vector3& a, const Vector3& b) {
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+}
+
 //初期化
 void Camera::Initialize(float windowWidth, float windowHeight) {
 	windowWidth_ = windowWidth;
 	windowHeight_ = windowHeight;
+	isDirty_ = true;
 }
 
 //更新
 void Camera::Update() {
+	//逆行列は重いので、回転・移動・画面の大きさが変わったときだけ行列を作り直してキャッシュする
+	if (!isDirty_) {
+		return;
+	}
 	MakeViewProjectionMatrix();
 	MakeViewportMatrix();
+	inverseViewProjectionViewportMatrix_ = (viewProjectionMatrix_ * viewportMatrix_).Inverse();
+	isDirty_ = false;
+}
+
+//ワールド行列のゲッター
+Matrix4x4 Camera::GetWorldMatrix() const {
+	return worldMatrix_;
 }
 
 //ビュー射影行列のゲッター
@@ -23,14 +44,32 @@ Matrix4x4 Camera::GetViewportMatrix() const {
 	return viewportMatrix_;
 }
 
+//スクリーン座標からワールド座標に戻す
+Vector3 Camera::ScreenToWorld(float screenX, float screenY, float depth) const {
+	return Rendering::Transform({ screenX, screenY, depth }, inverseViewProjectionViewportMatrix_);
+}
+
+//スクリーン座標を通る視線の半直線
+Ray Camera::ScreenToRay(float screenX, float screenY) const {
+	Vector3 nearPoint = ScreenToWorld(screenX, screenY, 0.0f);
+	Vector3 farPoint = ScreenToWorld(screenX, screenY, 1.0f);
+	return { .origin = nearPoint,.diff = (farPoint - nearPoint).Normalize() };
+}
+
 //回転のセッター
 void Camera::SetRotate(const Vector3& rotate) {
-	rotate_ = rotate;
+	if (!IsSame(rotate_, rotate)) {
+		rotate_ = rotate;
+		isDirty_ = true;
+	}
 }
 
 //平行移動のセッター
 void Camera::SetTranslate(const Vector3& translate) {
-	translate_ = translate;
+	if (!IsSame(translate_, translate)) {
+		translate_ = translate;
+		isDirty_ = true;
+	}
 }
 
 //ビュープロジェクション行列の作成
@@ -1,5 +1,6 @@
 #pragma once
 #include "Rendering.h"
+#include "Shape.h"
 
 /// <summary>
 /// カメラ
@@ -24,10 +25,16 @@ public://メンバ関数
 	void Initialize(float windowWidth, float windowHeight);
 
 	/// <summary>
-	/// 更新
+	/// 更新(前の更新から変わっていなければ行列を作り直さない)
 	/// </summary>
 	void Update();
 
+	/// <summary>
+	/// ワールド行列のゲッター(行がカメラの右・上・前の向き)
+	/// </summary>
+	/// <returns>ワールド行列</returns>
+	Matrix4x4 GetWorldMatrix() const;
+
 	/// <summary>
 	/// ビュー射影行列のゲッター
 	/// </summary>
@@ -40,6 +47,23 @@ public://メンバ関数
 	/// <returns>ビューポート行列</returns>
 	Matrix4x4 GetViewportMatrix() const;
 
+	/// <summary>
+	/// スクリーン座標からワールド座標に戻す
+	/// </summary>
+	/// <param name="screenX">スクリーンのx座標</param>
+	/// <param name="screenY">スクリーンのy座標</param>
+	/// <param name="depth">深度(0で近平面、1で遠平面)</param>
+	/// <returns>ワールド座標</returns>
+	Vector3 ScreenToWorld(float screenX, float screenY, float depth) const;
+
+	/// <summary>
+	/// スクリーン座標を通る視線の半直線(マウスでのピッキングに使う)
+	/// </summary>
+	/// <param name="screenX">スクリーンのx座標</param>
+	/// <param name="screenY">スクリーンのy座標</param>
+	/// <returns>近平面から奥へ向かう半直線(方向は正規化済み)</returns>
+	Ray ScreenToRay(float screenX, float screenY) const;
+
 	/// <summary>
 	/// 回転のセッター
 	/// </summary>
@@ -72,5 +96,7 @@ private://メンバ変数
 	Matrix4x4 projectionMatrix_ = Matrix4x4::Identity4x4();//射影行列
 	Matrix4x4 viewProjectionMatrix_ = Matrix4x4::Identity4x4();//ビュー射影行列
 	Matrix4x4 viewportMatrix_ = Matrix4x4::Identity4x4();//ビューポート行列
+	Matrix4x4 inverseViewProjectionViewportMatrix_ = Matrix4x4::Identity4x4();//スクリーンからワールドへの行列
+	bool isDirty_ = true;//行列を作り直すか(回転・移動・画面の大きさが変わったら立てる)
 };
 
@@ -0,0 +1,163 @@
+#include "DrawCapture.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// DrawCaptureで記録したファイルを描画先に流し、フレームごとの再生時間を計る
+// 使い方: MT_Study_capture_replay 記録ファイル [--repeat 回数] [--worst 表示数] [--csv 出力先]
+// 同じ記録を描画先やコミットを変えて再生すれば、描画側の変更だけの差を比べられる
+
+namespace {
+	/// <summary>
+	/// 1フレーム分の結果
+	/// </summary>
+	struct FrameResult {
+		size_t frame = 0; //何番目のフレームか
+		uint32_t frameIndex = 0; //記録したときのフレーム番号
+		uint64_t timestamp = 0; //記録を始めてからの時間(ns)
+		uint32_t commandCount = 0; //命令の数
+		uint32_t payloadSize = 0; //本体のバイト数
+		double ns = 0.0; //再生にかかった時間(繰り返した中で最短)
+	};
+
+	/// <summary>
+	/// 並べた値の百分位数
+	/// </summary>
+	/// <param name="sorted">昇順に並べた値</param>
+	/// <param name="percent">百分率</param>
+	double Percentile(const std::vector<double>& sorted, double percent) {
+		const size_t index = static_cast<size_t>(percent / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+		return sorted[index];
+	}
+
+	/// <summary>
+	/// 結果をCSVで書き出す
+	/// </summary>
+	/// <param name="filePath">出力先</param>
+	/// <param name="results">フレームごとの結果</param>
+	/// <returns>書き出せたかどうか</returns>
+	bool WriteCsv(const char* filePath, const std::vector<FrameResult>& results) {
+		std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			return false;
+		}
+		file << "frame,frame_index,timestamp_us,commands,bytes,ns\n";
+		for (const FrameResult& r : results) {
+			file << r.frame << ',' << r.frameIndex << ',' << r.timestamp / 1000 << ','
+				<< r.commandCount << ',' << r.payloadSize << ',' << r.ns << '\n';
+		}
+		return file.good();
+	}
+}
+
+int main(int argc, char** argv) {
+	std::string capturePath;
+	std::string csvPath;
+	uint32_t repeatCount = 5;
+	size_t worstCount = 5;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--repeat" && i + 1 < argc) {
+			repeatCount = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+		} else if (arg == "--worst" && i + 1 < argc) {
+			worstCount = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+		} else if (arg == "--csv" && i + 1 < argc) {
+			csvPath = argv[++i];
+		} else if (capturePath.empty() && arg.rfind("--", 0) != 0) {
+			capturePath = arg;
+		} else {
+			capturePath.clear();
+			break;
+		}
+	}
+	if (capturePath.empty()) {
+		std::cerr << "usage: " << argv[0] << " capture [--repeat count] [--worst count] [--csv path]" << std::endl;
+		return 1;
+	}
+
+	DrawCaptureReader reader;
+	if (!reader.Open(capturePath.c_str())) {
+		std::cerr << "failed to open " << capturePath << std::endl;
+		return 1;
+	}
+	if (reader.GetFrameCount() == 0) {
+		std::cerr << "no frames in " << capturePath << std::endl;
+		return 1;
+	}
+	if (reader.IsTruncated()) {
+		std::cerr << "warning: the last frame is truncated and skipped" << std::endl;
+	}
+
+	//フレームごとに繰り返して最短の時間を取り、割り込みなどの揺れを除く
+	NullDrawBackend backend;
+	std::vector<FrameResult> results(reader.GetFrameCount());
+	uint64_t totalCommands = 0;
+	uint64_t totalBytes = 0;
+	for (size_t frame = 0; frame < reader.GetFrameCount(); frame++) {
+		const DrawCapture::FrameHeader header = reader.GetFrameHeader(frame);
+		FrameResult& result = results[frame];
+		result.frame = frame;
+		result.frameIndex = header.frameIndex;
+		result.timestamp = header.timestamp;
+		result.commandCount = header.commandCount;
+		result.payloadSize = header.payloadSize;
+		result.ns = 1.0e300;
+		for (uint32_t i = 0; i < repeatCount; i++) {
+			const auto start = std::chrono::steady_clock::now();
+			const bool isValid = reader.Replay(frame, backend);
+			const auto end = std::chrono::steady_clock::now();
+			if (!isValid) {
+				std::cerr << "frame " << frame << " is corrupt" << std::endl;
+				return 1;
+			}
+			result.ns = std::min(result.ns, std::chrono::duration<double, std::nano>(end - start).count());
+		}
+		totalCommands += header.commandCount;
+		totalBytes += sizeof(header) + header.payloadSize;
+	}
+
+	std::vector<double> sorted(results.size());
+	double totalNs = 0.0;
+	for (size_t i = 0; i < results.size(); i++) {
+		sorted[i] = results[i].ns;
+		totalNs += results[i].ns;
+	}
+	std::sort(sorted.begin(), sorted.end());
+
+	char line[256];
+	std::snprintf(line, sizeof(line), "frames: %zu  commands: %llu (%.1f/frame)  bytes: %llu (%.2f/command)",
+		results.size(), static_cast<unsigned long long>(totalCommands),
+		static_cast<double>(totalCommands) / static_cast<double>(results.size()),
+		static_cast<unsigned long long>(totalBytes),
+		totalCommands > 0 ? static_cast<double>(totalBytes) / static_cast<double>(totalCommands) : 0.0);
+	std::cout << line << std::endl;
+	std::snprintf(line, sizeof(line), "ns/frame: min %.0f  avg %.0f  p50 %.0f  p99 %.0f  max %.0f  (%.2f ns/command)",
+		sorted.front(), totalNs / static_cast<double>(results.size()), Percentile(sorted, 50.0), Percentile(sorted, 99.0), sorted.back(),
+		totalCommands > 0 ? totalNs / static_cast<double>(totalCommands) : 0.0);
+	std::cout << line << std::endl;
+
+	//遅いフレームを順に表示する
+	std::vector<FrameResult> worst = results;
+	worstCount = std::min(worstCount, worst.size());
+	std::partial_sort(worst.begin(), worst.begin() + static_cast<std::ptrdiff_t>(worstCount), worst.end(),
+		[](const FrameResult& a, const FrameResult& b) { return a.ns > b.ns; });
+	for (size_t i = 0; i < worstCount; i++) {
+		std::snprintf(line, sizeof(line), "  worst #%zu: frame %u at %.3f s  %u commands  %u bytes  %.0f ns",
+			i + 1, worst[i].frameIndex, static_cast<double>(worst[i].timestamp) * 1.0e-9,
+			worst[i].commandCount, worst[i].payloadSize, worst[i].ns);
+		std::cout << line << std::endl;
+	}
+	std::cout << "checksum: " << backend.GetChecksum() << std::endl;
+
+	if (!csvPath.empty() && !WriteCsv(csvPath.c_str(), results)) {
+		std::cerr << "failed to write " << csvPath << std::endl;
+		return 1;
+	}
+	return 0;
+}
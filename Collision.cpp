@@ -0,0 +1,598 @@
+#include "Collision.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+	//平行な軸の外積が0になるのを防ぐ値
+	const float kParallelEpsilon = 1.0e-6f;
+	//0除算を防ぐための極小値
+	const float kTinyDirection = 1.0e-30f;
+
+	/// <summary>
+	/// 範囲に収める(ベクトル化しやすいように三項演算子で書く)
+	/// </summary>
+	inline float Clamp(float value, float min, float max) {
+		value = value < min ? min : value;
+		return value > max ? max : value;
+	}
+
+	/// <summary>
+	/// 0除算しない逆数
+	/// </summary>
+	inline float SafeInverse(float value) {
+		return 1.0f / (value != 0.0f ? value : kTinyDirection);
+	}
+
+	/// <summary>
+	/// OBBの集合の配列の先頭
+	/// </summary>
+	/// <remarks>結果の書き込み先(uint8_t*)は何とでもエイリアスしうるので、先頭はループの外で取り出し、書き込み先には__restrictを付けないとベクトル化されない</remarks>
+	struct OBBSetView {
+		const float* center[3];
+		const float* orientations[3][3];
+		const float* size[3];
+
+		explicit OBBSetView(const OBBSet& obbs) {
+			for (int i = 0; i < 3; i++) {
+				center[i] = obbs.center[i].data();
+				size[i] = obbs.size[i].data();
+				for (int j = 0; j < 3; j++) {
+					orientations[i][j] = obbs.orientations[i][j].data();
+				}
+			}
+		}
+	};
+
+	/// <summary>
+	/// OBBの1軸分のスラブとの交差区間を狭める
+	/// </summary>
+	inline void ClipOBBSlab(float dx, float dy, float dz, float vx, float vy, float vz,
+		float ax, float ay, float az, float size, float& tNear, float& tFar) {
+		//ローカル座標での始点と方向
+		float localOrigin = dx * ax + dy * ay + dz * az;
+		float inverse = SafeInverse(vx * ax + vy * ay + vz * az);
+		float t1 = (-size - localOrigin) * inverse;
+		float t2 = (size - localOrigin) * inverse;
+		float nearT = t1 < t2 ? t1 : t2;
+		float farT = t1 < t2 ? t2 : t1;
+		tNear = tNear > nearT ? tNear : nearT;
+		tFar = tFar < farT ? tFar : farT;
+	}
+
+	/// <summary>
+	/// OBBの1軸分の、点からOBBまでのはみ出し量の2乗
+	/// </summary>
+	inline float OBBAxisExcessSquared(float dx, float dy, float dz, float ax, float ay, float az, float size) {
+		float local = dx * ax + dy * ay + dz * az;
+		float excess = local - Clamp(local, -size, size);
+		return excess * excess;
+	}
+
+	/// <summary>
+	/// 当たった数を数える
+	/// </summary>
+	size_t CountHits(const uint8_t* hits, size_t count) {
+		size_t result = 0;
+		for (size_t i = 0; i < count; i++) {
+			result += hits[i];
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// 直線(origin + diff * t, 0 <= t <= tMax)と球
+	/// </summary>
+	bool IsCollisionLineSphere(const Vector3& origin, const Vector3& diff, float tMax, const SphereData& sphere) {
+		float lengthSquared = diff.Dot(diff);
+		float t = lengthSquared > 0.0f ? (sphere.center - origin).Dot(diff) / lengthSquared : 0.0f;
+		t = Clamp(t, 0.0f, tMax);
+		Vector3 closestPoint = origin + diff * t;
+		Vector3 toCenter = sphere.center - closestPoint;
+		return toCenter.Dot(toCenter) <= sphere.radius * sphere.radius;
+	}
+
+	/// <summary>
+	/// 直線と平面
+	/// </summary>
+	bool IsCollisionLinePlane(const Vector3& origin, const Vector3& diff, float tMax, const Plane& plane) {
+		float dot = plane.normal.Dot(diff);
+		//平行なら平面上にあるときだけ当たる
+		if (dot == 0.0f) {
+			return plane.normal.Dot(origin) == plane.distance;
+		}
+		float t = (plane.distance - origin.Dot(plane.normal)) / dot;
+		return t >= 0.0f && t <= tMax;
+	}
+
+	/// <summary>
+	/// 直線とAABB(スラブ法)
+	/// </summary>
+	bool IsCollisionLineAABB(const Vector3& origin, const Vector3& diff, float tMax, const AABB& aabb) {
+		const float origins[3] = { origin.x,origin.y,origin.z };
+		const float diffs[3] = { diff.x,diff.y,diff.z };
+		const float mins[3] = { aabb.min.x,aabb.min.y,aabb.min.z };
+		const float maxs[3] = { aabb.max.x,aabb.max.y,aabb.max.z };
+		float tNear = 0.0f;
+		float tFar = tMax;
+		for (int i = 0; i < 3; i++) {
+			//軸に平行ならスラブの中にあるかだけを見る
+			if (diffs[i] == 0.0f) {
+				if (origins[i] < mins[i] || origins[i] > maxs[i]) {
+					return false;
+				}
+				continue;
+			}
+			float t1 = (mins[i] - origins[i]) / diffs[i];
+			float t2 = (maxs[i] - origins[i]) / diffs[i];
+			tNear = std::fmax(tNear, std::fmin(t1, t2));
+			tFar = std::fmin(tFar, std::fmax(t1, t2));
+			if (tNear > tFar) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 点をOBBのローカル座標に変換
+	/// </summary>
+	Vector3 ToOBBLocal(const Vector3& point, const OBB& obb) {
+		Vector3 d = point - obb.center;
+		return { d.Dot(obb.orientations[0]), d.Dot(obb.orientations[1]), d.Dot(obb.orientations[2]) };
+	}
+
+	/// <summary>
+	/// 方向をOBBのローカル座標に変換
+	/// </summary>
+	Vector3 ToOBBLocalDirection(const Vector3& direction, const OBB& obb) {
+		return { direction.Dot(obb.orientations[0]), direction.Dot(obb.orientations[1]), direction.Dot(obb.orientations[2]) };
+	}
+
+	/// <summary>
+	/// 直線とOBB(ローカル座標に変換してAABBとして判定)
+	/// </summary>
+	bool IsCollisionLineOBB(const Vector3& origin, const Vector3& diff, float tMax, const OBB& obb) {
+		AABB localAABB = { -obb.size, obb.size };
+		return IsCollisionLineAABB(ToOBBLocal(origin, obb), ToOBBLocalDirection(diff, obb), tMax, localAABB);
+	}
+
+	/// <summary>
+	/// OBB同士の分離軸判定
+	/// </summary>
+	/// <param name="r">Aの軸から見たBの軸(r[i][j] = Ai・Bj)</param>
+	/// <param name="t">Aの軸から見た中心間のベクトル</param>
+	/// <param name="a">Aの半分の長さ</param>
+	/// <param name="b">Bの半分の長さ</param>
+	/// <returns>分離しているかどうか</returns>
+	template<bool kEarlyOut>
+	inline bool IsSeparatedOBB(const float r[3][3], const float t[3], const float a[3], const float b[3]) {
+		//ベクトル化できるようにループは展開して書く
+		const float absR[3][3] = {
+			{ std::fabs(r[0][0]) + kParallelEpsilon, std::fabs(r[0][1]) + kParallelEpsilon, std::fabs(r[0][2]) + kParallelEpsilon },
+			{ std::fabs(r[1][0]) + kParallelEpsilon, std::fabs(r[1][1]) + kParallelEpsilon, std::fabs(r[1][2]) + kParallelEpsilon },
+			{ std::fabs(r[2][0]) + kParallelEpsilon, std::fabs(r[2][1]) + kParallelEpsilon, std::fabs(r[2][2]) + kParallelEpsilon },
+		};
+
+		bool separated = false;
+		//軸ごとの判定(早期終了ありなら見つかった時点で抜ける)
+		auto test = [&separated](float distance, float ra, float rb) {
+			separated |= std::fabs(distance) > ra + rb;
+			return kEarlyOut && separated;
+			};
+
+		//Aの軸
+		if (test(t[0], a[0], b[0] * absR[0][0] + b[1] * absR[0][1] + b[2] * absR[0][2])) { return true; }
+		if (test(t[1], a[1], b[0] * absR[1][0] + b[1] * absR[1][1] + b[2] * absR[1][2])) { return true; }
+		if (test(t[2], a[2], b[0] * absR[2][0] + b[1] * absR[2][1] + b[2] * absR[2][2])) { return true; }
+		//Bの軸
+		if (test(t[0] * r[0][0] + t[1] * r[1][0] + t[2] * r[2][0], a[0] * absR[0][0] + a[1] * absR[1][0] + a[2] * absR[2][0], b[0])) { return true; }
+		if (test(t[0] * r[0][1] + t[1] * r[1][1] + t[2] * r[2][1], a[0] * absR[0][1] + a[1] * absR[1][1] + a[2] * absR[2][1], b[1])) { return true; }
+		if (test(t[0] * r[0][2] + t[1] * r[1][2] + t[2] * r[2][2], a[0] * absR[0][2] + a[1] * absR[1][2] + a[2] * absR[2][2], b[2])) { return true; }
+		//辺同士の外積の軸
+		if (test(t[2] * r[1][0] - t[1] * r[2][0], a[1] * absR[2][0] + a[2] * absR[1][0], b[1] * absR[0][2] + b[2] * absR[0][1])) { return true; }
+		if (test(t[2] * r[1][1] - t[1] * r[2][1], a[1] * absR[2][1] + a[2] * absR[1][1], b[0] * absR[0][2] + b[2] * absR[0][0])) { return true; }
+		if (test(t[2] * r[1][2] - t[1] * r[2][2], a[1] * absR[2][2] + a[2] * absR[1][2], b[0] * absR[0][1] + b[1] * absR[0][0])) { return true; }
+		if (test(t[0] * r[2][0] - t[2] * r[0][0], a[0] * absR[2][0] + a[2] * absR[0][0], b[1] * absR[1][2] + b[2] * absR[1][1])) { return true; }
+		if (test(t[0] * r[2][1] - t[2] * r[0][1], a[0] * absR[2][1] + a[2] * absR[0][1], b[0] * absR[1][2] + b[2] * absR[1][0])) { return true; }
+		if (test(t[0] * r[2][2] - t[2] * r[0][2], a[0] * absR[2][2] + a[2] * absR[0][2], b[0] * absR[1][1] + b[1] * absR[1][0])) { return true; }
+		if (test(t[1] * r[0][0] - t[0] * r[1][0], a[0] * absR[1][0] + a[1] * absR[0][0], b[1] * absR[2][2] + b[2] * absR[2][1])) { return true; }
+		if (test(t[1] * r[0][1] - t[0] * r[1][1], a[0] * absR[1][1] + a[1] * absR[0][1], b[0] * absR[2][2] + b[2] * absR[2][0])) { return true; }
+		if (test(t[1] * r[0][2] - t[0] * r[1][2], a[0] * absR[1][2] + a[1] * absR[0][2], b[0] * absR[2][1] + b[1] * absR[2][0])) { return true; }
+		return separated;
+	}
+
+	/// <summary>
+	/// 直線とAABBの集合(スラブ法、分岐なし)
+	/// </summary>
+	size_t IsCollisionLineAABBBatch(const Vector3& origin, const Vector3& diff, float tMax, const AABBSet& aabbs, uint8_t* hits) {
+		const size_t count = aabbs.Size();
+		const float ox = origin.x, oy = origin.y, oz = origin.z;
+		const float ix = SafeInverse(diff.x), iy = SafeInverse(diff.y), iz = SafeInverse(diff.z);
+		const float* minX = aabbs.min[0].data();
+		const float* minY = aabbs.min[1].data();
+		const float* minZ = aabbs.min[2].data();
+		const float* maxX = aabbs.max[0].data();
+		const float* maxY = aabbs.max[1].data();
+		const float* maxZ = aabbs.max[2].data();
+		for (size_t i = 0; i < count; i++) {
+			float tx1 = (minX[i] - ox) * ix, tx2 = (maxX[i] - ox) * ix;
+			float ty1 = (minY[i] - oy) * iy, ty2 = (maxY[i] - oy) * iy;
+			float tz1 = (minZ[i] - oz) * iz, tz2 = (maxZ[i] - oz) * iz;
+			float nearX = tx1 < tx2 ? tx1 : tx2, farX = tx1 < tx2 ? tx2 : tx1;
+			float nearY = ty1 < ty2 ? ty1 : ty2, farY = ty1 < ty2 ? ty2 : ty1;
+			float nearZ = tz1 < tz2 ? tz1 : tz2, farZ = tz1 < tz2 ? tz2 : tz1;
+			float tNear = nearX > nearY ? nearX : nearY;
+			tNear = tNear > nearZ ? tNear : nearZ;
+			tNear = tNear > 0.0f ? tNear : 0.0f;
+			float tFar = farX < farY ? farX : farY;
+			tFar = tFar < farZ ? tFar : farZ;
+			tFar = tFar < tMax ? tFar : tMax;
+			hits[i] = static_cast<uint8_t>(tNear <= tFar);
+		}
+		return CountHits(hits, count);
+	}
+
+	/// <summary>
+	/// 直線と球の集合
+	/// </summary>
+	size_t IsCollisionLineSphereBatch(const Vector3& origin, const Vector3& diff, float tMax, const SphereSet& spheres, uint8_t* hits) {
+		const size_t count = spheres.Size();
+		const float lengthSquared = diff.Dot(diff);
+		const float inverseLengthSquared = lengthSquared > 0.0f ? 1.0f / lengthSquared : 0.0f;
+		const float* cx = spheres.center[0].data();
+		const float* cy = spheres.center[1].data();
+		const float* cz = spheres.center[2].data();
+		const float* radius = spheres.radius.data();
+		const float ox = origin.x, oy = origin.y, oz = origin.z;
+		const float vx = diff.x, vy = diff.y, vz = diff.z;
+		for (size_t i = 0; i < count; i++) {
+			float dx = cx[i] - ox, dy = cy[i] - oy, dz = cz[i] - oz;
+			float t = Clamp((dx * vx + dy * vy + dz * vz) * inverseLengthSquared, 0.0f, tMax);
+			float ex = dx - vx * t, ey = dy - vy * t, ez = dz - vz * t;
+			hits[i] = static_cast<uint8_t>(ex * ex + ey * ey + ez * ez <= radius[i] * radius[i]);
+		}
+		return CountHits(hits, count);
+	}
+
+	/// <summary>
+	/// 直線と平面の集合
+	/// </summary>
+	size_t IsCollisionLinePlaneBatch(const Vector3& origin, const Vector3& diff, float tMax, const PlaneSet& planes, uint8_t* hits) {
+		const size_t count = planes.Size();
+		const float* nx = planes.normal[0].data();
+		const float* ny = planes.normal[1].data();
+		const float* nz = planes.normal[2].data();
+		const float* distance = planes.distance.data();
+		const float ox = origin.x, oy = origin.y, oz = origin.z;
+		const float vx = diff.x, vy = diff.y, vz = diff.z;
+		//半直線の無限大は0を掛けると非数になるので、最大の有限の値に置き換える
+		const float tLimit = tMax < std::numeric_limits<float>::max() ? tMax : std::numeric_limits<float>::max();
+		for (size_t i = 0; i < count; i++) {
+			float dot = nx[i] * vx + ny[i] * vy + nz[i] * vz;
+			float s = distance[i] - (ox * nx[i] + oy * ny[i] + oz * nz[i]);
+			//t = s / dotが0からtMaxの間にあるかを、割らずに符号をそろえたsが0からtMax * |dot|の間にあるかで見る
+			//平行なら上限が0になり、平面上にあるときだけ当たる
+			float absDot = std::fabs(dot);
+			float signedS = dot < 0.0f ? -s : s;
+			float limit = tLimit * absDot;
+			float clamped = signedS > 0.0f ? signedS : 0.0f;
+			clamped = clamped < limit ? clamped : limit;
+			hits[i] = static_cast<uint8_t>(clamped == signedS);
+		}
+		return CountHits(hits, count);
+	}
+
+	/// <summary>
+	/// 直線とOBBの集合
+	/// </summary>
+	size_t IsCollisionLineOBBBatch(const Vector3& origin, const Vector3& diff, float tMax, const OBBSet& obbs, uint8_t* __restrict hits) {
+		const size_t count = obbs.Size();
+		const OBBSetView view(obbs);
+		const float ox = origin.x, oy = origin.y, oz = origin.z;
+		const float vx = diff.x, vy = diff.y, vz = diff.z;
+		for (size_t i = 0; i < count; i++) {
+			float dx = ox - view.center[0][i];
+			float dy = oy - view.center[1][i];
+			float dz = oz - view.center[2][i];
+			float tNear = 0.0f;
+			float tFar = tMax;
+			ClipOBBSlab(dx, dy, dz, vx, vy, vz, view.orientations[0][0][i], view.orientations[0][1][i], view.orientations[0][2][i], view.size[0][i], tNear, tFar);
+			ClipOBBSlab(dx, dy, dz, vx, vy, vz, view.orientations[1][0][i], view.orientations[1][1][i], view.orientations[1][2][i], view.size[1][i], tNear, tFar);
+			ClipOBBSlab(dx, dy, dz, vx, vy, vz, view.orientations[2][0][i], view.orientations[2][1][i], view.orientations[2][2][i], view.size[2][i], tNear, tFar);
+			hits[i] = static_cast<uint8_t>(tNear <= tFar);
+		}
+		return CountHits(hits, count);
+	}
+}
+
+//球と球
+bool Collision::IsCollision(const SphereData& sphere1, const SphereData& sphere2) {
+	Vector3 d = sphere2.center - sphere1.center;
+	float radius = sphere1.radius + sphere2.radius;
+	return d.Dot(d) <= radius * radius;
+}
+
+//球と平面
+bool Collision::IsCollision(const SphereData& sphere, const Plane& plane) {
+	float distance = std::fabs(plane.normal.Dot(sphere.center) - plane.distance);
+	return distance <= sphere.radius;
+}
+
+//球とAABB
+bool Collision::IsCollision(const SphereData& sphere, const AABB& aabb) {
+	Vector3 closestPoint = {
+		Clamp(sphere.center.x, aabb.min.x, aabb.max.x),
+		Clamp(sphere.center.y, aabb.min.y, aabb.max.y),
+		Clamp(sphere.center.z, aabb.min.z, aabb.max.z),
+	};
+	Vector3 d = closestPoint - sphere.center;
+	return d.Dot(d) <= sphere.radius * sphere.radius;
+}
+
+//球とOBB
+bool Collision::IsCollision(const SphereData& sphere, const OBB& obb) {
+	//OBBのローカル座標でAABBとして判定する
+	SphereData localSphere = { ToOBBLocal(sphere.center, obb), sphere.radius };
+	AABB localAABB = { -obb.size, obb.size };
+	return IsCollision(localSphere, localAABB);
+}
+
+//AABBとAABB
+bool Collision::IsCollision(const AABB& aabb1, const AABB& aabb2) {
+	return (aabb1.min.x <= aabb2.max.x && aabb1.max.x >= aabb2.min.x) &&
+		(aabb1.min.y <= aabb2.max.y && aabb1.max.y >= aabb2.min.y) &&
+		(aabb1.min.z <= aabb2.max.z && aabb1.max.z >= aabb2.min.z);
+}
+
+//OBBとOBB
+bool Collision::IsCollision(const OBB& obb1, const OBB& obb2) {
+	float r[3][3];
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			r[i][j] = obb1.orientations[i].Dot(obb2.orientations[j]);
+		}
+	}
+	Vector3 d = obb2.center - obb1.center;
+	const float t[3] = { d.Dot(obb1.orientations[0]), d.Dot(obb1.orientations[1]), d.Dot(obb1.orientations[2]) };
+	const float a[3] = { obb1.size.x,obb1.size.y,obb1.size.z };
+	const float b[3] = { obb2.size.x,obb2.size.y,obb2.size.z };
+	return !IsSeparatedOBB<true>(r, t, a, b);
+}
+
+//半直線と球
+bool Collision::IsCollision(const Ray& ray, const SphereData& sphere) {
+	return IsCollisionLineSphere(ray.origin, ray.diff, std::numeric_limits<float>::infinity(), sphere);
+}
+
+//半直線と平面
+bool Collision::IsCollision(const Ray& ray, const Plane& plane) {
+	return IsCollisionLinePlane(ray.origin, ray.diff, std::numeric_limits<float>::infinity(), plane);
+}
+
+//半直線とAABB
+bool Collision::IsCollision(const Ray& ray, const AABB& aabb) {
+	return IsCollisionLineAABB(ray.origin, ray.diff, std::numeric_limits<float>::infinity(), aabb);
+}
+
+//半直線とOBB
+bool Collision::IsCollision(const Ray& ray, const OBB& obb) {
+	return IsCollisionLineOBB(ray.origin, ray.diff, std::numeric_limits<float>::infinity(), obb);
+}
+
+//線分と球
+bool Collision::IsCollision(const Segment& segment, const SphereData& sphere) {
+	return IsCollisionLineSphere(segment.origin, segment.diff, 1.0f, sphere);
+}
+
+//線分と平面
+bool Collision::IsCollision(const Segment& segment, const Plane& plane) {
+	return IsCollisionLinePlane(segment.origin, segment.diff, 1.0f, plane);
+}
+
+//線分とAABB
+bool Collision::IsCollision(const Segment& segment, const AABB& aabb) {
+	return IsCollisionLineAABB(segment.origin, segment.diff, 1.0f, aabb);
+}
+
+//線分とOBB
+bool Collision::IsCollision(const Segment& segment, const OBB& obb) {
+	return IsCollisionLineOBB(segment.origin, segment.diff, 1.0f, obb);
+}
+
+//視錐台とAABB
+bool Collision::IsCollision(const Frustum& frustum, const AABB& aabb) {
+	for (const Plane& plane : frustum.planes) {
+		//法線方向に一番進んだ頂点が外側なら全体が外側
+		Vector3 positive = {
+			plane.normal.x >= 0.0f ? aabb.max.x : aabb.min.x,
+			plane.normal.y >= 0.0f ? aabb.max.y : aabb.min.y,
+			plane.normal.z >= 0.0f ? aabb.max.z : aabb.min.z,
+		};
+		if (plane.normal.Dot(positive) < plane.distance) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//球を囲むAABB
+AABB Collision::ComputeAABB(const SphereData& sphere) {
+	Vector3 extent = { sphere.radius,sphere.radius,sphere.radius };
+	return { sphere.center - extent, sphere.center + extent };
+}
+
+//OBBを囲むAABB
+AABB Collision::ComputeAABB(const OBB& obb) {
+	//各軸の寄与の絶対値を足すと、ワールド軸方向の半分の長さになる
+	Vector3 extent = {
+		std::fabs(obb.orientations[0].x) * obb.size.x + std::fabs(obb.orientations[1].x) * obb.size.y + std::fabs(obb.orientations[2].x) * obb.size.z,
+		std::fabs(obb.orientations[0].y) * obb.size.x + std::fabs(obb.orientations[1].y) * obb.size.y + std::fabs(obb.orientations[2].y) * obb.size.z,
+		std::fabs(obb.orientations[0].z) * obb.size.x + std::fabs(obb.orientations[1].z) * obb.size.y + std::fabs(obb.orientations[2].z) * obb.size.z,
+	};
+	return { obb.center - extent, obb.center + extent };
+}
+
+//球と球の集合
+size_t Collision::IsCollisionBatch(const SphereData& sphere, const SphereSet& spheres, uint8_t* hits) {
+	const size_t count = spheres.Size();
+	const float* cx = spheres.center[0].data();
+	const float* cy = spheres.center[1].data();
+	const float* cz = spheres.center[2].data();
+	const float* radius = spheres.radius.data();
+	const float sx = sphere.center.x, sy = sphere.center.y, sz = sphere.center.z, sr = sphere.radius;
+	for (size_t i = 0; i < count; i++) {
+		float dx = cx[i] - sx;
+		float dy = cy[i] - sy;
+		float dz = cz[i] - sz;
+		float r = radius[i] + sr;
+		hits[i] = static_cast<uint8_t>(dx * dx + dy * dy + dz * dz <= r * r);
+	}
+	return CountHits(hits, count);
+}
+
+//球と平面の集合
+size_t Collision::IsCollisionBatch(const SphereData& sphere, const PlaneSet& planes, uint8_t* hits) {
+	const size_t count = planes.Size();
+	const float* nx = planes.normal[0].data();
+	const float* ny = planes.normal[1].data();
+	const float* nz = planes.normal[2].data();
+	const float* distance = planes.distance.data();
+	const float sx = sphere.center.x, sy = sphere.center.y, sz = sphere.center.z, sr = sphere.radius;
+	for (size_t i = 0; i < count; i++) {
+		float d = nx[i] * sx + ny[i] * sy + nz[i] * sz - distance[i];
+		hits[i] = static_cast<uint8_t>(std::fabs(d) <= sr);
+	}
+	return CountHits(hits, count);
+}
+
+//球とAABBの集合
+size_t Collision::IsCollisionBatch(const SphereData& sphere, const AABBSet& aabbs, uint8_t* hits) {
+	const size_t count = aabbs.Size();
+	const float* minX = aabbs.min[0].data();
+	const float* minY = aabbs.min[1].data();
+	const float* minZ = aabbs.min[2].data();
+	const float* maxX = aabbs.max[0].data();
+	const float* maxY = aabbs.max[1].data();
+	const float* maxZ = aabbs.max[2].data();
+	const float sx = sphere.center.x, sy = sphere.center.y, sz = sphere.center.z;
+	const float radiusSquared = sphere.radius * sphere.radius;
+	for (size_t i = 0; i < count; i++) {
+		float dx = Clamp(sx, minX[i], maxX[i]) - sx;
+		float dy = Clamp(sy, minY[i], maxY[i]) - sy;
+		float dz = Clamp(sz, minZ[i], maxZ[i]) - sz;
+		hits[i] = static_cast<uint8_t>(dx * dx + dy * dy + dz * dz <= radiusSquared);
+	}
+	return CountHits(hits, count);
+}
+
+//球とOBBの集合
+size_t Collision::IsCollisionBatch(const SphereData& sphere, const OBBSet& obbs, uint8_t* __restrict hits) {
+	const size_t count = obbs.Size();
+	const OBBSetView view(obbs);
+	const float sx = sphere.center.x, sy = sphere.center.y, sz = sphere.center.z;
+	const float radiusSquared = sphere.radius * sphere.radius;
+	for (size_t i = 0; i < count; i++) {
+		float dx = sx - view.center[0][i];
+		float dy = sy - view.center[1][i];
+		float dz = sz - view.center[2][i];
+		//ローカル座標で最近接点までの距離を足していく
+		float distanceSquared =
+			OBBAxisExcessSquared(dx, dy, dz, view.orientations[0][0][i], view.orientations[0][1][i], view.orientations[0][2][i], view.size[0][i]) +
+			OBBAxisExcessSquared(dx, dy, dz, view.orientations[1][0][i], view.orientations[1][1][i], view.orientations[1][2][i], view.size[1][i]) +
+			OBBAxisExcessSquared(dx, dy, dz, view.orientations[2][0][i], view.orientations[2][1][i], view.orientations[2][2][i], view.size[2][i]);
+		hits[i] = static_cast<uint8_t>(distanceSquared <= radiusSquared);
+	}
+	return CountHits(hits, count);
+}
+
+//AABBとAABBの集合
+size_t Collision::IsCollisionBatch(const AABB& aabb, const AABBSet& aabbs, uint8_t* hits) {
+	const size_t count = aabbs.Size();
+	const float* minX = aabbs.min[0].data();
+	const float* minY = aabbs.min[1].data();
+	const float* minZ = aabbs.min[2].data();
+	const float* maxX = aabbs.max[0].data();
+	const float* maxY = aabbs.max[1].data();
+	const float* maxZ = aabbs.max[2].data();
+	const float queryMinX = aabb.min.x, queryMinY = aabb.min.y, queryMinZ = aabb.min.z;
+	const float queryMaxX = aabb.max.x, queryMaxY = aabb.max.y, queryMaxZ = aabb.max.z;
+	for (size_t i = 0; i < count; i++) {
+		hits[i] = static_cast<uint8_t>(
+			(queryMinX <= maxX[i]) & (queryMaxX >= minX[i]) &
+			(queryMinY <= maxY[i]) & (queryMaxY >= minY[i]) &
+			(queryMinZ <= maxZ[i]) & (queryMaxZ >= minZ[i]));
+	}
+	return CountHits(hits, count);
+}
+
+//OBBとOBBの集合
+size_t Collision::IsCollisionBatch(const OBB& obb, const OBBSet& obbs, uint8_t* __restrict hits) {
+	const size_t count = obbs.Size();
+	const OBBSetView view(obbs);
+	const float a[3] = { obb.size.x,obb.size.y,obb.size.z };
+	const float a0x = obb.orientations[0].x, a0y = obb.orientations[0].y, a0z = obb.orientations[0].z;
+	const float a1x = obb.orientations[1].x, a1y = obb.orientations[1].y, a1z = obb.orientations[1].z;
+	const float a2x = obb.orientations[2].x, a2y = obb.orientations[2].y, a2z = obb.orientations[2].z;
+	const float cx = obb.center.x, cy = obb.center.y, cz = obb.center.z;
+	for (size_t i = 0; i < count; i++) {
+		const float b0x = view.orientations[0][0][i], b0y = view.orientations[0][1][i], b0z = view.orientations[0][2][i];
+		const float b1x = view.orientations[1][0][i], b1y = view.orientations[1][1][i], b1z = view.orientations[1][2][i];
+		const float b2x = view.orientations[2][0][i], b2y = view.orientations[2][1][i], b2z = view.orientations[2][2][i];
+		const float r[3][3] = {
+			{ a0x * b0x + a0y * b0y + a0z * b0z, a0x * b1x + a0y * b1y + a0z * b1z, a0x * b2x + a0y * b2y + a0z * b2z },
+			{ a1x * b0x + a1y * b0y + a1z * b0z, a1x * b1x + a1y * b1y + a1z * b1z, a1x * b2x + a1y * b2y + a1z * b2z },
+			{ a2x * b0x + a2y * b0y + a2z * b0z, a2x * b1x + a2y * b1y + a2z * b1z, a2x * b2x + a2y * b2y + a2z * b2z },
+		};
+		float dx = view.center[0][i] - cx;
+		float dy = view.center[1][i] - cy;
+		float dz = view.center[2][i] - cz;
+		const float t[3] = {
+			dx * a0x + dy * a0y + dz * a0z,
+			dx * a1x + dy * a1y + dz * a1z,
+			dx * a2x + dy * a2y + dz * a2z,
+		};
+		const float b[3] = { view.size[0][i],view.size[1][i],view.size[2][i] };
+		hits[i] = static_cast<uint8_t>(!IsSeparatedOBB<false>(r, t, a, b));
+	}
+	return CountHits(hits, count);
+}
+
+//半直線と球の集合
+size_t Collision::IsCollisionBatch(const Ray& ray, const SphereSet& spheres, uint8_t* hits) {
+	return IsCollisionLineSphereBatch(ray.origin, ray.diff, std::numeric_limits<float>::infinity(), spheres, hits);
+}
+
+//半直線と平面の集合
+size_t Collision::IsCollisionBatch(const Ray& ray, const PlaneSet& planes, uint8_t* hits) {
+	return IsCollisionLinePlaneBatch(ray.origin, ray.diff, std::numeric_limits<float>::infinity(), planes, hits);
+}
+
+//半直線とAABBの集合
+size_t Collision::IsCollisionBatch(const Ray& ray, const AABBSet& aabbs, uint8_t* hits) {
+	return IsCollisionLineAABBBatch(ray.origin, ray.diff, std::numeric_limits<float>::infinity(), aabbs, hits);
+}
+
+//半直線とOBBの集合
+size_t Collision::IsCollisionBatch(const Ray& ray, const OBBSet& obbs, uint8_t* hits) {
+	return IsCollisionLineOBBBatch(ray.origin, ray.diff, std::numeric_limits<float>::infinity(), obbs, hits);
+}
+
+//線分と球の集合
+size_t Collision::IsCollisionBatch(const Segment& segment, const SphereSet& spheres, uint8_t* hits) {
+	return IsCollisionLineSphereBatch(segment.origin, segment.diff, 1.0f, spheres, hits);
+}
+
+//線分と平面の集合
+size_t Collision::IsCollisionBatch(const Segment& segment, const PlaneSet& planes, uint8_t* hits) {
+	return IsCollisionLinePlaneBatch(segment.origin, segment.diff, 1.0f, planes, hits);
+}
+
+//線分とAABBの集合
+size_t Collision::IsCollisionBatch(const Segment& segment, const AABBSet& aabbs, uint8_t* hits) {
+	return IsCollisionLineAABBBatch(segment.origin, segment.diff, 1.0f, aabbs, hits);
+}
+
+//線分とOBBの集合
+size_t Collision::IsCollisionBatch(const Segment& segment, const OBBSet& obbs, uint8_t* hits) {
+	return IsCollisionLineOBBBatch(segment.origin, segment.diff, 1.0f, obbs, hits);
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include "Shape.h"
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 衝突判定
+/// </summary>
+/// <remarks>
+/// 一括判定(IsCollisionBatch)は1つの形状と集合の全要素を判定し、hitsに要素ごとの結果(0か1)を書き込んで当たった数を返す。
+/// 集合は成分ごとに並んでいるので、ループは分岐なしでベクトル化される
+/// </remarks>
+class Collision {
+public://メンバ関数
+	/// <summary>
+	/// 球と球
+	/// </summary>
+	static bool IsCollision(const SphereData& sphere1, const SphereData& sphere2);
+
+	/// <summary>
+	/// 球と平面
+	/// </summary>
+	static bool IsCollision(const SphereData& sphere, const Plane& plane);
+
+	/// <summary>
+	/// 球とAABB
+	/// </summary>
+	static bool IsCollision(const SphereData& sphere, const AABB& aabb);
+
+	/// <summary>
+	/// 球とOBB
+	/// </summary>
+	static bool IsCollision(const SphereData& sphere, const OBB& obb);
+
+	/// <summary>
+	/// AABBとAABB
+	/// </summary>
+	static bool IsCollision(const AABB& aabb1, const AABB& aabb2);
+
+	/// <summary>
+	/// OBBとOBB(15軸の分離軸判定、分離軸が見つかった時点で終了)
+	/// </summary>
+	static bool IsCollision(const OBB& obb1, const OBB& obb2);
+
+	/// <summary>
+	/// 半直線と球
+	/// </summary>
+	static bool IsCollision(const Ray& ray, const SphereData& sphere);
+
+	/// <summary>
+	/// 半直線と平面
+	/// </summary>
+	static bool IsCollision(const Ray& ray, const Plane& plane);
+
+	/// <summary>
+	/// 半直線とAABB
+	/// </summary>
+	static bool IsCollision(const Ray& ray, const AABB& aabb);
+
+	/// <summary>
+	/// 半直線とOBB
+	/// </summary>
+	static bool IsCollision(const Ray& ray, const OBB& obb);
+
+	/// <summary>
+	/// 線分と球
+	/// </summary>
+	static bool IsCollision(const Segment& segment, const SphereData& sphere);
+
+	/// <summary>
+	/// 線分と平面
+	/// </summary>
+	static bool IsCollision(const Segment& segment, const Plane& plane);
+
+	/// <summary>
+	/// 線分とAABB
+	/// </summary>
+	static bool IsCollision(const Segment& segment, const AABB& aabb);
+
+	/// <summary>
+	/// 線分とOBB
+	/// </summary>
+	static bool IsCollision(const Segment& segment, const OBB& obb);
+
+	/// <summary>
+	/// 視錐台とAABB(AABBが少しでも内側にあれば当たり)
+	/// </summary>
+	static bool IsCollision(const Frustum& frustum, const AABB& aabb);
+
+	/// <summary>
+	/// 球を囲むAABB
+	/// </summary>
+	static AABB ComputeAABB(const SphereData& sphere);
+
+	/// <summary>
+	/// OBBを囲むAABB
+	/// </summary>
+	static AABB ComputeAABB(const OBB& obb);
+
+	/// <summary>
+	/// 球と球の集合
+	/// </summary>
+	/// <param name="sphere">球</param>
+	/// <param name="spheres">球の集合</param>
+	/// <param name="hits">結果の書き込み先(spheres.Size()個)</param>
+	/// <returns>当たった数</returns>
+	static size_t IsCollisionBatch(const SphereData& sphere, const SphereSet& spheres, uint8_t* hits);
+
+	/// <summary>
+	/// 球と平面の集合
+	/// </summary>
+	static size_t IsCollisionBatch(const SphereData& sphere, const PlaneSet& planes, uint8_t* hits);
+
+	/// <summary>
+	/// 球とAABBの集合
+	/// </summary>
+	static size_t IsCollisionBatch(const SphereData& sphere, const AABBSet& aabbs, uint8_t* hits);
+
+	/// <summary>
+	/// 球とOBBの集合
+	/// </summary>
+	static size_t IsCollisionBatch(const SphereData& sphere, const OBBSet& obbs, uint8_t* hits);
+
+	/// <summary>
+	/// AABBとAABBの集合
+	/// </summary>
+	static size_t IsCollisionBatch(const AABB& aabb, const AABBSet& aabbs, uint8_t* hits);
+
+	/// <summary>
+	/// OBBとOBBの集合(15軸をすべて判定して分岐をなくしている)
+	/// </summary>
+	static size_t IsCollisionBatch(const OBB& obb, const OBBSet& obbs, uint8_t* hits);
+
+	/// <summary>
+	/// 半直線と球の集合
+	/// </summary>
+	static size_t IsCollisionBatch(const Ray& ray, const SphereSet& spheres, uint8_t* hits);
+
+	/// <summary>
+	/// 半直線と平面の集合
+	/// </summary>
+	static size_t IsCollisionBatch(const Ray& ray, const PlaneSet& planes, uint8_t* hits);
+
+	/// <summary>
+	/// 半直線とAABBの集合
+	/// </summary>
+	static size_t IsCollisionBatch(const Ray& ray, const AABBSet& aabbs, uint8_t* hits);
+
+	/// <summary>
+	/// 半直線とOBBの集合
+	/// </summary>
+	static size_t IsCollisionBatch(const Ray& ray, const OBBSet& obbs, uint8_t* hits);
+
+	/// <summary>
+	/// 線分と球の集合
+	/// </summary>
+	static size_t IsCollisionBatch(const Segment& segment, const SphereSet& spheres, uint8_t* hits);
+
+	/// <summary>
+	/// 線分と平面の集合
+	/// </summary>
+	static size_t IsCollisionBatch(const Segment& segment, const PlaneSet& planes, uint8_t* hits);
+
+	/// <summary>
+	/// 線分とAABBの集合
+	/// </summary>
+	static size_t IsCollisionBatch(const Segment& segment, const AABBSet& aabbs, uint8_t* hits);
+
+	/// <summary>
+	/// 線分とOBBの集合
+	/// </summary>
+	static size_t IsCollisionBatch(const Segment& segment, const OBBSet& obbs, uint8_t* hits);
+};
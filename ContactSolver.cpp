@@ -0,0 +1,897 @@
+#include "ContactSolver.h"
+#include "MemoryTracker.h"
+#include "Collision.h"
+#include "JobSystem.h"
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace {
+	//0とみなす長さの2乗
+	const float kZeroLengthSquared = 1.0e-12f;
+	//平行な辺の外積を捨てる長さ
+	const float kParallelEdgeLength = 1.0e-4f;
+	//面の軸を優先する割合(わずかな差で面と辺が入れ替わって接触点が飛ばないように)
+	const float kRelativeTolerance = 0.98f;
+	const float kAbsoluteTolerance = 0.001f;
+	//辺どうしの特徴番号の印
+	const uint32_t kEdgeFeature = 0x01000000u;
+	//空きの素集合
+	const uint32_t kNullIndex = 0xFFFFFFFFu;
+
+	/// <summary>
+	/// 成分を配列で取り出す
+	/// </summary>
+	float GetComponent(const Vector3& v, int axis) {
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+
+	/// <summary>
+	/// 法線と垂直な2方向
+	/// </summary>
+	void ComputeTangents(const Vector3& normal, Vector3 tangents[2]) {
+		if (std::fabs(normal.x) >= 0.57735f) {
+			tangents[0] = Vector3{ normal.y,-normal.x,0.0f }.Normalize();
+		} else {
+			tangents[0] = Vector3{ 0.0f,normal.z,-normal.y }.Normalize();
+		}
+		tangents[1] = normal.Cross(tangents[0]);
+	}
+
+	/// <summary>
+	/// 剛体の位置と姿勢からOBB
+	/// </summary>
+	OBB MakeOBB(const Vector3& position, const Quaternion& orientation, const Vector3& size) {
+		OBB obb = {};
+		obb.center = position;
+		obb.orientations[0] = orientation.Rotate({ 1.0f,0.0f,0.0f });
+		obb.orientations[1] = orientation.Rotate({ 0.0f,1.0f,0.0f });
+		obb.orientations[2] = orientation.Rotate({ 0.0f,0.0f,1.0f });
+		obb.size = size;
+		return obb;
+	}
+
+	/// <summary>
+	/// 切り取り中の頂点
+	/// </summary>
+	struct ClipVertex {
+		Vector3 position;
+		uint32_t id;
+	};
+
+	/// <summary>
+	/// 多角形を平面(normal・x <= offset)で切り取る
+	/// </summary>
+	/// <returns>残った頂点数</returns>
+	int ClipPolygon(const ClipVertex* input, int inputCount, const Vector3& normal, float offset, uint32_t planeIndex, ClipVertex* output) {
+		int outputCount = 0;
+		for (int i = 0; i < inputCount; i++) {
+			const ClipVertex& current = input[i];
+			const ClipVertex& next = input[(i + 1) % inputCount];
+			float currentDistance = normal.Dot(current.position) - offset;
+			float nextDistance = normal.Dot(next.position) - offset;
+			if (currentDistance <= 0.0f) {
+				output[outputCount++] = current;
+			}
+			//辺が平面をまたぐなら交点を足す(どの平面とどの辺からできたかを番号にする)
+			if ((currentDistance <= 0.0f) != (nextDistance <= 0.0f)) {
+				float t = currentDistance / (currentDistance - nextDistance);
+				ClipVertex vertex = {};
+				vertex.position = current.position + (next.position - current.position) * t;
+				vertex.id = ((planeIndex + 1) << 12) | ((current.id & 0x3Fu) << 6) | (next.id & 0x3Fu);
+				output[outputCount++] = vertex;
+			}
+		}
+		return outputCount;
+	}
+
+	/// <summary>
+	/// 5点以上の接触点を4点に減らす(一番深い点、そこから一番遠い点、その2点の両側で一番面積を広げる点)
+	/// </summary>
+	void ReduceManifold(ContactSolver::ContactPoint* points, uint32_t& count, const Vector3& normal) {
+		if (count <= ContactSolver::kMaxManifoldPoints) {
+			return;
+		}
+		uint32_t chosen[4] = {};
+		chosen[0] = 0;
+		for (uint32_t i = 1; i < count; i++) {
+			if (points[i].separation < points[chosen[0]].separation) {
+				chosen[0] = i;
+			}
+		}
+		float farthest = -1.0f;
+		for (uint32_t i = 0; i < count; i++) {
+			Vector3 diff = points[i].position - points[chosen[0]].position;
+			float distanceSquared = diff.Dot(diff);
+			if (distanceSquared > farthest) {
+				farthest = distanceSquared;
+				chosen[1] = i;
+			}
+		}
+		float maxArea = -std::numeric_limits<float>::infinity();
+		float minArea = std::numeric_limits<float>::infinity();
+		chosen[2] = chosen[0];
+		chosen[3] = chosen[1];
+		Vector3 edge = points[chosen[1]].position - points[chosen[0]].position;
+		for (uint32_t i = 0; i < count; i++) {
+			float area = edge.Cross(points[i].position - points[chosen[0]].position).Dot(normal);
+			if (area > maxArea) {
+				maxArea = area;
+				chosen[2] = i;
+			}
+			if (area < minArea) {
+				minArea = area;
+				chosen[3] = i;
+			}
+		}
+		ContactSolver::ContactPoint reduced[4];
+		uint32_t reducedCount = 0;
+		for (uint32_t index : chosen) {
+			bool isDuplicate = false;
+			for (uint32_t j = 0; j < reducedCount; j++) {
+				isDuplicate = isDuplicate || reduced[j].featureId == points[index].featureId;
+			}
+			if (!isDuplicate) {
+				reduced[reducedCount++] = points[index];
+			}
+		}
+		for (uint32_t i = 0; i < reducedCount; i++) {
+			points[i] = reduced[i];
+		}
+		count = reducedCount;
+	}
+
+	/// <summary>
+	/// 2本の線分の最近点のパラメータ
+	/// </summary>
+	void ClosestSegmentParameters(const Vector3& originA, const Vector3& directionA, float halfLengthA,
+		const Vector3& originB, const Vector3& directionB, float halfLengthB, float& s, float& u) {
+		Vector3 w = originA - originB;
+		float b = directionA.Dot(directionB);
+		float d = directionA.Dot(w);
+		float e = directionB.Dot(w);
+		float denominator = 1.0f - b * b;
+		s = denominator > kZeroLengthSquared ? (b * e - d) / denominator : 0.0f;
+		s = s < -halfLengthA ? -halfLengthA : (s > halfLengthA ? halfLengthA : s);
+		u = e + b * s;
+		u = u < -halfLengthB ? -halfLengthB : (u > halfLengthB ? halfLengthB : u);
+		s = -d + b * u;
+		s = s < -halfLengthA ? -halfLengthA : (s > halfLengthA ? halfLengthA : s);
+	}
+}
+
+//球と球の接触点
+void ContactSolver::Collide(const SphereData& sphereA, const SphereData& sphereB, ContactManifold& manifold) {
+	manifold.pointCount = 0;
+	Vector3 diff = sphereB.center - sphereA.center;
+	float distanceSquared = diff.Dot(diff);
+	float radiusSum = sphereA.radius + sphereB.radius + kSpeculativeDistance;
+	if (distanceSquared > radiusSum * radiusSum) {
+		return;
+	}
+	float distance = std::sqrt(distanceSquared);
+	manifold.normal = distance > 0.0f ? diff * (1.0f / distance) : Vector3{ 0.0f,1.0f,0.0f };
+	ContactPoint& point = manifold.points[manifold.pointCount++];
+	point = {};
+	point.separation = distance - sphereA.radius - sphereB.radius;
+	point.position = sphereA.center + manifold.normal * (sphereA.radius + point.separation * 0.5f);
+}
+
+//球とOBBの接触点
+void ContactSolver::Collide(const SphereData& sphere, const OBB& obb, ContactManifold& manifold) {
+	manifold.pointCount = 0;
+	Vector3 d = sphere.center - obb.center;
+	float local[3] = {};
+	float clamped[3] = {};
+	bool isInside = true;
+	Vector3 closest = obb.center;
+	for (int i = 0; i < 3; i++) {
+		float size = GetComponent(obb.size, i);
+		local[i] = d.Dot(obb.orientations[i]);
+		clamped[i] = local[i] < -size ? -size : (local[i] > size ? size : local[i]);
+		isInside = isInside && clamped[i] == local[i];
+		closest += obb.orientations[i] * clamped[i];
+	}
+
+	ContactPoint point = {};
+	if (!isInside) {
+		Vector3 diff = sphere.center - closest;
+		float distance = std::sqrt(diff.Dot(diff));
+		point.separation = distance - sphere.radius;
+		if (point.separation > kSpeculativeDistance) {
+			return;
+		}
+		//球からOBBへ向ける
+		manifold.normal = diff * (-1.0f / distance);
+		point.position = (sphere.center + manifold.normal * sphere.radius + closest) * 0.5f;
+	} else {
+		//中心が中にあれば、一番近い面から押し出す
+		int axis = 0;
+		float minDepth = std::numeric_limits<float>::infinity();
+		for (int i = 0; i < 3; i++) {
+			float depth = GetComponent(obb.size, i) - std::fabs(local[i]);
+			if (depth < minDepth) {
+				minDepth = depth;
+				axis = i;
+			}
+		}
+		Vector3 outward = obb.orientations[axis] * (local[axis] >= 0.0f ? 1.0f : -1.0f);
+		manifold.normal = -outward;
+		point.separation = -minDepth - sphere.radius;
+		point.position = (sphere.center + manifold.normal * sphere.radius + sphere.center + outward * minDepth) * 0.5f;
+	}
+	manifold.points[manifold.pointCount++] = point;
+}
+
+//OBBとOBBの接触点
+void ContactSolver::Collide(const OBB& obbA, const OBB& obbB, ContactManifold& manifold) {
+	manifold.pointCount = 0;
+	const Vector3 d = obbB.center - obbA.center;
+	const float sizeA[3] = { obbA.size.x,obbA.size.y,obbA.size.z };
+	const float sizeB[3] = { obbB.size.x,obbB.size.y,obbB.size.z };
+	float absR[3][3] = {};
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			absR[i][j] = std::fabs(obbA.orientations[i].Dot(obbB.orientations[j])) + 1.0e-6f;
+		}
+	}
+
+	//Aの面の軸
+	float faceSeparationA = -std::numeric_limits<float>::infinity();
+	int faceAxisA = 0;
+	for (int i = 0; i < 3; i++) {
+		float radiusB = sizeB[0] * absR[i][0] + sizeB[1] * absR[i][1] + sizeB[2] * absR[i][2];
+		float separation = std::fabs(d.Dot(obbA.orientations[i])) - sizeA[i] - radiusB;
+		if (separation > kSpeculativeDistance) {
+			return;
+		}
+		if (separation > faceSeparationA) {
+			faceSeparationA = separation;
+			faceAxisA = i;
+		}
+	}
+	//Bの面の軸
+	float faceSeparationB = -std::numeric_limits<float>::infinity();
+	int faceAxisB = 0;
+	for (int j = 0; j < 3; j++) {
+		float radiusA = sizeA[0] * absR[0][j] + sizeA[1] * absR[1][j] + sizeA[2] * absR[2][j];
+		float separation = std::fabs(d.Dot(obbB.orientations[j])) - sizeB[j] - radiusA;
+		if (separation > kSpeculativeDistance) {
+			return;
+		}
+		if (separation > faceSeparationB) {
+			faceSeparationB = separation;
+			faceAxisB = j;
+		}
+	}
+	//辺と辺の軸
+	float edgeSeparation = -std::numeric_limits<float>::infinity();
+	int edgeAxisA = 0;
+	int edgeAxisB = 0;
+	Vector3 edgeNormal = {};
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			Vector3 axis = obbA.orientations[i].Cross(obbB.orientations[j]);
+			float length = std::sqrt(axis.Dot(axis));
+			if (length < kParallelEdgeLength) {
+				continue;
+			}
+			axis = axis * (1.0f / length);
+			float radiusA = 0.0f;
+			float radiusB = 0.0f;
+			for (int k = 0; k < 3; k++) {
+				radiusA += sizeA[k] * std::fabs(obbA.orientations[k].Dot(axis));
+				radiusB += sizeB[k] * std::fabs(obbB.orientations[k].Dot(axis));
+			}
+			float separation = std::fabs(d.Dot(axis)) - radiusA - radiusB;
+			if (separation > kSpeculativeDistance) {
+				return;
+			}
+			if (separation > edgeSeparation) {
+				edgeSeparation = separation;
+				edgeAxisA = i;
+				edgeAxisB = j;
+				edgeNormal = d.Dot(axis) >= 0.0f ? axis : -axis;
+			}
+		}
+	}
+
+	//面どうしを優先する
+	bool isReferenceB = faceSeparationB > kRelativeTolerance * faceSeparationA + kAbsoluteTolerance;
+	float faceSeparation = isReferenceB ? faceSeparationB : faceSeparationA;
+	if (edgeSeparation > kRelativeTolerance * faceSeparation + kAbsoluteTolerance) {
+		//辺どうしは最近点を1つだけ
+		Vector3 edgeA = obbA.center;
+		Vector3 edgeB = obbB.center;
+		for (int k = 0; k < 3; k++) {
+			if (k != edgeAxisA) {
+				edgeA += obbA.orientations[k] * (edgeNormal.Dot(obbA.orientations[k]) >= 0.0f ? sizeA[k] : -sizeA[k]);
+			}
+			if (k != edgeAxisB) {
+				edgeB += obbB.orientations[k] * (edgeNormal.Dot(obbB.orientations[k]) >= 0.0f ? -sizeB[k] : sizeB[k]);
+			}
+		}
+		float s = 0.0f;
+		float u = 0.0f;
+		ClosestSegmentParameters(edgeA, obbA.orientations[edgeAxisA], sizeA[edgeAxisA],
+			edgeB, obbB.orientations[edgeAxisB], sizeB[edgeAxisB], s, u);
+		Vector3 closestA = edgeA + obbA.orientations[edgeAxisA] * s;
+		Vector3 closestB = edgeB + obbB.orientations[edgeAxisB] * u;
+		manifold.normal = edgeNormal;
+		ContactPoint& point = manifold.points[manifold.pointCount++];
+		point = {};
+		point.position = (closestA + closestB) * 0.5f;
+		point.separation = (closestB - closestA).Dot(edgeNormal);
+		point.featureId = kEdgeFeature | static_cast<uint32_t>(edgeAxisA * 3 + edgeAxisB);
+		return;
+	}
+
+	//基準の面と、それに一番向き合う相手の面
+	const OBB& reference = isReferenceB ? obbB : obbA;
+	const OBB& incident = isReferenceB ? obbA : obbB;
+	const float* referenceSize = isReferenceB ? sizeB : sizeA;
+	const float* incidentSize = isReferenceB ? sizeA : sizeB;
+	const int referenceAxis = isReferenceB ? faceAxisB : faceAxisA;
+	const bool isReferencePositive = (incident.center - reference.center).Dot(reference.orientations[referenceAxis]) >= 0.0f;
+	const Vector3 referenceNormal = reference.orientations[referenceAxis] * (isReferencePositive ? 1.0f : -1.0f);
+
+	int incidentAxis = 0;
+	float maxDot = -1.0f;
+	for (int j = 0; j < 3; j++) {
+		float dot = std::fabs(incident.orientations[j].Dot(referenceNormal));
+		if (dot > maxDot) {
+			maxDot = dot;
+			incidentAxis = j;
+		}
+	}
+	const bool isIncidentPositive = incident.orientations[incidentAxis].Dot(referenceNormal) < 0.0f;
+	const Vector3 incidentCenter = incident.center + incident.orientations[incidentAxis] * (isIncidentPositive ? incidentSize[incidentAxis] : -incidentSize[incidentAxis]);
+	const int incidentU = (incidentAxis + 1) % 3;
+	const int incidentV = (incidentAxis + 2) % 3;
+	const Vector3 edgeU = incident.orientations[incidentU] * incidentSize[incidentU];
+	const Vector3 edgeV = incident.orientations[incidentV] * incidentSize[incidentV];
+
+	//相手の面の4頂点を、基準の面の4つの側面で切り取る
+	ClipVertex polygon[16] = {
+		{ incidentCenter + edgeU + edgeV, 0 },
+		{ incidentCenter - edgeU + edgeV, 1 },
+		{ incidentCenter - edgeU - edgeV, 2 },
+		{ incidentCenter + edgeU - edgeV, 3 },
+	};
+	ClipVertex clipped[16];
+	int polygonCount = 4;
+	uint32_t planeIndex = 0;
+	for (int side = 1; side <= 2; side++) {
+		const int axis = (referenceAxis + side) % 3;
+		const Vector3& sideNormal = reference.orientations[axis];
+		const float centerOffset = sideNormal.Dot(reference.center);
+		polygonCount = ClipPolygon(polygon, polygonCount, sideNormal, centerOffset + referenceSize[axis], planeIndex++, clipped);
+		if (polygonCount == 0) {
+			return;
+		}
+		polygonCount = ClipPolygon(clipped, polygonCount, -sideNormal, -centerOffset + referenceSize[axis], planeIndex++, polygon);
+		if (polygonCount == 0) {
+			return;
+		}
+	}
+
+	//基準の面より下(と少し上)の点を残す
+	const float referenceOffset = referenceNormal.Dot(reference.center) + referenceSize[referenceAxis];
+	const uint32_t featureBase = (isReferenceB ? 1u << 23 : 0u) | (static_cast<uint32_t>(referenceAxis) << 21) | (isReferencePositive ? 1u << 20 : 0u) |
+		(static_cast<uint32_t>(incidentAxis) << 18) | (isIncidentPositive ? 1u << 17 : 0u);
+	ContactPoint points[16];
+	uint32_t pointCount = 0;
+	for (int i = 0; i < polygonCount; i++) {
+		float separation = referenceNormal.Dot(polygon[i].position) - referenceOffset;
+		if (separation > kSpeculativeDistance) {
+			continue;
+		}
+		ContactPoint& point = points[pointCount++];
+		point = {};
+		point.separation = separation;
+		point.position = polygon[i].position - referenceNormal * (separation * 0.5f);
+		point.featureId = featureBase | (polygon[i].id & 0xFFFFu);
+	}
+	ReduceManifold(points, pointCount, referenceNormal);
+	manifold.normal = isReferenceB ? -referenceNormal : referenceNormal;
+	manifold.pointCount = pointCount;
+	for (uint32_t i = 0; i < pointCount; i++) {
+		manifold.points[i] = points[i];
+	}
+}
+
+//剛体に球の形状を付ける
+void ContactSolver::AddSphere(const RigidBodyWorld& world, RigidBodyWorld::BodyHandle body, float radius, float friction) {
+	AddShape(world, body, false, { radius,radius,radius }, friction);
+}
+
+//剛体にOBBの形状を付ける
+void ContactSolver::AddBox(const RigidBodyWorld& world, RigidBodyWorld::BodyHandle body, const Vector3& size, float friction) {
+	AddShape(world, body, true, size, friction);
+}
+
+//形状の登録
+void ContactSolver::AddShape(const RigidBodyWorld& world, RigidBodyWorld::BodyHandle body, bool isBox, const Vector3& size, float friction) {
+	assert(world.IsValid(body));
+	if (shapes_.size() <= body.index) {
+		shapes_.resize(body.index + 1);
+	}
+	Shape& shape = shapes_[body.index];
+	assert(!shape.isUsed);
+	shape.body = body;
+	shape.isUsed = true;
+	shape.isBox = isBox;
+	shape.size = size;
+	shape.friction = friction;
+	shape.sleepTime = 0.0f;
+	shape.proxyId = tree_.CreateProxy(ComputeShapeAABB(world, shape), body.index);
+}
+
+//形状を外す
+void ContactSolver::RemoveShape(RigidBodyWorld::BodyHandle body) {
+	if (shapes_.size() <= body.index || !shapes_[body.index].isUsed) {
+		return;
+	}
+	Shape& shape = shapes_[body.index];
+	tree_.DestroyProxy(shape.proxyId);
+	shape.isUsed = false;
+	shape.proxyId = -1;
+	//この剛体の組を消す
+	for (size_t i = contacts_.size(); i-- > 0;) {
+		if (contacts_[i].slotA == body.index || contacts_[i].slotB == body.index) {
+			RemoveContact(i);
+		}
+	}
+}
+
+//形状のワールドでのAABB
+AABB ContactSolver::ComputeShapeAABB(const RigidBodyWorld& world, const Shape& shape) const {
+	Vector3 position = world.GetPosition(shape.body);
+	if (!shape.isBox) {
+		return Collision::ComputeAABB(SphereData{ .center = position,.radius = shape.size.x });
+	}
+	return Collision::ComputeAABB(MakeOBB(position, world.GetOrientation(shape.body), shape.size));
+}
+
+//時間を進める
+void ContactSolver::Step(RigidBodyWorld& world, float deltaTime) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kPhysics);
+	if (deltaTime <= 0.0f) {
+		return;
+	}
+	world.IntegrateVelocities(deltaTime);
+	UpdateContacts(world, deltaTime);
+	BuildIslands(world);
+
+	//独立したアイランドは同じ剛体に触らないので並列に解ける
+	size_t contactCount = 0;
+	for (size_t i = 0; i < islandCount_; i++) {
+		contactCount += islands_[i].isAwake ? islands_[i].contacts.size() : 0;
+	}
+	auto solveRange = [this, deltaTime](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			if (islands_[i].isAwake) {
+				SolveIsland(islands_[i], deltaTime);
+			}
+		}
+		};
+	if (contactCount >= kParallelContactThreshold) {
+		JobSystem::GetInstance()->ParallelFor(islandCount_, 1, solveRange);
+	} else {
+		solveRange(0, islandCount_);
+	}
+
+	//解いた速度を書き戻し、めり込みを直してから位置を進める
+	for (size_t i = 0; i < islandCount_; i++) {
+		if (!islands_[i].isAwake) {
+			continue;
+		}
+		for (uint32_t slot : islands_[i].bodies) {
+			const SolverBody& body = solverBodies_[slot];
+			const RigidBodyWorld::BodyHandle handle = shapes_[slot].body;
+			world.SetVelocity(handle, body.velocity);
+			world.SetAngularVelocity(handle, body.angularVelocity);
+			//擬似速度の分だけ位置と姿勢を直接動かす
+			if (body.pseudoVelocity.Dot(body.pseudoVelocity) > 0.0f) {
+				world.SetPosition(handle, world.GetPosition(handle) + body.pseudoVelocity * deltaTime);
+			}
+			float pseudoAngularSpeed = std::sqrt(body.pseudoAngularVelocity.Dot(body.pseudoAngularVelocity));
+			if (pseudoAngularSpeed > 0.0f) {
+				Quaternion rotation = Quaternion::MakeRotateAxisAngle(body.pseudoAngularVelocity * (1.0f / pseudoAngularSpeed), pseudoAngularSpeed * deltaTime);
+				world.SetOrientation(handle, rotation * world.GetOrientation(handle));
+			}
+		}
+	}
+	world.IntegratePositions(deltaTime);
+	UpdateSleep(world, deltaTime);
+}
+
+//ブロードフェーズを更新して、新しい組を加え、離れた組を消す
+void ContactSolver::UpdateContacts(const RigidBodyWorld& world, float deltaTime) {
+	//起きている剛体のプロキシを動かす
+	for (Shape& shape : shapes_) {
+		if (!shape.isUsed || !world.IsAwake(shape.body) || world.GetInverseMass(shape.body) == 0.0f) {
+			continue;
+		}
+		tree_.MoveProxy(shape.proxyId, ComputeShapeAABB(world, shape), world.GetVelocity(shape.body) * deltaTime);
+	}
+
+	//新しく太らせたAABBが重なった組を加える(動かないものどうしは除く)
+	tree_.UpdatePairs(newPairs_);
+	for (const DynamicAABBTree::ProxyPair& pair : newPairs_) {
+		uint32_t slotA = tree_.GetUserData(pair.proxyA);
+		uint32_t slotB = tree_.GetUserData(pair.proxyB);
+		if (slotA > slotB) {
+			std::swap(slotA, slotB);
+		}
+		if (world.GetInverseMass(shapes_[slotA].body) == 0.0f && world.GetInverseMass(shapes_[slotB].body) == 0.0f) {
+			continue;
+		}
+		uint64_t key = MakePairKey(slotA, slotB);
+		if (pairToContact_.contains(key)) {
+			continue;
+		}
+		Contact contact = {};
+		contact.slotA = slotA;
+		contact.slotB = slotB;
+		contact.friction = std::sqrt(shapes_[slotA].friction * shapes_[slotB].friction);
+		pairToContact_.emplace(key, static_cast<uint32_t>(contacts_.size()));
+		contacts_.push_back(contact);
+	}
+
+	//太らせたAABBが離れた組を消す
+	for (size_t i = contacts_.size(); i-- > 0;) {
+		const Contact& contact = contacts_[i];
+		if (!Collision::IsCollision(tree_.GetFatAABB(shapes_[contact.slotA].proxyId), tree_.GetFatAABB(shapes_[contact.slotB].proxyId))) {
+			RemoveContact(i);
+		}
+	}
+
+	//接触点を作り直す(組ごとに独立しているので並列にできる)
+	auto collideRange = [this, &world](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			CollideContact(world, contacts_[i]);
+		}
+		};
+	if (contacts_.size() >= kParallelContactThreshold) {
+		JobSystem::GetInstance()->ParallelFor(contacts_.size(), 64, collideRange);
+	} else {
+		collideRange(0, contacts_.size());
+	}
+}
+
+//組の接触点を作り直して、前フレームの力積を引き継ぐ
+void ContactSolver::CollideContact(const RigidBodyWorld& world, Contact& contact) const {
+	const Shape& shapeA = shapes_[contact.slotA];
+	const Shape& shapeB = shapes_[contact.slotB];
+	//眠っている剛体と、眠っているか動かない剛体の組は前の接触点のまま
+	bool isActiveA = world.IsAwake(shapeA.body) && world.GetInverseMass(shapeA.body) > 0.0f;
+	bool isActiveB = world.IsAwake(shapeB.body) && world.GetInverseMass(shapeB.body) > 0.0f;
+	if (!isActiveA && !isActiveB) {
+		return;
+	}
+
+	ContactManifold manifold = {};
+	Vector3 positionA = world.GetPosition(shapeA.body);
+	Vector3 positionB = world.GetPosition(shapeB.body);
+	if (shapeA.isBox && shapeB.isBox) {
+		Collide(MakeOBB(positionA, world.GetOrientation(shapeA.body), shapeA.size),
+			MakeOBB(positionB, world.GetOrientation(shapeB.body), shapeB.size), manifold);
+	} else if (shapeA.isBox) {
+		//球を先にして求め、向きを戻す
+		Collide(SphereData{ .center = positionB,.radius = shapeB.size.x },
+			MakeOBB(positionA, world.GetOrientation(shapeA.body), shapeA.size), manifold);
+		manifold.normal = -manifold.normal;
+	} else if (shapeB.isBox) {
+		Collide(SphereData{ .center = positionA,.radius = shapeA.size.x },
+			MakeOBB(positionB, world.GetOrientation(shapeB.body), shapeB.size), manifold);
+	} else {
+		Collide(SphereData{ .center = positionA,.radius = shapeA.size.x }, SphereData{ .center = positionB,.radius = shapeB.size.x }, manifold);
+	}
+
+	//同じ特徴の点は前の力積から始める
+	for (uint32_t i = 0; i < manifold.pointCount; i++) {
+		ContactPoint& point = manifold.points[i];
+		for (uint32_t j = 0; j < contact.manifold.pointCount; j++) {
+			const ContactPoint& oldPoint = contact.manifold.points[j];
+			if (oldPoint.featureId == point.featureId) {
+				point.normalImpulse = oldPoint.normalImpulse;
+				point.tangentImpulse[0] = oldPoint.tangentImpulse[0];
+				point.tangentImpulse[1] = oldPoint.tangentImpulse[1];
+				break;
+			}
+		}
+	}
+	contact.manifold = manifold;
+}
+
+//アイランドに分ける
+void ContactSolver::BuildIslands(RigidBodyWorld& world) {
+	//接触でつながった動く剛体を素集合でまとめる(動かない剛体はつながりを作らない)
+	const uint32_t slotCount = static_cast<uint32_t>(shapes_.size());
+	unionParent_.resize(slotCount);
+	solverBodies_.resize(slotCount);
+	for (uint32_t slot = 0; slot < slotCount; slot++) {
+		unionParent_[slot] = slot;
+	}
+	for (const Contact& contact : contacts_) {
+		if (contact.manifold.pointCount == 0 ||
+			world.GetInverseMass(shapes_[contact.slotA].body) == 0.0f || world.GetInverseMass(shapes_[contact.slotB].body) == 0.0f) {
+			continue;
+		}
+		uint32_t rootA = FindRoot(contact.slotA);
+		uint32_t rootB = FindRoot(contact.slotB);
+		if (rootA != rootB) {
+			unionParent_[rootB] = rootA;
+		}
+	}
+
+	//根ごとにアイランドを割り当てる
+	rootToIsland_.assign(slotCount, kNullIndex);
+	islandCount_ = 0;
+	for (uint32_t slot = 0; slot < slotCount; slot++) {
+		const Shape& shape = shapes_[slot];
+		if (!shape.isUsed) {
+			continue;
+		}
+		//ソルバー用の状態を集める(動かない剛体も接触の相手として読む)
+		SolverBody& body = solverBodies_[slot];
+		body.position = world.GetPosition(shape.body);
+		body.velocity = world.GetVelocity(shape.body);
+		body.angularVelocity = world.GetAngularVelocity(shape.body);
+		body.pseudoVelocity = { 0.0f,0.0f,0.0f };
+		body.pseudoAngularVelocity = { 0.0f,0.0f,0.0f };
+		body.inverseMass = world.GetInverseMass(shape.body);
+		body.inverseInertia = world.GetInverseInertia(shape.body);
+		if (body.inverseMass == 0.0f) {
+			continue;
+		}
+		uint32_t root = FindRoot(slot);
+		if (rootToIsland_[root] == kNullIndex) {
+			rootToIsland_[root] = static_cast<uint32_t>(islandCount_++);
+			if (islands_.size() < islandCount_) {
+				islands_.resize(islandCount_);
+			}
+			Island& island = islands_[islandCount_ - 1];
+			island.bodies.clear();
+			island.contacts.clear();
+			island.isAwake = false;
+		}
+		Island& island = islands_[rootToIsland_[root]];
+		island.bodies.push_back(slot);
+		island.isAwake = island.isAwake || world.IsAwake(shape.body);
+	}
+	for (uint32_t i = 0; i < static_cast<uint32_t>(contacts_.size()); i++) {
+		const Contact& contact = contacts_[i];
+		if (contact.manifold.pointCount == 0) {
+			continue;
+		}
+		uint32_t dynamicSlot = solverBodies_[contact.slotA].inverseMass > 0.0f ? contact.slotA : contact.slotB;
+		islands_[rootToIsland_[FindRoot(dynamicSlot)]].contacts.push_back(i);
+	}
+
+	//起きている剛体に触れたアイランドは全体を起こす
+	awakeIslandCount_ = 0;
+	for (size_t i = 0; i < islandCount_; i++) {
+		Island& island = islands_[i];
+		if (!island.isAwake) {
+			continue;
+		}
+		awakeIslandCount_++;
+		for (uint32_t slot : island.bodies) {
+			if (!world.IsAwake(shapes_[slot].body)) {
+				world.SetAwake(shapes_[slot].body, true);
+				shapes_[slot].sleepTime = 0.0f;
+			}
+		}
+	}
+}
+
+//アイランドを解く
+void ContactSolver::SolveIsland(Island& island, float deltaTime) {
+	const float inverseDeltaTime = 1.0f / deltaTime;
+
+	//拘束を作る(反復中に外積を求めなくて済むように、r×nとr×tを先に求めておく)
+	island.constraints.resize(island.contacts.size());
+	for (size_t c = 0; c < island.contacts.size(); c++) {
+		Contact& contact = contacts_[island.contacts[c]];
+		ContactConstraint& constraint = island.constraints[c];
+		const SolverBody& bodyA = solverBodies_[contact.slotA];
+		const SolverBody& bodyB = solverBodies_[contact.slotB];
+		constraint.slotA = contact.slotA;
+		constraint.slotB = contact.slotB;
+		constraint.normal = contact.manifold.normal;
+		ComputeTangents(constraint.normal, constraint.tangents);
+		constraint.friction = contact.friction;
+		constraint.pointCount = contact.manifold.pointCount;
+		for (uint32_t p = 0; p < constraint.pointCount; p++) {
+			ContactPoint& point = contact.manifold.points[p];
+			PointConstraint& pc = constraint.points[p];
+			pc.point = &point;
+			const Vector3 anchorA = point.position - bodyA.position;
+			const Vector3 anchorB = point.position - bodyB.position;
+			//慣性モーメントは全軸同じなので、有効質量は m^-1 + I^-1 |r×n|^2 の和
+			auto effectiveMass = [&](const Vector3& crossA, const Vector3& crossB) {
+				float k = bodyA.inverseMass + bodyB.inverseMass +
+					bodyA.inverseInertia * crossA.Dot(crossA) + bodyB.inverseInertia * crossB.Dot(crossB);
+				return k > 0.0f ? 1.0f / k : 0.0f;
+				};
+			pc.normalCrossA = anchorA.Cross(constraint.normal);
+			pc.normalCrossB = anchorB.Cross(constraint.normal);
+			pc.normalMass = effectiveMass(pc.normalCrossA, pc.normalCrossB);
+			for (int t = 0; t < 2; t++) {
+				pc.tangentCrossA[t] = anchorA.Cross(constraint.tangents[t]);
+				pc.tangentCrossB[t] = anchorB.Cross(constraint.tangents[t]);
+				pc.tangentMass[t] = effectiveMass(pc.tangentCrossA[t], pc.tangentCrossB[t]);
+			}
+			//離れていれば接するまでは近づけ、めり込んでいれば擬似速度で少しずつ押し戻す
+			//(押し戻しを速度に足すと、その分が次のフレームに残って積み重ねが揺れ続ける)
+			pc.velocityBias = point.separation > 0.0f ? -point.separation * inverseDeltaTime : 0.0f;
+			float penetration = -point.separation - kLinearSlop;
+			pc.positionBias = penetration > 0.0f ? kBaumgarte * penetration * inverseDeltaTime : 0.0f;
+			pc.pseudoImpulse = 0.0f;
+		}
+	}
+
+	//前フレームの力積から始める
+	for (ContactConstraint& constraint : island.constraints) {
+		SolverBody& bodyA = solverBodies_[constraint.slotA];
+		SolverBody& bodyB = solverBodies_[constraint.slotB];
+		for (uint32_t p = 0; p < constraint.pointCount; p++) {
+			const PointConstraint& pc = constraint.points[p];
+			const ContactPoint& point = *pc.point;
+			Vector3 impulse = constraint.normal * point.normalImpulse +
+				constraint.tangents[0] * point.tangentImpulse[0] + constraint.tangents[1] * point.tangentImpulse[1];
+			Vector3 angularImpulseA = pc.normalCrossA * point.normalImpulse +
+				pc.tangentCrossA[0] * point.tangentImpulse[0] + pc.tangentCrossA[1] * point.tangentImpulse[1];
+			Vector3 angularImpulseB = pc.normalCrossB * point.normalImpulse +
+				pc.tangentCrossB[0] * point.tangentImpulse[0] + pc.tangentCrossB[1] * point.tangentImpulse[1];
+			//動かない剛体には書き込まない(他のアイランドと共有しているため)
+			if (bodyA.inverseMass > 0.0f) {
+				bodyA.velocity -= impulse * bodyA.inverseMass;
+				bodyA.angularVelocity -= angularImpulseA * bodyA.inverseInertia;
+			}
+			if (bodyB.inverseMass > 0.0f) {
+				bodyB.velocity += impulse * bodyB.inverseMass;
+				bodyB.angularVelocity += angularImpulseB * bodyB.inverseInertia;
+			}
+		}
+	}
+
+	for (uint32_t iteration = 0; iteration < kVelocityIterations; iteration++) {
+		for (ContactConstraint& constraint : island.constraints) {
+			//組の間は手元の変数で解き、最後に書き戻す
+			SolverBody& bodyA = solverBodies_[constraint.slotA];
+			SolverBody& bodyB = solverBodies_[constraint.slotB];
+			const float inverseMassA = bodyA.inverseMass;
+			const float inverseMassB = bodyB.inverseMass;
+			const float inverseInertiaA = bodyA.inverseInertia;
+			const float inverseInertiaB = bodyB.inverseInertia;
+			Vector3 velocityA = bodyA.velocity;
+			Vector3 velocityB = bodyB.velocity;
+			Vector3 angularVelocityA = bodyA.angularVelocity;
+			Vector3 angularVelocityB = bodyB.angularVelocity;
+			Vector3 pseudoVelocityA = bodyA.pseudoVelocity;
+			Vector3 pseudoVelocityB = bodyB.pseudoVelocity;
+			Vector3 pseudoAngularVelocityA = bodyA.pseudoAngularVelocity;
+			Vector3 pseudoAngularVelocityB = bodyB.pseudoAngularVelocity;
+
+			for (uint32_t p = 0; p < constraint.pointCount; p++) {
+				PointConstraint& pc = constraint.points[p];
+				ContactPoint& point = *pc.point;
+
+				//摩擦(法線方向の力積に比例する上限で切る)
+				float maxFriction = constraint.friction * point.normalImpulse;
+				for (int t = 0; t < 2; t++) {
+					const Vector3& tangent = constraint.tangents[t];
+					float velocity = (velocityB - velocityA).Dot(tangent) +
+						angularVelocityB.Dot(pc.tangentCrossB[t]) - angularVelocityA.Dot(pc.tangentCrossA[t]);
+					float newImpulse = point.tangentImpulse[t] - velocity * pc.tangentMass[t];
+					newImpulse = newImpulse < -maxFriction ? -maxFriction : (newImpulse > maxFriction ? maxFriction : newImpulse);
+					float lambda = newImpulse - point.tangentImpulse[t];
+					point.tangentImpulse[t] = newImpulse;
+					velocityA -= tangent * (lambda * inverseMassA);
+					angularVelocityA -= pc.tangentCrossA[t] * (lambda * inverseInertiaA);
+					velocityB += tangent * (lambda * inverseMassB);
+					angularVelocityB += pc.tangentCrossB[t] * (lambda * inverseInertiaB);
+				}
+
+				//法線(合計が負にならないように切る)
+				const Vector3& normal = constraint.normal;
+				float velocity = (velocityB - velocityA).Dot(normal) +
+					angularVelocityB.Dot(pc.normalCrossB) - angularVelocityA.Dot(pc.normalCrossA);
+				float newImpulse = point.normalImpulse + (pc.velocityBias - velocity) * pc.normalMass;
+				newImpulse = newImpulse > 0.0f ? newImpulse : 0.0f;
+				float lambda = newImpulse - point.normalImpulse;
+				point.normalImpulse = newImpulse;
+				velocityA -= normal * (lambda * inverseMassA);
+				angularVelocityA -= pc.normalCrossA * (lambda * inverseInertiaA);
+				velocityB += normal * (lambda * inverseMassB);
+				angularVelocityB += pc.normalCrossB * (lambda * inverseInertiaB);
+
+				//めり込みの押し戻し(前フレームからは引き継がない)
+				if (pc.positionBias > 0.0f) {
+					float pseudoVelocity = (pseudoVelocityB - pseudoVelocityA).Dot(normal) +
+						pseudoAngularVelocityB.Dot(pc.normalCrossB) - pseudoAngularVelocityA.Dot(pc.normalCrossA);
+					float newPseudoImpulse = pc.pseudoImpulse + (pc.positionBias - pseudoVelocity) * pc.normalMass;
+					newPseudoImpulse = newPseudoImpulse > 0.0f ? newPseudoImpulse : 0.0f;
+					float pseudoLambda = newPseudoImpulse - pc.pseudoImpulse;
+					pc.pseudoImpulse = newPseudoImpulse;
+					pseudoVelocityA -= normal * (pseudoLambda * inverseMassA);
+					pseudoAngularVelocityA -= pc.normalCrossA * (pseudoLambda * inverseInertiaA);
+					pseudoVelocityB += normal * (pseudoLambda * inverseMassB);
+					pseudoAngularVelocityB += pc.normalCrossB * (pseudoLambda * inverseInertiaB);
+				}
+			}
+
+			//動かない剛体は質量の逆数が0なので変わっていないが、他のアイランドと共有しているので書き込まない
+			if (inverseMassA > 0.0f) {
+				bodyA.velocity = velocityA;
+				bodyA.angularVelocity = angularVelocityA;
+				bodyA.pseudoVelocity = pseudoVelocityA;
+				bodyA.pseudoAngularVelocity = pseudoAngularVelocityA;
+			}
+			if (inverseMassB > 0.0f) {
+				bodyB.velocity = velocityB;
+				bodyB.angularVelocity = angularVelocityB;
+				bodyB.pseudoVelocity = pseudoVelocityB;
+				bodyB.pseudoAngularVelocity = pseudoAngularVelocityB;
+			}
+		}
+	}
+}
+
+//眠るアイランドを探して眠らせる
+void ContactSolver::UpdateSleep(RigidBodyWorld& world, float deltaTime) {
+	const float linearToleranceSquared = kSleepLinearVelocity * kSleepLinearVelocity;
+	const float angularToleranceSquared = kSleepAngularVelocity * kSleepAngularVelocity;
+	for (size_t i = 0; i < islandCount_; i++) {
+		Island& island = islands_[i];
+		if (!island.isAwake) {
+			continue;
+		}
+		//一番最近まで動いていた剛体に合わせる
+		float minSleepTime = std::numeric_limits<float>::infinity();
+		for (uint32_t slot : island.bodies) {
+			Shape& shape = shapes_[slot];
+			Vector3 velocity = world.GetVelocity(shape.body);
+			Vector3 angularVelocity = world.GetAngularVelocity(shape.body);
+			if (velocity.Dot(velocity) > linearToleranceSquared || angularVelocity.Dot(angularVelocity) > angularToleranceSquared) {
+				shape.sleepTime = 0.0f;
+			} else {
+				shape.sleepTime += deltaTime;
+			}
+			minSleepTime = shape.sleepTime < minSleepTime ? shape.sleepTime : minSleepTime;
+		}
+		if (minSleepTime >= kTimeToSleep) {
+			for (uint32_t slot : island.bodies) {
+				world.SetAwake(shapes_[slot].body, false);
+			}
+		}
+	}
+}
+
+//組の鍵
+uint64_t ContactSolver::MakePairKey(uint32_t slotA, uint32_t slotB) {
+	return (static_cast<uint64_t>(slotA) << 32) | slotB;
+}
+
+//接触の削除
+void ContactSolver::RemoveContact(size_t index) {
+	pairToContact_.erase(MakePairKey(contacts_[index].slotA, contacts_[index].slotB));
+	if (index + 1 != contacts_.size()) {
+		contacts_[index] = contacts_.back();
+		pairToContact_[MakePairKey(contacts_[index].slotA, contacts_[index].slotB)] = static_cast<uint32_t>(index);
+	}
+	contacts_.pop_back();
+}
+
+//素集合の根
+uint32_t ContactSolver::FindRoot(uint32_t slot) {
+	//経路を半分に縮めながら辿る
+	while (unionParent_[slot] != slot) {
+		unionParent_[slot] = unionParent_[unionParent_[slot]];
+		slot = unionParent_[slot];
+	}
+	return slot;
+}
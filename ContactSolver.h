@@ -0,0 +1,253 @@
+#pragma once
+#include "Shape.h"
+#include "RigidBodyWorld.h"
+#include "DynamicAABBTree.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// 接触の拘束ソルバー(逐次インパルス法)
+/// </summary>
+/// <remarks>
+/// RigidBodyWorldの剛体に球かOBBの形状を付けて使う。Stepでは速度の積分、接触点の生成、
+/// 前フレームの力積での初期化(特徴番号で対応付ける)、アイランドごとの反復、位置の積分、眠りの判定を順に行う。
+/// 独立したアイランドは並列に解き、眠っているアイランドは解かない
+/// </remarks>
+class ContactSolver {
+public://定数
+	//接触点の最大数
+	static inline const uint32_t kMaxManifoldPoints = 4;
+	//速度の反復回数
+	static inline const uint32_t kVelocityIterations = 8;
+	//離れていても接触点を作る距離(次のフレームで当たる分を先に止める)
+	static inline const float kSpeculativeDistance = 0.02f;
+	//めり込みを許す量(押し戻しの振動を防ぐ)
+	static inline const float kLinearSlop = 0.005f;
+	//1フレームで押し戻すめり込みの割合(押し戻しは位置だけを動かす擬似速度で行い、速度には残さない)
+	static inline const float kBaumgarte = 0.2f;
+	//止まっているとみなす速さ
+	static inline const float kSleepLinearVelocity = 0.05f;
+	//止まっているとみなす角速度
+	static inline const float kSleepAngularVelocity = 0.05f;
+	//止まってから眠るまでの時間(秒)
+	static inline const float kTimeToSleep = 0.5f;
+	//並列に解くアイランドの最小の接触数の合計
+	static inline const size_t kParallelContactThreshold = 256;
+public://構造体
+	/// <summary>
+	/// 接触点
+	/// </summary>
+	struct ContactPoint {
+		Vector3 position; //接触点(2つの表面の中点)
+		float separation; //離れている距離(負ならめり込み)
+		uint32_t featureId; //どの面・辺・頂点から作った点か(前フレームとの対応付けに使う)
+		float normalImpulse; //法線方向の力積の合計
+		float tangentImpulse[2]; //摩擦方向の力積の合計
+	};
+
+	/// <summary>
+	/// 接触点の集まり
+	/// </summary>
+	struct ContactManifold {
+		Vector3 normal; //AからBへの向きの法線
+		uint32_t pointCount; //接触点の数
+		ContactPoint points[kMaxManifoldPoints]; //接触点
+	};
+
+	/// <summary>
+	/// 太らせたAABBが重なっている剛体の組
+	/// </summary>
+	struct Contact {
+		uint32_t slotA; //剛体Aのスロット番号
+		uint32_t slotB; //剛体Bのスロット番号
+		float friction; //摩擦係数
+		ContactManifold manifold; //接触点
+	};
+public://メンバ関数
+	/// <summary>
+	/// 剛体に球の形状を付ける
+	/// </summary>
+	/// <param name="world">剛体の集まり</param>
+	/// <param name="body">剛体(中心が球の中心)</param>
+	/// <param name="radius">半径</param>
+	/// <param name="friction">摩擦係数</param>
+	void AddSphere(const RigidBodyWorld& world, RigidBodyWorld::BodyHandle body, float radius, float friction = 0.5f);
+
+	/// <summary>
+	/// 剛体にOBBの形状を付ける
+	/// </summary>
+	/// <param name="world">剛体の集まり</param>
+	/// <param name="body">剛体(中心と姿勢がOBBの中心と向き)</param>
+	/// <param name="size">座標軸方向の長さの半分</param>
+	/// <param name="friction">摩擦係数</param>
+	void AddBox(const RigidBodyWorld& world, RigidBodyWorld::BodyHandle body, const Vector3& size, float friction = 0.5f);
+
+	/// <summary>
+	/// 形状を外す(剛体を削除する前に呼ぶ)
+	/// </summary>
+	void RemoveShape(RigidBodyWorld::BodyHandle body);
+
+	/// <summary>
+	/// 時間を進める(RigidBodyWorld::Stepの代わりに呼ぶ)
+	/// </summary>
+	/// <param name="world">剛体の集まり</param>
+	/// <param name="deltaTime">経過時間(秒)</param>
+	void Step(RigidBodyWorld& world, float deltaTime);
+
+	/// <summary>
+	/// 接触の組のゲッター(デバッグ描画用)
+	/// </summary>
+	const std::vector<Contact>& GetContacts() const { return contacts_; }
+
+	/// <summary>
+	/// 前回のStepで解いたアイランド数のゲッター
+	/// </summary>
+	size_t GetAwakeIslandCount() const { return awakeIslandCount_; }
+
+	/// <summary>
+	/// 球と球の接触点
+	/// </summary>
+	/// <param name="sphereA">球A</param>
+	/// <param name="sphereB">球B</param>
+	/// <param name="manifold">接触点(力積は0にする)</param>
+	static void Collide(const SphereData& sphereA, const SphereData& sphereB, ContactManifold& manifold);
+
+	/// <summary>
+	/// 球とOBBの接触点
+	/// </summary>
+	static void Collide(const SphereData& sphere, const OBB& obb, ContactManifold& manifold);
+
+	/// <summary>
+	/// OBBとOBBの接触点(分離軸で最もめり込みの浅い軸を選び、面どうしなら相手の面を切り取る)
+	/// </summary>
+	static void Collide(const OBB& obbA, const OBB& obbB, ContactManifold& manifold);
+private://構造体
+	/// <summary>
+	/// 形状
+	/// </summary>
+	struct Shape {
+		RigidBodyWorld::BodyHandle body; //剛体
+		bool isUsed = false; //使っているか
+		bool isBox = false; //OBBか(でなければ球)
+		Vector3 size = {}; //OBBの長さの半分(球ならxが半径)
+		float friction = 0.0f; //摩擦係数
+		int32_t proxyId = -1; //ブロードフェーズのプロキシ番号
+		float sleepTime = 0.0f; //止まっている時間
+	};
+
+	/// <summary>
+	/// ソルバー用の剛体の状態
+	/// </summary>
+	struct SolverBody {
+		Vector3 position; //位置
+		Vector3 velocity; //速度
+		Vector3 angularVelocity; //角速度
+		Vector3 pseudoVelocity; //めり込みを押し戻すための速度(位置だけに使う)
+		Vector3 pseudoAngularVelocity; //めり込みを押し戻すための角速度(姿勢だけに使う)
+		float inverseMass; //質量の逆数
+		float inverseInertia; //慣性モーメントの逆数
+	};
+
+	/// <summary>
+	/// 接触点ごとの拘束
+	/// </summary>
+	struct PointConstraint {
+		ContactPoint* point; //力積を書き戻す接触点
+		Vector3 normalCrossA; //Aの中心から接触点へのベクトルと法線の外積
+		Vector3 normalCrossB; //Bの中心から接触点へのベクトルと法線の外積
+		Vector3 tangentCrossA[2]; //Aの中心から接触点へのベクトルと摩擦方向の外積
+		Vector3 tangentCrossB[2]; //Bの中心から接触点へのベクトルと摩擦方向の外積
+		float normalMass; //法線方向の有効質量
+		float tangentMass[2]; //摩擦方向の有効質量
+		float velocityBias; //法線方向の目標の相対速度(離れている分だけ近づいてよい)
+		float positionBias; //めり込みを押し戻す擬似速度
+		float pseudoImpulse; //擬似速度の力積の合計
+	};
+
+	/// <summary>
+	/// 接触の組ごとの拘束
+	/// </summary>
+	struct ContactConstraint {
+		uint32_t slotA; //剛体Aのスロット番号
+		uint32_t slotB; //剛体Bのスロット番号
+		Vector3 normal; //法線
+		Vector3 tangents[2]; //摩擦方向
+		float friction; //摩擦係数
+		uint32_t pointCount; //接触点の数
+		PointConstraint points[kMaxManifoldPoints]; //接触点ごとの拘束
+	};
+
+	/// <summary>
+	/// 接触でつながった動く剛体の集まり
+	/// </summary>
+	struct Island {
+		std::vector<uint32_t> bodies; //剛体のスロット番号
+		std::vector<uint32_t> contacts; //接触の番号
+		std::vector<ContactConstraint> constraints; //拘束(解くときに作る)
+		bool isAwake; //起きているか
+	};
+private://メンバ関数
+	/// <summary>
+	/// 形状の登録
+	/// </summary>
+	void AddShape(const RigidBodyWorld& world, RigidBodyWorld::BodyHandle body, bool isBox, const Vector3& size, float friction);
+
+	/// <summary>
+	/// 形状のワールドでのAABB
+	/// </summary>
+	AABB ComputeShapeAABB(const RigidBodyWorld& world, const Shape& shape) const;
+
+	/// <summary>
+	/// ブロードフェーズを更新して、新しい組を加え、離れた組を消す
+	/// </summary>
+	void UpdateContacts(const RigidBodyWorld& world, float deltaTime);
+
+	/// <summary>
+	/// 組の接触点を作り直して、前フレームの力積を引き継ぐ
+	/// </summary>
+	void CollideContact(const RigidBodyWorld& world, Contact& contact) const;
+
+	/// <summary>
+	/// アイランドに分ける
+	/// </summary>
+	void BuildIslands(RigidBodyWorld& world);
+
+	/// <summary>
+	/// アイランドを解く
+	/// </summary>
+	void SolveIsland(Island& island, float deltaTime);
+
+	/// <summary>
+	/// 眠るアイランドを探して眠らせる
+	/// </summary>
+	void UpdateSleep(RigidBodyWorld& world, float deltaTime);
+
+	/// <summary>
+	/// 組の鍵(スロット番号の小さい方を上位に置く)
+	/// </summary>
+	static uint64_t MakePairKey(uint32_t slotA, uint32_t slotB);
+
+	/// <summary>
+	/// 接触の削除(末尾と入れ替える)
+	/// </summary>
+	void RemoveContact(size_t index);
+
+	/// <summary>
+	/// 素集合の根
+	/// </summary>
+	uint32_t FindRoot(uint32_t slot);
+private://メンバ変数
+	std::vector<Shape> shapes_; //形状(剛体のスロット番号で引く)
+	DynamicAABBTree tree_; //ブロードフェーズ
+	std::vector<DynamicAABBTree::ProxyPair> newPairs_; //新しく重なった組
+	std::vector<Contact> contacts_; //接触の組
+	std::unordered_map<uint64_t, uint32_t> pairToContact_; //組の鍵から接触の番号
+	std::vector<SolverBody> solverBodies_; //ソルバー用の剛体の状態(スロット番号で引く)
+	std::vector<uint32_t> unionParent_; //アイランド分けの素集合
+	std::vector<uint32_t> rootToIsland_; //素集合の根からアイランドの番号
+	std::vector<Island> islands_; //アイランド(中の配列は使い回す)
+	size_t islandCount_ = 0; //今回のアイランド数
+	size_t awakeIslandCount_ = 0; //今回解いたアイランド数
+};
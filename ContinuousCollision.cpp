@@ -0,0 +1,427 @@
+#include "ContinuousCollision.h"
+#include "Gjk.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	//平行とみなす値
+	const float kParallelEpsilon = 1.0e-12f;
+
+	/// <summary>
+	/// 平行移動した凸形状
+	/// </summary>
+	class TranslatedSupport : public SupportShape {
+	public:
+		TranslatedSupport(const SupportShape& shape, const Vector3& offset) : shape_(shape), offset_(offset) {}
+		Vector3 Support(const Vector3& direction) const override { return shape_.Support(direction) + offset_; }
+		Vector3 GetCenter() const override { return shape_.GetCenter() + offset_; }
+		Vector3 SupportCore(const Vector3& direction) const override { return shape_.SupportCore(direction) + offset_; }
+		float GetMargin() const override { return shape_.GetMargin(); }
+	private:
+		const SupportShape& shape_;
+		Vector3 offset_;
+	};
+
+	/// <summary>
+	/// 正規化(0ベクトルなら代わりの値を返す)
+	/// </summary>
+	Vector3 NormalizeOr(const Vector3& v, const Vector3& fallback) {
+		float lengthSquared = v.Dot(v);
+		if (lengthSquared < kParallelEpsilon) {
+			return fallback;
+		}
+		return v * (1.0f / std::sqrt(lengthSquared));
+	}
+
+	/// <summary>
+	/// 半直線と球が最初に当たる時刻(始点が内側なら0)
+	/// </summary>
+	bool RaySphere(const Vector3& origin, const Vector3& direction, const Vector3& center, float radius, float tMax, float& t) {
+		Vector3 m = origin - center;
+		float c = m.Dot(m) - radius * radius;
+		if (c <= 0.0f) {
+			t = 0.0f;
+			return true;
+		}
+		float b = m.Dot(direction);
+		if (b >= 0.0f) {
+			return false;
+		}
+		float a = direction.Dot(direction);
+		float discriminant = b * b - a * c;
+		if (discriminant < 0.0f) {
+			return false;
+		}
+		t = (-b - std::sqrt(discriminant)) / a;
+		return t <= tMax;
+	}
+
+	/// <summary>
+	/// 半直線とカプセルが最初に当たる時刻(始点は外側にあるものとする)
+	/// </summary>
+	bool RayCapsule(const Vector3& origin, const Vector3& direction, const Vector3& start, const Vector3& end, float radius, float tMax, float& t) {
+		float best = std::numeric_limits<float>::infinity();
+
+		//側面(無限円柱に当たった点が線分の範囲内か)
+		Vector3 axis = end - start;
+		Vector3 offset = origin - start;
+		float axisSquared = axis.Dot(axis);
+		float m = offset.Dot(axis);
+		float n = direction.Dot(axis);
+		float a = axisSquared * direction.Dot(direction) - n * n;
+		if (a > kParallelEpsilon) {
+			float b = axisSquared * offset.Dot(direction) - n * m;
+			float c = axisSquared * (offset.Dot(offset) - radius * radius) - m * m;
+			float discriminant = b * b - a * c;
+			if (discriminant >= 0.0f) {
+				float tCylinder = (-b - std::sqrt(discriminant)) / a;
+				float s = m + tCylinder * n;
+				if (tCylinder >= 0.0f && 0.0f <= s && s <= axisSquared) {
+					best = tCylinder;
+				}
+			}
+		}
+
+		//両端の球
+		float tSphere = 0.0f;
+		if (RaySphere(origin, direction, start, radius, tMax, tSphere)) {
+			best = std::min(best, tSphere);
+		}
+		if (RaySphere(origin, direction, end, radius, tMax, tSphere)) {
+			best = std::min(best, tSphere);
+		}
+		t = best;
+		return best <= tMax;
+	}
+
+	/// <summary>
+	/// 原点中心の箱のローカル座標で、移動する球が最初に当たる時刻
+	/// </summary>
+	/// <param name="center">球の中心</param>
+	/// <param name="velocity">移動量</param>
+	/// <param name="radius">球の半径</param>
+	/// <param name="half">箱の大きさの半分</param>
+	/// <param name="tMax">時刻の上限</param>
+	/// <param name="t">時刻</param>
+	/// <param name="point">箱の表面の接触点</param>
+	/// <param name="normal">法線</param>
+	bool SweepSphereLocalBox(const Vector3& center, const Vector3& velocity, float radius, const Vector3& half, float tMax,
+		float& t, Vector3& point, Vector3& normal) {
+		const float c[3] = { center.x,center.y,center.z };
+		const float v[3] = { velocity.x,velocity.y,velocity.z };
+		const float h[3] = { half.x,half.y,half.z };
+
+		//最初から重なっている
+		Vector3 closest = { std::clamp(c[0], -h[0], h[0]), std::clamp(c[1], -h[1], h[1]), std::clamp(c[2], -h[2], h[2]) };
+		Vector3 d = center - closest;
+		if (d.Dot(d) <= radius * radius) {
+			t = 0.0f;
+			point = closest;
+			if (d.Dot(d) > kParallelEpsilon) {
+				normal = NormalizeOr(d, { 1.0f,0.0f,0.0f });
+			} else {
+				//中心が箱の中なら一番近い面から押し出す
+				int axis = 0;
+				float best = std::numeric_limits<float>::infinity();
+				for (int i = 0; i < 3; i++) {
+					if (h[i] - std::fabs(c[i]) < best) {
+						best = h[i] - std::fabs(c[i]);
+						axis = i;
+					}
+				}
+				float n[3] = {};
+				n[axis] = c[axis] >= 0.0f ? 1.0f : -1.0f;
+				normal = { n[0],n[1],n[2] };
+			}
+			return true;
+		}
+
+		//半径だけ広げた箱と半直線のスラブ判定
+		float tNear = 0.0f;
+		float tFar = tMax;
+		for (int i = 0; i < 3; i++) {
+			float expanded = h[i] + radius;
+			if (std::fabs(v[i]) < kParallelEpsilon) {
+				if (std::fabs(c[i]) > expanded) {
+					return false;
+				}
+				continue;
+			}
+			float inverse = 1.0f / v[i];
+			float t1 = (-expanded - c[i]) * inverse;
+			float t2 = (expanded - c[i]) * inverse;
+			tNear = std::max(tNear, std::min(t1, t2));
+			tFar = std::min(tFar, std::max(t1, t2));
+			if (tNear > tFar) {
+				return false;
+			}
+		}
+
+		//当たった点が箱のどの領域の外にあるか
+		float p[3] = {};
+		int outsideCount = 0;
+		float sign[3] = {};
+		for (int i = 0; i < 3; i++) {
+			p[i] = c[i] + v[i] * tNear;
+			if (p[i] < -h[i]) {
+				sign[i] = -1.0f;
+				outsideCount++;
+			} else if (p[i] > h[i]) {
+				sign[i] = 1.0f;
+				outsideCount++;
+			}
+		}
+
+		t = tNear;
+		if (outsideCount >= 2) {
+			//辺や角の領域は、角の丸みにあたるカプセルと判定し直す
+			float best = std::numeric_limits<float>::infinity();
+			for (int axis = 0; axis < 3; axis++) {
+				//辺の領域なら内側にある軸の辺だけ、角の領域なら角に集まる3辺
+				if (outsideCount == 2 && sign[axis] != 0.0f) {
+					continue;
+				}
+				float start[3] = {};
+				float end[3] = {};
+				for (int i = 0; i < 3; i++) {
+					start[i] = i == axis ? -h[i] : sign[i] * h[i];
+					end[i] = i == axis ? h[i] : sign[i] * h[i];
+				}
+				float tCapsule = 0.0f;
+				if (RayCapsule(center, velocity, { start[0],start[1],start[2] }, { end[0],end[1],end[2] }, radius, tMax, tCapsule)) {
+					best = std::min(best, tCapsule);
+				}
+			}
+			if (best > tMax) {
+				return false;
+			}
+			t = best;
+		}
+
+		Vector3 position = center + velocity * t;
+		point = {
+			std::clamp(position.x, -h[0], h[0]),
+			std::clamp(position.y, -h[1], h[1]),
+			std::clamp(position.z, -h[2], h[2]),
+		};
+		normal = NormalizeOr(position - point, NormalizeOr(-velocity, { 1.0f,0.0f,0.0f }));
+		return true;
+	}
+
+	/// <summary>
+	/// 移動する球と平面(時刻の上限つき)
+	/// </summary>
+	bool SweepSpherePlane(const SphereData& sphere, const Vector3& displacement, const Plane& plane, float tMax, ContinuousCollision::SweepResult& result) {
+		float distance = plane.normal.Dot(sphere.center) - plane.distance;
+		float sign = distance >= 0.0f ? 1.0f : -1.0f;
+		float t = 0.0f;
+		if (std::fabs(distance) > sphere.radius) {
+			//平面に近づいているときだけ当たる
+			float speed = plane.normal.Dot(displacement) * sign;
+			if (speed >= 0.0f) {
+				return false;
+			}
+			t = (std::fabs(distance) - sphere.radius) / -speed;
+			if (t > tMax) {
+				return false;
+			}
+		}
+		result.time = t;
+		result.normal = plane.normal * sign;
+		Vector3 center = sphere.center + displacement * t;
+		result.point = center - plane.normal * (plane.normal.Dot(center) - plane.distance);
+		return true;
+	}
+
+	/// <summary>
+	/// 移動する球と球(時刻の上限つき)
+	/// </summary>
+	bool SweepSphereSphere(const SphereData& sphere, const Vector3& displacement, const Vector3& targetCenter, float targetRadius,
+		float tMax, ContinuousCollision::SweepResult& result) {
+		float t = 0.0f;
+		if (!RaySphere(sphere.center, displacement, targetCenter, sphere.radius + targetRadius, tMax, t)) {
+			return false;
+		}
+		Vector3 center = sphere.center + displacement * t;
+		result.time = t;
+		result.normal = NormalizeOr(center - targetCenter, NormalizeOr(-displacement, { 1.0f,0.0f,0.0f }));
+		result.point = targetCenter + result.normal * targetRadius;
+		return true;
+	}
+
+	/// <summary>
+	/// 移動する球とAABB(時刻の上限つき)
+	/// </summary>
+	bool SweepSphereAABB(const SphereData& sphere, const Vector3& displacement, const Vector3& min, const Vector3& max,
+		float tMax, ContinuousCollision::SweepResult& result) {
+		Vector3 boxCenter = (min + max) * 0.5f;
+		Vector3 half = (max - min) * 0.5f;
+		float t = 0.0f;
+		Vector3 point = {};
+		Vector3 normal = {};
+		if (!SweepSphereLocalBox(sphere.center - boxCenter, displacement, sphere.radius, half, tMax, t, point, normal)) {
+			return false;
+		}
+		result.time = t;
+		result.normal = normal;
+		result.point = point + boxCenter;
+		return true;
+	}
+
+	/// <summary>
+	/// 移動する球とOBB(時刻の上限つき)
+	/// </summary>
+	bool SweepSphereOBB(const SphereData& sphere, const Vector3& displacement, const Vector3& obbCenter, const Vector3 orientations[3],
+		const Vector3& size, float tMax, ContinuousCollision::SweepResult& result) {
+		//OBBのローカル座標でAABBとして求める
+		Vector3 d = sphere.center - obbCenter;
+		Vector3 localCenter = { d.Dot(orientations[0]), d.Dot(orientations[1]), d.Dot(orientations[2]) };
+		Vector3 localVelocity = { displacement.Dot(orientations[0]), displacement.Dot(orientations[1]), displacement.Dot(orientations[2]) };
+		float t = 0.0f;
+		Vector3 point = {};
+		Vector3 normal = {};
+		if (!SweepSphereLocalBox(localCenter, localVelocity, sphere.radius, size, tMax, t, point, normal)) {
+			return false;
+		}
+		result.time = t;
+		result.normal = orientations[0] * normal.x + orientations[1] * normal.y + orientations[2] * normal.z;
+		result.point = obbCenter + orientations[0] * point.x + orientations[1] * point.y + orientations[2] * point.z;
+		return true;
+	}
+}
+
+//移動する球と平面
+bool ContinuousCollision::SweepSphere(const SphereData& sphere, const Vector3& displacement, const Plane& plane, SweepResult& result) {
+	return SweepSpherePlane(sphere, displacement, plane, 1.0f, result);
+}
+
+//移動する球と球
+bool ContinuousCollision::SweepSphere(const SphereData& sphere, const Vector3& displacement, const SphereData& target, SweepResult& result) {
+	return SweepSphereSphere(sphere, displacement, target.center, target.radius, 1.0f, result);
+}
+
+//移動する球とAABB
+bool ContinuousCollision::SweepSphere(const SphereData& sphere, const Vector3& displacement, const AABB& aabb, SweepResult& result) {
+	return SweepSphereAABB(sphere, displacement, aabb.min, aabb.max, 1.0f, result);
+}
+
+//移動する球とOBB
+bool ContinuousCollision::SweepSphere(const SphereData& sphere, const Vector3& displacement, const OBB& obb, SweepResult& result) {
+	return SweepSphereOBB(sphere, displacement, obb.center, obb.orientations, obb.size, 1.0f, result);
+}
+
+//移動する凸形状と凸形状
+bool ContinuousCollision::Sweep(const SupportShape& shape, const Vector3& displacement, const SupportShape& target, SweepResult& result) {
+	//平行移動だけなら距離は時刻の凸関数なので、接線で進めれば行き過ぎない
+	Gjk::Cache cache;
+	float t = 0.0f;
+	for (uint32_t iteration = 0; iteration < kMaxIterations; iteration++) {
+		TranslatedSupport moved(shape, displacement * t);
+		Gjk::DistanceResult distance = Gjk::Distance(moved, target, &cache);
+		if (distance.isIntersecting) {
+			Gjk::PenetrationResult penetration = Gjk::Penetration(moved, target, &cache);
+			result.time = t;
+			result.normal = -penetration.normal;
+			result.point = penetration.pointB;
+			return true;
+		}
+
+		Vector3 normal = NormalizeOr(distance.pointA - distance.pointB, NormalizeOr(-displacement, { 1.0f,0.0f,0.0f }));
+		if (distance.distance <= kTolerance) {
+			result.time = t;
+			result.normal = normal;
+			result.point = distance.pointB;
+			return true;
+		}
+
+		//相手に近づく速さ
+		float closingSpeed = -displacement.Dot(normal);
+		if (closingSpeed <= 0.0f) {
+			return false;
+		}
+		t += (distance.distance - kTolerance * 0.5f) / closingSpeed;
+		if (t > 1.0f) {
+			return false;
+		}
+	}
+
+	//収束しきらなければ、抜けないようにその時刻で当たったことにする
+	TranslatedSupport moved(shape, displacement * t);
+	Gjk::DistanceResult distance = Gjk::Distance(moved, target, &cache);
+	result.time = t;
+	result.normal = NormalizeOr(distance.pointA - distance.pointB, NormalizeOr(-displacement, { 1.0f,0.0f,0.0f }));
+	result.point = distance.pointB;
+	return true;
+}
+
+//移動する球と球の候補
+uint32_t ContinuousCollision::SweepSphereBatch(const SphereData& sphere, const Vector3& displacement, const SphereSet& spheres,
+	const uint32_t* candidates, size_t candidateCount, SweepResult& result) {
+	//早い衝突が見つかるほど時刻の上限を縮めて、後の候補を早く打ち切る
+	uint32_t hitIndex = kNoHit;
+	float tMax = 1.0f;
+	SweepResult hit = {};
+	for (size_t i = 0; i < candidateCount; i++) {
+		uint32_t index = candidates[i];
+		Vector3 center = { spheres.center[0][index], spheres.center[1][index], spheres.center[2][index] };
+		if (SweepSphereSphere(sphere, displacement, center, spheres.radius[index], tMax, hit)) {
+			hitIndex = index;
+			tMax = hit.time;
+			result = hit;
+		}
+	}
+	return hitIndex;
+}
+
+//移動する球とAABBの候補
+uint32_t ContinuousCollision::SweepSphereBatch(const SphereData& sphere, const Vector3& displacement, const AABBSet& aabbs,
+	const uint32_t* candidates, size_t candidateCount, SweepResult& result) {
+	uint32_t hitIndex = kNoHit;
+	float tMax = 1.0f;
+	SweepResult hit = {};
+	for (size_t i = 0; i < candidateCount; i++) {
+		uint32_t index = candidates[i];
+		Vector3 min = { aabbs.min[0][index], aabbs.min[1][index], aabbs.min[2][index] };
+		Vector3 max = { aabbs.max[0][index], aabbs.max[1][index], aabbs.max[2][index] };
+		if (SweepSphereAABB(sphere, displacement, min, max, tMax, hit)) {
+			hitIndex = index;
+			tMax = hit.time;
+			result = hit;
+		}
+	}
+	return hitIndex;
+}
+
+//移動する球とOBBの候補
+uint32_t ContinuousCollision::SweepSphereBatch(const SphereData& sphere, const Vector3& displacement, const OBBSet& obbs,
+	const uint32_t* candidates, size_t candidateCount, SweepResult& result) {
+	uint32_t hitIndex = kNoHit;
+	float tMax = 1.0f;
+	SweepResult hit = {};
+	for (size_t i = 0; i < candidateCount; i++) {
+		uint32_t index = candidates[i];
+		Vector3 center = { obbs.center[0][index], obbs.center[1][index], obbs.center[2][index] };
+		Vector3 orientations[3];
+		for (int axis = 0; axis < 3; axis++) {
+			orientations[axis] = { obbs.orientations[axis][0][index], obbs.orientations[axis][1][index], obbs.orientations[axis][2][index] };
+		}
+		Vector3 size = { obbs.size[0][index], obbs.size[1][index], obbs.size[2][index] };
+		if (SweepSphereOBB(sphere, displacement, center, orientations, size, tMax, hit)) {
+			hitIndex = index;
+			tMax = hit.time;
+			result = hit;
+		}
+	}
+	return hitIndex;
+}
+
+//移動する球が通る範囲を囲むAABB
+AABB ContinuousCollision::ComputeSweptAABB(const SphereData& sphere, const Vector3& displacement) {
+	Vector3 end = sphere.center + displacement;
+	Vector3 extent = { sphere.radius,sphere.radius,sphere.radius };
+	return {
+		Vector3{ std::min(sphere.center.x, end.x), std::min(sphere.center.y, end.y), std::min(sphere.center.z, end.z) } - extent,
+		Vector3{ std::max(sphere.center.x, end.x), std::max(sphere.center.y, end.y), std::max(sphere.center.z, end.z) } + extent,
+	};
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "Shape.h"
+#include "SupportShape.h"
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 連続衝突判定(移動の途中で最初に当たる時刻を求める)
+/// </summary>
+/// <remarks>
+/// 移動する側は center + displacement * t (0 <= t <= 1) と動き、相手は止まっているものとする。
+/// 相手も動くときは相手の移動量を引いた相対移動量を渡す
+/// </remarks>
+class ContinuousCollision {
+public://構造体
+	/// <summary>
+	/// 衝突時刻の結果
+	/// </summary>
+	struct SweepResult {
+		float time; //衝突時刻(0～1、最初から重なっていれば0)
+		Vector3 normal; //相手から移動する側への向きの法線
+		Vector3 point; //相手の表面の接触点
+	};
+public://メンバ関数
+	/// <summary>
+	/// 移動する球と平面
+	/// </summary>
+	/// <param name="sphere">移動前の球</param>
+	/// <param name="displacement">移動量</param>
+	/// <param name="plane">平面</param>
+	/// <param name="result">結果(当たったときだけ書き込む)</param>
+	/// <returns>当たったか</returns>
+	static bool SweepSphere(const SphereData& sphere, const Vector3& displacement, const Plane& plane, SweepResult& result);
+
+	/// <summary>
+	/// 移動する球と球
+	/// </summary>
+	static bool SweepSphere(const SphereData& sphere, const Vector3& displacement, const SphereData& target, SweepResult& result);
+
+	/// <summary>
+	/// 移動する球とAABB
+	/// </summary>
+	static bool SweepSphere(const SphereData& sphere, const Vector3& displacement, const AABB& aabb, SweepResult& result);
+
+	/// <summary>
+	/// 移動する球とOBB
+	/// </summary>
+	static bool SweepSphere(const SphereData& sphere, const Vector3& displacement, const OBB& obb, SweepResult& result);
+
+	/// <summary>
+	/// 移動する凸形状と凸形状(GJKの距離で少しずつ進める保守的前進法)
+	/// </summary>
+	/// <param name="shape">移動前の形状</param>
+	/// <param name="displacement">移動量</param>
+	/// <param name="target">相手の形状</param>
+	/// <param name="result">結果(当たったときだけ書き込む、時刻は接触のkTolerance手前)</param>
+	/// <returns>当たったか</returns>
+	static bool Sweep(const SupportShape& shape, const Vector3& displacement, const SupportShape& target, SweepResult& result);
+
+	/// <summary>
+	/// 移動する球と、ブロードフェーズで絞った球の候補
+	/// </summary>
+	/// <param name="sphere">移動前の球</param>
+	/// <param name="displacement">移動量</param>
+	/// <param name="spheres">球の集合</param>
+	/// <param name="candidates">候補の番号(集合での順番)</param>
+	/// <param name="candidateCount">候補の数</param>
+	/// <param name="result">一番早い衝突の結果</param>
+	/// <returns>一番早く当たった要素の番号(当たらなければkNoHit)</returns>
+	static uint32_t SweepSphereBatch(const SphereData& sphere, const Vector3& displacement, const SphereSet& spheres,
+		const uint32_t* candidates, size_t candidateCount, SweepResult& result);
+
+	/// <summary>
+	/// 移動する球と、ブロードフェーズで絞ったAABBの候補
+	/// </summary>
+	static uint32_t SweepSphereBatch(const SphereData& sphere, const Vector3& displacement, const AABBSet& aabbs,
+		const uint32_t* candidates, size_t candidateCount, SweepResult& result);
+
+	/// <summary>
+	/// 移動する球と、ブロードフェーズで絞ったOBBの候補
+	/// </summary>
+	static uint32_t SweepSphereBatch(const SphereData& sphere, const Vector3& displacement, const OBBSet& obbs,
+		const uint32_t* candidates, size_t candidateCount, SweepResult& result);
+
+	/// <summary>
+	/// 移動する球が通る範囲を囲むAABB(ブロードフェーズの問い合わせに使う)
+	/// </summary>
+	static AABB ComputeSweptAABB(const SphereData& sphere, const Vector3& displacement);
+public://定数
+	//当たらなかったことを表す番号
+	static inline const uint32_t kNoHit = 0xFFFFFFFFu;
+	//保守的前進法で接触とみなす距離
+	static inline const float kTolerance = 1.0e-3f;
+	//保守的前進法の反復回数の上限
+	static inline const uint32_t kMaxIterations = 32;
+};
@@ -0,0 +1,225 @@
+#include "DebugText.h"
+#include "MemoryTracker.h"
+#include <cassert>
+#include <charconv>
+#include <cstring>
+
+namespace {
+	//FNV-1aの初期値
+	const uint64_t kHashOffset = 14695981039346656037ull;
+	//FNV-1aの乗数
+	const uint64_t kHashPrime = 1099511628211ull;
+	//ベクトルの種類
+	const uint8_t kVectorTag = 1;
+	//行列の種類
+	const uint8_t kMatrixTag = 2;
+
+	/// <summary>
+	/// バイト列をハッシュに混ぜる(8バイトずつ混ぜ、端数は1バイトずつ)
+	/// </summary>
+	uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		size_t i = 0;
+		for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+			uint64_t word = 0;
+			std::memcpy(&word, bytes + i, sizeof(word));
+			hash = (hash ^ word) * kHashPrime;
+		}
+		for (; i < size; i++) {
+			hash = (hash ^ bytes[i]) * kHashPrime;
+		}
+		return hash;
+	}
+
+	/// <summary>
+	/// 種類と値とラベルのハッシュ(ラベルは終端文字も混ぜて、値との境目をはっきりさせる)
+	/// </summary>
+	uint64_t HashValue(uint8_t tag, const void* data, size_t size, const char* label) {
+		uint64_t hash = HashBytes(kHashOffset, &tag, sizeof(tag));
+		hash = HashBytes(hash, data, size);
+		hash = HashBytes(hash, label, std::strlen(label) + 1);
+		//8バイトずつ混ぜると上位ビットの違いが下位に届かないので、キャッシュの枠を選ぶ前に全体に広げる
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+}
+
+//コンストラクタ
+DebugText::DebugText() {
+	arenas_[0].reserve(kInitialArenaSize);
+	arenas_[1].reserve(kInitialArenaSize);
+	cacheSlots_.resize(kCacheSlotCount, CacheSlot{});
+}
+
+//フレームの開始
+void DebugText::BeginFrame() {
+	//今フレームの領域は次のフレームでは前フレームの領域になり、前フレームの領域は捨てる
+	currentArena_ ^= 1;
+	arenas_[currentArena_].clear();
+	lines_.clear();
+	frame_++;
+}
+
+//文字列を1行追加する
+void DebugText::AddText(int32_t x, int32_t y, std::string_view text) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	const uint32_t offset = GetArenaSize();
+	AppendString(text);
+	arenas_[currentArena_].push_back('\0');
+	PushLine(x, y, offset);
+}
+
+//ベクトルを1行追加する
+void DebugText::AddVector(int32_t x, int32_t y, const Vector3& vector, const char* label) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	//x,y,zとラベルが終端文字で区切って続いている
+	uint32_t offset = PrepareVector(vector, label);
+	for (int32_t column = 0; column < 4; column++) {
+		PushLine(x + column * kColumnWidth, y, offset);
+		offset = GetNextOffset(offset);
+	}
+}
+
+//行列を追加する
+void DebugText::AddMatrix(int32_t x, int32_t y, const Matrix4x4& matrix, const char* label) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	//ラベルと16個の値が終端文字で区切って続いている
+	uint32_t offset = PrepareMatrix(matrix, label);
+	PushLine(x, y, offset);
+	offset = GetNextOffset(offset);
+	for (int32_t row = 0; row < 4; row++) {
+		for (int32_t column = 0; column < 4; column++) {
+			PushLine(x + column * kColumnWidth, y + (row + 1) * kRowHeight, offset);
+			offset = GetNextOffset(offset);
+		}
+	}
+}
+
+//ベクトルの表を追加する
+void DebugText::AddVectorTable(int32_t x, int32_t y, std::span<const Vector3> vectors, std::span<const char* const> labels) {
+	for (size_t i = 0; i < vectors.size(); i++) {
+		AddVector(x, y + static_cast<int32_t>(i) * kRowHeight, vectors[i], i < labels.size() ? labels[i] : "");
+	}
+}
+
+//行列の表を追加する
+void DebugText::AddMatrixTable(int32_t x, int32_t y, std::span<const Matrix4x4> matrices, std::span<const char* const> labels, size_t columnCount) {
+	assert(columnCount > 0);
+	for (size_t i = 0; i < matrices.size(); i++) {
+		const int32_t column = static_cast<int32_t>(i % columnCount);
+		const int32_t row = static_cast<int32_t>(i / columnCount);
+		AddMatrix(x + column * kMatrixCellWidth, y + row * kMatrixCellHeight, matrices[i], i < labels.size() ? labels[i] : "");
+	}
+}
+
+//キャッシュから今フレームの領域に文字列を用意する
+bool DebugText::FindCache(uint64_t hash, uint32_t& offset) {
+	const size_t mask = kCacheSlotCount - 1;
+	for (size_t probe = 0; probe < kMaxProbeCount; probe++) {
+		CacheSlot& slot = cacheSlots_[(hash + probe) & mask];
+		const bool isCurrent = slot.frame == frame_;
+		const bool isPrevious = slot.frame != 0 && slot.frame + 1 == frame_;
+		//空きか古い枠で止める(その先に同じ値があっても、書式化し直すだけで表示は変わらない)
+		if (!isCurrent && !isPrevious) {
+			break;
+		}
+		if (slot.hash != hash) {
+			continue;
+		}
+		if (isPrevious) {
+			//前フレームの文字列を今フレームの領域にコピーする
+			const std::vector<char>& previousArena = arenas_[currentArena_ ^ 1];
+			const uint32_t newOffset = GetArenaSize();
+			arenas_[currentArena_].insert(arenas_[currentArena_].end(), previousArena.begin() + slot.offset, previousArena.begin() + slot.offset + slot.length);
+			slot.offset = newOffset;
+			slot.frame = frame_;
+		}
+		offset = slot.offset;
+		cacheHitCount_++;
+		return true;
+	}
+	cacheMissCount_++;
+	return false;
+}
+
+//キャッシュに登録する
+void DebugText::StoreCache(uint64_t hash, uint32_t offset) {
+	const size_t mask = kCacheSlotCount - 1;
+	for (size_t probe = 0; probe < kMaxProbeCount; probe++) {
+		CacheSlot& slot = cacheSlots_[(hash + probe) & mask];
+		const bool isCurrent = slot.frame == frame_;
+		const bool isPrevious = slot.frame != 0 && slot.frame + 1 == frame_;
+		if (!isCurrent && !isPrevious) {
+			slot = { .hash = hash,.frame = frame_,.offset = offset,.length = GetArenaSize() - offset };
+			return;
+		}
+	}
+}
+
+//ベクトルの4つの文字列を用意する
+uint32_t DebugText::PrepareVector(const Vector3& vector, const char* label) {
+	const float values[3] = { vector.x,vector.y,vector.z };
+	const uint64_t hash = HashValue(kVectorTag, values, sizeof(values), label);
+	uint32_t offset = 0;
+	if (FindCache(hash, offset)) {
+		return offset;
+	}
+	offset = GetArenaSize();
+	for (float value : values) {
+		AppendFloat(value, 0);
+		arenas_[currentArena_].push_back('\0');
+	}
+	AppendString(label);
+	arenas_[currentArena_].push_back('\0');
+	StoreCache(hash, offset);
+	return offset;
+}
+
+//行列の17個の文字列を用意する
+uint32_t DebugText::PrepareMatrix(const Matrix4x4& matrix, const char* label) {
+	const uint64_t hash = HashValue(kMatrixTag, matrix.m, sizeof(matrix.m), label);
+	uint32_t offset = 0;
+	if (FindCache(hash, offset)) {
+		return offset;
+	}
+	offset = GetArenaSize();
+	AppendString(label);
+	arenas_[currentArena_].push_back('\0');
+	for (int row = 0; row < 4; row++) {
+		for (int column = 0; column < 4; column++) {
+			AppendFloat(matrix.m[row][column], kFieldWidth);
+			arenas_[currentArena_].push_back('\0');
+		}
+	}
+	StoreCache(hash, offset);
+	return offset;
+}
+
+//小数を右に寄せて書き込む
+void DebugText::AppendFloat(float value, int fieldWidth) {
+	char buffer[64];
+	const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, kPrecision);
+	const size_t length = result.ec == std::errc() ? static_cast<size_t>(result.ptr - buffer) : 0;
+	std::vector<char>& arena = arenas_[currentArena_];
+	if (length < static_cast<size_t>(fieldWidth)) {
+		arena.insert(arena.end(), static_cast<size_t>(fieldWidth) - length, ' ');
+	}
+	arena.insert(arena.end(), buffer, buffer + length);
+}
+
+//文字列を書き込む
+void DebugText::AppendString(std::string_view text) {
+	arenas_[currentArena_].insert(arenas_[currentArena_].end(), text.begin(), text.end());
+}
+
+//行を追加する
+void DebugText::PushLine(int32_t x, int32_t y, uint32_t offset) {
+	lines_.push_back({ .x = x,.y = y,.offset = offset });
+}
+
+//次の文字列の始まり
+uint32_t DebugText::GetNextOffset(uint32_t offset) const {
+	return offset + static_cast<uint32_t>(std::strlen(arenas_[currentArena_].data() + offset)) + 1;
+}
@@ -0,0 +1,192 @@
+#pragma once
+#include "MathData.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// デバッグ表示の文字列を作る(Noviceには依存しない。表示はScreenPrintfが行う)
+/// </summary>
+/// <remarks>
+/// 文字列はフレームごとの領域(2つを交互に使う)に続けて書き、行はその中の位置で持つ。
+/// ベクトルと行列の値は1つずつ別の行にして列ごとに決まったxに置くので、桁の多い値があっても列がずれない。
+/// ベクトルと行列は値とラベルから作ったハッシュで前フレームの文字列を探し、見つかればコピーするだけで数値の書式化をしない。
+/// 数値はstd::to_charsで書くので、領域の容量が足りていればフレーム中にメモリを確保しない
+/// </remarks>
+class DebugText {
+public://構造体
+	/// <summary>
+	/// 1行の文字列(ベクトルと行列は値1つ分)
+	/// </summary>
+	struct Line {
+		int32_t x; //表示位置x
+		int32_t y; //表示位置y
+		uint32_t offset; //領域の中の始まり(終端文字まで)
+	};
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	DebugText();
+
+	/// <summary>
+	/// フレームの開始(今フレームの行を捨て、前フレームに使った文字列だけをキャッシュに残す)
+	/// </summary>
+	void BeginFrame();
+
+	/// <summary>
+	/// 文字列を1行追加する(キャッシュしない)
+	/// </summary>
+	/// <param name="x">x</param>
+	/// <param name="y">y</param>
+	/// <param name="text">文字列</param>
+	void AddText(int32_t x, int32_t y, std::string_view text);
+
+	/// <summary>
+	/// ベクトルを1行追加する(x,y,z,ラベルの順に列の幅ずつ並べる)
+	/// </summary>
+	/// <param name="x">x</param>
+	/// <param name="y">y</param>
+	/// <param name="vector">ベクトル</param>
+	/// <param name="label">ラベル</param>
+	void AddVector(int32_t x, int32_t y, const Vector3& vector, const char* label);
+
+	/// <summary>
+	/// 行列を追加する(ラベルの行と、列の幅ずつ並べた4行の値)
+	/// </summary>
+	/// <param name="x">x</param>
+	/// <param name="y">y</param>
+	/// <param name="matrix">行列</param>
+	/// <param name="label">ラベル</param>
+	void AddMatrix(int32_t x, int32_t y, const Matrix4x4& matrix, const char* label);
+
+	/// <summary>
+	/// ベクトルの表を追加する(1行に1つ)
+	/// </summary>
+	/// <param name="x">x</param>
+	/// <param name="y">y</param>
+	/// <param name="vectors">ベクトル</param>
+	/// <param name="labels">ラベル(足りない分はラベルなし)</param>
+	void AddVectorTable(int32_t x, int32_t y, std::span<const Vector3> vectors, std::span<const char* const> labels);
+
+	/// <summary>
+	/// 行列の表を追加する(左から右、上から下の順に並べる)
+	/// </summary>
+	/// <param name="x">x</param>
+	/// <param name="y">y</param>
+	/// <param name="matrices">行列</param>
+	/// <param name="labels">ラベル(足りない分はラベルなし)</param>
+	/// <param name="columnCount">横に並べる数</param>
+	void AddMatrixTable(int32_t x, int32_t y, std::span<const Matrix4x4> matrices, std::span<const char* const> labels, size_t columnCount);
+
+	/// <summary>
+	/// 今フレームの行のゲッター
+	/// </summary>
+	const std::vector<Line>& GetLines() const { return lines_; }
+
+	/// <summary>
+	/// 行の文字列のゲッター(次のBeginFrameまで有効)
+	/// </summary>
+	const char* GetText(const Line& line) const { return arenas_[currentArena_].data() + line.offset; }
+
+	/// <summary>
+	/// キャッシュから取り出した回数のゲッター
+	/// </summary>
+	uint64_t GetCacheHitCount() const { return cacheHitCount_; }
+
+	/// <summary>
+	/// 書式化した回数のゲッター
+	/// </summary>
+	uint64_t GetCacheMissCount() const { return cacheMissCount_; }
+public://定数
+	//列の幅
+	static inline const int32_t kColumnWidth = 60;
+	//行の幅
+	static inline const int32_t kRowHeight = 20;
+	//行列の1つの値の文字数(足りない分は空白で埋める)
+	static inline const int kFieldWidth = 6;
+	//小数点以下の桁数
+	static inline const int kPrecision = 2;
+	//表の行列1つ分の幅(4列と間)
+	static inline const int32_t kMatrixCellWidth = kColumnWidth * 5;
+	//表の行列1つ分の高さ(ラベルと4行)
+	static inline const int32_t kMatrixCellHeight = kRowHeight * 5;
+	//キャッシュの枠の数(2の累乗)
+	static inline const size_t kCacheSlotCount = 4096;
+	//キャッシュで探す最大の枠の数(超えたらキャッシュせずに書式化する)
+	static inline const size_t kMaxProbeCount = 8;
+	//最初に確保する領域の大きさ
+	static inline const size_t kInitialArenaSize = 64 * 1024;
+private://構造体
+	/// <summary>
+	/// キャッシュの枠
+	/// </summary>
+	struct CacheSlot {
+		uint64_t hash; //値とラベルのハッシュ
+		uint32_t frame; //最後に使ったフレーム(0は空き)
+		uint32_t offset; //そのフレームの領域の中の始まり
+		uint32_t length; //終端文字を含む長さ
+	};
+private://メンバ関数
+	/// <summary>
+	/// キャッシュから今フレームの領域に文字列を用意する
+	/// </summary>
+	/// <param name="hash">値とラベルのハッシュ</param>
+	/// <param name="offset">今フレームの領域の中の始まり</param>
+	/// <returns>見つかったか(見つからなければ書式化してStoreCacheを呼ぶ)</returns>
+	bool FindCache(uint64_t hash, uint32_t& offset);
+
+	/// <summary>
+	/// 書式化した文字列をキャッシュに登録する(空きがなければ登録しない)
+	/// </summary>
+	void StoreCache(uint64_t hash, uint32_t offset);
+
+	/// <summary>
+	/// ベクトルの4つの文字列(x,y,z,ラベル)を続けて用意する
+	/// </summary>
+	/// <returns>今フレームの領域の中の始まり</returns>
+	uint32_t PrepareVector(const Vector3& vector, const char* label);
+
+	/// <summary>
+	/// 行列の17個の文字列(ラベルと16個の値)を続けて用意する
+	/// </summary>
+	/// <returns>今フレームの領域の中の始まり</returns>
+	uint32_t PrepareMatrix(const Matrix4x4& matrix, const char* label);
+
+	/// <summary>
+	/// 小数を右に寄せて書き込む(printfの"%*.02f"と同じ)
+	/// </summary>
+	/// <param name="value">値</param>
+	/// <param name="fieldWidth">文字数(足りない分は左を空白で埋める)</param>
+	void AppendFloat(float value, int fieldWidth);
+
+	/// <summary>
+	/// 文字列を書き込む
+	/// </summary>
+	void AppendString(std::string_view text);
+
+	/// <summary>
+	/// 行を追加する
+	/// </summary>
+	void PushLine(int32_t x, int32_t y, uint32_t offset);
+
+	/// <summary>
+	/// 続けて用意した次の文字列の始まり
+	/// </summary>
+	uint32_t GetNextOffset(uint32_t offset) const;
+
+	/// <summary>
+	/// 今フレームの領域の使っている大きさ
+	/// </summary>
+	uint32_t GetArenaSize() const { return static_cast<uint32_t>(arenas_[currentArena_].size()); }
+private://メンバ変数
+	std::vector<char> arenas_[2]; //今フレームと前フレームの文字列
+	size_t currentArena_ = 0; //今フレームの領域の番号
+	uint32_t frame_ = 1; //フレーム番号(キャッシュの空きと区別するため1から)
+	std::vector<CacheSlot> cacheSlots_; //キャッシュ(ハッシュの下位ビットから順に探す)
+	std::vector<Line> lines_; //今フレームの行
+	uint64_t cacheHitCount_ = 0; //キャッシュから取り出した回数
+	uint64_t cacheMissCount_ = 0; //書式化した回数
+};
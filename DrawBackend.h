@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// 描画先
+/// </summary>
+/// <remarks>Noviceに依存しない描画処理はこれを通して描画する</remarks>
+class DrawBackend {
+public://メンバ関数
+	/// <summary>
+	/// デストラクタ
+	/// </summary>
+	virtual ~DrawBackend() = default;
+
+	/// <summary>
+	/// 線の描画
+	/// </summary>
+	/// <param name="x1">始点x</param>
+	/// <param name="y1">始点y</param>
+	/// <param name="x2">終点x</param>
+	/// <param name="y2">終点y</param>
+	/// <param name="color">色</param>
+	virtual void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) = 0;
+
+	/// <summary>
+	/// 塗りつぶした三角形の描画
+	/// </summary>
+	/// <param name="x1">頂点1のx</param>
+	/// <param name="y1">頂点1のy</param>
+	/// <param name="x2">頂点2のx</param>
+	/// <param name="y2">頂点2のy</param>
+	/// <param name="x3">頂点3のx</param>
+	/// <param name="y3">頂点3のy</param>
+	/// <param name="color">色</param>
+	virtual void DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color) = 0;
+
+	/// <summary>
+	/// 文字列の描画
+	/// </summary>
+	/// <param name="x">x</param>
+	/// <param name="y">y</param>
+	/// <param name="text">文字列(終端文字まで)</param>
+	virtual void DrawString(int32_t x, int32_t y, const char* text) = 0;
+};
+
+/// <summary>
+/// 何も描画しない描画先(ベンチマーク用)
+/// </summary>
+class NullDrawBackend : public DrawBackend {
+public://メンバ関数
+	/// <summary>
+	/// 線の描画(描画せずに数だけ数える)
+	/// </summary>
+	void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) override {
+		lineCount_++;
+		checksum_ += static_cast<uint32_t>(x1 ^ y1 ^ x2 ^ y2) ^ color;
+	}
+
+	/// <summary>
+	/// 三角形の描画(描画せずに数だけ数える)
+	/// </summary>
+	void DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color) override {
+		triangleCount_++;
+		checksum_ += static_cast<uint32_t>(x1 ^ y1 ^ x2 ^ y2 ^ x3 ^ y3) ^ color;
+	}
+
+	/// <summary>
+	/// 文字列の描画(描画せずに数だけ数える)
+	/// </summary>
+	void DrawString(int32_t x, int32_t y, const char* text) override {
+		stringCount_++;
+		checksum_ += static_cast<uint32_t>(x ^ y) ^ static_cast<uint32_t>(static_cast<unsigned char>(text[0]));
+	}
+
+	/// <summary>
+	/// 描画した線の数のゲッター
+	/// </summary>
+	/// <returns>線の数</returns>
+	uint64_t GetLineCount() const { return lineCount_; }
+
+	/// <summary>
+	/// 描画した三角形の数のゲッター
+	/// </summary>
+	/// <returns>三角形の数</returns>
+	uint64_t GetTriangleCount() const { return triangleCount_; }
+
+	/// <summary>
+	/// 描画した文字列の数のゲッター
+	/// </summary>
+	/// <returns>文字列の数</returns>
+	uint64_t GetStringCount() const { return stringCount_; }
+
+	/// <summary>
+	/// 描画内容のチェックサムのゲッター(最適化で消されないように使う)
+	/// </summary>
+	/// <returns>チェックサム</returns>
+	uint32_t GetChecksum() const { return checksum_; }
+private://メンバ変数
+	uint64_t lineCount_ = 0; //描画した線の数
+	uint64_t triangleCount_ = 0; //描画した三角形の数
+	uint64_t stringCount_ = 0; //描画した文字列の数
+	uint32_t checksum_ = 0; //描画内容のチェックサム
+};
@@ -0,0 +1,293 @@
+#include "DrawCapture.h"
+#include "MemoryTracker.h"
+#include "Camera.h"
+#include <cstring>
+
+namespace {
+	/// <summary>
+	/// 符号付きの差を、絶対値が小さいほど小さい符号なしの値にする(0,-1,1,-2... → 0,1,2,3...)
+	/// </summary>
+	uint32_t EncodeZigZag(uint32_t delta) {
+		return (delta << 1) ^ (0u - (delta >> 31));
+	}
+
+	/// <summary>
+	/// EncodeZigZagの逆
+	/// </summary>
+	uint32_t DecodeZigZag(uint32_t value) {
+		return (value >> 1) ^ (0u - (value & 1));
+	}
+
+	/// <summary>
+	/// 命令を読む位置
+	/// </summary>
+	struct PayloadReader {
+		const uint8_t* current; //次に読む位置
+		const uint8_t* end; //終わり
+		int32_t previousX = 0; //直前のx
+		int32_t previousY = 0; //直前のy
+
+		/// <summary>
+		/// 可変長の整数を読み込む
+		/// </summary>
+		bool ReadVarint(uint32_t& value) {
+			value = 0;
+			for (uint32_t shift = 0; shift < 35; shift += 7) {
+				if (current == end) {
+					return false;
+				}
+				const uint8_t byte = *current++;
+				value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// <summary>
+		/// 直前の座標との差から座標を読み込む
+		/// </summary>
+		bool ReadPoint(int32_t& x, int32_t& y) {
+			uint32_t deltaX = 0;
+			uint32_t deltaY = 0;
+			if (!ReadVarint(deltaX) || !ReadVarint(deltaY)) {
+				return false;
+			}
+			x = previousX = static_cast<int32_t>(static_cast<uint32_t>(previousX) + DecodeZigZag(deltaX));
+			y = previousY = static_cast<int32_t>(static_cast<uint32_t>(previousY) + DecodeZigZag(deltaY));
+			return true;
+		}
+	};
+}
+
+//記録の開始
+bool DrawCapture::Start(const char* filePath) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	Stop();
+	output_.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!output_.is_open()) {
+		return false;
+	}
+	const FileHeader header = { .magic = kMagic,.version = kVersion,.frameHeaderSize = sizeof(FrameHeader),.reserved = 0 };
+	output_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	frameCount_ = 0;
+	byteCount_ = sizeof(header);
+	startTime_ = std::chrono::steady_clock::now();
+	return true;
+}
+
+//記録の終了
+void DrawCapture::Stop() {
+	if (output_.is_open()) {
+		output_.close();
+	}
+}
+
+//フレームの開始
+void DrawCapture::BeginFrame(const Camera& camera) {
+	payload_.clear();
+	frameHeader_.commandCount = 0;
+	frameHeader_.worldMatrix = camera.GetWorldMatrix();
+	frameHeader_.viewProjectionMatrix = camera.GetViewProjectionMatrix();
+	frameHeader_.viewportMatrix = camera.GetViewportMatrix();
+	previousX_ = 0;
+	previousY_ = 0;
+	color_ = 0;
+}
+
+//フレームの終了
+void DrawCapture::EndFrame() {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	if (!output_.is_open()) {
+		return;
+	}
+	frameHeader_.magic = kFrameMagic;
+	frameHeader_.frameIndex = frameCount_;
+	frameHeader_.payloadSize = static_cast<uint32_t>(payload_.size());
+	frameHeader_.timestamp = static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime_).count());
+	output_.write(reinterpret_cast<const char*>(&frameHeader_), sizeof(frameHeader_));
+	output_.write(reinterpret_cast<const char*>(payload_.data()), static_cast<std::streamsize>(payload_.size()));
+	//落ちても書き終えたフレームまでは残るように、フレームごとに書き出す
+	output_.flush();
+	frameCount_++;
+	byteCount_ += sizeof(frameHeader_) + payload_.size();
+}
+
+//線の描画
+void DrawCapture::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	target_.DrawLine(x1, y1, x2, y2, color);
+	if (!output_.is_open()) {
+		return;
+	}
+	WriteColor(color);
+	payload_.push_back(static_cast<uint8_t>(Command::kLine));
+	WritePoint(x1, y1);
+	WritePoint(x2, y2);
+	frameHeader_.commandCount++;
+}
+
+//塗りつぶした三角形の描画
+void DrawCapture::DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	target_.DrawTriangle(x1, y1, x2, y2, x3, y3, color);
+	if (!output_.is_open()) {
+		return;
+	}
+	WriteColor(color);
+	payload_.push_back(static_cast<uint8_t>(Command::kTriangle));
+	WritePoint(x1, y1);
+	WritePoint(x2, y2);
+	WritePoint(x3, y3);
+	frameHeader_.commandCount++;
+}
+
+//文字列の描画
+void DrawCapture::DrawString(int32_t x, int32_t y, const char* text) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	target_.DrawString(x, y, text);
+	if (!output_.is_open()) {
+		return;
+	}
+	const size_t length = std::strlen(text);
+	payload_.push_back(static_cast<uint8_t>(Command::kString));
+	WritePoint(x, y);
+	WriteVarint(static_cast<uint32_t>(length));
+	//終端文字も書き、再生するときはコピーせずに渡す
+	payload_.insert(payload_.end(), reinterpret_cast<const uint8_t*>(text), reinterpret_cast<const uint8_t*>(text) + length + 1);
+	frameHeader_.commandCount++;
+}
+
+//色が変わっていれば色の命令を書く
+void DrawCapture::WriteColor(uint32_t color) {
+	if (color == color_) {
+		return;
+	}
+	payload_.push_back(static_cast<uint8_t>(Command::kColor));
+	const uint8_t* colorBytes = reinterpret_cast<const uint8_t*>(&color);
+	payload_.insert(payload_.end(), colorBytes, colorBytes + sizeof(color));
+	color_ = color;
+}
+
+//直前の座標との差を書く
+void DrawCapture::WritePoint(int32_t x, int32_t y) {
+	//差はuint32_tで計算して、範囲外の座標でもあふれないようにする
+	WriteVarint(EncodeZigZag(static_cast<uint32_t>(x) - static_cast<uint32_t>(previousX_)));
+	WriteVarint(EncodeZigZag(static_cast<uint32_t>(y) - static_cast<uint32_t>(previousY_)));
+	previousX_ = x;
+	previousY_ = y;
+}
+
+//可変長の整数を書き込む
+void DrawCapture::WriteVarint(uint32_t value) {
+	while (value >= 0x80) {
+		payload_.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	payload_.push_back(static_cast<uint8_t>(value));
+}
+
+//開く
+bool DrawCaptureReader::Open(const char* filePath) {
+	Close();
+	if (!file_.Open(filePath)) {
+		return false;
+	}
+	const uint8_t* data = file_.GetData();
+	const size_t size = file_.GetSize();
+	DrawCapture::FileHeader header = {};
+	if (size < sizeof(header)) {
+		Close();
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+	if (header.magic != DrawCapture::kMagic || header.version != DrawCapture::kVersion ||
+		header.frameHeaderSize != sizeof(DrawCapture::FrameHeader)) {
+		Close();
+		return false;
+	}
+
+	//フレームの先頭だけをたどり、本体は読み飛ばす
+	size_t offset = sizeof(header);
+	while (offset < size) {
+		DrawCapture::FrameHeader frameHeader = {};
+		if (size - offset < sizeof(frameHeader)) {
+			isTruncated_ = true;
+			break;
+		}
+		std::memcpy(&frameHeader, data + offset, sizeof(frameHeader));
+		if (frameHeader.magic != DrawCapture::kFrameMagic || size - offset - sizeof(frameHeader) < frameHeader.payloadSize) {
+			isTruncated_ = true;
+			break;
+		}
+		frameOffsets_.push_back(offset);
+		offset += sizeof(frameHeader) + frameHeader.payloadSize;
+	}
+	return true;
+}
+
+//閉じる
+void DrawCaptureReader::Close() {
+	file_.Close();
+	frameOffsets_.clear();
+	isTruncated_ = false;
+}
+
+//フレームの先頭のゲッター
+DrawCapture::FrameHeader DrawCaptureReader::GetFrameHeader(size_t frame) const {
+	DrawCapture::FrameHeader frameHeader = {};
+	std::memcpy(&frameHeader, file_.GetData() + frameOffsets_[frame], sizeof(frameHeader));
+	return frameHeader;
+}
+
+//1フレーム分の命令を描画先に渡す
+bool DrawCaptureReader::Replay(size_t frame, DrawBackend& backend) const {
+	const DrawCapture::FrameHeader frameHeader = GetFrameHeader(frame);
+	const uint8_t* payload = file_.GetData() + frameOffsets_[frame] + sizeof(frameHeader);
+	PayloadReader reader = { .current = payload,.end = payload + frameHeader.payloadSize };
+	uint32_t color = 0;
+	while (reader.current != reader.end) {
+		const DrawCapture::Command command = static_cast<DrawCapture::Command>(*reader.current++);
+		switch (command) {
+		case DrawCapture::Command::kLine: {
+			int32_t x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+			if (!reader.ReadPoint(x1, y1) || !reader.ReadPoint(x2, y2)) {
+				return false;
+			}
+			backend.DrawLine(x1, y1, x2, y2, color);
+			break;
+		}
+		case DrawCapture::Command::kTriangle: {
+			int32_t x1 = 0, y1 = 0, x2 = 0, y2 = 0, x3 = 0, y3 = 0;
+			if (!reader.ReadPoint(x1, y1) || !reader.ReadPoint(x2, y2) || !reader.ReadPoint(x3, y3)) {
+				return false;
+			}
+			backend.DrawTriangle(x1, y1, x2, y2, x3, y3, color);
+			break;
+		}
+		case DrawCapture::Command::kString: {
+			int32_t x = 0, y = 0;
+			uint32_t length = 0;
+			if (!reader.ReadPoint(x, y) || !reader.ReadVarint(length) ||
+				static_cast<size_t>(reader.end - reader.current) <= length || reader.current[length] != '\0') {
+				return false;
+			}
+			backend.DrawString(x, y, reinterpret_cast<const char*>(reader.current));
+			reader.current += length + 1;
+			break;
+		}
+		case DrawCapture::Command::kColor:
+			if (reader.end - reader.current < static_cast<ptrdiff_t>(sizeof(color))) {
+				return false;
+			}
+			std::memcpy(&color, reader.current, sizeof(color));
+			reader.current += sizeof(color);
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,201 @@
+#pragma once
+#include "DrawBackend.h"
+#include "MappedFile.h"
+#include "MathData.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+class Camera;
+
+/// <summary>
+/// 描画命令の記録(別の描画先に渡しながら、線・三角形・文字列とカメラの行列をファイルに書き出す)
+/// </summary>
+/// <remarks>
+/// ファイルはヘッダのあとに1フレーム1レコードを追記していく。
+/// レコードは固定長のFrameHeader(カメラの行列を含む)と、命令を並べた可変長の本体からなる。
+/// 座標は直前の座標との差をジグザグ符号化した可変長の整数にし、色は変わったときだけ書くので、
+/// 線をつなげて描く球やグリッドは1本あたり数バイトになる。
+/// 命令の状態(直前の座標と色)はフレームごとに戻すので、どのフレームからでも再生できる
+/// </remarks>
+class DrawCapture : public DrawBackend {
+public://列挙型
+	/// <summary>
+	/// 命令の種類
+	/// </summary>
+	enum class Command : uint8_t {
+		kLine = 1,     //線(始点と終点)
+		kTriangle = 2, //三角形(3頂点)
+		kString = 3,   //文字列(位置、長さ、文字列と終端文字)
+		kColor = 4,    //以降の色(4バイト)
+	};
+public://構造体
+	/// <summary>
+	/// ファイルの先頭
+	/// </summary>
+	struct FileHeader {
+		uint32_t magic; //識別子
+		uint32_t version; //版
+		uint32_t frameHeaderSize; //FrameHeaderのバイト数
+		uint32_t reserved; //予約
+	};
+
+	/// <summary>
+	/// フレームの先頭
+	/// </summary>
+	struct FrameHeader {
+		uint32_t magic; //識別子(壊れたレコードの検出用)
+		uint32_t frameIndex; //記録を始めてからのフレーム番号
+		uint32_t commandCount; //命令の数(色は含まない)
+		uint32_t payloadSize; //本体のバイト数
+		uint64_t timestamp; //記録を始めてからの時間(ns)
+		Matrix4x4 worldMatrix; //カメラのワールド行列
+		Matrix4x4 viewProjectionMatrix; //ビュー射影行列
+		Matrix4x4 viewportMatrix; //ビューポート行列
+	};
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="target">実際に描画する先(記録していなくても渡す)</param>
+	explicit DrawCapture(DrawBackend& target) : target_(target) {}
+
+	/// <summary>
+	/// 記録の開始
+	/// </summary>
+	/// <param name="filePath">出力先(あれば上書きするので、残したい記録とは別の名前にする)</param>
+	/// <returns>開けたかどうか</returns>
+	bool Start(const char* filePath);
+
+	/// <summary>
+	/// 記録の終了
+	/// </summary>
+	void Stop();
+
+	/// <summary>
+	/// 記録中か
+	/// </summary>
+	bool IsCapturing() const { return output_.is_open(); }
+
+	/// <summary>
+	/// フレームの開始(描画の前に呼ぶ)
+	/// </summary>
+	/// <param name="camera">このフレームのカメラ</param>
+	void BeginFrame(const Camera& camera);
+
+	/// <summary>
+	/// フレームの終了(記録中ならこのフレームを書き出す)
+	/// </summary>
+	void EndFrame();
+
+	/// <summary>
+	/// 線の描画
+	/// </summary>
+	void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) override;
+
+	/// <summary>
+	/// 塗りつぶした三角形の描画
+	/// </summary>
+	void DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color) override;
+
+	/// <summary>
+	/// 文字列の描画
+	/// </summary>
+	void DrawString(int32_t x, int32_t y, const char* text) override;
+
+	/// <summary>
+	/// 記録したフレーム数のゲッター
+	/// </summary>
+	uint32_t GetFrameCount() const { return frameCount_; }
+
+	/// <summary>
+	/// 書き出したバイト数のゲッター
+	/// </summary>
+	uint64_t GetByteCount() const { return byteCount_; }
+public://定数
+	//ファイルの識別子
+	static inline const uint32_t kMagic = 0x4344544D; //"MTDC"
+	//ファイルの版
+	static inline const uint32_t kVersion = 1;
+	//フレームの識別子
+	static inline const uint32_t kFrameMagic = 0x4D415246; //"FRAM"
+private://メンバ関数
+	/// <summary>
+	/// 色が変わっていれば色の命令を書く
+	/// </summary>
+	void WriteColor(uint32_t color);
+
+	/// <summary>
+	/// 直前の座標との差を書く
+	/// </summary>
+	void WritePoint(int32_t x, int32_t y);
+
+	/// <summary>
+	/// 可変長の整数を書き込む(7ビットずつ、続きがあれば最上位ビットを立てる)
+	/// </summary>
+	void WriteVarint(uint32_t value);
+private://メンバ変数
+	DrawBackend& target_; //実際に描画する先
+	std::ofstream output_; //出力先
+	std::vector<uint8_t> payload_; //書き出す前の1フレーム分の命令
+	FrameHeader frameHeader_ = {}; //書き出す前の1フレーム分の先頭
+	int32_t previousX_ = 0; //直前のx
+	int32_t previousY_ = 0; //直前のy
+	uint32_t color_ = 0; //今の色
+	uint32_t frameCount_ = 0; //記録したフレーム数
+	uint64_t byteCount_ = 0; //書き出したバイト数
+	std::chrono::steady_clock::time_point startTime_; //記録を始めた時刻
+};
+
+/// <summary>
+/// DrawCaptureで記録したファイルの読み込みと再生
+/// </summary>
+/// <remarks>
+/// ファイルはメモリに割り当てるだけで読み込まない。開くときはフレームの先頭だけをたどって位置を覚え、
+/// 再生するフレームの本体はそのときに割り当てたメモリから直接読む(文字列もコピーせずに渡す)。
+/// 記録中に落ちて最後のフレームが途中で切れていても、そこまでのフレームは読める
+/// </remarks>
+class DrawCaptureReader {
+public://メンバ関数
+	/// <summary>
+	/// 開く
+	/// </summary>
+	/// <param name="filePath">DrawCaptureで記録したファイル</param>
+	/// <returns>読めるファイルだったか</returns>
+	bool Open(const char* filePath);
+
+	/// <summary>
+	/// 閉じる
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// フレーム数のゲッター
+	/// </summary>
+	size_t GetFrameCount() const { return frameOffsets_.size(); }
+
+	/// <summary>
+	/// フレームの先頭のゲッター
+	/// </summary>
+	/// <param name="frame">何番目のフレームか</param>
+	DrawCapture::FrameHeader GetFrameHeader(size_t frame) const;
+
+	/// <summary>
+	/// 途中で切れたフレームがあったか
+	/// </summary>
+	bool IsTruncated() const { return isTruncated_; }
+
+	/// <summary>
+	/// 1フレーム分の命令を描画先に渡す
+	/// </summary>
+	/// <param name="frame">何番目のフレームか</param>
+	/// <param name="backend">描画先</param>
+	/// <returns>最後まで読めたか(壊れていればそこで止める)</returns>
+	bool Replay(size_t frame, DrawBackend& backend) const;
+private://メンバ変数
+	MappedFile file_; //割り当てたファイル
+	std::vector<size_t> frameOffsets_; //フレームの先頭の位置
+	bool isTruncated_ = false; //途中で切れたフレームがあったか
+};
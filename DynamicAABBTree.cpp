@@ -0,0 +1,486 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	//2つのAABBを囲むAABB
+	AABB Combine(const AABB& a, const AABB& b) {
+		return {
+			{ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+			{ std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) },
+		};
+	}
+
+	//表面積(挿入先を選ぶコストに使う)
+	float SurfaceArea(const AABB& aabb) {
+		float dx = aabb.max.x - aabb.min.x;
+		float dy = aabb.max.y - aabb.min.y;
+		float dz = aabb.max.z - aabb.min.z;
+		return 2.0f * (dx * dy + dy * dz + dz * dx);
+	}
+
+	//outerがinnerを含んでいるか
+	bool Contains(const AABB& outer, const AABB& inner) {
+		return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+			inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+	}
+
+	//全方向に広げる
+	AABB Expand(const AABB& aabb, float margin) {
+		Vector3 extent = { margin,margin,margin };
+		return { aabb.min - extent, aabb.max + extent };
+	}
+
+	//視錐台との位置関係
+	enum class FrustumClass {
+		kOutside,    //完全に外側
+		kIntersect,  //境界をまたぐ
+		kInside,     //完全に内側
+	};
+
+	//視錐台とAABBの位置関係を調べる
+	FrustumClass ClassifyFrustum(const Frustum& frustum, const AABB& aabb) {
+		FrustumClass result = FrustumClass::kInside;
+		for (const Plane& plane : frustum.planes) {
+			//法線方向に一番進んだ頂点と一番戻った頂点
+			Vector3 positive = {
+				plane.normal.x >= 0.0f ? aabb.max.x : aabb.min.x,
+				plane.normal.y >= 0.0f ? aabb.max.y : aabb.min.y,
+				plane.normal.z >= 0.0f ? aabb.max.z : aabb.min.z,
+			};
+			if (plane.normal.Dot(positive) < plane.distance) {
+				return FrustumClass::kOutside;
+			}
+			Vector3 negative = {
+				plane.normal.x >= 0.0f ? aabb.min.x : aabb.max.x,
+				plane.normal.y >= 0.0f ? aabb.min.y : aabb.max.y,
+				plane.normal.z >= 0.0f ? aabb.min.z : aabb.max.z,
+			};
+			if (plane.normal.Dot(negative) < plane.distance) {
+				result = FrustumClass::kIntersect;
+			}
+		}
+		return result;
+	}
+}
+
+//コンストラクタ
+DynamicAABBTree::DynamicAABBTree() {
+	nodes_.reserve(16);
+}
+
+//プロキシの作成
+int32_t DynamicAABBTree::CreateProxy(const AABB& aabb, uint32_t userData) {
+	int32_t proxyId = AllocateNode();
+	TreeNode& node = nodes_[proxyId];
+	node.aabb = Expand(aabb, kAABBMargin);
+	node.userData = userData;
+	node.height = 0;
+	node.moved = true;
+	InsertLeaf(proxyId);
+	moveBuffer_.push_back(proxyId);
+	proxyCount_++;
+	return proxyId;
+}
+
+//プロキシの削除
+void DynamicAABBTree::DestroyProxy(int32_t proxyId) {
+	assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+	assert(nodes_[proxyId].IsLeaf());
+	if (nodes_[proxyId].moved) {
+		//移動リストからは消さずに無効にしておく
+		std::replace(moveBuffer_.begin(), moveBuffer_.end(), proxyId, kNullNode);
+	}
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	proxyCount_--;
+}
+
+//プロキシの移動
+bool DynamicAABBTree::MoveProxy(int32_t proxyId, const AABB& aabb, const Vector3& displacement) {
+	assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+	assert(nodes_[proxyId].IsLeaf());
+
+	//太らせて、移動方向に伸ばしたAABB
+	AABB fatAABB = Expand(aabb, kAABBMargin);
+	Vector3 d = displacement * kDisplacementMultiplier;
+	(d.x < 0.0f ? fatAABB.min.x : fatAABB.max.x) += d.x;
+	(d.y < 0.0f ? fatAABB.min.y : fatAABB.max.y) += d.y;
+	(d.z < 0.0f ? fatAABB.min.z : fatAABB.max.z) += d.z;
+
+	const AABB& treeAABB = nodes_[proxyId].aabb;
+	if (Contains(treeAABB, aabb)) {
+		//木のAABBが大きすぎなければ組み替えない
+		AABB hugeAABB = Expand(fatAABB, kAABBMargin * 4.0f);
+		if (Contains(hugeAABB, treeAABB)) {
+			return false;
+		}
+	}
+
+	RemoveLeaf(proxyId);
+	nodes_[proxyId].aabb = fatAABB;
+	InsertLeaf(proxyId);
+	if (!nodes_[proxyId].moved) {
+		nodes_[proxyId].moved = true;
+		moveBuffer_.push_back(proxyId);
+	}
+	return true;
+}
+
+//利用側のデータのゲッター
+uint32_t DynamicAABBTree::GetUserData(int32_t proxyId) const {
+	assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+	return nodes_[proxyId].userData;
+}
+
+//太らせたAABBのゲッター
+const AABB& DynamicAABBTree::GetFatAABB(int32_t proxyId) const {
+	assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+	return nodes_[proxyId].aabb;
+}
+
+//動いたプロキシに関係する組を求める
+void DynamicAABBTree::UpdatePairs(std::vector<ProxyPair>& pairs) {
+	pairs.clear();
+	for (int32_t proxyId : moveBuffer_) {
+		if (proxyId != kNullNode) {
+			AddPairsOf(proxyId, true, pairs);
+		}
+	}
+	for (int32_t proxyId : moveBuffer_) {
+		if (proxyId != kNullNode) {
+			nodes_[proxyId].moved = false;
+		}
+	}
+	moveBuffer_.clear();
+}
+
+//当たっている可能性のある組をすべて求める
+void DynamicAABBTree::QueryAllPairs(std::vector<ProxyPair>& pairs) const {
+	pairs.clear();
+	for (int32_t proxyId = 0; proxyId < static_cast<int32_t>(nodes_.size()); proxyId++) {
+		if (nodes_[proxyId].height == 0) {
+			AddPairsOf(proxyId, false, pairs);
+		}
+	}
+}
+
+//視錐台と重なる葉を探す
+void DynamicAABBTree::QueryFrustum(const Frustum& frustum, std::vector<int32_t>& proxies) const {
+	//下位ビットに「完全に内側」の印を付けて積む
+	int32_t stack[kStackCapacity];
+	int32_t stackCount = 0;
+	if (root_ != kNullNode) {
+		stack[stackCount++] = root_ << 1;
+	}
+	while (stackCount > 0) {
+		int32_t entry = stack[--stackCount];
+		int32_t nodeId = entry >> 1;
+		bool isInside = (entry & 1) != 0;
+		const TreeNode& node = nodes_[nodeId];
+		if (!isInside) {
+			FrustumClass frustumClass = ClassifyFrustum(frustum, node.aabb);
+			if (frustumClass == FrustumClass::kOutside) {
+				continue;
+			}
+			isInside = frustumClass == FrustumClass::kInside;
+		}
+		if (node.IsLeaf()) {
+			proxies.push_back(nodeId);
+		} else {
+			//完全に内側なら子は判定しない
+			assert(stackCount + 2 <= kStackCapacity);
+			stack[stackCount++] = (node.child1 << 1) | (isInside ? 1 : 0);
+			stack[stackCount++] = (node.child2 << 1) | (isInside ? 1 : 0);
+		}
+	}
+}
+
+//木の高さのゲッター
+int32_t DynamicAABBTree::GetHeight() const {
+	return root_ == kNullNode ? 0 : nodes_[root_].height;
+}
+
+//木の構造の検証
+void DynamicAABBTree::Validate() const {
+#ifndef NDEBUG
+	int32_t leafCount = 0;
+	std::vector<int32_t> stack;
+	if (root_ != kNullNode) {
+		assert(nodes_[root_].parent == kNullNode);
+		stack.push_back(root_);
+	}
+	while (!stack.empty()) {
+		int32_t index = stack.back();
+		stack.pop_back();
+		const TreeNode& node = nodes_[index];
+		if (node.IsLeaf()) {
+			assert(node.height == 0);
+			leafCount++;
+			continue;
+		}
+		const TreeNode& child1 = nodes_[node.child1];
+		const TreeNode& child2 = nodes_[node.child2];
+		assert(child1.parent == index && child2.parent == index);
+		assert(node.height == 1 + std::max(child1.height, child2.height));
+		assert(std::abs(child2.height - child1.height) <= 1);
+		assert(Contains(node.aabb, child1.aabb) && Contains(node.aabb, child2.aabb));
+		stack.push_back(node.child1);
+		stack.push_back(node.child2);
+	}
+	assert(leafCount == proxyCount_);
+
+	int32_t freeCount = 0;
+	for (int32_t index = freeList_; index != kNullNode; index = nodes_[index].parent) {
+		assert(nodes_[index].height == -1);
+		freeCount++;
+	}
+	assert(leafCount * 2 - (leafCount > 0 ? 1 : 0) + freeCount == static_cast<int32_t>(nodes_.size()));
+#endif // NDEBUG
+}
+
+//ノードの確保
+int32_t DynamicAABBTree::AllocateNode() {
+	int32_t nodeId = freeList_;
+	if (nodeId == kNullNode) {
+		nodeId = static_cast<int32_t>(nodes_.size());
+		nodes_.push_back({});
+	} else {
+		freeList_ = nodes_[nodeId].parent;
+	}
+	TreeNode& node = nodes_[nodeId];
+	node.aabb = {};
+	node.parent = kNullNode;
+	node.child1 = kNullNode;
+	node.child2 = kNullNode;
+	node.height = 0;
+	node.userData = 0;
+	node.moved = false;
+	return nodeId;
+}
+
+//ノードの解放
+void DynamicAABBTree::FreeNode(int32_t nodeId) {
+	nodes_[nodeId].parent = freeList_;
+	nodes_[nodeId].height = -1;
+	freeList_ = nodeId;
+}
+
+//葉の挿入
+void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+	if (root_ == kNullNode) {
+		root_ = leaf;
+		nodes_[root_].parent = kNullNode;
+		return;
+	}
+
+	//表面積が一番増えない兄弟を探す
+	const AABB leafAABB = nodes_[leaf].aabb;
+	int32_t index = root_;
+	while (!nodes_[index].IsLeaf()) {
+		const TreeNode& node = nodes_[index];
+		float area = SurfaceArea(node.aabb);
+		float combinedArea = SurfaceArea(Combine(node.aabb, leafAABB));
+
+		//ここで新しい親を作るコストと、下に降りるときに祖先が増えるコスト
+		float cost = 2.0f * combinedArea;
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [&](int32_t child) {
+			const TreeNode& childNode = nodes_[child];
+			float newArea = SurfaceArea(Combine(leafAABB, childNode.aabb));
+			if (childNode.IsLeaf()) {
+				return newArea + inheritanceCost;
+			}
+			return newArea - SurfaceArea(childNode.aabb) + inheritanceCost;
+			};
+		float cost1 = descendCost(node.child1);
+		float cost2 = descendCost(node.child2);
+
+		if (cost < cost1 && cost < cost2) {
+			break;
+		}
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+	int32_t sibling = index;
+
+	//新しい親を作って兄弟と葉をぶら下げる
+	int32_t newParent = AllocateNode();
+	int32_t oldParent = nodes_[sibling].parent;
+	nodes_[newParent].parent = oldParent;
+	nodes_[newParent].aabb = Combine(leafAABB, nodes_[sibling].aabb);
+	nodes_[newParent].height = nodes_[sibling].height + 1;
+	nodes_[newParent].child1 = sibling;
+	nodes_[newParent].child2 = leaf;
+	nodes_[sibling].parent = newParent;
+	nodes_[leaf].parent = newParent;
+
+	if (oldParent != kNullNode) {
+		if (nodes_[oldParent].child1 == sibling) {
+			nodes_[oldParent].child1 = newParent;
+		} else {
+			nodes_[oldParent].child2 = newParent;
+		}
+	} else {
+		root_ = newParent;
+	}
+
+	Refit(nodes_[leaf].parent);
+}
+
+//葉の取り外し
+void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+	if (leaf == root_) {
+		root_ = kNullNode;
+		return;
+	}
+
+	int32_t parent = nodes_[leaf].parent;
+	int32_t grandParent = nodes_[parent].parent;
+	int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+	if (grandParent != kNullNode) {
+		//親を消して兄弟を祖父につなぐ
+		if (nodes_[grandParent].child1 == parent) {
+			nodes_[grandParent].child1 = sibling;
+		} else {
+			nodes_[grandParent].child2 = sibling;
+		}
+		nodes_[sibling].parent = grandParent;
+		FreeNode(parent);
+		Refit(grandParent);
+	} else {
+		root_ = sibling;
+		nodes_[sibling].parent = kNullNode;
+		FreeNode(parent);
+	}
+}
+
+//回転で平衡させる
+int32_t DynamicAABBTree::Balance(int32_t iA) {
+	TreeNode& a = nodes_[iA];
+	if (a.IsLeaf() || a.height < 2) {
+		return iA;
+	}
+
+	int32_t iB = a.child1;
+	int32_t iC = a.child2;
+	TreeNode& b = nodes_[iB];
+	TreeNode& c = nodes_[iC];
+	int32_t balance = c.height - b.height;
+
+	//Cを上げる
+	if (balance > 1) {
+		int32_t iF = c.child1;
+		int32_t iG = c.child2;
+		TreeNode& f = nodes_[iF];
+		TreeNode& g = nodes_[iG];
+
+		c.child1 = iA;
+		c.parent = a.parent;
+		a.parent = iC;
+		if (c.parent != kNullNode) {
+			if (nodes_[c.parent].child1 == iA) {
+				nodes_[c.parent].child1 = iC;
+			} else {
+				nodes_[c.parent].child2 = iC;
+			}
+		} else {
+			root_ = iC;
+		}
+
+		//高い方の孫をCに残す
+		if (f.height > g.height) {
+			c.child2 = iF;
+			a.child2 = iG;
+			g.parent = iA;
+			a.aabb = Combine(b.aabb, g.aabb);
+			c.aabb = Combine(a.aabb, f.aabb);
+			a.height = 1 + std::max(b.height, g.height);
+			c.height = 1 + std::max(a.height, f.height);
+		} else {
+			c.child2 = iG;
+			a.child2 = iF;
+			f.parent = iA;
+			a.aabb = Combine(b.aabb, f.aabb);
+			c.aabb = Combine(a.aabb, g.aabb);
+			a.height = 1 + std::max(b.height, f.height);
+			c.height = 1 + std::max(a.height, g.height);
+		}
+		return iC;
+	}
+
+	//Bを上げる
+	if (balance < -1) {
+		int32_t iD = b.child1;
+		int32_t iE = b.child2;
+		TreeNode& d = nodes_[iD];
+		TreeNode& e = nodes_[iE];
+
+		b.child1 = iA;
+		b.parent = a.parent;
+		a.parent = iB;
+		if (b.parent != kNullNode) {
+			if (nodes_[b.parent].child1 == iA) {
+				nodes_[b.parent].child1 = iB;
+			} else {
+				nodes_[b.parent].child2 = iB;
+			}
+		} else {
+			root_ = iB;
+		}
+
+		if (d.height > e.height) {
+			b.child2 = iD;
+			a.child1 = iE;
+			e.parent = iA;
+			a.aabb = Combine(c.aabb, e.aabb);
+			b.aabb = Combine(a.aabb, d.aabb);
+			a.height = 1 + std::max(c.height, e.height);
+			b.height = 1 + std::max(a.height, d.height);
+		} else {
+			b.child2 = iE;
+			a.child1 = iD;
+			d.parent = iA;
+			a.aabb = Combine(c.aabb, d.aabb);
+			b.aabb = Combine(a.aabb, e.aabb);
+			a.height = 1 + std::max(c.height, d.height);
+			b.height = 1 + std::max(a.height, e.height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+//親をたどってAABBと高さを更新する
+void DynamicAABBTree::Refit(int32_t index) {
+	while (index != kNullNode) {
+		index = Balance(index);
+		TreeNode& node = nodes_[index];
+		const TreeNode& child1 = nodes_[node.child1];
+		const TreeNode& child2 = nodes_[node.child2];
+		node.height = 1 + std::max(child1.height, child2.height);
+		node.aabb = Combine(child1.aabb, child2.aabb);
+		index = node.parent;
+	}
+}
+
+//プロキシが重なる葉を組に追加する
+void DynamicAABBTree::AddPairsOf(int32_t proxyId, bool skipMoved, std::vector<ProxyPair>& pairs) const {
+	Query(nodes_[proxyId].aabb, [&](int32_t otherId) {
+		if (otherId == proxyId) {
+			return true;
+		}
+		if (skipMoved) {
+			//両方動いていれば番号の大きい方からだけ追加する
+			if (nodes_[otherId].moved && otherId > proxyId) {
+				return true;
+			}
+		} else if (otherId < proxyId) {
+			return true;
+		}
+		pairs.push_back({ std::min(proxyId, otherId), std::max(proxyId, otherId) });
+		return true;
+		});
+}
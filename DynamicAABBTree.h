@@ -0,0 +1,245 @@
+#pragma once
+#include "Shape.h"
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 動的AABB木(ブロードフェーズ)
+/// </summary>
+/// <remarks>
+/// ノードは配列に並べて添字で参照する。葉には少し太らせたAABBを持たせ、
+/// 少し動いただけでは木を組み替えないようにしている
+/// </remarks>
+class DynamicAABBTree {
+public://構造体
+	/// <summary>
+	/// 当たっている可能性のあるプロキシの組
+	/// </summary>
+	struct ProxyPair {
+		int32_t proxyA; //小さい方のプロキシ
+		int32_t proxyB; //大きい方のプロキシ
+	};
+
+	/// <summary>
+	/// ノード
+	/// </summary>
+	struct TreeNode {
+		AABB aabb; //AABB(葉は太らせたもの)
+		int32_t parent; //親(空きノードのときは次の空きノード)
+		int32_t child1; //子1(葉ならkNullNode)
+		int32_t child2; //子2
+		int32_t height; //高さ(葉は0、空きノードは-1)
+		uint32_t userData; //利用側のデータ
+		bool moved; //移動リストに入っているか
+
+		//葉かどうか
+		bool IsLeaf() const { return child1 == kNullNode; }
+	};
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	DynamicAABBTree();
+
+	/// <summary>
+	/// プロキシの作成
+	/// </summary>
+	/// <param name="aabb">AABB</param>
+	/// <param name="userData">利用側のデータ</param>
+	/// <returns>プロキシ番号</returns>
+	int32_t CreateProxy(const AABB& aabb, uint32_t userData);
+
+	/// <summary>
+	/// プロキシの削除
+	/// </summary>
+	/// <param name="proxyId">プロキシ番号</param>
+	void DestroyProxy(int32_t proxyId);
+
+	/// <summary>
+	/// プロキシの移動
+	/// </summary>
+	/// <param name="proxyId">プロキシ番号</param>
+	/// <param name="aabb">新しいAABB</param>
+	/// <param name="displacement">移動量(移動方向にAABBを伸ばす)</param>
+	/// <returns>木を組み替えたかどうか</returns>
+	bool MoveProxy(int32_t proxyId, const AABB& aabb, const Vector3& displacement);
+
+	/// <summary>
+	/// 利用側のデータのゲッター
+	/// </summary>
+	uint32_t GetUserData(int32_t proxyId) const;
+
+	/// <summary>
+	/// 太らせたAABBのゲッター
+	/// </summary>
+	const AABB& GetFatAABB(int32_t proxyId) const;
+
+	/// <summary>
+	/// 当たっている可能性のある組を求める(前回から動いたプロキシに関係する組だけ)
+	/// </summary>
+	/// <param name="pairs">組の書き込み先(クリアしてから書き込む、重複なし)</param>
+	void UpdatePairs(std::vector<ProxyPair>& pairs);
+
+	/// <summary>
+	/// 当たっている可能性のある組をすべて求める
+	/// </summary>
+	/// <param name="pairs">組の書き込み先(クリアしてから書き込む、重複なし)</param>
+	void QueryAllPairs(std::vector<ProxyPair>& pairs) const;
+
+	/// <summary>
+	/// AABBと重なる葉を探す
+	/// </summary>
+	/// <param name="aabb">AABB</param>
+	/// <param name="callback">bool(int32_t proxyId) falseを返すと打ち切る</param>
+	template<class Callback>
+	void Query(const AABB& aabb, Callback callback) const;
+
+	/// <summary>
+	/// 線分と重なる葉を探す
+	/// </summary>
+	/// <param name="segment">線分(origin + diff * t, 0 <= t <= maxFraction)</param>
+	/// <param name="maxFraction">tの上限</param>
+	/// <param name="callback">float(int32_t proxyId, float maxFraction) 新しいtの上限を返す(0で打ち切り)</param>
+	template<class Callback>
+	void RayCast(const Segment& segment, float maxFraction, Callback callback) const;
+
+	/// <summary>
+	/// 視錐台と重なる葉を探す
+	/// </summary>
+	/// <param name="frustum">視錐台</param>
+	/// <param name="proxies">プロキシ番号の書き込み先(末尾に追加する)</param>
+	void QueryFrustum(const Frustum& frustum, std::vector<int32_t>& proxies) const;
+
+	/// <summary>
+	/// 木の高さのゲッター
+	/// </summary>
+	int32_t GetHeight() const;
+
+	/// <summary>
+	/// プロキシ数のゲッター
+	/// </summary>
+	int32_t GetProxyCount() const { return proxyCount_; }
+
+	/// <summary>
+	/// 木の構造の検証(デバッグ用、壊れていればassert)
+	/// </summary>
+	void Validate() const;
+public://定数
+	//ノードがないことを表す値
+	static inline const int32_t kNullNode = -1;
+	//AABBを太らせる量
+	static inline const float kAABBMargin = 0.1f;
+	//移動量からAABBを伸ばすときの倍率
+	static inline const float kDisplacementMultiplier = 4.0f;
+	//探索用スタックの大きさ(木は平衡させているのでこれで足りる)
+	static inline const int32_t kStackCapacity = 256;
+private://メンバ関数
+	//ノードの確保
+	int32_t AllocateNode();
+	//ノードの解放
+	void FreeNode(int32_t nodeId);
+	//葉の挿入
+	void InsertLeaf(int32_t leaf);
+	//葉の取り外し
+	void RemoveLeaf(int32_t leaf);
+	//回転で平衡させる(新しい部分木の根を返す)
+	int32_t Balance(int32_t nodeA);
+	//親をたどってAABBと高さを更新する
+	void Refit(int32_t index);
+	//プロキシが重なる葉を組に追加する
+	void AddPairsOf(int32_t proxyId, bool skipMoved, std::vector<ProxyPair>& pairs) const;
+private://メンバ変数
+	std::vector<TreeNode> nodes_; //ノードの配列
+	int32_t root_ = kNullNode; //根
+	int32_t freeList_ = kNullNode; //空きノードの先頭
+	int32_t proxyCount_ = 0; //プロキシ数
+	std::vector<int32_t> moveBuffer_; //前回から動いたプロキシ
+};
+
+namespace DynamicAABBTreeDetail {
+	/// <summary>
+	/// AABBが重なっているか
+	/// </summary>
+	inline bool Overlaps(const AABB& a, const AABB& b) {
+		return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+			a.min.y <= b.max.y && a.max.y >= b.min.y &&
+			a.min.z <= b.max.z && a.max.z >= b.min.z;
+	}
+
+	/// <summary>
+	/// 線分(逆数で持つ)とAABBのスラブ判定
+	/// </summary>
+	inline bool SegmentOverlaps(const Vector3& origin, const Vector3& inverseDiff, float maxFraction, const AABB& aabb) {
+		float tx1 = (aabb.min.x - origin.x) * inverseDiff.x, tx2 = (aabb.max.x - origin.x) * inverseDiff.x;
+		float ty1 = (aabb.min.y - origin.y) * inverseDiff.y, ty2 = (aabb.max.y - origin.y) * inverseDiff.y;
+		float tz1 = (aabb.min.z - origin.z) * inverseDiff.z, tz2 = (aabb.max.z - origin.z) * inverseDiff.z;
+		float tNear = tx1 < tx2 ? tx1 : tx2;
+		float tFar = tx1 < tx2 ? tx2 : tx1;
+		float nearY = ty1 < ty2 ? ty1 : ty2, farY = ty1 < ty2 ? ty2 : ty1;
+		float nearZ = tz1 < tz2 ? tz1 : tz2, farZ = tz1 < tz2 ? tz2 : tz1;
+		tNear = tNear > nearY ? tNear : nearY;
+		tNear = tNear > nearZ ? tNear : nearZ;
+		tFar = tFar < farY ? tFar : farY;
+		tFar = tFar < farZ ? tFar : farZ;
+		tNear = tNear > 0.0f ? tNear : 0.0f;
+		tFar = tFar < maxFraction ? tFar : maxFraction;
+		return tNear <= tFar;
+	}
+}
+
+//AABBと重なる葉を探す
+template<class Callback>
+void DynamicAABBTree::Query(const AABB& aabb, Callback callback) const {
+	int32_t stack[kStackCapacity];
+	int32_t stackCount = 0;
+	if (root_ != kNullNode) {
+		stack[stackCount++] = root_;
+	}
+	while (stackCount > 0) {
+		const TreeNode& node = nodes_[stack[--stackCount]];
+		if (!DynamicAABBTreeDetail::Overlaps(node.aabb, aabb)) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			if (!callback(static_cast<int32_t>(&node - nodes_.data()))) {
+				return;
+			}
+		} else {
+			assert(stackCount + 2 <= kStackCapacity);
+			stack[stackCount++] = node.child1;
+			stack[stackCount++] = node.child2;
+		}
+	}
+}
+
+//線分と重なる葉を探す
+template<class Callback>
+void DynamicAABBTree::RayCast(const Segment& segment, float maxFraction, Callback callback) const {
+	//0除算を避けつつ逆数にしておく
+	auto inverse = [](float value) { return 1.0f / (value != 0.0f ? value : 1.0e-30f); };
+	const Vector3 inverseDiff = { inverse(segment.diff.x), inverse(segment.diff.y), inverse(segment.diff.z) };
+
+	int32_t stack[kStackCapacity];
+	int32_t stackCount = 0;
+	if (root_ != kNullNode) {
+		stack[stackCount++] = root_;
+	}
+	while (stackCount > 0) {
+		int32_t nodeId = stack[--stackCount];
+		const TreeNode& node = nodes_[nodeId];
+		if (!DynamicAABBTreeDetail::SegmentOverlaps(segment.origin, inverseDiff, maxFraction, node.aabb)) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			maxFraction = callback(nodeId, maxFraction);
+			if (maxFraction <= 0.0f) {
+				return;
+			}
+		} else {
+			assert(stackCount + 2 <= kStackCapacity);
+			stack[stackCount++] = node.child1;
+			stack[stackCount++] = node.child2;
+		}
+	}
+}
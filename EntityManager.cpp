@@ -0,0 +1,382 @@
+#include "EntityManager.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+namespace {
+	//番号を取り出すマスク
+	const uint32_t kIndexMask = (1u << EntityManager::kIndexBits) - 1;
+	//世代を取り出すマスク(ずらした後)
+	const uint32_t kGenerationMask = 0xFFFFFFFFu >> EntityManager::kIndexBits;
+
+	/// <summary>
+	/// ハンドルの番号
+	/// </summary>
+	uint32_t GetIndex(EntityManager::Entity entity) {
+		return entity.id & kIndexMask;
+	}
+
+	/// <summary>
+	/// ハンドルの世代
+	/// </summary>
+	uint32_t GetGeneration(EntityManager::Entity entity) {
+		return entity.id >> EntityManager::kIndexBits;
+	}
+
+	/// <summary>
+	/// 倍数に切り上げる
+	/// </summary>
+	constexpr size_t AlignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	//チャンクは領域ごと捨てるので、成分は後始末のいらない型にする
+	static_assert(std::is_trivially_destructible_v<EntityManager::TransformComponent>);
+	static_assert(std::is_trivially_destructible_v<EntityManager::BoundsComponent>);
+	static_assert(std::is_trivially_destructible_v<EntityManager::RenderComponent>);
+	static_assert(std::is_trivially_destructible_v<EntityManager::PhysicsComponent>);
+
+	//全部の成分を持つエンティティが1つはチャンクに入る(成分を大きくしてこれを超えても、チャンクを大きく確保するので壊れはしない)
+	static_assert(AlignUp(sizeof(EntityManager::Entity), EntityManager::kChunkAlignment) +
+		AlignUp(sizeof(EntityManager::TransformComponent), EntityManager::kChunkAlignment) +
+		AlignUp(sizeof(EntityManager::BoundsComponent), EntityManager::kChunkAlignment) +
+		AlignUp(sizeof(EntityManager::RenderComponent), EntityManager::kChunkAlignment) +
+		sizeof(EntityManager::PhysicsComponent) <= EntityManager::kChunkBytes);
+}
+
+//エンティティの追加
+EntityManager::Entity EntityManager::CreateEntity(uint32_t componentMask) {
+	assert(componentMask < kComponentMaskCount);
+	//空いている番号が十分にたまってから古いものを使い回す
+	//全ビットが1のハンドルは無効を表すので最後の番号は使わず、新しい番号を使い切ったら空きがあるだけ使い回す
+	const bool isIndexExhausted = records_.size() >= kIndexMask;
+	uint32_t index = 0;
+	if (freeIndices_.size() >= kMinFreeIndexCount || (isIndexExhausted && !freeIndices_.empty())) {
+		index = freeIndices_.front();
+		freeIndices_.pop_front();
+	} else if (isIndexExhausted) {
+		//空きもなければ無効なハンドルを返す
+		return Entity{};
+	} else {
+		index = static_cast<uint32_t>(records_.size());
+		records_.push_back({ .archetype = 0,.position = 0,.generation = 0,.isAlive = false });
+	}
+	EntityRecord& record = records_[index];
+	const Entity entity = { .id = (record.generation << kIndexBits) | index };
+
+	const uint32_t archetypeIndex = GetOrCreateArchetype(componentMask);
+	record.archetype = archetypeIndex;
+	record.position = Allocate(archetypes_[archetypeIndex], entity);
+	record.isAlive = true;
+	entityCount_++;
+	return entity;
+}
+
+//エンティティの削除
+void EntityManager::DestroyEntity(Entity entity) {
+	if (!IsValid(entity)) {
+		return;
+	}
+	const uint32_t index = GetIndex(entity);
+	EntityRecord& record = records_[index];
+	Deallocate(archetypes_[record.archetype], record.position);
+	//古いハンドルが無効になるように世代を進める
+	record.generation = (record.generation + 1) & kGenerationMask;
+	record.isAlive = false;
+	freeIndices_.push_back(index);
+	entityCount_--;
+}
+
+//ハンドルが有効か
+bool EntityManager::IsValid(Entity entity) const {
+	const uint32_t index = GetIndex(entity);
+	return index < records_.size() && records_[index].isAlive && records_[index].generation == GetGeneration(entity);
+}
+
+//全削除
+void EntityManager::Clear() {
+	for (uint32_t index = 0; index < records_.size(); index++) {
+		EntityRecord& record = records_[index];
+		if (!record.isAlive) {
+			continue;
+		}
+		record.generation = (record.generation + 1) & kGenerationMask;
+		record.isAlive = false;
+		freeIndices_.push_back(index);
+	}
+	//チャンクは確保したまま次に使う
+	for (Archetype& archetype : archetypes_) {
+		archetype.count = 0;
+	}
+	entityCount_ = 0;
+}
+
+//成分を加える
+void EntityManager::AddComponents(Entity entity, uint32_t componentMask) {
+	ChangeArchetype(entity, GetComponentMask(entity) | componentMask);
+}
+
+//成分を外す
+void EntityManager::RemoveComponents(Entity entity, uint32_t componentMask) {
+	ChangeArchetype(entity, GetComponentMask(entity) & ~componentMask);
+}
+
+//持っている成分のゲッター
+uint32_t EntityManager::GetComponentMask(Entity entity) const {
+	return archetypes_[GetRecord(entity).archetype].componentMask;
+}
+
+//位置・姿勢・大きさのゲッター
+EntityManager::TransformComponent& EntityManager::GetTransform(Entity entity) {
+	assert(HasComponents(entity, kTransform));
+	const EntityRecord& record = GetRecord(entity);
+	Archetype& archetype = archetypes_[record.archetype];
+	return GetArray<TransformComponent>(archetype.chunks[record.position / archetype.chunkCapacity], archetype.transformOffset)[record.position % archetype.chunkCapacity];
+}
+
+//境界箱のゲッター
+EntityManager::BoundsComponent& EntityManager::GetBounds(Entity entity) {
+	assert(HasComponents(entity, kBounds));
+	const EntityRecord& record = GetRecord(entity);
+	Archetype& archetype = archetypes_[record.archetype];
+	return GetArray<BoundsComponent>(archetype.chunks[record.position / archetype.chunkCapacity], archetype.boundsOffset)[record.position % archetype.chunkCapacity];
+}
+
+//描画のゲッター
+EntityManager::RenderComponent& EntityManager::GetRender(Entity entity) {
+	assert(HasComponents(entity, kRender));
+	const EntityRecord& record = GetRecord(entity);
+	Archetype& archetype = archetypes_[record.archetype];
+	return GetArray<RenderComponent>(archetype.chunks[record.position / archetype.chunkCapacity], archetype.renderOffset)[record.position % archetype.chunkCapacity];
+}
+
+//動きのゲッター
+EntityManager::PhysicsComponent& EntityManager::GetPhysics(Entity entity) {
+	assert(HasComponents(entity, kPhysics));
+	const EntityRecord& record = GetRecord(entity);
+	Archetype& archetype = archetypes_[record.archetype];
+	return GetArray<PhysicsComponent>(archetype.chunks[record.position / archetype.chunkCapacity], archetype.physicsOffset)[record.position % archetype.chunkCapacity];
+}
+
+//チャンクを順に処理する
+void EntityManager::Query(uint32_t componentMask, const std::function<void(const ChunkView&)>& function) {
+	for (Archetype& archetype : archetypes_) {
+		if ((archetype.componentMask & componentMask) != componentMask) {
+			continue;
+		}
+		const size_t chunkCount = (archetype.count + archetype.chunkCapacity - 1) / archetype.chunkCapacity;
+		for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+			function(MakeChunkView(archetype, chunk));
+		}
+	}
+}
+
+//チャンクを分担して処理する
+void EntityManager::ParallelQuery(uint32_t componentMask, const std::function<void(const ChunkView&)>& function) {
+	CollectChunks(componentMask);
+	JobSystem::GetInstance()->ParallelFor(queryChunks_.size(), 1, [this, &function](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			function(queryChunks_[i]);
+		}
+		});
+}
+
+//アーキタイプを探す(なければ作る)
+uint32_t EntityManager::GetOrCreateArchetype(uint32_t componentMask) {
+	if (archetypeOfMask_[componentMask] != 0) {
+		return archetypeOfMask_[componentMask] - 1;
+	}
+	//1エンティティあたりの大きさからチャンクに入る数を決める
+	size_t entityBytes = sizeof(Entity);
+	entityBytes += (componentMask & kTransform) ? sizeof(TransformComponent) : 0;
+	entityBytes += (componentMask & kBounds) ? sizeof(BoundsComponent) : 0;
+	entityBytes += (componentMask & kRender) ? sizeof(RenderComponent) : 0;
+	entityBytes += (componentMask & kPhysics) ? sizeof(PhysicsComponent) : 0;
+
+	Archetype archetype = {};
+	archetype.componentMask = componentMask;
+	archetype.count = 0;
+	//配列の先頭をそろえた分だけ収まらなくなれば減らす
+	size_t capacity = std::max<size_t>(kChunkBytes / entityBytes, 1);
+	while (capacity > 1 && LayoutChunk(archetype, capacity) > kChunkBytes) {
+		capacity--;
+	}
+	archetype.chunkCapacity = capacity;
+	//1つでも収まらない大きさなら、チャンクをその大きさで確保して範囲外に書かないようにする
+	archetype.chunkBytes = std::max(LayoutChunk(archetype, capacity), kChunkBytes);
+	archetypes_.push_back(std::move(archetype));
+	archetypeOfMask_[componentMask] = static_cast<uint32_t>(archetypes_.size());
+	return static_cast<uint32_t>(archetypes_.size() - 1);
+}
+
+//チャンクの中の配列の位置を決める
+size_t EntityManager::LayoutChunk(Archetype& archetype, size_t capacity) {
+	size_t offset = 0;
+	auto place = [&offset, capacity](size_t& arrayOffset, size_t elementBytes) {
+		offset = AlignUp(offset, kChunkAlignment);
+		arrayOffset = offset;
+		offset += elementBytes * capacity;
+	};
+	place(archetype.entityOffset, sizeof(Entity));
+	if (archetype.componentMask & kTransform) {
+		place(archetype.transformOffset, sizeof(TransformComponent));
+	}
+	if (archetype.componentMask & kBounds) {
+		place(archetype.boundsOffset, sizeof(BoundsComponent));
+	}
+	if (archetype.componentMask & kRender) {
+		place(archetype.renderOffset, sizeof(RenderComponent));
+	}
+	if (archetype.componentMask & kPhysics) {
+		place(archetype.physicsOffset, sizeof(PhysicsComponent));
+	}
+	return offset;
+}
+
+//アーキタイプの末尾に場所を確保する
+uint32_t EntityManager::Allocate(Archetype& archetype, Entity entity) {
+	const size_t position = archetype.count;
+	const size_t chunkIndex = position / archetype.chunkCapacity;
+	const size_t row = position % archetype.chunkCapacity;
+	//チャンクは1つの領域で確保して、空になっても捨てずに使い回す
+	if (chunkIndex == archetype.chunks.size()) {
+		Chunk chunk;
+		chunk.memory.reset(static_cast<uint8_t*>(::operator new(archetype.chunkBytes, std::align_val_t(kChunkAlignment))));
+		std::uninitialized_default_construct_n(GetArray<Entity>(chunk, archetype.entityOffset), archetype.chunkCapacity);
+		if (archetype.componentMask & kTransform) {
+			std::uninitialized_default_construct_n(GetArray<TransformComponent>(chunk, archetype.transformOffset), archetype.chunkCapacity);
+		}
+		if (archetype.componentMask & kBounds) {
+			std::uninitialized_default_construct_n(GetArray<BoundsComponent>(chunk, archetype.boundsOffset), archetype.chunkCapacity);
+		}
+		if (archetype.componentMask & kRender) {
+			std::uninitialized_default_construct_n(GetArray<RenderComponent>(chunk, archetype.renderOffset), archetype.chunkCapacity);
+		}
+		if (archetype.componentMask & kPhysics) {
+			std::uninitialized_default_construct_n(GetArray<PhysicsComponent>(chunk, archetype.physicsOffset), archetype.chunkCapacity);
+		}
+		archetype.chunks.push_back(std::move(chunk));
+	}
+
+	//前に使っていた値が残らないように初期値に戻す
+	GetArray<Entity>(archetype.chunks[chunkIndex], archetype.entityOffset)[row] = entity;
+	const ChunkView view = MakeChunkView(archetype, chunkIndex);
+	if (view.transforms) {
+		view.transforms[row] = TransformComponent{};
+	}
+	if (view.bounds) {
+		view.bounds[row] = BoundsComponent{};
+	}
+	if (view.renders) {
+		view.renders[row] = RenderComponent{};
+	}
+	if (view.physics) {
+		view.physics[row] = PhysicsComponent{};
+	}
+	archetype.count++;
+	return static_cast<uint32_t>(position);
+}
+
+//アーキタイプから取り除く
+void EntityManager::Deallocate(Archetype& archetype, uint32_t position) {
+	const size_t last = archetype.count - 1;
+	if (position != last) {
+		//末尾のエンティティを穴に移す
+		const size_t chunkIndex = position / archetype.chunkCapacity;
+		const size_t row = position % archetype.chunkCapacity;
+		const ChunkView chunk = MakeChunkView(archetype, chunkIndex);
+		const ChunkView lastChunk = MakeChunkView(archetype, last / archetype.chunkCapacity);
+		const size_t lastRow = last % archetype.chunkCapacity;
+		Entity* entities = GetArray<Entity>(archetype.chunks[chunkIndex], archetype.entityOffset);
+		entities[row] = lastChunk.entities[lastRow];
+		if (chunk.transforms) {
+			chunk.transforms[row] = lastChunk.transforms[lastRow];
+		}
+		if (chunk.bounds) {
+			chunk.bounds[row] = lastChunk.bounds[lastRow];
+		}
+		if (chunk.renders) {
+			chunk.renders[row] = lastChunk.renders[lastRow];
+		}
+		if (chunk.physics) {
+			chunk.physics[row] = lastChunk.physics[lastRow];
+		}
+		records_[GetIndex(entities[row])].position = position;
+	}
+	archetype.count--;
+}
+
+//別のアーキタイプに移す
+void EntityManager::ChangeArchetype(Entity entity, uint32_t componentMask) {
+	assert(componentMask < kComponentMaskCount);
+	const EntityRecord& record = GetRecord(entity);
+	const uint32_t sourceIndex = record.archetype;
+	const uint32_t sourcePosition = record.position;
+	if (archetypes_[sourceIndex].componentMask == componentMask) {
+		return;
+	}
+	//アーキタイプを作ると配列が伸びるので、参照は作った後で取る
+	const uint32_t destinationIndex = GetOrCreateArchetype(componentMask);
+	Archetype& source = archetypes_[sourceIndex];
+	Archetype& destination = archetypes_[destinationIndex];
+	const uint32_t destinationPosition = Allocate(destination, entity);
+
+	//両方にある成分の値を引き継ぐ
+	const ChunkView from = MakeChunkView(source, sourcePosition / source.chunkCapacity);
+	const size_t fromRow = sourcePosition % source.chunkCapacity;
+	const ChunkView to = MakeChunkView(destination, destinationPosition / destination.chunkCapacity);
+	const size_t toRow = destinationPosition % destination.chunkCapacity;
+	const uint32_t sharedMask = source.componentMask & componentMask;
+	if (sharedMask & kTransform) {
+		to.transforms[toRow] = from.transforms[fromRow];
+	}
+	if (sharedMask & kBounds) {
+		to.bounds[toRow] = from.bounds[fromRow];
+	}
+	if (sharedMask & kRender) {
+		to.renders[toRow] = from.renders[fromRow];
+	}
+	if (sharedMask & kPhysics) {
+		to.physics[toRow] = from.physics[fromRow];
+	}
+
+	Deallocate(source, sourcePosition);
+	EntityRecord& movedRecord = records_[GetIndex(entity)];
+	movedRecord.archetype = destinationIndex;
+	movedRecord.position = destinationPosition;
+}
+
+//条件に合うチャンクを集める
+void EntityManager::CollectChunks(uint32_t componentMask) {
+	queryChunks_.clear();
+	for (Archetype& archetype : archetypes_) {
+		if ((archetype.componentMask & componentMask) != componentMask) {
+			continue;
+		}
+		const size_t chunkCount = (archetype.count + archetype.chunkCapacity - 1) / archetype.chunkCapacity;
+		for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+			queryChunks_.push_back(MakeChunkView(archetype, chunk));
+		}
+	}
+}
+
+//チャンクの中身を作る
+EntityManager::ChunkView EntityManager::MakeChunkView(Archetype& archetype, size_t chunkIndex) {
+	const Chunk& chunk = archetype.chunks[chunkIndex];
+	const size_t begin = chunkIndex * archetype.chunkCapacity;
+	return {
+		.entities = GetArray<Entity>(chunk, archetype.entityOffset),
+		.count = std::min(archetype.chunkCapacity, archetype.count - begin),
+		.transforms = (archetype.componentMask & kTransform) ? GetArray<TransformComponent>(chunk, archetype.transformOffset) : nullptr,
+		.bounds = (archetype.componentMask & kBounds) ? GetArray<BoundsComponent>(chunk, archetype.boundsOffset) : nullptr,
+		.renders = (archetype.componentMask & kRender) ? GetArray<RenderComponent>(chunk, archetype.renderOffset) : nullptr,
+		.physics = (archetype.componentMask & kPhysics) ? GetArray<PhysicsComponent>(chunk, archetype.physicsOffset) : nullptr,
+	};
+}
+
+//エンティティの居場所
+const EntityManager::EntityRecord& EntityManager::GetRecord(Entity entity) const {
+	assert(IsValid(entity));
+	return records_[GetIndex(entity)];
+}
@@ -0,0 +1,280 @@
+#pragma once
+#include "MathData.h"
+#include "Shape.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+/// <summary>
+/// エンティティと、その成分(コンポーネント)の管理
+/// </summary>
+/// <remarks>
+/// 同じ成分の組み合わせ(アーキタイプ)のエンティティを固定数ずつのチャンクにまとめ、チャンクの中は成分ごとの配列に持つ。
+/// チャンクはkChunkBytesの1つの領域で、成分ごとの配列はその中の決まった位置に並べる。
+/// クエリは条件に合うアーキタイプのチャンクを先頭から順に渡すので、同じ処理をするエンティティは配列を続けて読む1つのループで回せる。
+/// 削除や成分の付け外しはアーキタイプの末尾のエンティティで穴を埋めるので、クエリの最中には行わないこと
+/// </remarks>
+class EntityManager {
+public://構造体
+	/// <summary>
+	/// エンティティを指すハンドル(下位20ビットが番号、上位12ビットが世代)
+	/// </summary>
+	struct Entity {
+		uint32_t id = 0xFFFFFFFFu; //番号と世代
+	};
+
+	/// <summary>
+	/// 位置・姿勢・大きさ
+	/// </summary>
+	struct TransformComponent {
+		Vector3 scale = { 1.0f,1.0f,1.0f }; //拡縮
+		Vector3 rotate = { 0.0f,0.0f,0.0f }; //回転
+		Vector3 translate = { 0.0f,0.0f,0.0f }; //移動
+		Matrix4x4 worldMatrix = Matrix4x4::Identity4x4(); //ワールド行列
+	};
+
+	/// <summary>
+	/// 境界箱
+	/// </summary>
+	struct BoundsComponent {
+		AABB localBounds = { { -0.5f,-0.5f,-0.5f },{ 0.5f,0.5f,0.5f } }; //ローカル座標での境界箱
+		AABB worldBounds = { { -0.5f,-0.5f,-0.5f },{ 0.5f,0.5f,0.5f } }; //ワールド座標での境界箱
+	};
+
+	/// <summary>
+	/// 描画
+	/// </summary>
+	struct RenderComponent {
+		uint32_t color = 0x000000FF; //色
+		bool isVisible = true; //描画するか
+	};
+
+	/// <summary>
+	/// 動き
+	/// </summary>
+	struct PhysicsComponent {
+		Vector3 velocity = { 0.0f,0.0f,0.0f }; //速度
+		Vector3 angularVelocity = { 0.0f,0.0f,0.0f }; //回転の速さ(各軸の角度の変化量)
+		float inverseMass = 1.0f; //質量の逆数(動かないものは0)
+	};
+
+	/// <summary>
+	/// クエリに渡すチャンクの中身(持っていない成分はnullptr)
+	/// </summary>
+	struct ChunkView {
+		const Entity* entities; //エンティティ
+		size_t count; //エンティティ数
+		TransformComponent* transforms; //位置・姿勢・大きさ
+		BoundsComponent* bounds; //境界箱
+		RenderComponent* renders; //描画
+		PhysicsComponent* physics; //動き
+	};
+public://メンバ関数
+	/// <summary>
+	/// エンティティの追加
+	/// </summary>
+	/// <param name="componentMask">持たせる成分(kTransformなどの組み合わせ)</param>
+	/// <returns>ハンドル(番号を使い切っていれば無効なハンドル)</returns>
+	Entity CreateEntity(uint32_t componentMask);
+
+	/// <summary>
+	/// エンティティの削除
+	/// </summary>
+	/// <param name="entity">ハンドル(無効なハンドルなら何もしない)</param>
+	void DestroyEntity(Entity entity);
+
+	/// <summary>
+	/// ハンドルが有効か
+	/// </summary>
+	bool IsValid(Entity entity) const;
+
+	/// <summary>
+	/// 全削除
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 成分を加える(持っていた成分の値はそのまま)
+	/// </summary>
+	/// <param name="entity">ハンドル</param>
+	/// <param name="componentMask">加える成分</param>
+	void AddComponents(Entity entity, uint32_t componentMask);
+
+	/// <summary>
+	/// 成分を外す
+	/// </summary>
+	/// <param name="entity">ハンドル</param>
+	/// <param name="componentMask">外す成分</param>
+	void RemoveComponents(Entity entity, uint32_t componentMask);
+
+	/// <summary>
+	/// 持っている成分のゲッター
+	/// </summary>
+	uint32_t GetComponentMask(Entity entity) const;
+
+	/// <summary>
+	/// 指定した成分をすべて持っているか
+	/// </summary>
+	bool HasComponents(Entity entity, uint32_t componentMask) const { return (GetComponentMask(entity) & componentMask) == componentMask; }
+
+	/// <summary>
+	/// 位置・姿勢・大きさのゲッター
+	/// </summary>
+	TransformComponent& GetTransform(Entity entity);
+
+	/// <summary>
+	/// 境界箱のゲッター
+	/// </summary>
+	BoundsComponent& GetBounds(Entity entity);
+
+	/// <summary>
+	/// 描画のゲッター
+	/// </summary>
+	RenderComponent& GetRender(Entity entity);
+
+	/// <summary>
+	/// 動きのゲッター
+	/// </summary>
+	PhysicsComponent& GetPhysics(Entity entity);
+
+	/// <summary>
+	/// 指定した成分をすべて持つエンティティのチャンクを順に処理する
+	/// </summary>
+	/// <param name="componentMask">必要な成分</param>
+	/// <param name="function">チャンクごとの処理</param>
+	void Query(uint32_t componentMask, const std::function<void(const ChunkView&)>& function);
+
+	/// <summary>
+	/// 指定した成分をすべて持つエンティティのチャンクをJobSystemで分担して処理する
+	/// </summary>
+	/// <param name="componentMask">必要な成分</param>
+	/// <param name="function">チャンクごとの処理(別々のチャンクから同時に呼ばれる)</param>
+	void ParallelQuery(uint32_t componentMask, const std::function<void(const ChunkView&)>& function);
+
+	/// <summary>
+	/// エンティティ数のゲッター
+	/// </summary>
+	size_t GetEntityCount() const { return entityCount_; }
+public://定数
+	//位置・姿勢・大きさ
+	static inline const uint32_t kTransform = 1u << 0;
+	//境界箱
+	static inline const uint32_t kBounds = 1u << 1;
+	//描画
+	static inline const uint32_t kRender = 1u << 2;
+	//動き
+	static inline const uint32_t kPhysics = 1u << 3;
+	//成分の組み合わせの数
+	static inline const uint32_t kComponentMaskCount = 1u << 4;
+	//チャンク1つの大きさ(バイト)
+	static inline const size_t kChunkBytes = 16384;
+	//チャンクの中の配列の先頭のそろえ方(キャッシュラインの大きさ)
+	static inline const size_t kChunkAlignment = 64;
+	//ハンドルの番号のビット数
+	static inline const uint32_t kIndexBits = 20;
+	//使い回す前に空けておく番号の数(同じ番号の世代が早く一周しないように)
+	static inline const size_t kMinFreeIndexCount = 1024;
+private://構造体
+	/// <summary>
+	/// チャンクの領域の解放
+	/// </summary>
+	struct ChunkDeleter {
+		void operator()(uint8_t* memory) const { ::operator delete(memory, std::align_val_t(kChunkAlignment)); }
+	};
+
+	/// <summary>
+	/// チャンク(kChunkBytesの領域に、成分ごとの配列をchunkCapacity個分ずつ並べる)
+	/// </summary>
+	struct Chunk {
+		std::unique_ptr<uint8_t, ChunkDeleter> memory; //領域
+	};
+
+	/// <summary>
+	/// 成分の組み合わせごとのエンティティの集まり(前のチャンクから詰めて入れる)
+	/// </summary>
+	struct Archetype {
+		uint32_t componentMask; //持っている成分
+		size_t chunkCapacity; //チャンク1つに入る数
+		size_t chunkBytes; //チャンク1つの大きさ(ふつうはkChunkBytes。1つも入らなければ1つ分)
+		size_t count; //エンティティ数
+		size_t entityOffset; //チャンクの中のエンティティの配列の位置
+		size_t transformOffset; //チャンクの中の位置・姿勢・大きさの配列の位置
+		size_t boundsOffset; //チャンクの中の境界箱の配列の位置
+		size_t renderOffset; //チャンクの中の描画の配列の位置
+		size_t physicsOffset; //チャンクの中の動きの配列の位置
+		std::vector<Chunk> chunks; //チャンク
+	};
+
+	/// <summary>
+	/// エンティティの居場所
+	/// </summary>
+	struct EntityRecord {
+		uint32_t archetype; //アーキタイプの番号
+		uint32_t position; //アーキタイプの中での番号
+		uint32_t generation; //世代
+		bool isAlive; //使われているか
+	};
+private://メンバ関数
+	/// <summary>
+	/// 成分の組み合わせのアーキタイプ(なければ作る)
+	/// </summary>
+	uint32_t GetOrCreateArchetype(uint32_t componentMask);
+
+	/// <summary>
+	/// チャンクの中の配列の位置を決める
+	/// </summary>
+	/// <param name="archetype">アーキタイプ(位置を書き込む)</param>
+	/// <param name="capacity">チャンク1つに入る数</param>
+	/// <returns>チャンクに必要な大きさ(バイト)</returns>
+	static size_t LayoutChunk(Archetype& archetype, size_t capacity);
+
+	/// <summary>
+	/// チャンクの中の配列
+	/// </summary>
+	/// <param name="chunk">チャンク</param>
+	/// <param name="offset">配列の位置</param>
+	template<class T>
+	static T* GetArray(const Chunk& chunk, size_t offset) { return std::launder(reinterpret_cast<T*>(chunk.memory.get() + offset)); }
+
+	/// <summary>
+	/// アーキタイプの末尾に場所を確保する
+	/// </summary>
+	/// <returns>アーキタイプの中での番号</returns>
+	uint32_t Allocate(Archetype& archetype, Entity entity);
+
+	/// <summary>
+	/// アーキタイプから取り除き、末尾のエンティティで穴を埋める
+	/// </summary>
+	void Deallocate(Archetype& archetype, uint32_t position);
+
+	/// <summary>
+	/// 別のアーキタイプに移す(両方にある成分の値は引き継ぐ)
+	/// </summary>
+	void ChangeArchetype(Entity entity, uint32_t componentMask);
+
+	/// <summary>
+	/// 条件に合うチャンクを集める
+	/// </summary>
+	void CollectChunks(uint32_t componentMask);
+
+	/// <summary>
+	/// チャンクの中身を作る
+	/// </summary>
+	ChunkView MakeChunkView(Archetype& archetype, size_t chunkIndex);
+
+	/// <summary>
+	/// エンティティの居場所(有効なハンドルであること)
+	/// </summary>
+	const EntityRecord& GetRecord(Entity entity) const;
+private://メンバ変数
+	std::vector<Archetype> archetypes_; //アーキタイプ
+	uint32_t archetypeOfMask_[kComponentMaskCount] = {}; //成分の組み合わせからアーキタイプの番号+1(0はまだない)
+	std::vector<EntityRecord> records_; //番号ごとのエンティティの居場所
+	std::deque<uint32_t> freeIndices_; //空いている番号(古いものから使い回す)
+	size_t entityCount_ = 0; //エンティティ数
+	std::vector<ChunkView> queryChunks_; //並列クエリの作業用
+};
@@ -0,0 +1,155 @@
+#include "FrameAllocator.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <new>
+
+namespace {
+	/// <summary>
+	/// alignmentの倍数に切り上げる
+	/// </summary>
+	size_t AlignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+//コンストラクタ
+FrameArena::FrameArena(size_t capacity) : capacity_(std::max<size_t>(capacity, kMaxAlignment)) {
+	assert(capacity_ <= UINT32_MAX && "FrameArena capacity must fit in 32 bits");
+	buffer_ = static_cast<uint8_t*>(::operator new(capacity_, std::align_val_t(kMaxAlignment)));
+}
+
+//デストラクタ
+FrameArena::~FrameArena() {
+	for (const OverflowBlock& block : overflowBlocks_) {
+		::operator delete(block.pointer, std::align_val_t(block.alignment));
+	}
+	::operator delete(buffer_, std::align_val_t(kMaxAlignment));
+}
+
+//確保
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+	assert(std::has_single_bit(alignment) && alignment <= kMaxAlignment && "alignment must be a power of two up to kMaxAlignment");
+#ifndef NDEBUG
+	//確保の情報を前に、番兵を後ろに置く
+	const size_t start = AlignUp(offset_ + sizeof(DebugHeader), alignment);
+	const size_t end = start + size + kGuardSize;
+#else
+	const size_t start = AlignUp(offset_, alignment);
+	const size_t end = start + size;
+#endif
+	if (end > capacity_ || end < start) {
+		return AllocateOverflow(size, alignment);
+	}
+#ifndef NDEBUG
+	const DebugHeader header = { lastHeader_, static_cast<uint32_t>(size) };
+	lastHeader_ = static_cast<uint32_t>(start - sizeof(DebugHeader));
+	std::memcpy(buffer_ + lastHeader_, &header, sizeof(header));
+	std::memset(buffer_ + start + size, kGuardByte, kGuardSize);
+#endif
+	offset_ = end;
+	peakBytes_ = std::max(peakBytes_, GetUsedBytes());
+	return buffer_ + start;
+}
+
+//すべて解放する
+void FrameArena::Reset() {
+#ifndef NDEBUG
+	CheckGuards();
+	std::memset(buffer_, kFreedByte, offset_);
+#endif
+	for (const OverflowBlock& block : overflowBlocks_) {
+		::operator delete(block.pointer, std::align_val_t(block.alignment));
+	}
+
+	//あふれた分が次から入るように広げる(揃えと番兵の分も見込む)
+	if (!overflowBlocks_.empty()) {
+		const size_t required = capacity_ + overflowBytes_ + overflowBlocks_.size() * (kMaxAlignment + sizeof(DebugHeader) + kGuardSize);
+		capacity_ = std::bit_ceil(required);
+		assert(capacity_ <= UINT32_MAX && "FrameArena capacity must fit in 32 bits");
+		::operator delete(buffer_, std::align_val_t(kMaxAlignment));
+		buffer_ = static_cast<uint8_t*>(::operator new(capacity_, std::align_val_t(kMaxAlignment)));
+		overflowBlocks_.clear();
+	}
+
+	offset_ = 0;
+	overflowBytes_ = 0;
+	lastHeader_ = kNoHeader;
+	generation_++;
+}
+
+//領域に入りきらない分をヒープから確保する
+void* FrameArena::AllocateOverflow(size_t size, size_t alignment) {
+	void* pointer = ::operator new(size, std::align_val_t(alignment));
+	overflowBlocks_.push_back({ pointer, alignment });
+	overflowBytes_ += size;
+	peakBytes_ = std::max(peakBytes_, GetUsedBytes());
+	return pointer;
+}
+
+//番兵が書き換えられていないか調べる
+void FrameArena::CheckGuards() const {
+#ifndef NDEBUG
+	//最後の確保から前へたどる
+	for (uint32_t position = lastHeader_; position != kNoHeader;) {
+		DebugHeader header;
+		std::memcpy(&header, buffer_ + position, sizeof(header));
+		const uint8_t* guard = buffer_ + position + sizeof(DebugHeader) + header.size;
+		for (size_t i = 0; i < kGuardSize; i++) {
+			assert(guard[i] == kGuardByte && "FrameArena allocation was written past its end");
+		}
+		position = header.previousHeader;
+	}
+#endif
+}
+
+//インスタンスのゲッター
+FrameAllocator* FrameAllocator::GetInstance() {
+	assert(!isFinalize && "GetInstance() called after Finalize()");
+	if (instance == nullptr) {
+		instance = new FrameAllocator();
+	}
+	return instance;
+}
+
+//終了
+void FrameAllocator::Finalize() {
+	delete instance;
+	instance = nullptr;
+	isFinalize = true;
+}
+
+//呼んだスレッドの領域のゲッター
+FrameArena& FrameAllocator::GetThreadArena() {
+	//初めて使ったスレッドにだけ割り当てる
+	if (threadArena == nullptr) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		arenas_.push_back(std::make_unique<FrameArena>(kArenaCapacity));
+		threadArena = arenas_.back().get();
+	}
+	return *threadArena;
+}
+
+//フレームの終了
+void FrameAllocator::EndFrame() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (const std::unique_ptr<FrameArena>& arena : arenas_) {
+		arena->Reset();
+	}
+}
+
+//全スレッドの領域で使っているバイト数の合計のゲッター
+size_t FrameAllocator::GetUsedBytes() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	size_t usedBytes = 0;
+	for (const std::unique_ptr<FrameArena>& arena : arenas_) {
+		usedBytes += arena->GetUsedBytes();
+	}
+	return usedBytes;
+}
+
+//領域の数のゲッター
+size_t FrameAllocator::GetArenaCount() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return arenas_.size();
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// <summary>
+/// 線形に確保してまとめて解放する領域(1フレームだけ使うデータ用)
+/// </summary>
+/// <remarks>
+/// 確保は位置を進めるだけで、Resetで全部を一度に解放する。
+/// 入りきらなかった分は一時的にヒープから確保し、次のResetで足りなかった分まで領域を広げるので、
+/// 使う量が落ち着けばヒープからは確保しなくなる。
+/// デバッグビルドでは確保ごとに後ろに番兵を置いてResetであふれを調べ、解放した領域を0xDDで埋める。
+/// Resetのたびに世代を進め、ArenaAllocatorは作ったときの世代と比べてResetの後の使用を検出する
+/// </remarks>
+class FrameArena {
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="capacity">最初の大きさ(バイト)</param>
+	explicit FrameArena(size_t capacity);
+
+	/// <summary>
+	/// デストラクタ
+	/// </summary>
+	~FrameArena();
+
+	//コピーの禁止
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	/// <summary>
+	/// 確保(次のResetまで有効)
+	/// </summary>
+	/// <param name="size">バイト数</param>
+	/// <param name="alignment">揃えるバイト数(2のべき乗、kMaxAlignment以下)</param>
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	/// <summary>
+	/// 配列の確保(コンストラクタは呼ばない)
+	/// </summary>
+	/// <param name="count">要素数</param>
+	template<class T>
+	T* AllocateArray(size_t count) { return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T))); }
+
+	/// <summary>
+	/// すべて解放する(足りなかった分だけ領域を広げる)
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 使っているバイト数のゲッター(あふれてヒープから確保した分を含む)
+	/// </summary>
+	size_t GetUsedBytes() const { return offset_ + overflowBytes_; }
+
+	/// <summary>
+	/// 領域の大きさのゲッター
+	/// </summary>
+	size_t GetCapacity() const { return capacity_; }
+
+	/// <summary>
+	/// 今までで最も多く使ったバイト数のゲッター
+	/// </summary>
+	size_t GetPeakBytes() const { return peakBytes_; }
+
+	/// <summary>
+	/// 世代(Resetした回数)のゲッター
+	/// </summary>
+	uint32_t GetGeneration() const { return generation_; }
+
+	/// <summary>
+	/// 領域に入りきらずにヒープから確保した回数のゲッター(Resetまで)
+	/// </summary>
+	uint32_t GetOverflowCount() const { return static_cast<uint32_t>(overflowBlocks_.size()); }
+public://定数
+	//揃えるバイト数の上限(領域の先頭をこれに揃える)
+	static inline const size_t kMaxAlignment = 64;
+private://構造体
+	/// <summary>
+	/// あふれてヒープから確保したブロック
+	/// </summary>
+	struct OverflowBlock {
+		void* pointer; //先頭
+		size_t alignment; //揃えたバイト数(解放に使う)
+	};
+
+	/// <summary>
+	/// 確保ごとの情報(デバッグビルドだけ確保した領域の前に置く)
+	/// </summary>
+	struct DebugHeader {
+		uint32_t previousHeader; //1つ前の情報の位置(最初はkNoHeader)
+		uint32_t size; //確保したバイト数(番兵はこの後ろ)
+	};
+private://定数
+	//番兵のバイト数
+	static inline const size_t kGuardSize = 8;
+	//番兵の値
+	static inline const uint8_t kGuardByte = 0xFD;
+	//解放した領域を埋める値
+	static inline const uint8_t kFreedByte = 0xDD;
+	//前の情報がないことを表す位置
+	static inline const uint32_t kNoHeader = UINT32_MAX;
+private://メンバ関数
+	/// <summary>
+	/// 領域に入りきらない分をヒープから確保する
+	/// </summary>
+	void* AllocateOverflow(size_t size, size_t alignment);
+
+	/// <summary>
+	/// 番兵が書き換えられていないか調べる(デバッグビルドだけ)
+	/// </summary>
+	void CheckGuards() const;
+private://メンバ変数
+	uint8_t* buffer_ = nullptr; //領域
+	size_t capacity_ = 0; //領域の大きさ
+	size_t offset_ = 0; //次に確保する位置
+	size_t overflowBytes_ = 0; //あふれてヒープから確保したバイト数
+	size_t peakBytes_ = 0; //最も多く使ったバイト数
+	uint32_t generation_ = 0; //Resetした回数
+	uint32_t lastHeader_ = kNoHeader; //最後の確保の情報の位置(デバッグビルドだけ使う)
+	std::vector<OverflowBlock> overflowBlocks_; //あふれてヒープから確保したブロック
+};
+
+/// <summary>
+/// スレッドごとのフレーム用の領域(Novice::EndFrameの後にまとめて解放する)
+/// </summary>
+/// <remarks>
+/// 領域は初めて使ったスレッドに1つずつ割り当て、JobSystemのワーカーもそれぞれ自分の領域から確保する。
+/// EndFrameはどのスレッドも確保していない間(ParallelForの外)に呼ぶ
+/// </remarks>
+class FrameAllocator {
+public://メンバ関数
+	/// <summary>
+	/// インスタンスのゲッター
+	/// </summary>
+	/// <returns></returns>
+	static FrameAllocator* GetInstance();
+
+	/// <summary>
+	/// 終了
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// 呼んだスレッドの領域のゲッター
+	/// </summary>
+	FrameArena& GetThreadArena();
+
+	/// <summary>
+	/// フレームの終了(すべてのスレッドの領域を解放する)
+	/// </summary>
+	void EndFrame();
+
+	/// <summary>
+	/// 全スレッドの領域で使っているバイト数の合計のゲッター
+	/// </summary>
+	size_t GetUsedBytes();
+
+	/// <summary>
+	/// 領域の数(使ったスレッドの数)のゲッター
+	/// </summary>
+	size_t GetArenaCount();
+public://定数
+	//1スレッドの領域の最初の大きさ
+	static inline const size_t kArenaCapacity = 256 * 1024;
+private://静的メンバ変数
+	//インスタンス
+	static inline FrameAllocator* instance = nullptr;
+	//解放したかどうか
+	static inline bool isFinalize = false;
+	//呼んだスレッドの領域
+	static inline thread_local FrameArena* threadArena = nullptr;
+private://メンバ関数
+	//コンストラクタの封印
+	FrameAllocator() = default;
+	//デストラクタの封印
+	~FrameAllocator() = default;
+	//コピーコンストラクタの封印
+	FrameAllocator(const FrameAllocator&) = delete;
+	//代入演算子の封印
+	FrameAllocator& operator=(const FrameAllocator&) = delete;
+private://メンバ変数
+	std::mutex mutex_; //arenas_を守る
+	std::vector<std::unique_ptr<FrameArena>> arenas_; //スレッドごとの領域
+};
+
+/// <summary>
+/// FrameArenaから確保する標準コンテナ用のアロケータ(解放は何もしない)
+/// </summary>
+/// <remarks>
+/// 作ったときの世代を覚えておき、ArenaがResetされた後に確保・解放するとassertで止める
+/// (フレームをまたいでFrameVectorを持ち越したときなど)
+/// </remarks>
+template<class T>
+class ArenaAllocator {
+public://型
+	using value_type = T;
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="arena">確保する領域</param>
+	ArenaAllocator(FrameArena& arena) : arena_(&arena), generation_(arena.GetGeneration()) {}
+
+	/// <summary>
+	/// 別の型のアロケータからのコンストラクタ
+	/// </summary>
+	template<class U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena_), generation_(other.generation_) {}
+
+	/// <summary>
+	/// 確保
+	/// </summary>
+	T* allocate(size_t count) {
+		assert(generation_ == arena_->GetGeneration() && "FrameArena used after Reset()");
+		return arena_->AllocateArray<T>(count);
+	}
+
+	/// <summary>
+	/// 解放(Resetでまとめて解放するので何もしない)
+	/// </summary>
+	void deallocate(T*, size_t) {
+		assert(generation_ == arena_->GetGeneration() && "FrameArena used after Reset()");
+	}
+
+	/// <summary>
+	/// 同じ領域から確保するか
+	/// </summary>
+	template<class U>
+	bool operator==(const ArenaAllocator<U>& other) const { return arena_ == other.arena_; }
+private://メンバ変数
+	template<class U>
+	friend class ArenaAllocator;
+
+	FrameArena* arena_; //確保する領域
+	uint32_t generation_; //作ったときの世代
+};
+
+/// <summary>
+/// フレーム用の領域から確保する可変長配列
+/// </summary>
+template<class T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,38 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+template<class Signature>
+class FunctionRef;
+
+/// <summary>
+/// 呼び出せるものへの参照(std::functionと違って写しを持たないので、キャプチャが大きくてもヒープを使わない)
+/// </summary>
+/// <remarks>
+/// 参照先より長く持たないこと。引数で受け取ってその呼び出しの中だけで使う
+/// </remarks>
+template<class Result, class... Args>
+class FunctionRef<Result(Args...)> {
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="function">呼び出せるもの(ラムダ式やstd::function)</param>
+	template<class Function>
+		requires (!std::is_same_v<std::remove_cvref_t<Function>, FunctionRef> && std::is_invocable_r_v<Result, Function&, Args...>)
+	FunctionRef(Function&& function)
+		: object_(const_cast<void*>(static_cast<const void*>(std::addressof(function)))),
+		invoke_([](void* object, Args... args) -> Result {
+		return (*static_cast<std::remove_reference_t<Function>*>(object))(std::forward<Args>(args)...);
+			}) {
+	}
+
+	/// <summary>
+	/// 呼び出し
+	/// </summary>
+	Result operator()(Args... args) const { return invoke_(object_, std::forward<Args>(args)...); }
+private://メンバ変数
+	void* object_; //参照先
+	Result(*invoke_)(void*, Args...); //参照先の型に戻して呼び出す関数
+};
@@ -0,0 +1,646 @@
+#include "Gjk.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	//原点に重なっているとみなす距離の2乗
+	const float kIntersectEpsilonSquared = 1.0e-12f;
+	//退化しているとみなす値
+	const float kDegenerateEpsilon = 1.0e-12f;
+	//三角形や四面体が潰れているとみなす割合(辺の長さの積に対する面積や体積)
+	const float kRelativeDegenerateEpsilon = 1.0e-5f;
+	//EPAの多面体の大きさ
+	const int kEpaMaxVertices = 64;
+	const int kEpaMaxFaces = 128;
+	const int kEpaMaxEdges = 128;
+
+	/// <summary>
+	/// 単体の頂点(ミンコフスキー差A-B上の点)
+	/// </summary>
+	struct SimplexVertex {
+		Vector3 a; //Aのサポート点
+		Vector3 b; //Bのサポート点
+		Vector3 w; //a - b
+		Vector3 direction; //サポートを求めた方向
+		float weight; //最近点の重心座標
+	};
+
+	/// <summary>
+	/// 単体
+	/// </summary>
+	struct Simplex {
+		SimplexVertex vertices[4];
+		int count = 0;
+
+		//原点に一番近い点
+		Vector3 ClosestPoint() const {
+			Vector3 result = {};
+			for (int i = 0; i < count; i++) {
+				result += vertices[i].w * vertices[i].weight;
+			}
+			return result;
+		}
+		//形状ごとの最近点
+		void GetWitnessPoints(Vector3& pointA, Vector3& pointB) const {
+			pointA = {};
+			pointB = {};
+			for (int i = 0; i < count; i++) {
+				pointA += vertices[i].a * vertices[i].weight;
+				pointB += vertices[i].b * vertices[i].weight;
+			}
+		}
+	};
+
+	/// <summary>
+	/// ミンコフスキー差のサポート点
+	/// </summary>
+	/// <param name="useCore">丸みを除いた芯の形状を使うか</param>
+	SimplexVertex MakeVertex(const SupportShape& shapeA, const SupportShape& shapeB, const Vector3& direction, bool useCore = false) {
+		SimplexVertex vertex;
+		vertex.a = useCore ? shapeA.SupportCore(direction) : shapeA.Support(direction);
+		vertex.b = useCore ? shapeB.SupportCore(-direction) : shapeB.Support(-direction);
+		vertex.w = vertex.a - vertex.b;
+		vertex.direction = direction;
+		vertex.weight = 1.0f;
+		return vertex;
+	}
+
+	/// <summary>
+	/// 頂点を1つだけ残す
+	/// </summary>
+	void KeepVertex(Simplex& simplex, int index) {
+		simplex.vertices[0] = simplex.vertices[index];
+		simplex.vertices[0].weight = 1.0f;
+		simplex.count = 1;
+	}
+
+	/// <summary>
+	/// 頂点を2つだけ残す
+	/// </summary>
+	void KeepEdge(Simplex& simplex, int index0, int index1, float t) {
+		SimplexVertex v0 = simplex.vertices[index0];
+		SimplexVertex v1 = simplex.vertices[index1];
+		v0.weight = 1.0f - t;
+		v1.weight = t;
+		simplex.vertices[0] = v0;
+		simplex.vertices[1] = v1;
+		simplex.count = 2;
+	}
+
+	/// <summary>
+	/// 線分の原点に一番近い点
+	/// </summary>
+	void SolveSegment(Simplex& simplex) {
+		const Vector3& w0 = simplex.vertices[0].w;
+		Vector3 edge = simplex.vertices[1].w - w0;
+		float lengthSquared = edge.Dot(edge);
+		if (lengthSquared < kDegenerateEpsilon) {
+			KeepVertex(simplex, 0);
+			return;
+		}
+		float t = -w0.Dot(edge) / lengthSquared;
+		if (t <= 0.0f) {
+			KeepVertex(simplex, 0);
+		} else if (t >= 1.0f) {
+			KeepVertex(simplex, 1);
+		} else {
+			KeepEdge(simplex, 0, 1, t);
+		}
+	}
+
+	/// <summary>
+	/// 三角形の原点に一番近い点(ボロノイ領域で場合分け)
+	/// </summary>
+	void SolveTriangle(Simplex& simplex) {
+		const Vector3 a = simplex.vertices[0].w;
+		const Vector3 b = simplex.vertices[1].w;
+		const Vector3 c = simplex.vertices[2].w;
+		const Vector3 ab = b - a;
+		const Vector3 ac = c - a;
+
+		float d1 = -ab.Dot(a);
+		float d2 = -ac.Dot(a);
+		if (d1 <= 0.0f && d2 <= 0.0f) {
+			KeepVertex(simplex, 0);
+			return;
+		}
+		float d3 = -ab.Dot(b);
+		float d4 = -ac.Dot(b);
+		if (d3 >= 0.0f && d4 <= d3) {
+			KeepVertex(simplex, 1);
+			return;
+		}
+		float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+			KeepEdge(simplex, 0, 1, d1 / (d1 - d3));
+			return;
+		}
+		float d5 = -ab.Dot(c);
+		float d6 = -ac.Dot(c);
+		if (d6 >= 0.0f && d5 <= d6) {
+			KeepVertex(simplex, 2);
+			return;
+		}
+		float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+			KeepEdge(simplex, 0, 2, d2 / (d2 - d6));
+			return;
+		}
+		float va = d3 * d6 - d5 * d4;
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+			KeepEdge(simplex, 1, 2, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+			return;
+		}
+		//va + vb + vc は外積の長さの2乗
+		float sum = va + vb + vc;
+		if (sum <= kRelativeDegenerateEpsilon * ab.Dot(ab) * ac.Dot(ac)) {
+			//潰れた三角形は一番近い辺にする
+			SolveSegment(simplex);
+			return;
+		}
+		float v = vb / sum;
+		float w = vc / sum;
+		simplex.vertices[0].weight = 1.0f - v - w;
+		simplex.vertices[1].weight = v;
+		simplex.vertices[2].weight = w;
+	}
+
+	/// <summary>
+	/// 四面体の原点に一番近い点
+	/// </summary>
+	/// <returns>原点が内側にあるか</returns>
+	bool SolveTetrahedron(Simplex& simplex) {
+		const SimplexVertex* v = simplex.vertices;
+		//面(3頂点)と反対側の頂点
+		const int faces[4][4] = { { 0,1,2,3 },{ 0,3,1,2 },{ 0,2,3,1 },{ 1,3,2,0 } };
+		Vector3 ab = v[1].w - v[0].w;
+		Vector3 ac = v[2].w - v[0].w;
+		Vector3 ad = v[3].w - v[0].w;
+		float volume = std::abs(ab.Cross(ac).Dot(ad));
+		float scale = std::sqrt(ab.Dot(ab) * ac.Dot(ac) * ad.Dot(ad));
+		bool isDegenerate = volume <= kRelativeDegenerateEpsilon * scale;
+
+		Simplex best;
+		float bestDistanceSquared = std::numeric_limits<float>::infinity();
+		bool isInside = !isDegenerate;
+		for (const int* face : faces) {
+			const Vector3& p0 = v[face[0]].w;
+			Vector3 normal = (v[face[1]].w - p0).Cross(v[face[2]].w - p0);
+			float originSide = -p0.Dot(normal);
+			float oppositeSide = (v[face[3]].w - p0).Dot(normal);
+			//原点が反対側の頂点と逆側にある面だけ調べる
+			if (!isDegenerate && originSide * oppositeSide >= 0.0f) {
+				continue;
+			}
+			isInside = false;
+			Simplex triangle;
+			triangle.vertices[0] = v[face[0]];
+			triangle.vertices[1] = v[face[1]];
+			triangle.vertices[2] = v[face[2]];
+			triangle.count = 3;
+			SolveTriangle(triangle);
+			Vector3 closest = triangle.ClosestPoint();
+			float distanceSquared = closest.Dot(closest);
+			if (distanceSquared < bestDistanceSquared) {
+				bestDistanceSquared = distanceSquared;
+				best = triangle;
+			}
+		}
+		if (isInside) {
+			return true;
+		}
+		simplex = best;
+		return false;
+	}
+
+	/// <summary>
+	/// 単体を原点に一番近い部分単体に縮める
+	/// </summary>
+	/// <returns>原点が四面体の内側にあるか</returns>
+	bool Solve(Simplex& simplex) {
+		switch (simplex.count) {
+		case 1:
+			simplex.vertices[0].weight = 1.0f;
+			return false;
+		case 2:
+			SolveSegment(simplex);
+			return false;
+		case 3:
+			SolveTriangle(simplex);
+			return false;
+		default:
+			return SolveTetrahedron(simplex);
+		}
+	}
+
+	/// <summary>
+	/// GJKの結果
+	/// </summary>
+	enum class GjkStatus {
+		kSeparated,   //離れている(単体は最近点を表す)
+		kIntersecting //重なっている
+	};
+
+	/// <summary>
+	/// GJK本体
+	/// </summary>
+	/// <param name="isEarlyOut">分離が分かった時点で終了するか</param>
+	/// <param name="useCore">丸みを除いた芯の形状を使うか</param>
+	GjkStatus RunGjk(const SupportShape& shapeA, const SupportShape& shapeB, Gjk::Cache* cache, bool isEarlyOut, bool useCore,
+		Simplex& simplex, uint32_t& iterations) {
+		//前回の単体を作り直すか、中心どうしの方向から始める
+		if (cache && cache->count > 0) {
+			simplex.count = static_cast<int>(cache->count);
+			for (int i = 0; i < simplex.count; i++) {
+				simplex.vertices[i] = MakeVertex(shapeA, shapeB, cache->directions[i], useCore);
+			}
+		} else {
+			Vector3 direction = shapeB.GetCenter() - shapeA.GetCenter();
+			if (direction.Dot(direction) < kDegenerateEpsilon) {
+				direction = { 1.0f,0.0f,0.0f };
+			}
+			simplex.vertices[0] = MakeVertex(shapeA, shapeB, direction, useCore);
+			simplex.count = 1;
+		}
+
+		GjkStatus status = GjkStatus::kSeparated;
+		bool isInside = Solve(simplex);
+		iterations = 0;
+		float previousDistanceSquared = std::numeric_limits<float>::infinity();
+		Simplex previous = simplex;
+		while (!isInside && iterations < Gjk::kMaxIterations) {
+			iterations++;
+			Vector3 closest = simplex.ClosestPoint();
+			float distanceSquared = closest.Dot(closest);
+			if (distanceSquared < kIntersectEpsilonSquared) {
+				isInside = true;
+				break;
+			}
+			//丸め誤差で近づかなくなったら、前の単体を答えにして終了
+			if (distanceSquared >= previousDistanceSquared) {
+				simplex = previous;
+				break;
+			}
+			previousDistanceSquared = distanceSquared;
+			previous = simplex;
+
+			//原点の方向へ一番遠い点
+			Vector3 direction = -closest;
+			SimplexVertex vertex = MakeVertex(shapeA, shapeB, direction, useCore);
+			float progress = vertex.w.Dot(direction);
+			if (isEarlyOut && progress < 0.0f) {
+				//原点を越えられないので分離している
+				break;
+			}
+			//これ以上近づかなければ収束
+			if (distanceSquared + progress <= Gjk::kTolerance * distanceSquared) {
+				break;
+			}
+			//同じ点が出たら収束
+			bool isDuplicate = false;
+			for (int i = 0; i < simplex.count; i++) {
+				Vector3 diff = simplex.vertices[i].w - vertex.w;
+				isDuplicate = isDuplicate || diff.Dot(diff) < kDegenerateEpsilon;
+			}
+			if (isDuplicate) {
+				break;
+			}
+
+			simplex.vertices[simplex.count++] = vertex;
+			isInside = Solve(simplex);
+		}
+		if (isInside) {
+			status = GjkStatus::kIntersecting;
+		}
+
+		if (cache) {
+			cache->count = static_cast<uint32_t>(simplex.count);
+			for (int i = 0; i < simplex.count; i++) {
+				cache->directions[i] = simplex.vertices[i].direction;
+			}
+		}
+		return status;
+	}
+
+	/// <summary>
+	/// 原点を含む四面体になるまで単体を膨らませる
+	/// </summary>
+	/// <returns>四面体にできたか(できなければ接しているだけ)</returns>
+	bool BlowUpSimplex(const SupportShape& shapeA, const SupportShape& shapeB, Simplex& simplex) {
+		const Vector3 axes[6] = { { 1,0,0 },{ -1,0,0 },{ 0,1,0 },{ 0,-1,0 },{ 0,0,1 },{ 0,0,-1 } };
+
+		//点から線分
+		if (simplex.count == 1) {
+			for (const Vector3& axis : axes) {
+				SimplexVertex vertex = MakeVertex(shapeA, shapeB, axis);
+				Vector3 diff = vertex.w - simplex.vertices[0].w;
+				if (diff.Dot(diff) > kDegenerateEpsilon) {
+					simplex.vertices[simplex.count++] = vertex;
+					break;
+				}
+			}
+			if (simplex.count < 2) {
+				return false;
+			}
+		}
+
+		//線分から三角形(線分と垂直な方向を順に試す)
+		if (simplex.count == 2) {
+			Vector3 line = simplex.vertices[1].w - simplex.vertices[0].w;
+			for (const Vector3& axis : axes) {
+				Vector3 perpendicular = line.Cross(axis);
+				if (perpendicular.Dot(perpendicular) < kDegenerateEpsilon) {
+					continue;
+				}
+				SimplexVertex vertex = MakeVertex(shapeA, shapeB, perpendicular);
+				Vector3 area = line.Cross(vertex.w - simplex.vertices[0].w);
+				if (area.Dot(area) > kDegenerateEpsilon) {
+					simplex.vertices[simplex.count++] = vertex;
+					break;
+				}
+			}
+			if (simplex.count < 3) {
+				return false;
+			}
+		}
+
+		//三角形から四面体(法線の両側を試す)
+		if (simplex.count == 3) {
+			const Vector3& w0 = simplex.vertices[0].w;
+			Vector3 normal = (simplex.vertices[1].w - w0).Cross(simplex.vertices[2].w - w0);
+			for (float sign : { 1.0f, -1.0f }) {
+				SimplexVertex vertex = MakeVertex(shapeA, shapeB, normal * sign);
+				if (std::abs((vertex.w - w0).Dot(normal)) > kDegenerateEpsilon) {
+					simplex.vertices[simplex.count++] = vertex;
+					break;
+				}
+			}
+			if (simplex.count < 4) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// EPAの多面体の面
+	/// </summary>
+	struct EpaFace {
+		int indices[3]; //頂点番号(外から見て反時計回り)
+		Vector3 normal; //外向きの法線
+		float distance; //原点からの距離
+	};
+
+	/// <summary>
+	/// 面の作成(潰れた面は選ばれないように距離を無限にする)
+	/// </summary>
+	EpaFace MakeFace(const SimplexVertex* vertices, int i0, int i1, int i2) {
+		EpaFace face = { { i0,i1,i2 },{},std::numeric_limits<float>::infinity() };
+		const Vector3& p0 = vertices[i0].w;
+		Vector3 normal = (vertices[i1].w - p0).Cross(vertices[i2].w - p0);
+		float lengthSquared = normal.Dot(normal);
+		if (lengthSquared > kDegenerateEpsilon * kDegenerateEpsilon) {
+			face.normal = normal * (1.0f / std::sqrt(lengthSquared));
+			face.distance = face.normal.Dot(p0);
+		}
+		return face;
+	}
+
+	/// <summary>
+	/// 面が使えるか(潰れておらず、法線の長さが1の面)
+	/// </summary>
+	bool IsValidFace(const EpaFace& face) {
+		return std::isfinite(face.distance) && std::abs(face.normal.Dot(face.normal) - 1.0f) < 1.0e-3f;
+	}
+
+	/// <summary>
+	/// 原点に一番近い面の番号
+	/// </summary>
+	int FindClosestFace(const EpaFace* faces, int faceCount) {
+		int closestFace = 0;
+		for (int i = 1; i < faceCount; i++) {
+			if (faces[i].distance < faces[closestFace].distance) {
+				closestFace = i;
+			}
+		}
+		return closestFace;
+	}
+
+	/// <summary>
+	/// 三角形の重心座標
+	/// </summary>
+	void Barycentric(const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c, float& u, float& v, float& w) {
+		Vector3 v0 = b - a, v1 = c - a, v2 = p - a;
+		float d00 = v0.Dot(v0), d01 = v0.Dot(v1), d11 = v1.Dot(v1);
+		float d20 = v2.Dot(v0), d21 = v2.Dot(v1);
+		float denominator = d00 * d11 - d01 * d01;
+		if (std::abs(denominator) < kDegenerateEpsilon) {
+			u = 1.0f;
+			v = 0.0f;
+			w = 0.0f;
+			return;
+		}
+		v = (d11 * d20 - d01 * d21) / denominator;
+		w = (d00 * d21 - d01 * d20) / denominator;
+		u = 1.0f - v - w;
+	}
+}
+
+//距離と最近点
+Gjk::DistanceResult Gjk::Distance(const SupportShape& shapeA, const SupportShape& shapeB, Cache* cache) {
+	//丸みのある形状は芯どうしの距離から丸みを引く
+	const float marginA = shapeA.GetMargin();
+	const float marginB = shapeB.GetMargin();
+	Simplex simplex;
+	DistanceResult result = {};
+	GjkStatus status = RunGjk(shapeA, shapeB, cache, false, marginA + marginB > 0.0f, simplex, result.iterations);
+	result.isIntersecting = status == GjkStatus::kIntersecting;
+	if (result.isIntersecting) {
+		return result;
+	}
+	simplex.GetWitnessPoints(result.pointA, result.pointB);
+	Vector3 closest = simplex.ClosestPoint();
+	float coreDistance = std::sqrt(closest.Dot(closest));
+	if (coreDistance <= marginA + marginB) {
+		result.isIntersecting = true;
+		return result;
+	}
+	Vector3 normal = closest * (-1.0f / coreDistance);
+	result.pointA += normal * marginA;
+	result.pointB -= normal * marginB;
+	result.distance = coreDistance - marginA - marginB;
+	return result;
+}
+
+//重なっているか
+bool Gjk::IsIntersecting(const SupportShape& shapeA, const SupportShape& shapeB, Cache* cache) {
+	Simplex simplex;
+	uint32_t iterations = 0;
+	return RunGjk(shapeA, shapeB, cache, true, false, simplex, iterations) == GjkStatus::kIntersecting;
+}
+
+//めり込みの法線と深さ
+Gjk::PenetrationResult Gjk::Penetration(const SupportShape& shapeA, const SupportShape& shapeB, Cache* cache) {
+	const float marginA = shapeA.GetMargin();
+	const float marginB = shapeB.GetMargin();
+	const bool useCore = marginA + marginB > 0.0f;
+	Simplex simplex;
+	PenetrationResult result = {};
+	GjkStatus status = RunGjk(shapeA, shapeB, cache, false, useCore, simplex, result.iterations);
+	if (status == GjkStatus::kSeparated) {
+		//芯(丸みがなければ形状そのもの)が離れていれば、最近点の向きを法線にする
+		Vector3 coreA = {};
+		Vector3 coreB = {};
+		simplex.GetWitnessPoints(coreA, coreB);
+		Vector3 closest = simplex.ClosestPoint();
+		float coreDistance = std::sqrt(closest.Dot(closest));
+		if (coreDistance > kDegenerateEpsilon || !useCore) {
+			result.normal = coreDistance > 0.0f ? closest * (-1.0f / coreDistance) : Vector3{ 1.0f,0.0f,0.0f };
+			result.depth = marginA + marginB - coreDistance;
+			result.isIntersecting = result.depth >= 0.0f;
+			result.pointA = coreA + result.normal * marginA;
+			result.pointB = coreB - result.normal * marginB;
+			return result;
+		}
+	}
+	if (useCore) {
+		//芯どうしが重なるほど深ければ、形状そのものでやり直す
+		uint32_t iterations = 0;
+		status = RunGjk(shapeA, shapeB, cache, false, false, simplex, iterations);
+		result.iterations += iterations;
+		if (status == GjkStatus::kSeparated) {
+			simplex.GetWitnessPoints(result.pointA, result.pointB);
+			result.normal = { 1.0f,0.0f,0.0f };
+			result.depth = 0.0f;
+			result.isIntersecting = true;
+			return result;
+		}
+	}
+	result.isIntersecting = true;
+
+	SimplexVertex vertices[kEpaMaxVertices];
+	if (!BlowUpSimplex(shapeA, shapeB, simplex)) {
+		//接しているだけ
+		simplex.GetWitnessPoints(result.pointA, result.pointB);
+		result.normal = { 1.0f,0.0f,0.0f };
+		result.depth = 0.0f;
+		return result;
+	}
+	int vertexCount = 4;
+	for (int i = 0; i < 4; i++) {
+		vertices[i] = simplex.vertices[i];
+	}
+
+	//四面体の面を外向きにそろえる
+	EpaFace faces[kEpaMaxFaces];
+	int faceCount = 0;
+	const int tetrahedron[4][4] = { { 0,1,2,3 },{ 0,3,1,2 },{ 0,2,3,1 },{ 1,3,2,0 } };
+	for (const int* face : tetrahedron) {
+		const Vector3& p0 = vertices[face[0]].w;
+		Vector3 normal = (vertices[face[1]].w - p0).Cross(vertices[face[2]].w - p0);
+		if (normal.Dot(vertices[face[3]].w - p0) > 0.0f) {
+			faces[faceCount++] = MakeFace(vertices, face[0], face[2], face[1]);
+		} else {
+			faces[faceCount++] = MakeFace(vertices, face[0], face[1], face[2]);
+		}
+	}
+
+	//面を張り直すと消えるので、最後に使えた一番近い面を写しておく(頂点は消さないので番号はそのまま使える)
+	EpaFace validFace = {};
+	bool hasValidFace = false;
+	for (uint32_t iteration = 0; iteration < kMaxEpaIterations; iteration++) {
+		result.iterations++;
+		const EpaFace& face = faces[FindClosestFace(faces, faceCount)];
+		//一番近い面まで潰れていれば、どの面も法線を決められない
+		if (!IsValidFace(face)) {
+			break;
+		}
+		validFace = face;
+		hasValidFace = true;
+
+		//面の法線方向にこれ以上広がらなければ収束
+		SimplexVertex vertex = MakeVertex(shapeA, shapeB, face.normal);
+		if (vertex.w.Dot(face.normal) - face.distance < kEpaTolerance || vertexCount == kEpaMaxVertices) {
+			break;
+		}
+		//新しい点から見える面と、その境界の辺を先に調べる(多面体を書き換える前に収まるかを確かめる)
+		bool isVisible[kEpaMaxFaces];
+		int visibleCount = 0;
+		int edges[kEpaMaxEdges][2];
+		int edgeCount = 0;
+		bool isOverflow = false;
+		for (int i = 0; i < faceCount && !isOverflow; i++) {
+			const EpaFace& candidate = faces[i];
+			isVisible[i] = candidate.normal.Dot(vertex.w - vertices[candidate.indices[0]].w) > 0.0f;
+			if (!isVisible[i]) {
+				continue;
+			}
+			visibleCount++;
+			for (int e = 0; e < 3; e++) {
+				int from = candidate.indices[e];
+				int to = candidate.indices[(e + 1) % 3];
+				//逆向きの辺があれば隣の面も消えるので境界ではない
+				bool isShared = false;
+				for (int k = 0; k < edgeCount; k++) {
+					if (edges[k][0] == to && edges[k][1] == from) {
+						edges[k][0] = edges[edgeCount - 1][0];
+						edges[k][1] = edges[edgeCount - 1][1];
+						edgeCount--;
+						isShared = true;
+						break;
+					}
+				}
+				if (isShared) {
+					continue;
+				}
+				if (edgeCount == kEpaMaxEdges) {
+					isOverflow = true;
+					break;
+				}
+				edges[edgeCount][0] = from;
+				edges[edgeCount][1] = to;
+				edgeCount++;
+			}
+		}
+		//収まらない、または閉じた多面体にならなければ、今の多面体の一番近い面を使う
+		if (isOverflow || visibleCount == 0 || edgeCount == 0 || faceCount - visibleCount + edgeCount > kEpaMaxFaces) {
+			break;
+		}
+
+		//見える面を消し、境界の辺と新しい点で面を張る
+		int newIndex = vertexCount;
+		vertices[vertexCount++] = vertex;
+		int keptCount = 0;
+		for (int i = 0; i < faceCount; i++) {
+			if (!isVisible[i]) {
+				faces[keptCount++] = faces[i];
+			}
+		}
+		faceCount = keptCount;
+		for (int e = 0; e < edgeCount; e++) {
+			faces[faceCount++] = MakeFace(vertices, edges[e][0], edges[e][1], newIndex);
+		}
+	}
+
+	//一番近い面への原点の射影から接触点を求める(潰れていれば最後に使えた面、それもなければ接しているだけとする)
+	const EpaFace& closestFace = faces[FindClosestFace(faces, faceCount)];
+	if (!IsValidFace(closestFace) && !hasValidFace) {
+		simplex.GetWitnessPoints(result.pointA, result.pointB);
+		result.normal = { 1.0f,0.0f,0.0f };
+		result.depth = 0.0f;
+		return result;
+	}
+	const EpaFace& face = IsValidFace(closestFace) ? closestFace : validFace;
+	const SimplexVertex& v0 = vertices[face.indices[0]];
+	const SimplexVertex& v1 = vertices[face.indices[1]];
+	const SimplexVertex& v2 = vertices[face.indices[2]];
+	float u = 0.0f, v = 0.0f, w = 0.0f;
+	Barycentric(face.normal * face.distance, v0.w, v1.w, v2.w, u, v, w);
+	result.pointA = v0.a * u + v1.a * v + v2.a * w;
+	result.pointB = v0.b * u + v1.b * v + v2.b * w;
+	result.normal = face.normal;
+	//原点は多面体の中にあるので負にはならないはずだが、丸めで少し負になることがある
+	result.depth = std::max(face.distance, 0.0f);
+	return result;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "SupportShape.h"
+#include <cstdint>
+
+/// <summary>
+/// GJK/EPAによる凸形状どうしの判定
+/// </summary>
+/// <remarks>
+/// 形状はサポート写像(SupportShape)で渡す。Cacheに前フレームの単体を残しておくと、
+/// 少ししか動いていない組は1～2回の反復で収束する
+/// </remarks>
+class Gjk {
+public://構造体
+	/// <summary>
+	/// 前回の単体(頂点を作ったときの方向を覚えておく)
+	/// </summary>
+	struct Cache {
+		Vector3 directions[4] = {}; //頂点ごとのサポートの方向
+		uint32_t count = 0; //頂点数(0なら使わない)
+	};
+
+	/// <summary>
+	/// 距離の結果
+	/// </summary>
+	struct DistanceResult {
+		bool isIntersecting; //重なっているか
+		float distance; //距離(重なっていれば0)
+		Vector3 pointA; //Aの最近点
+		Vector3 pointB; //Bの最近点
+		uint32_t iterations; //反復回数
+	};
+
+	/// <summary>
+	/// めり込みの結果
+	/// </summary>
+	struct PenetrationResult {
+		bool isIntersecting; //重なっているか
+		Vector3 normal; //AからBへの向きの法線(Aを-normal*depth動かすと離れる)
+		float depth; //めり込み量
+		Vector3 pointA; //Bに一番深く入ったAの点
+		Vector3 pointB; //Aに一番深く入ったBの点
+		uint32_t iterations; //反復回数(GJKとEPAの合計)
+	};
+public://メンバ関数
+	/// <summary>
+	/// 距離と最近点
+	/// </summary>
+	/// <param name="shapeA">形状A</param>
+	/// <param name="shapeB">形状B</param>
+	/// <param name="cache">前回の単体(nullptrなら使わない、終了時に書き戻す)</param>
+	static DistanceResult Distance(const SupportShape& shapeA, const SupportShape& shapeB, Cache* cache = nullptr);
+
+	/// <summary>
+	/// 重なっているか(分離が分かった時点で終了する)
+	/// </summary>
+	static bool IsIntersecting(const SupportShape& shapeA, const SupportShape& shapeB, Cache* cache = nullptr);
+
+	/// <summary>
+	/// めり込みの法線と深さ(重なっていなければ距離の結果を返す。重なっていれば深さは0以上で、法線は長さ1)
+	/// </summary>
+	static PenetrationResult Penetration(const SupportShape& shapeA, const SupportShape& shapeB, Cache* cache = nullptr);
+public://定数
+	//GJKの反復回数の上限
+	static inline const uint32_t kMaxIterations = 64;
+	//GJKの収束判定(距離の2乗に対する割合)
+	static inline const float kTolerance = 1.0e-6f;
+	//EPAの反復回数の上限
+	static inline const uint32_t kMaxEpaIterations = 64;
+	//EPAの収束判定(距離)
+	static inline const float kEpaTolerance = 1.0e-4f;
+};
@@ -12,8 +12,33 @@ Input* Input::GetInstance() {
 
 //更新
 void Input::Update() {
-	memcpy(preKeys_, keys_, 256);
-	Novice::GetHitKeyStateAll(keys_);
+	preKeys_ = keys_;
+	events_.clear();
+	if (poller_.IsRunning()) {
+		//届いた出来事を順に当てはめ、押して離したキーは両方に残す
+		pressed_ = {};
+		released_ = {};
+		InputEvent event;
+		while (queue_.Pop(event)) {
+			keys_.Set(event.key, event.isPressed);
+			(event.isPressed ? pressed_ : released_).Set(event.key, true);
+			events_.push_back(event);
+		}
+		return;
+	}
+
+	char keys[KeyBitset::kKeyCount] = {};
+	Novice::GetHitKeyStateAll(keys);
+	keys_ = KeyBitset::FromKeyArray(keys);
+	KeyBitset::DetectEdges(preKeys_, keys_, pressed_, released_);
+
+	//別スレッドで読んでいないときは、このフレームの時刻で出来事を作る
+	const uint64_t timestamp = InputEventQueue::GetTimestamp();
+	for (size_t key = 0; key < KeyBitset::kKeyCount; key++) {
+		if (pressed_.Test(key) || released_.Test(key)) {
+			events_.push_back({ .timestamp = timestamp,.key = static_cast<uint32_t>(key),.isPressed = pressed_.Test(key) });
+		}
+	}
 }
 
 //終了
@@ -23,22 +48,27 @@ void Input::Finalize() {
 	isFinalize = true;
 }
 
-//Pressキーのゲッター
-bool Input::GetPressKeys(int32_t keyNumber){
-	//指定キーを押していればtrueを返す
-	if (keys_[keyNumber]) {
-		return true;
+//キーの状態を上書きする
+void Input::SetKeys(const KeyBitset& keys) {
+	keys_ = keys;
+	KeyBitset::DetectEdges(preKeys_, keys_, pressed_, released_);
+	events_.clear();
+	//別スレッドが比べる相手も合わせ、実際のキーとの違いを次のフレームに出来事として届けさせる
+	if (poller_.IsRunning()) {
+		poller_.Reseed(keys_);
 	}
-	//そうでなければfalseを返す
-	return false;
 }
 
-//Triggerきーのゲッター
-bool Input::GetTriggerKeys(int32_t keyNumber){
-	//指定キーを押していればtrueを返す
-	if (keys_[keyNumber]&&preKeys_[keyNumber]) {
-		return true;
-	}
-	//そうでなければfalseを返す
-	return false;
+//別スレッドでキーを読み始める
+void Input::StartPolling(std::chrono::microseconds interval) {
+	//今の状態からの変化を送らせ、押したままのキーを押した瞬間と取り違えないようにする
+	poller_.Stop();
+	queue_.Clear();
+	poller_.Start([](char* keys) { Novice::GetHitKeyStateAll(keys); }, interval, queue_, keys_);
+}
+
+//別スレッドで読むのをやめる
+void Input::StopPolling() {
+	poller_.Stop();
+	queue_.Clear();
 }
@@ -1,9 +1,19 @@
 ﻿#pragma once
 #include <Novice.h>
+#include "KeyBitset.h"
+#include "InputEventQueue.h"
+#include "InputPoller.h"
+#include <chrono>
 #include <cstdint>
+#include <span>
+#include <vector>
 /// <summary>
 /// 入力
 /// </summary>
+/// <remarks>
+/// キーは1キー1ビットで持ち、押した・離したキーはUpdateでまとめて求める。
+/// StartPollingすると別スレッドがキーを読み、出来事を待ち行列で受け取るので、フレームの途中で押して離したキーも取りこぼさない
+/// </remarks>
 class Input {
 public://メンバ関数
 	/// <summary>
@@ -27,14 +37,51 @@ public://メンバ関数
 	/// </summary>
 	/// <param name="keyNumber">キー番号</param>
 	/// <returns>Pressキー</returns>
-	bool GetPressKeys(int32_t keyNumber);
+	bool GetPressKeys(int32_t keyNumber) const { return keys_.Test(static_cast<size_t>(keyNumber)); }
 
 	/// <summary>
-	/// Triggerきーのゲッター
+	/// Triggerキーのゲッター(押した瞬間)
 	/// </summary>
 	/// <param name="keyNumber">キー番号</param>
 	/// <returns>Triggerキー</returns>
-	bool GetTriggerKeys(int32_t keyNumber);
+	bool GetTriggerKeys(int32_t keyNumber) const { return pressed_.Test(static_cast<size_t>(keyNumber)); }
+
+	/// <summary>
+	/// Releaseキーのゲッター(離した瞬間)
+	/// </summary>
+	/// <param name="keyNumber">キー番号</param>
+	/// <returns>Releaseキー</returns>
+	bool GetReleaseKeys(int32_t keyNumber) const { return released_.Test(static_cast<size_t>(keyNumber)); }
+
+	/// <summary>
+	/// このフレームに届いた出来事のゲッター(時刻順)
+	/// </summary>
+	std::span<const InputEvent> GetEvents() const { return events_; }
+
+	/// <summary>
+	/// キーの状態のゲッター(InputRecorderで記録・再生するときに使う)
+	/// </summary>
+	const KeyBitset& GetKeys() const { return keys_; }
+
+	/// <summary>
+	/// キーの状態を上書きする(再生した状態から押した・離したキーを求め直す。別スレッドで読んでいればその比べる相手も合わせる)
+	/// </summary>
+	/// <param name="keys">キーの状態</param>
+	void SetKeys(const KeyBitset& keys);
+
+	/// <summary>
+	/// 別スレッドでキーを読み始める
+	/// </summary>
+	/// <param name="interval">読む間隔</param>
+	void StartPolling(std::chrono::microseconds interval = kDefaultPollingInterval);
+
+	/// <summary>
+	/// 別スレッドで読むのをやめる
+	/// </summary>
+	void StopPolling();
+public://定数
+	//別スレッドで読む間隔
+	static inline const std::chrono::microseconds kDefaultPollingInterval = std::chrono::microseconds(1000);
 private://静的メンバ変数
 	//インスタンス
 	static inline Input* instance = nullptr;
@@ -50,7 +97,12 @@ private://メンバ関数
 	//代入演算子の封印
 	Input& operator=(const Input&) = delete;
 private://メンバ変数
-	char keys_[256] = {};
-	char preKeys_[256] = {};
+	KeyBitset keys_; //今のキー
+	KeyBitset preKeys_; //前のフレームのキー
+	KeyBitset pressed_; //このフレームで押したキー
+	KeyBitset released_; //このフレームで離したキー
+	std::vector<InputEvent> events_; //このフレームに届いた出来事
+	InputEventQueue queue_; //別スレッドから届く出来事
+	InputPoller poller_; //別スレッドでキーを読む
 };
 
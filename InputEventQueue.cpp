@@ -0,0 +1,35 @@
+#include "InputEventQueue.h"
+#include <chrono>
+
+//入れる
+bool InputEventQueue::Push(const InputEvent& event) {
+	//末尾は自分しか書かないのでrelaxedで読め、先頭は取り出した要素を読み終えてから進むのでacquireで読む
+	const size_t tail = tail_.load(std::memory_order_relaxed);
+	if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+		return false;
+	}
+	events_[tail & (kCapacity - 1)] = event;
+	tail_.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+//取り出す
+bool InputEventQueue::Pop(InputEvent& event) {
+	const size_t head = head_.load(std::memory_order_relaxed);
+	if (head == tail_.load(std::memory_order_acquire)) {
+		return false;
+	}
+	event = events_[head & (kCapacity - 1)];
+	head_.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+//空にする
+void InputEventQueue::Clear() {
+	head_.store(tail_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+//今の時刻
+uint64_t InputEventQueue::GetTimestamp() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// キーを押した・離した出来事
+/// </summary>
+struct InputEvent {
+	uint64_t timestamp; //時刻(InputEventQueue::GetTimestampのナノ秒)
+	uint32_t key; //キー番号
+	bool isPressed; //押したか(falseなら離した)
+};
+
+/// <summary>
+/// 1つのスレッドが入れ、別の1つのスレッドが取り出す入力の待ち行列
+/// </summary>
+/// <remarks>
+/// 入れる側は末尾だけ、取り出す側は先頭だけを書くので、ロックせずにacquire/releaseの順序付けだけで受け渡せる。
+/// 先頭と末尾は別のキャッシュラインに置き、互いの書き込みでキャッシュを奪い合わないようにする
+/// </remarks>
+class InputEventQueue {
+public://メンバ関数
+	/// <summary>
+	/// 入れる(入れる側のスレッドだけが呼ぶ)
+	/// </summary>
+	/// <returns>入ったか(満杯ならfalse)</returns>
+	bool Push(const InputEvent& event);
+
+	/// <summary>
+	/// 取り出す(取り出す側のスレッドだけが呼ぶ)
+	/// </summary>
+	/// <returns>取り出せたか(空ならfalse)</returns>
+	bool Pop(InputEvent& event);
+
+	/// <summary>
+	/// 空にする(どちらのスレッドも使っていないときだけ呼ぶ)
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 今の時刻(ナノ秒、steady_clock)
+	/// </summary>
+	static uint64_t GetTimestamp();
+public://定数
+	//入る数(2の累乗)
+	static inline const size_t kCapacity = 1024;
+	//キャッシュラインの大きさ
+	static inline const size_t kCacheLineSize = 64;
+private://メンバ変数
+	alignas(kCacheLineSize) std::atomic<size_t> head_ = 0; //次に取り出す位置(取り出す側が書く)
+	alignas(kCacheLineSize) std::atomic<size_t> tail_ = 0; //次に入れる位置(入れる側が書く)
+	alignas(kCacheLineSize) InputEvent events_[kCapacity] = {}; //出来事
+};
@@ -0,0 +1,72 @@
+#include "InputPoller.h"
+#include <bit>
+#include <cassert>
+#include <utility>
+
+//デストラクタ
+InputPoller::~InputPoller() {
+	Stop();
+}
+
+//開始
+void InputPoller::Start(std::function<void(char*)> pollFunction, std::chrono::microseconds interval, InputEventQueue& queue, const KeyBitset& initialKeys) {
+	assert(pollFunction);
+	Stop();
+	pollFunction_ = std::move(pollFunction);
+	interval_ = interval;
+	queue_ = &queue;
+	initialKeys_ = initialKeys;
+	isReseedRequested_.store(false, std::memory_order_relaxed);
+	isStopRequested_.store(false, std::memory_order_relaxed);
+	thread_ = std::thread(&InputPoller::Run, this);
+}
+
+//停止
+void InputPoller::Stop() {
+	if (!thread_.joinable()) {
+		return;
+	}
+	isStopRequested_.store(true, std::memory_order_relaxed);
+	thread_.join();
+}
+
+//取り出す側の状態を差し替える
+void InputPoller::Reseed(const KeyBitset& keys) {
+	{
+		std::lock_guard<std::mutex> lock(reseedMutex_);
+		reseedKeys_ = keys;
+	}
+	isReseedRequested_.store(true, std::memory_order_release);
+}
+
+//スレッドの処理
+void InputPoller::Run() {
+	char keys[KeyBitset::kKeyCount] = {};
+	//待ち行列に入れ終えた状態
+	KeyBitset published = initialKeys_;
+	while (!isStopRequested_.load(std::memory_order_relaxed)) {
+		if (isReseedRequested_.exchange(false, std::memory_order_acquire)) {
+			std::lock_guard<std::mutex> lock(reseedMutex_);
+			published = reseedKeys_;
+		}
+		pollFunction_(keys);
+		const KeyBitset current = KeyBitset::FromKeyArray(keys);
+		const uint64_t timestamp = InputEventQueue::GetTimestamp();
+		bool isFull = false;
+		for (size_t word = 0; word < KeyBitset::kWordCount && !isFull; word++) {
+			//変わったビットだけをたどる
+			uint64_t changed = current.words[word] ^ published.words[word];
+			while (changed != 0) {
+				const size_t key = word * 64 + static_cast<size_t>(std::countr_zero(changed));
+				const bool isPressed = current.Test(key);
+				if (!queue_->Push({ .timestamp = timestamp,.key = static_cast<uint32_t>(key),.isPressed = isPressed })) {
+					isFull = true;
+					break;
+				}
+				published.Set(key, isPressed);
+				changed &= changed - 1;
+			}
+		}
+		std::this_thread::sleep_for(interval_);
+	}
+}
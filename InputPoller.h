@@ -0,0 +1,63 @@
+#pragma once
+#include "InputEventQueue.h"
+#include "KeyBitset.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/// <summary>
+/// 別スレッドでキーを一定間隔で読み、変わったキーを時刻付きでInputEventQueueに入れる
+/// </summary>
+/// <remarks>
+/// 比べる相手は待ち行列に入れ終えた状態なので、満杯で入らなかった変化は次に読んだときにもう一度入れる。
+/// フレームの途中で押して離したキーも、両方の出来事として取り出す側に届く
+/// </remarks>
+class InputPoller {
+public://メンバ関数
+	/// <summary>
+	/// デストラクタ(スレッドを止める)
+	/// </summary>
+	~InputPoller();
+
+	/// <summary>
+	/// 開始
+	/// </summary>
+	/// <param name="pollFunction">void(char* keys) キーの状態(KeyBitset::kKeyCount個)を読む処理</param>
+	/// <param name="interval">読む間隔</param>
+	/// <param name="queue">入れる先(取り出すのは呼び出し側のスレッド)</param>
+	/// <param name="initialKeys">取り出す側が今持っている状態(ここからの変化を入れる)</param>
+	void Start(std::function<void(char*)> pollFunction, std::chrono::microseconds interval, InputEventQueue& queue, const KeyBitset& initialKeys);
+
+	/// <summary>
+	/// 停止(スレッドの終了を待つ)
+	/// </summary>
+	void Stop();
+
+	/// <summary>
+	/// 取り出す側の状態を差し替える(再生で上書きしたときなど。次に読んだときからこの状態との変化を入れる)
+	/// </summary>
+	/// <param name="keys">取り出す側が今持っている状態</param>
+	void Reseed(const KeyBitset& keys);
+
+	/// <summary>
+	/// 動いているか
+	/// </summary>
+	bool IsRunning() const { return thread_.joinable(); }
+private://メンバ関数
+	/// <summary>
+	/// スレッドの処理
+	/// </summary>
+	void Run();
+private://メンバ変数
+	std::thread thread_; //読むスレッド
+	std::atomic<bool> isStopRequested_ = false; //止めるか
+	std::function<void(char*)> pollFunction_; //キーの状態を読む処理
+	std::chrono::microseconds interval_ = {}; //読む間隔
+	InputEventQueue* queue_ = nullptr; //入れる先
+	KeyBitset initialKeys_; //取り出す側が開始時に持っていた状態
+	std::mutex reseedMutex_; //reseedKeys_を守る
+	KeyBitset reseedKeys_; //差し替える状態
+	std::atomic<bool> isReseedRequested_ = false; //差し替えるか
+};
@@ -0,0 +1,212 @@
+#include "InputRecorder.h"
+#include <cassert>
+#include <cstring>
+
+namespace {
+	//キーが変わったフレーム
+	const uint8_t kKeyChangedFlag = 1 << 0;
+	//調整値が変わったフレーム
+	const uint8_t kParameterChangedFlag = 1 << 1;
+	//キーの状態のバイト数
+	const size_t kKeyByteCount = InputRecorder::kKeyCount / 8;
+}
+
+//記録の開始
+bool InputRecorder::StartRecording(const char* filePath, size_t parameterCount) {
+	assert(parameterCount <= kMaxParameterCount);
+	Stop();
+	output_.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!output_.is_open()) {
+		return false;
+	}
+	const FileHeader header = { .magic = kMagic,.version = kVersion,.keyCount = kKeyCount,.parameterCount = static_cast<uint32_t>(parameterCount) };
+	output_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	//前のフレームを0にしておき、最初のフレームで全ての値を書く
+	keys_ = {};
+	std::memset(parameters_, 0, sizeof(parameters_));
+	parameterCount_ = parameterCount;
+	frameCount_ = 0;
+	elapsedMicroseconds_ = 0;
+	startTime_ = std::chrono::steady_clock::now();
+	mode_ = Mode::kRecord;
+	return true;
+}
+
+//再生の開始
+bool InputRecorder::StartReplay(const char* filePath, size_t parameterCount) {
+	assert(parameterCount <= kMaxParameterCount);
+	Stop();
+	input_.open(filePath, std::ios::in | std::ios::binary);
+	if (!input_.is_open()) {
+		return false;
+	}
+	FileHeader header = {};
+	input_.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!input_ || header.magic != kMagic || header.version != kVersion ||
+		header.keyCount != kKeyCount || header.parameterCount != parameterCount) {
+		input_.close();
+		return false;
+	}
+
+	keys_ = {};
+	std::memset(parameters_, 0, sizeof(parameters_));
+	parameterCount_ = parameterCount;
+	frameCount_ = 0;
+	elapsedMicroseconds_ = 0;
+	mode_ = Mode::kReplay;
+	return true;
+}
+
+//記録・再生の終了
+void InputRecorder::Stop() {
+	if (output_.is_open()) {
+		output_.close();
+	}
+	if (input_.is_open()) {
+		input_.close();
+	}
+	mode_ = Mode::kNone;
+}
+
+//1フレーム分の処理
+bool InputRecorder::ProcessFrame(KeyBitset& keys, std::span<float> parameters) {
+	assert(mode_ == Mode::kNone || parameters.size() == parameterCount_);
+	if (mode_ == Mode::kRecord) {
+		WriteFrame(keys, parameters);
+	} else if (mode_ == Mode::kReplay) {
+		if (ReadFrame(keys, parameters)) {
+			return true;
+		}
+		//最後まで再生したら、このフレームから操作を受け付ける
+		Stop();
+	}
+	return false;
+}
+
+//1フレーム分を書き出す
+void InputRecorder::WriteFrame(const KeyBitset& keys, std::span<const float> parameters) {
+	const uint64_t elapsedMicroseconds = static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime_).count());
+
+	//キーは前のフレームとの差分を取る
+	uint8_t keyDiff[kKeyByteCount];
+	uint32_t keyByteMask = 0;
+	for (size_t word = 0; word < KeyBitset::kWordCount; word++) {
+		const uint64_t diff = keys.words[word] ^ keys_.words[word];
+		std::memcpy(keyDiff + word * sizeof(uint64_t), &diff, sizeof(diff));
+	}
+	for (size_t i = 0; i < kKeyByteCount; i++) {
+		keyByteMask |= static_cast<uint32_t>(keyDiff[i] != 0) << i;
+	}
+
+	//調整値はビット列で比べる(-0とNaNも変化として残す)
+	uint64_t parameterMask = 0;
+	for (size_t i = 0; i < parameters.size(); i++) {
+		if (std::memcmp(&parameters[i], &parameters_[i], sizeof(float)) != 0) {
+			parameterMask |= 1ull << i;
+		}
+	}
+
+	record_.clear();
+	record_.push_back(static_cast<uint8_t>((keyByteMask != 0 ? kKeyChangedFlag : 0) | (parameterMask != 0 ? kParameterChangedFlag : 0)));
+	WriteVarint(elapsedMicroseconds - elapsedMicroseconds_);
+	if (keyByteMask != 0) {
+		const uint8_t* maskBytes = reinterpret_cast<const uint8_t*>(&keyByteMask);
+		record_.insert(record_.end(), maskBytes, maskBytes + sizeof(keyByteMask));
+		for (size_t i = 0; i < kKeyByteCount; i++) {
+			if (keyDiff[i] != 0) {
+				record_.push_back(keyDiff[i]);
+			}
+		}
+	}
+	if (parameterMask != 0) {
+		WriteVarint(parameterMask);
+		for (size_t i = 0; i < parameters.size(); i++) {
+			if (parameterMask & (1ull << i)) {
+				const uint8_t* valueBytes = reinterpret_cast<const uint8_t*>(&parameters[i]);
+				record_.insert(record_.end(), valueBytes, valueBytes + sizeof(float));
+			}
+		}
+	}
+	output_.write(reinterpret_cast<const char*>(record_.data()), static_cast<std::streamsize>(record_.size()));
+
+	keys_ = keys;
+	std::memcpy(parameters_, parameters.data(), parameters.size_bytes());
+	elapsedMicroseconds_ = elapsedMicroseconds;
+	frameCount_++;
+}
+
+//1フレーム分を読み込んで上書きする
+bool InputRecorder::ReadFrame(KeyBitset& keys, std::span<float> parameters) {
+	const int flags = input_.get();
+	if (flags == std::char_traits<char>::eof() || (flags & ~(kKeyChangedFlag | kParameterChangedFlag)) != 0) {
+		return false;
+	}
+	uint64_t deltaMicroseconds = 0;
+	if (!ReadVarint(deltaMicroseconds)) {
+		return false;
+	}
+
+	if (flags & kKeyChangedFlag) {
+		uint32_t keyByteMask = 0;
+		input_.read(reinterpret_cast<char*>(&keyByteMask), sizeof(keyByteMask));
+		uint8_t keyBytes[kKeyByteCount];
+		std::memcpy(keyBytes, keys_.words, sizeof(keyBytes));
+		for (size_t i = 0; i < kKeyByteCount; i++) {
+			if (keyByteMask & (1u << i)) {
+				keyBytes[i] ^= static_cast<uint8_t>(input_.get());
+			}
+		}
+		if (!input_) {
+			return false;
+		}
+		std::memcpy(keys_.words, keyBytes, sizeof(keyBytes));
+	}
+	if (flags & kParameterChangedFlag) {
+		uint64_t parameterMask = 0;
+		if (!ReadVarint(parameterMask)) {
+			return false;
+		}
+		for (size_t i = 0; i < parameterCount_; i++) {
+			if (parameterMask & (1ull << i)) {
+				input_.read(reinterpret_cast<char*>(&parameters_[i]), sizeof(float));
+			}
+		}
+		if (!input_) {
+			return false;
+		}
+	}
+
+	//変わっていないキーと値も毎フレーム上書きし、再生中の操作を無視する
+	keys = keys_;
+	std::memcpy(parameters.data(), parameters_, parameters.size_bytes());
+	elapsedMicroseconds_ += deltaMicroseconds;
+	frameCount_++;
+	return true;
+}
+
+//可変長の整数を書き込む
+void InputRecorder::WriteVarint(uint64_t value) {
+	while (value >= 0x80) {
+		record_.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	record_.push_back(static_cast<uint8_t>(value));
+}
+
+//可変長の整数を読み込む
+bool InputRecorder::ReadVarint(uint64_t& value) {
+	value = 0;
+	for (uint32_t shift = 0; shift < 64; shift += 7) {
+		const int byte = input_.get();
+		if (byte == std::char_traits<char>::eof()) {
+			return false;
+		}
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
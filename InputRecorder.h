@@ -0,0 +1,123 @@
+#pragma once
+#include "KeyBitset.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// キー入力と調整値の記録・再生(計測を同じ操作で繰り返すために使う)
+/// </summary>
+/// <remarks>
+/// ファイルはヘッダのあとに1フレーム1レコードを続けて書く。
+/// レコードは前のフレームからの経過時間(マイクロ秒)と、変わったものだけ(キーは256ビットの差分のうち0でないバイト、調整値は変わった値)を持つ。
+/// 記録しながら書き出し、再生しながら読み込むので、長く記録してもメモリは増えない
+/// </remarks>
+class InputRecorder {
+public://列挙型
+	/// <summary>
+	/// 状態
+	/// </summary>
+	enum class Mode : uint32_t {
+		kNone,   //何もしない
+		kRecord, //記録中
+		kReplay, //再生中
+	};
+public://メンバ関数
+	/// <summary>
+	/// 記録の開始
+	/// </summary>
+	/// <param name="filePath">出力先</param>
+	/// <param name="parameterCount">調整値の数(kMaxParameterCount以下)</param>
+	/// <returns>開けたかどうか</returns>
+	bool StartRecording(const char* filePath, size_t parameterCount);
+
+	/// <summary>
+	/// 再生の開始
+	/// </summary>
+	/// <param name="filePath">記録したファイル</param>
+	/// <param name="parameterCount">調整値の数(記録したときと同じであること)</param>
+	/// <returns>読めるファイルだったか</returns>
+	bool StartReplay(const char* filePath, size_t parameterCount);
+
+	/// <summary>
+	/// 記録・再生の終了
+	/// </summary>
+	void Stop();
+
+	/// <summary>
+	/// 1フレーム分の処理(記録中は書き出し、再生中は記録した値で上書きする。最後まで再生したら終了する)
+	/// </summary>
+	/// <param name="keys">キーの状態</param>
+	/// <param name="parameters">調整値(カメラや球など、ImGuiで動かす値)</param>
+	/// <returns>再生した値で上書きしたか</returns>
+	bool ProcessFrame(KeyBitset& keys, std::span<float> parameters);
+
+	/// <summary>
+	/// 状態のゲッター
+	/// </summary>
+	Mode GetMode() const { return mode_; }
+
+	/// <summary>
+	/// 記録・再生したフレーム数のゲッター
+	/// </summary>
+	uint32_t GetFrameCount() const { return frameCount_; }
+
+	/// <summary>
+	/// 記録したときの、開始からの時間(マイクロ秒)のゲッター
+	/// </summary>
+	uint64_t GetElapsedMicroseconds() const { return elapsedMicroseconds_; }
+public://定数
+	//キーの数
+	static inline const size_t kKeyCount = KeyBitset::kKeyCount;
+	//調整値の最大数
+	static inline const size_t kMaxParameterCount = 64;
+	//ファイルの識別子
+	static inline const uint32_t kMagic = 0x5249544D; //"MTIR"
+	//ファイルの版
+	static inline const uint32_t kVersion = 1;
+private://構造体
+	/// <summary>
+	/// ファイルの先頭
+	/// </summary>
+	struct FileHeader {
+		uint32_t magic; //識別子
+		uint32_t version; //版
+		uint32_t keyCount; //キーの数
+		uint32_t parameterCount; //調整値の数
+	};
+private://メンバ関数
+	/// <summary>
+	/// 1フレーム分を書き出す
+	/// </summary>
+	void WriteFrame(const KeyBitset& keys, std::span<const float> parameters);
+
+	/// <summary>
+	/// 1フレーム分を読み込んで上書きする
+	/// </summary>
+	/// <returns>読めたか(ファイルの終わりか壊れていればfalse)</returns>
+	bool ReadFrame(KeyBitset& keys, std::span<float> parameters);
+
+	/// <summary>
+	/// 可変長の整数を書き込む(7ビットずつ、続きがあれば最上位ビットを立てる)
+	/// </summary>
+	void WriteVarint(uint64_t value);
+
+	/// <summary>
+	/// 可変長の整数を読み込む
+	/// </summary>
+	bool ReadVarint(uint64_t& value);
+private://メンバ変数
+	Mode mode_ = Mode::kNone; //状態
+	std::ofstream output_; //記録の出力先
+	std::ifstream input_; //再生するファイル
+	std::vector<uint8_t> record_; //書き出す前の1フレーム分
+	KeyBitset keys_; //前のフレームのキー
+	float parameters_[kMaxParameterCount] = {}; //前のフレームの調整値
+	size_t parameterCount_ = 0; //調整値の数
+	uint32_t frameCount_ = 0; //記録・再生したフレーム数
+	uint64_t elapsedMicroseconds_ = 0; //開始からの時間
+	std::chrono::steady_clock::time_point startTime_; //記録を始めた時刻
+};
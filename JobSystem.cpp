@@ -0,0 +1,130 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <cassert>
+
+//インスタンスのゲッター
+JobSystem* JobSystem::GetInstance() {
+	assert(!isFinalize && "GetInstance() called after Finalize()");
+	if (instance == nullptr) {
+		instance = new JobSystem();
+	}
+	return instance;
+}
+
+//終了
+void JobSystem::Finalize() {
+	delete instance;
+	instance = nullptr;
+	isFinalize = true;
+}
+
+//並列に処理する
+void JobSystem::ParallelFor(size_t count, size_t minBatchSize, FunctionRef<void(size_t, size_t)> function) {
+	if (count == 0) {
+		return;
+	}
+	minBatchSize = std::max<size_t>(minBatchSize, 1);
+	size_t chunkCount = std::min((count + minBatchSize - 1) / minBatchSize, GetThreadCount() * kChunksPerThread);
+
+	//分ける意味がなければその場で実行する
+	if (workers_.empty() || chunkCount <= 1 || isInsideParallelFor) {
+		function(0, count);
+		return;
+	}
+
+	//仕事の状態は1つしかないので、別のスレッドが出した仕事が終わるまで待つ
+	std::lock_guard<std::mutex> dispatchLock(dispatchMutex_);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		function_ = &function;
+		count_ = count;
+		chunkCount_ = chunkCount;
+		chunkSize_ = (count + chunkCount - 1) / chunkCount;
+		nextChunk_.store(0, std::memory_order_relaxed);
+		isJobOpen_ = true;
+		tag_ = MemoryTracker::GetCurrentTag();
+		generation_++;
+	}
+	wakeCondition_.notify_all();
+
+	isInsideParallelFor = true;
+	RunChunks();
+	isInsideParallelFor = false;
+
+	//区間はすべて取り出されたので、実行中のワーカーを待つ
+	std::unique_lock<std::mutex> lock(mutex_);
+	isJobOpen_ = false;
+	doneCondition_.wait(lock, [this]() { return activeWorkerCount_ == 0; });
+	function_ = nullptr;
+}
+
+//コンストラクタ
+JobSystem::JobSystem() {
+	uint32_t hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	uint32_t workerCount = std::min(hardwareThreadCount - 1, kMaxWorkerCount);
+	workers_.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; i++) {
+		workers_.emplace_back([this]() { WorkerMain(); });
+	}
+}
+
+//デストラクタ
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isExiting_ = true;
+	}
+	wakeCondition_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+}
+
+//ワーカーの処理
+void JobSystem::WorkerMain() {
+	isInsideParallelFor = true;
+	uint64_t seenGeneration = 0;
+	for (;;) {
+		MemoryTracker::Tag tag = MemoryTracker::Tag::kGeneral;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			wakeCondition_.wait(lock, [&]() { return isExiting_ || generation_ != seenGeneration; });
+			if (isExiting_) {
+				return;
+			}
+			seenGeneration = generation_;
+			//起きるのが遅れて仕事が閉じていれば加わらない
+			if (!isJobOpen_) {
+				continue;
+			}
+			activeWorkerCount_++;
+			tag = tag_;
+		}
+
+		{
+			MemoryTracker::Scope memoryScope(tag);
+			RunChunks();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			activeWorkerCount_--;
+		}
+		doneCondition_.notify_one();
+	}
+}
+
+//区間がなくなるまで取り出して実行する
+void JobSystem::RunChunks() {
+	for (;;) {
+		size_t chunk = nextChunk_.fetch_add(1, std::memory_order_relaxed);
+		if (chunk >= chunkCount_) {
+			return;
+		}
+		size_t begin = chunk * chunkSize_;
+		size_t end = std::min(begin + chunkSize_, count_);
+		if (begin < end) {
+			(*function_)(begin, end);
+		}
+	}
+}
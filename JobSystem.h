@@ -0,0 +1,88 @@
+#pragma once
+#include "FunctionRef.h"
+#include "MemoryTracker.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// ワーカースレッドで処理を分担する
+/// </summary>
+/// <remarks>
+/// ParallelForを呼んだスレッドも分担に加わり、すべての区間が終わるまで戻らない。
+/// ワーカーの中からParallelForを呼んだ場合はその場で順番に実行する。
+/// 仕事は1つずつしか出せないので、複数のスレッド(読み込み用のスレッドなど)から呼んだ場合は先の呼び出しが終わるまで待つ
+/// </remarks>
+class JobSystem {
+public://メンバ関数
+	/// <summary>
+	/// インスタンスのゲッター
+	/// </summary>
+	/// <returns></returns>
+	static JobSystem* GetInstance();
+
+	/// <summary>
+	/// 終了処理(ワーカーを止める)
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// 処理に使うスレッド数のゲッター(呼び出し元のスレッドを含む)
+	/// </summary>
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()) + 1; }
+
+	/// <summary>
+	/// [0, count)を区間に分けて並列に処理する
+	/// </summary>
+	/// <param name="count">要素数</param>
+	/// <param name="minBatchSize">1区間の最小の要素数</param>
+	/// <param name="function">void(size_t begin, size_t end) 区間の処理(写さずに参照するので、確保は起きない)</param>
+	void ParallelFor(size_t count, size_t minBatchSize, FunctionRef<void(size_t, size_t)> function);
+private://静的メンバ変数
+	//インスタンス
+	static inline JobSystem* instance = nullptr;
+	//解放したかどうか
+	static inline bool isFinalize = false;
+	//ParallelForの実行中かどうか(入れ子の呼び出しを順番に実行するため)
+	static inline thread_local bool isInsideParallelFor = false;
+private://定数
+	//ワーカー数の上限
+	static inline const uint32_t kMaxWorkerCount = 31;
+	//スレッドあたりの区間数(処理時間のばらつきをならす)
+	static inline const size_t kChunksPerThread = 4;
+private://メンバ関数
+	//コンストラクタの封印
+	JobSystem();
+	//デストラクタの封印
+	~JobSystem();
+	//コピーコンストラクタの封印
+	JobSystem(const JobSystem&) = delete;
+	//代入演算子の封印
+	JobSystem& operator=(const JobSystem&) = delete;
+	//ワーカーの処理
+	void WorkerMain();
+	//区間がなくなるまで取り出して実行する
+	void RunChunks();
+private://メンバ変数
+	std::vector<std::thread> workers_; //ワーカー
+	std::mutex dispatchMutex_; //仕事を出す呼び出し元を1つにする(仕事が終わるまで持つ)
+	std::mutex mutex_; //以下の状態を守る
+	std::condition_variable wakeCondition_; //仕事が来たらワーカーを起こす
+	std::condition_variable doneCondition_; //ワーカーが抜けたら呼び出し元を起こす
+	uint64_t generation_ = 0; //仕事を出した回数
+	bool isJobOpen_ = false; //ワーカーが仕事に加われるか
+	bool isExiting_ = false; //終了中か
+	MemoryTracker::Tag tag_ = MemoryTracker::Tag::kGeneral; //ParallelForを呼んだスレッドのタグ(ワーカーも同じタグで数える)
+	uint32_t activeWorkerCount_ = 0; //仕事をしているワーカーの数
+
+	//現在の仕事(isJobOpen_の間だけ有効)
+	const FunctionRef<void(size_t, size_t)>* function_ = nullptr;
+	size_t count_ = 0; //要素数
+	size_t chunkSize_ = 0; //1区間の要素数
+	size_t chunkCount_ = 0; //区間数
+	std::atomic<size_t> nextChunk_ = 0; //次に取り出す区間
+};
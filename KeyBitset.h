@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/// <summary>
+/// 256キーの状態(1キー1ビット)
+/// </summary>
+/// <remarks>
+/// 64ビット4つなので、押した・離したの判定はXORとANDを4回ずつで済む(ループはコンパイラがSIMDにする)
+/// </remarks>
+struct KeyBitset {
+	//キーの数
+	static inline const size_t kKeyCount = 256;
+	//64ビットの数
+	static inline const size_t kWordCount = kKeyCount / 64;
+
+	uint64_t words[kWordCount] = {}; //キーごとのビット
+
+	/// <summary>
+	/// 押しているか
+	/// </summary>
+	/// <param name="key">キー番号</param>
+	bool Test(size_t key) const { return (words[key / 64] >> (key % 64)) & 1; }
+
+	/// <summary>
+	/// 状態の設定
+	/// </summary>
+	/// <param name="key">キー番号</param>
+	/// <param name="isDown">押しているか</param>
+	void Set(size_t key, bool isDown) {
+		const uint64_t bit = 1ull << (key % 64);
+		words[key / 64] = isDown ? (words[key / 64] | bit) : (words[key / 64] & ~bit);
+	}
+
+	/// <summary>
+	/// どれかのキーを押しているか
+	/// </summary>
+	bool Any() const { return (words[0] | words[1] | words[2] | words[3]) != 0; }
+
+	/// <summary>
+	/// 1キー1バイトの配列(0以外が押している)から作る
+	/// </summary>
+	/// <param name="keys">キーの状態(kKeyCount個。Novice::GetHitKeyStateAllの結果)</param>
+	static KeyBitset FromKeyArray(const char* keys) {
+		KeyBitset result;
+		for (size_t word = 0; word < kWordCount; word++) {
+			uint64_t bits = 0;
+			for (size_t block = 0; block < 8; block++) {
+				//8バイトを読み、各バイトの全ビットを最下位ビットに集めてから、掛け算で8ビットに詰める
+				uint64_t value = 0;
+				std::memcpy(&value, keys + word * 64 + block * 8, sizeof(value));
+				value |= value >> 4;
+				value |= value >> 2;
+				value |= value >> 1;
+				value &= 0x0101010101010101ull;
+				bits |= ((value * 0x0102040810204080ull) >> 56) << (block * 8);
+			}
+			result.words[word] = bits;
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// 前の状態から押した・離したキーを求める
+	/// </summary>
+	/// <param name="previous">前の状態</param>
+	/// <param name="current">今の状態</param>
+	/// <param name="pressed">押したキー</param>
+	/// <param name="released">離したキー</param>
+	static void DetectEdges(const KeyBitset& previous, const KeyBitset& current, KeyBitset& pressed, KeyBitset& released) {
+		for (size_t word = 0; word < kWordCount; word++) {
+			const uint64_t changed = previous.words[word] ^ current.words[word];
+			pressed.words[word] = changed & current.words[word];
+			released.words[word] = changed & previous.words[word];
+		}
+	}
+
+	/// <summary>
+	/// 等しいか
+	/// </summary>
+	bool operator==(const KeyBitset& other) const = default;
+};
@@ -0,0 +1,167 @@
+#include "Lz4.h"
+#include <cstring>
+
+namespace {
+	//最後のこのバイト数はリテラルにする(形式の決まり)
+	const size_t kLastLiterals = 5;
+	//一致はこのバイト数より前で始める(形式の決まり)
+	const size_t kMatchLimit = 12;
+
+	/// <summary>
+	/// 4バイトを読む
+	/// </summary>
+	uint32_t Read32(const uint8_t* p) {
+		uint32_t value = 0;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	/// <summary>
+	/// 4バイトのハッシュ
+	/// </summary>
+	uint32_t Hash(uint32_t sequence) {
+		return (sequence * 2654435761u) >> (32 - Lz4::kHashBits);
+	}
+
+	/// <summary>
+	/// 15以上の長さの続きを書く(255ずつ)
+	/// </summary>
+	uint8_t* WriteLength(uint8_t* output, size_t length) {
+		for (; length >= 255; length -= 255) {
+			*output++ = 255;
+		}
+		*output++ = static_cast<uint8_t>(length);
+		return output;
+	}
+
+	/// <summary>
+	/// 15以上の長さの続きを読む
+	/// </summary>
+	bool ReadLength(const uint8_t*& input, const uint8_t* end, size_t& length) {
+		uint8_t byte = 255;
+		while (byte == 255) {
+			if (input == end) {
+				return false;
+			}
+			byte = *input++;
+			length += byte;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// リテラルと一致を1組書く
+	/// </summary>
+	uint8_t* WriteSequence(uint8_t* output, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength) {
+		const size_t matchCode = matchLength - Lz4::kMinMatch;
+		uint8_t* token = output++;
+		*token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4 | (matchCode >= 15 ? 15 : matchCode));
+		if (literalLength >= 15) {
+			output = WriteLength(output, literalLength - 15);
+		}
+		std::memcpy(output, literals, literalLength);
+		output += literalLength;
+		*output++ = static_cast<uint8_t>(offset);
+		*output++ = static_cast<uint8_t>(offset >> 8);
+		if (matchCode >= 15) {
+			output = WriteLength(output, matchCode - 15);
+		}
+		return output;
+	}
+}
+
+//圧縮
+size_t Lz4::Compress(const uint8_t* source, size_t sourceSize, uint8_t* destination) {
+	uint8_t* output = destination;
+	size_t anchor = 0;
+	if (sourceSize > kMatchLimit) {
+		uint32_t table[1u << kHashBits] = {};
+		const size_t matchEndLimit = sourceSize - kLastLiterals;
+		size_t position = 0;
+		while (position < sourceSize - kMatchLimit) {
+			const uint32_t sequence = Read32(source + position);
+			const uint32_t hash = Hash(sequence);
+			const size_t candidate = table[hash];
+			table[hash] = static_cast<uint32_t>(position);
+			if (candidate >= position || position - candidate > kMaxOffset || Read32(source + candidate) != sequence) {
+				//一致しない間は読み飛ばす幅を広げ、圧縮できないデータを早く通り過ぎる
+				position += 1 + ((position - anchor) >> 6);
+				continue;
+			}
+			size_t matchLength = kMinMatch;
+			while (position + matchLength < matchEndLimit && source[candidate + matchLength] == source[position + matchLength]) {
+				matchLength++;
+			}
+			output = WriteSequence(output, source + anchor, position - anchor, position - candidate, matchLength);
+			position += matchLength;
+			anchor = position;
+		}
+	}
+
+	//残りはリテラルだけの組にする
+	const size_t literalLength = sourceSize - anchor;
+	*output++ = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+	if (literalLength >= 15) {
+		output = WriteLength(output, literalLength - 15);
+	}
+	//空の入力ではsourceがnullptrのことがあるので、写すものがなければmemcpyを呼ばない
+	if (literalLength != 0) {
+		std::memcpy(output, source + anchor, literalLength);
+		output += literalLength;
+	}
+	return static_cast<size_t>(output - destination);
+}
+
+//展開
+bool Lz4::Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize) {
+	const uint8_t* input = source;
+	const uint8_t* inputEnd = source + sourceSize;
+	uint8_t* output = destination;
+	uint8_t* outputEnd = destination + destinationSize;
+	for (;;) {
+		if (input == inputEnd) {
+			return false;
+		}
+		const uint8_t token = *input++;
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !ReadLength(input, inputEnd, literalLength)) {
+			return false;
+		}
+		if (static_cast<size_t>(inputEnd - input) < literalLength || static_cast<size_t>(outputEnd - output) < literalLength) {
+			return false;
+		}
+		if (literalLength != 0) {
+			std::memcpy(output, input, literalLength);
+			input += literalLength;
+			output += literalLength;
+		}
+		//最後の組はリテラルだけで終わる
+		if (input == inputEnd) {
+			return output == outputEnd;
+		}
+
+		if (inputEnd - input < 2) {
+			return false;
+		}
+		const size_t offset = static_cast<size_t>(input[0]) | static_cast<size_t>(input[1]) << 8;
+		input += 2;
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadLength(input, inputEnd, matchLength)) {
+			return false;
+		}
+		matchLength += kMinMatch;
+		if (offset == 0 || offset > static_cast<size_t>(output - destination) || static_cast<size_t>(outputEnd - output) < matchLength) {
+			return false;
+		}
+		const uint8_t* match = output - offset;
+		if (offset >= matchLength) {
+			std::memcpy(output, match, matchLength);
+			output += matchLength;
+		} else {
+			//重なっている一致は前から1バイトずつ写し、同じ並びを繰り返す
+			for (size_t i = 0; i < matchLength; i++) {
+				*output++ = match[i];
+			}
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// LZ4のブロック形式の圧縮・展開
+/// </summary>
+/// <remarks>
+/// 形式は公式のLZ4ブロックと同じ(トークン、リテラル、2バイトのオフセット、一致長の繰り返し)。
+/// 圧縮は4バイトのハッシュ表で直前の一致を1つだけ探す速さ優先のもので、一致しない間は読み飛ばす幅を広げていく。
+/// 展開は入力を信用せず、範囲外を読み書きする前にfalseを返す
+/// </remarks>
+class Lz4 {
+public://メンバ関数
+	/// <summary>
+	/// 圧縮後の最大バイト数(圧縮できないデータでもこれを超えない)
+	/// </summary>
+	/// <param name="size">元のバイト数</param>
+	static size_t GetMaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+
+	/// <summary>
+	/// 圧縮
+	/// </summary>
+	/// <param name="source">元のデータ</param>
+	/// <param name="sourceSize">元のバイト数</param>
+	/// <param name="destination">出力先(GetMaxCompressedSize(sourceSize)バイト以上)</param>
+	/// <returns>圧縮後のバイト数</returns>
+	static size_t Compress(const uint8_t* source, size_t sourceSize, uint8_t* destination);
+
+	/// <summary>
+	/// 展開
+	/// </summary>
+	/// <param name="source">圧縮したデータ</param>
+	/// <param name="sourceSize">圧縮したバイト数</param>
+	/// <param name="destination">出力先</param>
+	/// <param name="destinationSize">元のバイト数(ちょうどこの大きさに展開できなければ失敗)</param>
+	/// <returns>展開できたか</returns>
+	static bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+public://定数
+	//一致の最小の長さ
+	static inline const size_t kMinMatch = 4;
+	//一致を探す距離の上限
+	static inline const size_t kMaxOffset = 65535;
+	//ハッシュ表のビット数
+	static inline const uint32_t kHashBits = 12;
+};
@@ -0,0 +1,96 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+//デストラクタ
+MappedFile::~MappedFile() {
+	Close();
+}
+
+#ifdef _WIN32
+//開く
+bool MappedFile::Open(const char* filePath) {
+	Close();
+	//書き込み中のファイル(DrawCaptureで記録中など)も開けるようにする
+	HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 ||
+		static_cast<unsigned long long>(fileSize.QuadPart) > static_cast<unsigned long long>(SIZE_MAX)) {
+		CloseHandle(file);
+		return false;
+	}
+	//マッピングはファイルのハンドルを閉じても残る
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr) {
+		return false;
+	}
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr) {
+		CloseHandle(mapping);
+		return false;
+	}
+	data_ = static_cast<const uint8_t*>(view);
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+	mappingHandle_ = mapping;
+	return true;
+}
+
+//閉じる
+void MappedFile::Close() {
+	if (data_ != nullptr) {
+		UnmapViewOfFile(data_);
+		CloseHandle(mappingHandle_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	mappingHandle_ = nullptr;
+}
+#else
+//開く
+bool MappedFile::Open(const char* filePath) {
+	Close();
+	const int file = open(filePath, O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+	struct stat status = {};
+	if (fstat(file, &status) != 0 || status.st_size <= 0) {
+		close(file);
+		return false;
+	}
+	//割り当てはファイルを閉じても残る
+	void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+	data_ = static_cast<const uint8_t*>(view);
+	size_ = static_cast<size_t>(status.st_size);
+	return true;
+}
+
+//閉じる
+void MappedFile::Close() {
+	if (data_ != nullptr) {
+		munmap(const_cast<uint8_t*>(data_), size_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+}
+#endif // _WIN32
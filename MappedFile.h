@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 読み取り専用でメモリに割り当てたファイル
+/// </summary>
+/// <remarks>
+/// 読み込むのは触ったページだけなので、大きなファイルでも開くだけなら一瞬で終わり、メモリも増えない
+/// </remarks>
+class MappedFile {
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	MappedFile() = default;
+
+	/// <summary>
+	/// デストラクタ(開いていれば閉じる)
+	/// </summary>
+	~MappedFile();
+
+	//コピーの禁止
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/// <summary>
+	/// 開く
+	/// </summary>
+	/// <param name="filePath">ファイル</param>
+	/// <returns>開けたか(空のファイルは開けない)</returns>
+	bool Open(const char* filePath);
+
+	/// <summary>
+	/// 閉じる(GetDataで得たポインタは使えなくなる)
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// 開いているか
+	/// </summary>
+	bool IsOpen() const { return data_ != nullptr; }
+
+	/// <summary>
+	/// 中身のゲッター
+	/// </summary>
+	const uint8_t* GetData() const { return data_; }
+
+	/// <summary>
+	/// バイト数のゲッター
+	/// </summary>
+	size_t GetSize() const { return size_; }
+private://メンバ変数
+	const uint8_t* data_ = nullptr; //中身
+	size_t size_ = 0; //バイト数
+#ifdef _WIN32
+	void* mappingHandle_ = nullptr; //ファイルマッピングのハンドル
+#endif // _WIN32
+};
@@ -1,4 +1,5 @@
 #include "MathData.h"
+#include "RenderStats.h"
 #include <cmath>
 //Vector3のメンバ変数すべてに1.0fを代入したVector3を作成
 Vector3 Vector3::MakeAllOne() {
@@ -196,6 +197,7 @@ Matrix4x4 Matrix4x4::operator-(const Matrix4x4& mat) const {
 
 //乗法
 Matrix4x4 Matrix4x4::operator*(const Matrix4x4& mat) const {
+	RenderStats::AddMath(RenderStats::Counter::kMatrixMultiply);
 	Matrix4x4 result;
 	for (int i = 0; i < 4; i++) {
 		for (int j = 0; j < 4; j++) {
@@ -232,6 +234,7 @@ Matrix4x4& Matrix4x4::operator-=(const Matrix4x4& mat) {
 
 //逆行列
 Matrix4x4 Matrix4x4::Inverse() const {
+	RenderStats::AddMath(RenderStats::Counter::kMatrixInverse);
 	Matrix4x4 result{};
 	float determinant = m[0][0] * (m[1][1] * m[2][2] * m[3][3] +
 		m[2][1] * m[3][2] * m[1][3] +
@@ -419,4 +422,104 @@ Matrix4x4 Matrix4x4::Identity4x4() {
 		result.m[i][i] = 1;
 	}
 	return result;
-}
\ No newline at end of file
+}
+//回転なし
+Quaternion Quaternion::Identity() {
+	return { 0.0f,0.0f,0.0f,1.0f };
+}
+
+//任意軸回転
+Quaternion Quaternion::MakeRotateAxisAngle(const Vector3& axis, float angle) {
+	float s = std::sin(angle * 0.5f);
+	return { axis.x * s,axis.y * s,axis.z * s,std::cos(angle * 0.5f) };
+}
+
+//x,y,z軸の順に回転
+Quaternion Quaternion::MakeRotateXYZ(const Vector3& radian) {
+	Quaternion rotateX = MakeRotateAxisAngle({ 1.0f,0.0f,0.0f }, radian.x);
+	Quaternion rotateY = MakeRotateAxisAngle({ 0.0f,1.0f,0.0f }, radian.y);
+	Quaternion rotateZ = MakeRotateAxisAngle({ 0.0f,0.0f,1.0f }, radian.z);
+	return rotateZ * (rotateY * rotateX);
+}
+
+//球面線形補間
+Quaternion Quaternion::Slerp(const Quaternion& begin, const Quaternion& end, float t) {
+	//遠回りしないように向きをそろえる
+	float dot = begin.Dot(end);
+	Quaternion target = end;
+	if (dot < 0.0f) {
+		target = { -end.x,-end.y,-end.z,-end.w };
+		dot = -dot;
+	}
+	//ほぼ同じ向きなら線形補間で十分(0除算も避ける)
+	const float kLinearThreshold = 0.9995f;
+	float scaleBegin = 1.0f - t;
+	float scaleEnd = t;
+	if (dot < kLinearThreshold) {
+		float theta = std::acos(dot);
+		float inverseSin = 1.0f / std::sin(theta);
+		scaleBegin = std::sin((1.0f - t) * theta) * inverseSin;
+		scaleEnd = std::sin(t * theta) * inverseSin;
+	}
+	Quaternion result = {
+		begin.x * scaleBegin + target.x * scaleEnd,
+		begin.y * scaleBegin + target.y * scaleEnd,
+		begin.z * scaleBegin + target.z * scaleEnd,
+		begin.w * scaleBegin + target.w * scaleEnd,
+	};
+	return result.Normalize();
+}
+
+//内積
+float Quaternion::Dot(const Quaternion& q)const {
+	return x * q.x + y * q.y + z * q.z + w * q.w;
+}
+
+//正規化
+Quaternion Quaternion::Normalize()const {
+	float len = std::sqrt(Dot(*this));
+	if (len == 0.0f) {
+		return Identity();
+	}
+	float inverse = 1.0f / len;
+	return { x * inverse,y * inverse,z * inverse,w * inverse };
+}
+
+//共役
+Quaternion Quaternion::Conjugate()const {
+	return { -x,-y,-z,w };
+}
+
+//ベクトルを回転させる
+Vector3 Quaternion::Rotate(const Vector3& v)const {
+	//v' = v + 2w(u×v) + 2u×(u×v)
+	Vector3 u = { x,y,z };
+	Vector3 uv = u.Cross(v);
+	Vector3 uuv = u.Cross(uv);
+	return v + (uv * w + uuv) * 2.0f;
+}
+
+//回転行列
+Matrix4x4 Quaternion::MakeRotateMatrix()const {
+	Matrix4x4 result = Matrix4x4::Identity4x4();
+	result.m[0][0] = 1.0f - 2.0f * (y * y + z * z);
+	result.m[0][1] = 2.0f * (x * y + w * z);
+	result.m[0][2] = 2.0f * (x * z - w * y);
+	result.m[1][0] = 2.0f * (x * y - w * z);
+	result.m[1][1] = 1.0f - 2.0f * (x * x + z * z);
+	result.m[1][2] = 2.0f * (y * z + w * x);
+	result.m[2][0] = 2.0f * (x * z + w * y);
+	result.m[2][1] = 2.0f * (y * z - w * x);
+	result.m[2][2] = 1.0f - 2.0f * (x * x + y * y);
+	return result;
+}
+
+//積
+Quaternion Quaternion::operator*(const Quaternion& q)const {
+	return {
+		w * q.x + x * q.w + y * q.z - z * q.y,
+		w * q.y - x * q.z + y * q.w + z * q.x,
+		w * q.z + x * q.y - y * q.x + z * q.w,
+		w * q.w - x * q.x - y * q.y - z * q.z,
+	};
+}
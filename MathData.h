@@ -120,3 +120,66 @@ struct Matrix4x4 final {
 	static Matrix4x4 Identity4x4();
 };
 
+
+/// <summary>
+/// クォータニオン(回転を表す、wが実部)
+/// </summary>
+struct Quaternion final {
+	float x;
+	float y;
+	float z;
+	float w;
+
+	/// <summary>
+	/// 回転なし
+	/// </summary>
+	/// <returns>単位クォータニオン</returns>
+	static Quaternion Identity();
+
+	/// <summary>
+	/// 任意軸回転
+	/// </summary>
+	/// <param name="axis">回転軸(正規化済み)</param>
+	/// <param name="angle">角度(ラジアン)</param>
+	/// <returns>回転</returns>
+	static Quaternion MakeRotateAxisAngle(const Vector3& axis, float angle);
+
+	/// <summary>
+	/// x,y,z軸の順に回転(Rendering::MakeRotateXYZMatrixと同じ回転)
+	/// </summary>
+	/// <param name="radian">各軸の角度(ラジアン)</param>
+	/// <returns>回転</returns>
+	static Quaternion MakeRotateXYZ(const Vector3& radian);
+
+	/// <summary>
+	/// 球面線形補間
+	/// </summary>
+	/// <param name="begin">最初の回転</param>
+	/// <param name="end">最後の回転</param>
+	/// <param name="t">補間係数(0～1)</param>
+	/// <returns>現在の回転(近い方の向きで補間する)</returns>
+	static Quaternion Slerp(const Quaternion& begin, const Quaternion& end, float t);
+
+	//内積
+	float Dot(const Quaternion& q)const;
+	//正規化
+	Quaternion Normalize()const;
+	//共役(単位クォータニオンなら逆回転)
+	Quaternion Conjugate()const;
+
+	/// <summary>
+	/// ベクトルを回転させる
+	/// </summary>
+	/// <param name="v">ベクトル</param>
+	/// <returns>回転後のベクトル</returns>
+	Vector3 Rotate(const Vector3& v)const;
+
+	/// <summary>
+	/// 回転行列(行ベクトルに右から掛ける)
+	/// </summary>
+	/// <returns>回転行列</returns>
+	Matrix4x4 MakeRotateMatrix()const;
+
+	//積(qを回してからthisで回す)
+	Quaternion operator*(const Quaternion& q)const;
+};
@@ -0,0 +1,485 @@
+#include "MemoryTracker.h"
+#include <cassert>
+#ifdef MT_MEMORY_TRACKING
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <vector>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#include <DbgHelp.h>
+#pragma comment(lib, "Dbghelp.lib")
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define MT_MEMORY_TRACKING_BACKTRACE
+#endif
+#endif // MT_MEMORY_TRACKING
+
+namespace {
+	//タグの名前
+	const char* const kTagNames[MemoryTracker::kTagCount] = {
+		"general",
+		"math",
+		"draw",
+		"physics",
+		"assets",
+	};
+}
+
+//タグの名前のゲッター
+const char* MemoryTracker::GetTagName(Tag tag) {
+	assert(tag < Tag::kCount);
+	return kTagNames[static_cast<size_t>(tag)];
+}
+
+#ifdef MT_MEMORY_TRACKING
+namespace {
+	/// <summary>
+	/// 確保の前に置く情報
+	/// </summary>
+	struct AllocationHeader {
+		uint64_t size; //確保したバイト数
+		uint32_t tag; //確保したときのタグ
+		uint32_t magic; //壊れていないか確かめる値
+	};
+
+	//確保の前に置くバイト数(newが返す先頭の揃えを崩さない)
+	const size_t kHeaderSize = 16;
+	static_assert(sizeof(AllocationHeader) == kHeaderSize && kHeaderSize % alignof(std::max_align_t) == 0,
+		"AllocationHeaderはnewの揃えを崩さない大きさにする");
+	//AllocationHeader::magicの値
+	const uint32_t kHeaderMagic = 0x4B52544D; //"MTRK"
+	//呼び出し履歴から飛ばす関数の数(インライン展開で変わるので、呼び出し元を消さないように少なめにする)
+	const uint32_t kSkippedFrames = 1;
+
+	/// <summary>
+	/// タグごとのカウンタ(どのスレッドからも足す)
+	/// </summary>
+	struct TagCounters {
+		std::atomic<uint64_t> allocationCount;
+		std::atomic<uint64_t> allocationBytes;
+		std::atomic<uint64_t> freeBytes;
+		std::atomic<uint64_t> peakLiveBytes;
+	};
+
+	/// <summary>
+	/// 残した呼び出し履歴
+	/// </summary>
+	struct StackSample {
+		uint64_t hash; //関数の並びのハッシュ(0なら空き)
+		uint64_t count; //残した回数
+		uint64_t bytes; //残した確保のバイト数の合計
+		MemoryTracker::Tag tag; //最後に残したときのタグ
+		uint32_t depth; //関数の数
+		void* frames[MemoryTracker::kMaxStackDepth]; //関数の戻り先
+	};
+
+	//newはmainの前から呼ばれるので、すべて定数で初期化できるものだけを置く
+	TagCounters tagCounters[MemoryTracker::kTagCount];
+	std::atomic<uint32_t> stackSampleInterval = 0;
+	thread_local uint32_t stackSampleCounter = 0;
+	thread_local bool isSamplingStack = false;
+	std::mutex stackSampleMutex;
+	StackSample stackSamples[MemoryTracker::kMaxStackSamples];
+
+	//EndFrameだけが使う(メインスレッド)
+	uint64_t frame = 0;
+	MemoryTracker::FrameStats frameStats;
+	uint64_t previousCounts[MemoryTracker::kTagCount] = {};
+	uint64_t previousBytes[MemoryTracker::kTagCount] = {};
+	uint64_t peakTotalLiveBytes = 0;
+	uint64_t peakTotalFrameBytes = 0;
+
+	/// <summary>
+	/// 呼び出し履歴を取る
+	/// </summary>
+	/// <returns>関数の数</returns>
+	uint32_t CaptureStack(void** frames, uint32_t maxDepth) {
+#ifdef _WIN32
+		return CaptureStackBackTrace(kSkippedFrames, maxDepth, frames, nullptr);
+#elif defined(MT_MEMORY_TRACKING_BACKTRACE)
+		void* buffer[MemoryTracker::kMaxStackDepth + kSkippedFrames];
+		const int depth = backtrace(buffer, static_cast<int>(std::min(maxDepth, MemoryTracker::kMaxStackDepth) + kSkippedFrames));
+		if (depth <= static_cast<int>(kSkippedFrames)) {
+			return 0;
+		}
+		std::memcpy(frames, buffer + kSkippedFrames, sizeof(void*) * (static_cast<size_t>(depth) - kSkippedFrames));
+		return static_cast<uint32_t>(depth) - kSkippedFrames;
+#else
+		(void)frames;
+		(void)maxDepth;
+		return 0;
+#endif
+	}
+
+	/// <summary>
+	/// 呼び出し履歴を残す
+	/// </summary>
+	void SampleStack(MemoryTracker::Tag tag, size_t size) {
+		//履歴を取る処理の中の確保は数えない
+		isSamplingStack = true;
+		void* frames[MemoryTracker::kMaxStackDepth];
+		const uint32_t depth = CaptureStack(frames, MemoryTracker::kMaxStackDepth);
+		uint64_t hash = 14695981039346656037ull;
+		for (uint32_t i = 0; i < depth; i++) {
+			hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ull;
+		}
+		hash |= 1;
+
+		{
+			std::lock_guard<std::mutex> lock(stackSampleMutex);
+			//同じ履歴をまとめる(いっぱいなら捨てる)
+			for (size_t probe = 0; probe < MemoryTracker::kMaxStackSamples; probe++) {
+				StackSample& sample = stackSamples[(hash + probe) % MemoryTracker::kMaxStackSamples];
+				if (sample.hash == 0) {
+					sample.hash = hash;
+					sample.depth = depth;
+					std::memcpy(sample.frames, frames, sizeof(void*) * depth);
+				}
+				if (sample.hash == hash) {
+					sample.count++;
+					sample.bytes += size;
+					sample.tag = tag;
+					break;
+				}
+			}
+		}
+		isSamplingStack = false;
+	}
+
+	/// <summary>
+	/// 確保を数えて前に情報を書く
+	/// </summary>
+	/// <param name="pointer">返す先頭(この前kHeaderSizeバイトに書く)</param>
+	/// <param name="size">バイト数</param>
+	void* RecordAllocation(void* pointer, size_t size) {
+		const MemoryTracker::Tag tag = MemoryTracker::GetCurrentTag();
+		const AllocationHeader header = { size, static_cast<uint32_t>(tag), kHeaderMagic };
+		std::memcpy(static_cast<uint8_t*>(pointer) - kHeaderSize, &header, kHeaderSize);
+
+		TagCounters& counters = tagCounters[static_cast<size_t>(tag)];
+		counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+		const uint64_t allocationBytes = counters.allocationBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		const uint64_t liveBytes = allocationBytes - counters.freeBytes.load(std::memory_order_relaxed);
+		uint64_t peakLiveBytes = counters.peakLiveBytes.load(std::memory_order_relaxed);
+		while (liveBytes > peakLiveBytes && !counters.peakLiveBytes.compare_exchange_weak(peakLiveBytes, liveBytes, std::memory_order_relaxed)) {
+		}
+
+		const uint32_t interval = stackSampleInterval.load(std::memory_order_relaxed);
+		if (interval != 0 && !isSamplingStack && ++stackSampleCounter >= interval) {
+			stackSampleCounter = 0;
+			SampleStack(tag, size);
+		}
+		return pointer;
+	}
+
+	/// <summary>
+	/// 解放を数える
+	/// </summary>
+	/// <param name="pointer">newが返した先頭</param>
+	void RecordFree(void* pointer) {
+		AllocationHeader header;
+		std::memcpy(&header, static_cast<uint8_t*>(pointer) - kHeaderSize, kHeaderSize);
+		assert(header.magic == kHeaderMagic && header.tag < MemoryTracker::kTagCount && "deleted memory was not allocated by the tracked operator new");
+		tagCounters[header.tag].freeBytes.fetch_add(header.size, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// 揃えた確保(情報を置く分だけ前を空ける)
+	/// </summary>
+	/// <returns>確保した塊の先頭</returns>
+	void* AllocateAligned(size_t size, size_t alignment) {
+#ifdef _WIN32
+		return _aligned_malloc(size, alignment);
+#else
+		return std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+	}
+
+	/// <summary>
+	/// 揃えた確保の解放
+	/// </summary>
+	void FreeAligned(void* block) {
+#ifdef _WIN32
+		_aligned_free(block);
+#else
+		std::free(block);
+#endif
+	}
+
+	/// <summary>
+	/// 揃えた確保で前を空けるバイト数
+	/// </summary>
+	size_t GetAlignedOffset(std::align_val_t alignment) {
+		return std::max(kHeaderSize, static_cast<size_t>(alignment));
+	}
+}
+
+void* operator new(size_t size) {
+	if (void* block = std::malloc(size + kHeaderSize)) {
+		return RecordAllocation(static_cast<uint8_t*>(block) + kHeaderSize, size);
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	const size_t offset = GetAlignedOffset(alignment);
+	if (void* block = AllocateAligned(size + offset, static_cast<size_t>(alignment))) {
+		return RecordAllocation(static_cast<uint8_t*>(block) + offset, size);
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return operator new(size, alignment);
+}
+
+//nothrow版も置き換えないと、ライブラリが標準のnothrow版で確保したものを上の解放が受け取ってしまう
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return operator new(size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return operator new[](size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try {
+		return operator new(size, alignment);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try {
+		return operator new[](size, alignment);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void operator delete(void* p) noexcept {
+	if (p == nullptr) {
+		return;
+	}
+	RecordFree(p);
+	std::free(static_cast<uint8_t*>(p) - kHeaderSize);
+}
+
+void operator delete[](void* p) noexcept {
+	operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+	operator delete(p);
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept {
+	if (p == nullptr) {
+		return;
+	}
+	RecordFree(p);
+	FreeAligned(static_cast<uint8_t*>(p) - GetAlignedOffset(alignment));
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept {
+	operator delete(p, alignment);
+}
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept {
+	operator delete(p, alignment);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept {
+	operator delete(p, alignment);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	operator delete(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	operator delete[](p);
+}
+
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	operator delete(p, alignment);
+}
+
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	operator delete[](p, alignment);
+}
+
+//フレームの終了
+void MemoryTracker::EndFrame() {
+	FrameStats stats = {};
+	stats.frame = frame++;
+	for (size_t i = 0; i < kTagCount; i++) {
+		const TagCounters& counters = tagCounters[i];
+		TagStats& tagStats = stats.tags[i];
+		tagStats.totalAllocationCount = counters.allocationCount.load(std::memory_order_relaxed);
+		tagStats.totalAllocationBytes = counters.allocationBytes.load(std::memory_order_relaxed);
+		const uint64_t freeBytes = counters.freeBytes.load(std::memory_order_relaxed);
+		//ほかのスレッドが解放を先に数えていると一瞬負になるので0で止める
+		tagStats.liveBytes = tagStats.totalAllocationBytes > freeBytes ? tagStats.totalAllocationBytes - freeBytes : 0;
+		tagStats.peakLiveBytes = std::max(counters.peakLiveBytes.load(std::memory_order_relaxed), tagStats.liveBytes);
+		tagStats.frameAllocationCount = tagStats.totalAllocationCount - previousCounts[i];
+		tagStats.frameAllocationBytes = tagStats.totalAllocationBytes - previousBytes[i];
+		tagStats.peakFrameAllocationBytes = std::max(frameStats.tags[i].peakFrameAllocationBytes, tagStats.frameAllocationBytes);
+		previousCounts[i] = tagStats.totalAllocationCount;
+		previousBytes[i] = tagStats.totalAllocationBytes;
+
+		stats.total.frameAllocationCount += tagStats.frameAllocationCount;
+		stats.total.frameAllocationBytes += tagStats.frameAllocationBytes;
+		stats.total.totalAllocationCount += tagStats.totalAllocationCount;
+		stats.total.totalAllocationBytes += tagStats.totalAllocationBytes;
+		stats.total.liveBytes += tagStats.liveBytes;
+	}
+	//合計の最大はフレームの終わりの値で測る
+	peakTotalLiveBytes = std::max(peakTotalLiveBytes, stats.total.liveBytes);
+	peakTotalFrameBytes = std::max(peakTotalFrameBytes, stats.total.frameAllocationBytes);
+	stats.total.peakLiveBytes = peakTotalLiveBytes;
+	stats.total.peakFrameAllocationBytes = peakTotalFrameBytes;
+	frameStats = stats;
+}
+
+//直前のフレームの集計結果のゲッター
+const MemoryTracker::FrameStats& MemoryTracker::GetFrameStats() {
+	return frameStats;
+}
+
+//起動してからの確保回数のゲッター
+uint64_t MemoryTracker::GetAllocationCount() {
+	uint64_t count = 0;
+	for (const TagCounters& counters : tagCounters) {
+		count += counters.allocationCount.load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
+//起動してからの確保バイト数のゲッター
+uint64_t MemoryTracker::GetAllocationBytes() {
+	uint64_t bytes = 0;
+	for (const TagCounters& counters : tagCounters) {
+		bytes += counters.allocationBytes.load(std::memory_order_relaxed);
+	}
+	return bytes;
+}
+
+//呼び出し履歴を残す間隔の設定
+void MemoryTracker::SetStackSampleInterval(uint32_t interval) {
+	stackSampleInterval.store(interval, std::memory_order_relaxed);
+}
+
+//呼び出し履歴を残す間隔のゲッター
+uint32_t MemoryTracker::GetStackSampleInterval() {
+	return stackSampleInterval.load(std::memory_order_relaxed);
+}
+
+//集計と残した呼び出し履歴を書き出す
+bool MemoryTracker::WriteReport(const char* filePath) {
+	std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	//最後のEndFrameの後の分も入れる
+	EndFrame();
+	char line[256];
+	std::snprintf(line, sizeof(line), "%-10s %12s %16s %14s %14s %16s\n", "tag", "allocs", "bytes", "live", "peak live", "peak frame bytes");
+	file << "frames: " << frame << "\n" << line;
+	for (size_t i = 0; i <= kTagCount; i++) {
+		const TagStats& stats = i < kTagCount ? frameStats.tags[i] : frameStats.total;
+		std::snprintf(line, sizeof(line), "%-10s %12llu %16llu %14llu %14llu %16llu\n", i < kTagCount ? kTagNames[i] : "total",
+			static_cast<unsigned long long>(stats.totalAllocationCount), static_cast<unsigned long long>(stats.totalAllocationBytes),
+			static_cast<unsigned long long>(stats.liveBytes), static_cast<unsigned long long>(stats.peakLiveBytes),
+			static_cast<unsigned long long>(stats.peakFrameAllocationBytes));
+		file << line;
+	}
+
+	//残した呼び出し履歴をバイト数の多い順に並べる
+	//ロック中に確保すると履歴を残す処理が同じロックを待つので、先に確保しておく
+	std::vector<StackSample> samples;
+	samples.reserve(kMaxStackSamples);
+	{
+		std::lock_guard<std::mutex> lock(stackSampleMutex);
+		for (const StackSample& sample : stackSamples) {
+			if (sample.hash != 0) {
+				samples.push_back(sample);
+			}
+		}
+	}
+	std::sort(samples.begin(), samples.end(), [](const StackSample& a, const StackSample& b) { return a.bytes > b.bytes; });
+	file << "\nsampled allocation sites (1 in " << GetStackSampleInterval() << " allocations): " << samples.size() << "\n";
+
+#ifdef _WIN32
+	HANDLE process = GetCurrentProcess();
+	const bool isSymbolReady = SymInitialize(process, nullptr, TRUE) != FALSE;
+	SymSetOptions(SymGetOptions() | SYMOPT_LOAD_LINES | SYMOPT_UNDNAME);
+#endif
+	for (const StackSample& sample : samples) {
+		file << "\n" << sample.bytes << " bytes in " << sample.count << " samples [" << kTagNames[static_cast<size_t>(sample.tag)] << "]\n";
+#ifdef _WIN32
+		for (uint32_t i = 0; i < sample.depth; i++) {
+			const DWORD64 address = reinterpret_cast<DWORD64>(sample.frames[i]);
+			alignas(SYMBOL_INFO) char symbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+			SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(symbolBuffer);
+			symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+			symbol->MaxNameLen = MAX_SYM_NAME;
+			IMAGEHLP_LINE64 sourceLine = {};
+			sourceLine.SizeOfStruct = sizeof(sourceLine);
+			DWORD lineDisplacement = 0;
+			if (isSymbolReady && SymFromAddr(process, address, nullptr, symbol)) {
+				file << "    " << symbol->Name;
+				if (SymGetLineFromAddr64(process, address, &lineDisplacement, &sourceLine)) {
+					file << " (" << sourceLine.FileName << ":" << sourceLine.LineNumber << ")";
+				}
+				file << "\n";
+			} else {
+				std::snprintf(line, sizeof(line), "    0x%llx\n", static_cast<unsigned long long>(address));
+				file << line;
+			}
+		}
+#elif defined(MT_MEMORY_TRACKING_BACKTRACE)
+		char** symbols = backtrace_symbols(sample.frames, static_cast<int>(sample.depth));
+		for (uint32_t i = 0; i < sample.depth; i++) {
+			file << "    " << (symbols != nullptr ? symbols[i] : "?") << "\n";
+		}
+		std::free(symbols);
+#endif
+	}
+#ifdef _WIN32
+	if (isSymbolReady) {
+		SymCleanup(process);
+	}
+#endif
+	return static_cast<bool>(file);
+}
+#endif // MT_MEMORY_TRACKING
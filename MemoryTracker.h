@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// ヒープの確保の集計(サブシステムごとの確保回数・バイト数・最大使用量)
+/// </summary>
+/// <remarks>
+/// MT_MEMORY_TRACKINGを定義したビルド(DebugとDevelop)だけグローバルなnew/deleteを置き換え、
+/// 確保ごとに前へ16バイトの情報を付けて、確保したときのタグで解放も数える。
+/// タグはスレッドごとにScopeで切り替え、JobSystemのワーカーはParallelForを呼んだスレッドのタグを引き継ぐ。
+/// 定義しないビルドではどの関数も空のインライン関数になり、newも置き換えないので何も残らない。
+/// mallocで直接確保したもの(Noviceの中など)は数えない
+/// </remarks>
+class MemoryTracker {
+public://列挙型
+	/// <summary>
+	/// 確保したサブシステム
+	/// </summary>
+	enum class Tag : uint32_t {
+		kGeneral, //タグなし
+		kMath,    //数学の作業領域(TransformHierarchy、Splineなど)
+		kDraw,    //描画命令(DrawCapture、DebugTextなど)
+		kPhysics, //物理(RigidBodyWorld、ContactSolver、ParticleSystem)
+		kAssets,  //アセット(AssetArchive、ObjLoader)
+		kCount
+	};
+
+	//タグの数
+	static inline const size_t kTagCount = static_cast<size_t>(Tag::kCount);
+public://構造体
+	/// <summary>
+	/// タグごとの集計
+	/// </summary>
+	struct TagStats {
+		uint64_t frameAllocationCount = 0; //直前のフレームの確保回数
+		uint64_t frameAllocationBytes = 0; //直前のフレームの確保バイト数
+		uint64_t totalAllocationCount = 0; //起動してからの確保回数
+		uint64_t totalAllocationBytes = 0; //起動してからの確保バイト数
+		uint64_t liveBytes = 0; //解放していないバイト数
+		uint64_t peakLiveBytes = 0; //解放していないバイト数の最大
+		uint64_t peakFrameAllocationBytes = 0; //1フレームの確保バイト数の最大
+	};
+
+	/// <summary>
+	/// 1フレーム分の集計結果
+	/// </summary>
+	struct FrameStats {
+		uint64_t frame = 0; //フレーム番号
+		TagStats tags[kTagCount] = {}; //タグごとの集計
+		TagStats total = {}; //全タグの合計(peakLiveBytesは合計の最大)
+
+		/// <summary>
+		/// タグの集計のゲッター
+		/// </summary>
+		const TagStats& Get(Tag tag) const { return tags[static_cast<size_t>(tag)]; }
+	};
+
+	/// <summary>
+	/// タグを切り替える範囲(抜けると元のタグに戻る)
+	/// </summary>
+	class Scope {
+	public:
+#ifdef MT_MEMORY_TRACKING
+		explicit Scope(Tag tag) : previousTag_(currentTag) { currentTag = tag; }
+		~Scope() { currentTag = previousTag_; }
+#else
+		explicit Scope(Tag) {}
+#endif
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+#ifdef MT_MEMORY_TRACKING
+	private:
+		Tag previousTag_; //切り替える前のタグ
+#endif
+	};
+public://定数
+#ifdef MT_MEMORY_TRACKING
+	//集計するビルドか
+	static inline const bool kIsEnabled = true;
+#else
+	static inline const bool kIsEnabled = false;
+#endif
+	//1つの呼び出し履歴に残す関数の数
+	static inline const uint32_t kMaxStackDepth = 16;
+	//残す呼び出し履歴の種類の上限
+	static inline const size_t kMaxStackSamples = 256;
+public://メンバ関数
+	/// <summary>
+	/// 呼んだスレッドのタグのゲッター
+	/// </summary>
+	static Tag GetCurrentTag() {
+#ifdef MT_MEMORY_TRACKING
+		return currentTag;
+#else
+		return Tag::kGeneral;
+#endif
+	}
+
+	/// <summary>
+	/// タグの名前のゲッター
+	/// </summary>
+	static const char* GetTagName(Tag tag);
+
+#ifdef MT_MEMORY_TRACKING
+	/// <summary>
+	/// フレームの終了(前のフレームからの差分を集計する)
+	/// </summary>
+	static void EndFrame();
+
+	/// <summary>
+	/// 直前のフレームの集計結果のゲッター
+	/// </summary>
+	static const FrameStats& GetFrameStats();
+
+	/// <summary>
+	/// 起動してからの確保回数のゲッター(全タグ、集計を待たずに今の値)
+	/// </summary>
+	static uint64_t GetAllocationCount();
+
+	/// <summary>
+	/// 起動してからの確保バイト数のゲッター(全タグ、集計を待たずに今の値)
+	/// </summary>
+	static uint64_t GetAllocationBytes();
+
+	/// <summary>
+	/// 呼び出し履歴を残す間隔の設定
+	/// </summary>
+	/// <param name="interval">この回数の確保ごとに1回残す(0なら残さない)</param>
+	static void SetStackSampleInterval(uint32_t interval);
+
+	/// <summary>
+	/// 呼び出し履歴を残す間隔のゲッター
+	/// </summary>
+	static uint32_t GetStackSampleInterval();
+
+	/// <summary>
+	/// 集計と残した呼び出し履歴(バイト数の多い順)を書き出す
+	/// </summary>
+	/// <param name="filePath">出力先</param>
+	/// <returns>書き出せたか</returns>
+	static bool WriteReport(const char* filePath);
+#else
+	static void EndFrame() {}
+	static const FrameStats& GetFrameStats() {
+		static const FrameStats kEmptyStats = {};
+		return kEmptyStats;
+	}
+	static uint64_t GetAllocationCount() { return 0; }
+	static uint64_t GetAllocationBytes() { return 0; }
+	static void SetStackSampleInterval(uint32_t) {}
+	static uint32_t GetStackSampleInterval() { return 0; }
+	static bool WriteReport(const char*) { return false; }
+#endif
+private://静的メンバ変数
+#ifdef MT_MEMORY_TRACKING
+	//呼んだスレッドのタグ
+	static inline thread_local Tag currentTag = Tag::kGeneral;
+#endif
+};
@@ -0,0 +1,18 @@
+#include "NoviceDrawBackend.h"
+#include <Novice.h>
+
+//線の描画
+void NoviceDrawBackend::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {
+	Novice::DrawLine(x1, y1, x2, y2, color);
+}
+
+//塗りつぶした三角形の描画
+void NoviceDrawBackend::DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color) {
+	Novice::DrawTriangle(x1, y1, x2, y2, x3, y3, color, kFillModeSolid);
+}
+
+//文字列の描画
+void NoviceDrawBackend::DrawString(int32_t x, int32_t y, const char* text) {
+	//文字列はできあがっているので、書式は"%s"だけにする
+	Novice::ScreenPrintf(x, y, "%s", text);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "DrawBackend.h"
+
+/// <summary>
+/// Noviceへの描画先
+/// </summary>
+class NoviceDrawBackend : public DrawBackend {
+public://メンバ関数
+	/// <summary>
+	/// 線の描画
+	/// </summary>
+	void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) override;
+
+	/// <summary>
+	/// 塗りつぶした三角形の描画
+	/// </summary>
+	void DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color) override;
+
+	/// <summary>
+	/// 文字列の描画
+	/// </summary>
+	void DrawString(int32_t x, int32_t y, const char* text) override;
+};
@@ -0,0 +1,681 @@
+#include "ObjLoader.h"
+#include "MemoryTracker.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace {
+	//要素がないことを表す番号
+	const uint32_t kNone = UINT32_MAX;
+
+	/// <summary>
+	/// 面の頂点(OBJの1始まりの番号を0始まりにしたもの)
+	/// </summary>
+	struct Corner {
+		int32_t indices[3]; //位置・UV・法線の番号(ないものは-1。負の番号で書かれたものは区間の中での番号)
+		uint8_t relativeMask; //負の番号で書かれた要素のビット
+	};
+
+	/// <summary>
+	/// 描く範囲の区切り
+	/// </summary>
+	struct GroupEvent {
+		size_t cornerIndex; //区切る位置(区間の中での面の頂点の番号)
+		bool isMaterial; //usemtlか(o・gならfalse)
+		std::string_view name; //マテリアルの名前
+	};
+
+	/// <summary>
+	/// 区間ごとの解析結果
+	/// </summary>
+	struct ChunkResult {
+		std::vector<Vector3> positions; //位置
+		std::vector<float> texcoords; //テクスチャ座標(u,vの順)
+		std::vector<Vector3> normals; //法線
+		std::vector<Corner> corners; //三角形の頂点(3つで1つ)
+		std::vector<GroupEvent> events; //描く範囲の区切り
+		std::string_view materialLibrary; //mtllibのファイル名
+		bool isValid = true; //書式の誤りがなかったか
+	};
+
+	/// <summary>
+	/// 面の頂点の番号の組(重複をまとめるキー)
+	/// </summary>
+	struct VertexKey {
+		uint32_t position; //位置の番号
+		uint32_t texcoord; //UVの番号(なければkNone)
+		uint32_t normal; //法線の番号(なければkNone)
+
+		bool operator==(const VertexKey& other) const = default;
+	};
+
+	/// <summary>
+	/// キャッシュの先頭
+	/// </summary>
+	struct CacheHeader {
+		uint32_t magic; //識別子
+		uint32_t version; //版
+		uint64_t sourceSize; //元のOBJのバイト数
+		int64_t sourceWriteTime; //元のOBJの更新時刻
+		uint64_t materialLibrarySize; //MTLのバイト数(なければ0)
+		int64_t materialLibraryWriteTime; //MTLの更新時刻(なければ0)
+		uint32_t vertexCount; //頂点数
+		uint32_t indexCount; //インデックス数
+		uint32_t subMeshCount; //描く範囲の数
+		uint32_t materialCount; //マテリアル数
+		uint32_t materialLibraryLength; //MTLのパスのバイト数(ヘッダの直後に続く)
+		AABB bounds; //全体を囲むAABB
+	};
+
+	/// <summary>
+	/// キャッシュのマテリアル(後ろに名前とテクスチャのパスが続く)
+	/// </summary>
+	struct CacheMaterial {
+		Vector3 diffuseColor; //拡散色
+		uint32_t nameLength; //名前のバイト数
+		uint32_t textureLength; //テクスチャのパスのバイト数
+	};
+
+	static_assert(std::is_trivially_copyable_v<ObjLoader::Vertex> && std::is_trivially_copyable_v<ObjLoader::SubMesh>,
+		"キャッシュには頂点と描く範囲をそのまま書き出す");
+
+	/// <summary>
+	/// 空白を読み飛ばす
+	/// </summary>
+	const char* SkipSpaces(const char* p, const char* end) {
+		while (p < end && (*p == ' ' || *p == '\t')) {
+			p++;
+		}
+		return p;
+	}
+
+	/// <summary>
+	/// 行末か(改行の前の\rも行末とみなす)
+	/// </summary>
+	bool IsLineEnd(const char* p, const char* end) {
+		return p == end || *p == '\r';
+	}
+
+	/// <summary>
+	/// 実数を読む
+	/// </summary>
+	bool ParseFloat(const char*& p, const char* end, float& value) {
+		p = SkipSpaces(p, end);
+		const std::from_chars_result result = std::from_chars(p, end, value);
+		if (result.ec != std::errc()) {
+			return false;
+		}
+		p = result.ptr;
+		return true;
+	}
+
+	/// <summary>
+	/// 3つの実数を読む
+	/// </summary>
+	bool ParseVector3(const char*& p, const char* end, Vector3& value) {
+		return ParseFloat(p, end, value.x) && ParseFloat(p, end, value.y) && ParseFloat(p, end, value.z);
+	}
+
+	/// <summary>
+	/// 行の残りを名前として読む(前後の空白を除く)
+	/// </summary>
+	std::string_view ParseName(const char* p, const char* end) {
+		p = SkipSpaces(p, end);
+		const char* last = end;
+		while (last > p && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) {
+			last--;
+		}
+		return std::string_view(p, static_cast<size_t>(last - p));
+	}
+
+	/// <summary>
+	/// 面の頂点を1つ読む("p", "p/t", "p//n", "p/t/n")
+	/// </summary>
+	/// <param name="counts">この区間でここまでに読んだ位置・UV・法線の数(負の番号に使う)</param>
+	bool ParseCorner(const char*& p, const char* end, const size_t counts[3], Corner& corner) {
+		corner = { .indices = { -1,-1,-1 },.relativeMask = 0 };
+		for (uint32_t element = 0; element < 3; element++) {
+			if (element > 0) {
+				if (p == end || *p != '/') {
+					break;
+				}
+				p++;
+				//"p//n"のUVのように省略されている
+				if (p == end || *p == '/' || *p == ' ' || *p == '\t' || *p == '\r') {
+					continue;
+				}
+			}
+			int32_t index = 0;
+			const std::from_chars_result result = std::from_chars(p, end, index);
+			if (result.ec != std::errc() || index == 0) {
+				return false;
+			}
+			p = result.ptr;
+			if (index > 0) {
+				corner.indices[element] = index - 1;
+			} else {
+				corner.indices[element] = static_cast<int32_t>(counts[element]) + index;
+				corner.relativeMask |= static_cast<uint8_t>(1 << element);
+			}
+		}
+		return corner.indices[0] != -1 || (corner.relativeMask & 1) != 0;
+	}
+
+	/// <summary>
+	/// 1行の解析
+	/// </summary>
+	bool ParseLine(const char* p, const char* end, ChunkResult& result) {
+		p = SkipSpaces(p, end);
+		if (IsLineEnd(p, end) || *p == '#') {
+			return true;
+		}
+		const char* keywordEnd = p;
+		while (keywordEnd < end && *keywordEnd != ' ' && *keywordEnd != '\t' && *keywordEnd != '\r') {
+			keywordEnd++;
+		}
+		const std::string_view keyword(p, static_cast<size_t>(keywordEnd - p));
+		p = keywordEnd;
+
+		if (keyword == "v") {
+			Vector3 position = {};
+			if (!ParseVector3(p, end, position)) {
+				return false;
+			}
+			result.positions.push_back(position);
+		} else if (keyword == "vt") {
+			float u = 0.0f;
+			float v = 0.0f;
+			if (!ParseFloat(p, end, u)) {
+				return false;
+			}
+			if (!IsLineEnd(SkipSpaces(p, end), end) && !ParseFloat(p, end, v)) {
+				return false;
+			}
+			result.texcoords.push_back(u);
+			result.texcoords.push_back(v);
+		} else if (keyword == "vn") {
+			Vector3 normal = {};
+			if (!ParseVector3(p, end, normal)) {
+				return false;
+			}
+			result.normals.push_back(normal);
+		} else if (keyword == "f") {
+			//多角形は最初の頂点を中心に扇形に分ける
+			const size_t counts[3] = { result.positions.size(), result.texcoords.size() / 2, result.normals.size() };
+			Corner first = {};
+			Corner previous = {};
+			size_t cornerCount = 0;
+			for (p = SkipSpaces(p, end); !IsLineEnd(p, end); p = SkipSpaces(p, end)) {
+				Corner corner = {};
+				if (!ParseCorner(p, end, counts, corner) || (p != end && *p != ' ' && *p != '\t' && *p != '\r')) {
+					return false;
+				}
+				if (cornerCount == 0) {
+					first = corner;
+				} else if (cornerCount >= 2) {
+					result.corners.push_back(first);
+					result.corners.push_back(previous);
+					result.corners.push_back(corner);
+				}
+				previous = corner;
+				cornerCount++;
+			}
+			if (cornerCount < 3) {
+				return false;
+			}
+		} else if (keyword == "usemtl") {
+			result.events.push_back({ .cornerIndex = result.corners.size(),.isMaterial = true,.name = ParseName(p, end) });
+		} else if (keyword == "o" || keyword == "g") {
+			result.events.push_back({ .cornerIndex = result.corners.size(),.isMaterial = false,.name = {} });
+		} else if (keyword == "mtllib") {
+			if (result.materialLibrary.empty()) {
+				result.materialLibrary = ParseName(p, end);
+			}
+		}
+		//s・l・pなどは使わないので読み飛ばす
+		return true;
+	}
+
+	/// <summary>
+	/// 区間の解析
+	/// </summary>
+	void ParseChunk(const char* begin, const char* end, ChunkResult& result) {
+		const char* line = begin;
+		while (line < end) {
+			const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+			if (lineEnd == nullptr) {
+				lineEnd = end;
+			}
+			if (!ParseLine(line, lineEnd, result)) {
+				result.isValid = false;
+				return;
+			}
+			line = lineEnd + 1;
+		}
+	}
+
+	/// <summary>
+	/// 番号の組のハッシュ
+	/// </summary>
+	uint32_t HashVertexKey(const VertexKey& key) {
+		uint32_t hash = key.position * 0x9E3779B1u ^ key.texcoord * 0x85EBCA77u ^ key.normal * 0xC2B2AE3Du;
+		hash ^= hash >> 16;
+		hash *= 0x7FEB352Du;
+		hash ^= hash >> 15;
+		return hash;
+	}
+
+	/// <summary>
+	/// 元のファイルのサイズと更新時刻
+	/// </summary>
+	bool GetSourceStamp(const char* sourcePath, uint64_t& size, int64_t& writeTime) {
+		std::error_code error;
+		size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, error));
+		if (error) {
+			return false;
+		}
+		writeTime = static_cast<int64_t>(std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count());
+		return !error;
+	}
+
+	/// <summary>
+	/// MTLのサイズと更新時刻(MTLがなければどちらも0。後から置かれても古いと分かる)
+	/// </summary>
+	/// <param name="sourcePath">元のOBJファイル</param>
+	/// <param name="materialLibrary">MTLのOBJからの相対パス</param>
+	void GetMaterialLibraryStamp(const char* sourcePath, std::string_view materialLibrary, uint64_t& size, int64_t& writeTime) {
+		size = 0;
+		writeTime = 0;
+		if (materialLibrary.empty()) {
+			return;
+		}
+		const std::filesystem::path materialPath = std::filesystem::path(sourcePath).parent_path() / std::filesystem::path(materialLibrary);
+		if (!GetSourceStamp(materialPath.string().c_str(), size, writeTime)) {
+			size = 0;
+			writeTime = 0;
+		}
+	}
+
+	/// <summary>
+	/// 名前でマテリアルを探し、なければ追加する
+	/// </summary>
+	uint32_t FindOrAddMaterial(std::vector<ObjLoader::Material>& materials, std::string_view name) {
+		for (size_t i = 0; i < materials.size(); i++) {
+			if (materials[i].name == name) {
+				return static_cast<uint32_t>(i);
+			}
+		}
+		materials.push_back({ .name = std::string(name),.diffuseColor = { 1.0f,1.0f,1.0f },.diffuseTexture = {} });
+		return static_cast<uint32_t>(materials.size() - 1);
+	}
+}
+
+//読み込み
+bool ObjLoader::Load(const char* filePath, Mesh& mesh) {
+	const std::string cachePath = std::string(filePath) + kCacheExtension;
+	if (LoadCache(cachePath.c_str(), filePath, mesh)) {
+		return true;
+	}
+	if (!LoadObj(filePath, mesh)) {
+		return false;
+	}
+	//書き込めない場所でも読み込みは成功とする
+	WriteCache(cachePath.c_str(), filePath, mesh);
+	return true;
+}
+
+//OBJの解析
+bool ObjLoader::LoadObj(const char* filePath, Mesh& mesh) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kAssets);
+	mesh = {};
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return false;
+	}
+	const char* data = reinterpret_cast<const char*>(file.GetData());
+	const size_t size = file.GetSize();
+
+	//行の途中で切らないように、区切りを次の改行の後ろまで進める
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	const size_t chunkCount = std::clamp<size_t>(size / kMinChunkBytes, 1, static_cast<size_t>(jobSystem->GetThreadCount()) * 4);
+	std::vector<size_t> chunkBounds(chunkCount + 1, size);
+	chunkBounds[0] = 0;
+	for (size_t i = 1; i < chunkCount; i++) {
+		const size_t nominal = std::max(size / chunkCount * i, chunkBounds[i - 1]);
+		const void* newline = std::memchr(data + nominal, '\n', size - nominal);
+		chunkBounds[i] = newline != nullptr ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+	}
+
+	std::vector<ChunkResult> chunks(chunkCount);
+	jobSystem->ParallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			ParseChunk(data + chunkBounds[i], data + chunkBounds[i + 1], chunks[i]);
+		}
+		});
+
+	//区間ごとの要素の位置を求めてつなげる
+	std::vector<size_t> offsets[4];
+	for (std::vector<size_t>& offset : offsets) {
+		offset.resize(chunkCount + 1, 0);
+	}
+	std::vector<Vector3> positions;
+	std::vector<float> texcoords;
+	std::vector<Vector3> normals;
+	std::string_view materialLibrary;
+	for (size_t i = 0; i < chunkCount; i++) {
+		const ChunkResult& chunk = chunks[i];
+		if (!chunk.isValid) {
+			return false;
+		}
+		offsets[0][i + 1] = offsets[0][i] + chunk.positions.size();
+		offsets[1][i + 1] = offsets[1][i] + chunk.texcoords.size() / 2;
+		offsets[2][i + 1] = offsets[2][i] + chunk.normals.size();
+		offsets[3][i + 1] = offsets[3][i] + chunk.corners.size();
+		positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+		texcoords.insert(texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+		normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+		if (materialLibrary.empty()) {
+			materialLibrary = chunk.materialLibrary;
+		}
+	}
+	const size_t cornerCount = offsets[3][chunkCount];
+	if (cornerCount > UINT32_MAX) {
+		return false;
+	}
+
+	//面の頂点の番号をファイル全体での番号にする
+	const size_t elementCounts[3] = { positions.size(), texcoords.size() / 2, normals.size() };
+	std::vector<VertexKey> keys(cornerCount);
+	jobSystem->ParallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			ChunkResult& chunk = chunks[i];
+			VertexKey* chunkKeys = keys.data() + offsets[3][i];
+			for (size_t c = 0; c < chunk.corners.size(); c++) {
+				const Corner& corner = chunk.corners[c];
+				uint32_t resolved[3];
+				for (uint32_t element = 0; element < 3; element++) {
+					int64_t index = corner.indices[element];
+					if (corner.relativeMask & (1 << element)) {
+						index += static_cast<int64_t>(offsets[element][i]);
+					} else if (index < 0) {
+						resolved[element] = kNone;
+						continue;
+					}
+					if (index < 0 || index >= static_cast<int64_t>(elementCounts[element])) {
+						chunk.isValid = false;
+						return;
+					}
+					resolved[element] = static_cast<uint32_t>(index);
+				}
+				chunkKeys[c] = { .position = resolved[0],.texcoord = resolved[1],.normal = resolved[2] };
+			}
+		}
+		});
+	for (const ChunkResult& chunk : chunks) {
+		if (!chunk.isValid) {
+			return false;
+		}
+	}
+
+	//同じ番号の組の頂点を1つにまとめる(表は空きが1/3以上残る大きさにする)
+	const size_t slotCount = std::bit_ceil(cornerCount + cornerCount / 2 + 1);
+	const size_t slotMask = slotCount - 1;
+	std::vector<uint32_t> slots(slotCount, kNone);
+	std::vector<VertexKey> uniqueKeys;
+	mesh.indices.resize(cornerCount);
+	for (size_t c = 0; c < cornerCount; c++) {
+		const VertexKey& key = keys[c];
+		size_t slot = HashVertexKey(key) & slotMask;
+		while (slots[slot] != kNone && !(uniqueKeys[slots[slot]] == key)) {
+			slot = (slot + 1) & slotMask;
+		}
+		if (slots[slot] == kNone) {
+			slots[slot] = static_cast<uint32_t>(uniqueKeys.size());
+			uniqueKeys.push_back(key);
+		}
+		mesh.indices[c] = slots[slot];
+	}
+	mesh.vertices.resize(uniqueKeys.size());
+	for (size_t i = 0; i < uniqueKeys.size(); i++) {
+		const VertexKey& key = uniqueKeys[i];
+		Vertex& vertex = mesh.vertices[i];
+		vertex.position = positions[key.position];
+		vertex.normal = key.normal != kNone ? normals[key.normal] : Vector3{ 0.0f,0.0f,0.0f };
+		vertex.u = key.texcoord != kNone ? texcoords[key.texcoord * 2] : 0.0f;
+		vertex.v = key.texcoord != kNone ? texcoords[key.texcoord * 2 + 1] : 0.0f;
+	}
+
+	//マテリアルはOBJからの相対パス(読めなくてもメッシュは使える)
+	mesh.materialLibrary = std::string(materialLibrary);
+	if (!materialLibrary.empty()) {
+		const std::filesystem::path materialPath = std::filesystem::path(filePath).parent_path() / std::filesystem::path(materialLibrary);
+		LoadMtl(materialPath.string().c_str(), mesh.materials);
+	}
+
+	//o・g・usemtlで描く範囲を区切る
+	uint32_t materialIndex = kNoMaterial;
+	size_t rangeBegin = 0;
+	auto closeRange = [&](size_t rangeEnd) {
+		if (rangeEnd > rangeBegin) {
+			mesh.subMeshes.push_back({ .indexOffset = static_cast<uint32_t>(rangeBegin),.indexCount = static_cast<uint32_t>(rangeEnd - rangeBegin),
+				.materialIndex = materialIndex,.bounds = {} });
+		}
+		rangeBegin = rangeEnd;
+	};
+	for (size_t i = 0; i < chunkCount; i++) {
+		for (const GroupEvent& event : chunks[i].events) {
+			closeRange(offsets[3][i] + event.cornerIndex);
+			if (event.isMaterial) {
+				materialIndex = FindOrAddMaterial(mesh.materials, event.name);
+			}
+		}
+	}
+	closeRange(cornerCount);
+
+	//範囲ごとのAABBと全体のAABB
+	for (size_t i = 0; i < mesh.subMeshes.size(); i++) {
+		SubMesh& subMesh = mesh.subMeshes[i];
+		const Vector3& firstPosition = mesh.vertices[mesh.indices[subMesh.indexOffset]].position;
+		AABB bounds = { .min = firstPosition,.max = firstPosition };
+		for (uint32_t index = subMesh.indexOffset; index < subMesh.indexOffset + subMesh.indexCount; index++) {
+			const Vector3& position = mesh.vertices[mesh.indices[index]].position;
+			bounds.min = { std::min(bounds.min.x, position.x), std::min(bounds.min.y, position.y), std::min(bounds.min.z, position.z) };
+			bounds.max = { std::max(bounds.max.x, position.x), std::max(bounds.max.y, position.y), std::max(bounds.max.z, position.z) };
+		}
+		subMesh.bounds = bounds;
+		if (i == 0) {
+			mesh.bounds = bounds;
+		} else {
+			mesh.bounds.min = { std::min(mesh.bounds.min.x, bounds.min.x), std::min(mesh.bounds.min.y, bounds.min.y), std::min(mesh.bounds.min.z, bounds.min.z) };
+			mesh.bounds.max = { std::max(mesh.bounds.max.x, bounds.max.x), std::max(mesh.bounds.max.y, bounds.max.y), std::max(mesh.bounds.max.z, bounds.max.z) };
+		}
+	}
+	return true;
+}
+
+//MTLの読み込み
+bool ObjLoader::LoadMtl(const char* filePath, std::vector<Material>& materials) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kAssets);
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return false;
+	}
+	const char* data = reinterpret_cast<const char*>(file.GetData());
+	const char* end = data + file.GetSize();
+	Material* material = nullptr;
+	for (const char* line = data; line < end;) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+		if (lineEnd == nullptr) {
+			lineEnd = end;
+		}
+		const char* p = SkipSpaces(line, lineEnd);
+		const char* keywordEnd = p;
+		while (keywordEnd < lineEnd && *keywordEnd != ' ' && *keywordEnd != '\t' && *keywordEnd != '\r') {
+			keywordEnd++;
+		}
+		const std::string_view keyword(p, static_cast<size_t>(keywordEnd - p));
+		if (keyword == "newmtl") {
+			materials.push_back({ .name = std::string(ParseName(keywordEnd, lineEnd)),.diffuseColor = { 1.0f,1.0f,1.0f },.diffuseTexture = {} });
+			material = &materials.back();
+		} else if (material != nullptr && keyword == "Kd") {
+			Vector3 color = {};
+			if (ParseVector3(keywordEnd, lineEnd, color)) {
+				material->diffuseColor = color;
+			}
+		} else if (material != nullptr && keyword == "map_Kd") {
+			//-sなどのオプションは読み飛ばし、最後のファイル名だけを使う
+			const std::string_view rest = ParseName(keywordEnd, lineEnd);
+			const size_t lastSpace = rest.find_last_of(" \t");
+			material->diffuseTexture = std::string(lastSpace == std::string_view::npos ? rest : rest.substr(lastSpace + 1));
+		}
+		line = lineEnd + 1;
+	}
+	return true;
+}
+
+//キャッシュの書き出し
+bool ObjLoader::WriteCache(const char* cachePath, const char* sourcePath, const Mesh& mesh) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kAssets);
+	CacheHeader header = {
+		.magic = kCacheMagic,
+		.version = kCacheVersion,
+		.sourceSize = 0,
+		.sourceWriteTime = 0,
+		.materialLibrarySize = 0,
+		.materialLibraryWriteTime = 0,
+		.vertexCount = static_cast<uint32_t>(mesh.vertices.size()),
+		.indexCount = static_cast<uint32_t>(mesh.indices.size()),
+		.subMeshCount = static_cast<uint32_t>(mesh.subMeshes.size()),
+		.materialCount = static_cast<uint32_t>(mesh.materials.size()),
+		.materialLibraryLength = static_cast<uint32_t>(mesh.materialLibrary.size()),
+		.bounds = mesh.bounds,
+	};
+	if (!GetSourceStamp(sourcePath, header.sourceSize, header.sourceWriteTime)) {
+		return false;
+	}
+	GetMaterialLibraryStamp(sourcePath, mesh.materialLibrary, header.materialLibrarySize, header.materialLibraryWriteTime);
+
+	//途中で止まっても壊れたキャッシュが残らないように、書き終えてから置き換える
+	const std::string temporaryPath = std::string(cachePath) + ".tmp";
+	{
+		std::ofstream output(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!output.is_open()) {
+			return false;
+		}
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		output.write(mesh.materialLibrary.data(), static_cast<std::streamsize>(mesh.materialLibrary.size()));
+		output.write(reinterpret_cast<const char*>(mesh.vertices.data()), static_cast<std::streamsize>(mesh.vertices.size() * sizeof(Vertex)));
+		output.write(reinterpret_cast<const char*>(mesh.indices.data()), static_cast<std::streamsize>(mesh.indices.size() * sizeof(uint32_t)));
+		output.write(reinterpret_cast<const char*>(mesh.subMeshes.data()), static_cast<std::streamsize>(mesh.subMeshes.size() * sizeof(SubMesh)));
+		for (const Material& material : mesh.materials) {
+			const CacheMaterial cacheMaterial = {
+				.diffuseColor = material.diffuseColor,
+				.nameLength = static_cast<uint32_t>(material.name.size()),
+				.textureLength = static_cast<uint32_t>(material.diffuseTexture.size()),
+			};
+			output.write(reinterpret_cast<const char*>(&cacheMaterial), sizeof(cacheMaterial));
+			output.write(material.name.data(), static_cast<std::streamsize>(material.name.size()));
+			output.write(material.diffuseTexture.data(), static_cast<std::streamsize>(material.diffuseTexture.size()));
+		}
+		if (!output.good()) {
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, cachePath, error);
+	return !error;
+}
+
+//キャッシュの読み込み
+bool ObjLoader::LoadCache(const char* cachePath, const char* sourcePath, Mesh& mesh) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kAssets);
+	MappedFile file;
+	if (!file.Open(cachePath)) {
+		return false;
+	}
+	const uint8_t* data = file.GetData();
+	const size_t size = file.GetSize();
+	CacheHeader header = {};
+	uint64_t sourceSize = 0;
+	int64_t sourceWriteTime = 0;
+	if (size < sizeof(header) || !GetSourceStamp(sourcePath, sourceSize, sourceWriteTime)) {
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+	if (header.magic != kCacheMagic || header.version != kCacheVersion ||
+		header.sourceSize != sourceSize || header.sourceWriteTime != sourceWriteTime) {
+		return false;
+	}
+
+	//MTLを書き換えただけでも古いとみなす
+	if (size - sizeof(header) < header.materialLibraryLength) {
+		return false;
+	}
+	const std::string_view materialLibrary(reinterpret_cast<const char*>(data + sizeof(header)), header.materialLibraryLength);
+	uint64_t materialLibrarySize = 0;
+	int64_t materialLibraryWriteTime = 0;
+	GetMaterialLibraryStamp(sourcePath, materialLibrary, materialLibrarySize, materialLibraryWriteTime);
+	if (header.materialLibrarySize != materialLibrarySize || header.materialLibraryWriteTime != materialLibraryWriteTime) {
+		return false;
+	}
+
+	const size_t arrayBytes = static_cast<size_t>(header.vertexCount) * sizeof(Vertex) +
+		static_cast<size_t>(header.indexCount) * sizeof(uint32_t) + static_cast<size_t>(header.subMeshCount) * sizeof(SubMesh);
+	if (size - sizeof(header) - header.materialLibraryLength < arrayBytes) {
+		return false;
+	}
+
+	//配列はそのままコピーする
+	mesh = {};
+	mesh.materialLibrary = std::string(materialLibrary);
+	size_t offset = sizeof(header) + header.materialLibraryLength;
+	mesh.vertices.resize(header.vertexCount);
+	std::memcpy(mesh.vertices.data(), data + offset, mesh.vertices.size() * sizeof(Vertex));
+	offset += mesh.vertices.size() * sizeof(Vertex);
+	mesh.indices.resize(header.indexCount);
+	std::memcpy(mesh.indices.data(), data + offset, mesh.indices.size() * sizeof(uint32_t));
+	offset += mesh.indices.size() * sizeof(uint32_t);
+	mesh.subMeshes.resize(header.subMeshCount);
+	std::memcpy(mesh.subMeshes.data(), data + offset, mesh.subMeshes.size() * sizeof(SubMesh));
+	offset += mesh.subMeshes.size() * sizeof(SubMesh);
+	mesh.materials.resize(header.materialCount);
+	for (Material& material : mesh.materials) {
+		CacheMaterial cacheMaterial = {};
+		if (size - offset < sizeof(cacheMaterial)) {
+			mesh = {};
+			return false;
+		}
+		std::memcpy(&cacheMaterial, data + offset, sizeof(cacheMaterial));
+		offset += sizeof(cacheMaterial);
+		if (size - offset < static_cast<size_t>(cacheMaterial.nameLength) + cacheMaterial.textureLength) {
+			mesh = {};
+			return false;
+		}
+		const char* text = reinterpret_cast<const char*>(data + offset);
+		material.diffuseColor = cacheMaterial.diffuseColor;
+		material.name.assign(text, cacheMaterial.nameLength);
+		material.diffuseTexture.assign(text + cacheMaterial.nameLength, cacheMaterial.textureLength);
+		offset += static_cast<size_t>(cacheMaterial.nameLength) + cacheMaterial.textureLength;
+	}
+	mesh.bounds = header.bounds;
+
+	//壊れたキャッシュで範囲外を読まないように、番号と範囲を確かめる
+	const bool isValidIndex = std::all_of(mesh.indices.begin(), mesh.indices.end(), [&](uint32_t index) { return index < header.vertexCount; });
+	const bool isValidSubMesh = std::all_of(mesh.subMeshes.begin(), mesh.subMeshes.end(), [&](const SubMesh& subMesh) {
+		return static_cast<uint64_t>(subMesh.indexOffset) + subMesh.indexCount <= header.indexCount &&
+			(subMesh.materialIndex == kNoMaterial || subMesh.materialIndex < header.materialCount);
+		});
+	if (!isValidIndex || !isValidSubMesh) {
+		mesh = {};
+		return false;
+	}
+	return true;
+}
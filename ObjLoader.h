@@ -0,0 +1,113 @@
+#pragma once
+#include "MathData.h"
+#include "Shape.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// OBJ/MTLのメッシュの読み込み(当たり判定やカリングに使うCPU側のメッシュ)
+/// </summary>
+/// <remarks>
+/// OBJはメモリに割り当て、行の切れ目で区切った区間ごとにJobSystemで並列に解析する。
+/// 数値はstd::from_charsで読み、同じ(位置,UV,法線)の頂点はハッシュ表で1つにまとめてインデックスを振る。
+/// 多角形は扇形に三角形へ分け、座標系の変換(左手系への反転など)はしない。
+/// Loadは初回に解析結果をOBJの隣(.meshcache)に書き出し、次からはそれを割り当てて配列にコピーするだけで済ませる
+/// </remarks>
+class ObjLoader {
+public://構造体
+	/// <summary>
+	/// 頂点
+	/// </summary>
+	struct Vertex {
+		Vector3 position; //位置
+		Vector3 normal; //法線(OBJになければ0)
+		float u; //テクスチャ座標u(OBJになければ0)
+		float v; //テクスチャ座標v
+	};
+
+	/// <summary>
+	/// マテリアル(MTLのうち使うものだけ)
+	/// </summary>
+	struct Material {
+		std::string name; //名前
+		Vector3 diffuseColor; //拡散色(Kd)
+		std::string diffuseTexture; //拡散色のテクスチャ(map_Kd。MTLからの相対パス)
+	};
+
+	/// <summary>
+	/// 1つのマテリアルで描く範囲(o・g・usemtlで区切る)
+	/// </summary>
+	struct SubMesh {
+		uint32_t indexOffset; //最初のインデックスの位置
+		uint32_t indexCount; //インデックスの数
+		uint32_t materialIndex; //マテリアルの番号(なければkNoMaterial)
+		AABB bounds; //範囲の頂点を囲むAABB
+	};
+
+	/// <summary>
+	/// メッシュ
+	/// </summary>
+	struct Mesh {
+		std::vector<Vertex> vertices; //頂点
+		std::vector<uint32_t> indices; //インデックス(3つで1つの三角形)
+		std::vector<SubMesh> subMeshes; //描く範囲
+		std::vector<Material> materials; //マテリアル
+		AABB bounds; //全体を囲むAABB
+		std::string materialLibrary; //mtllibのMTL(OBJからの相対パス。なければ空)
+	};
+public://メンバ関数
+	/// <summary>
+	/// 読み込み(キャッシュが古くなければキャッシュから、なければOBJを解析してキャッシュを書き出す)
+	/// </summary>
+	/// <param name="filePath">OBJファイル</param>
+	/// <param name="mesh">読み込んだメッシュ</param>
+	/// <returns>読めたか</returns>
+	static bool Load(const char* filePath, Mesh& mesh);
+
+	/// <summary>
+	/// OBJの解析(mtllibのMTLも読む。キャッシュは使わない)
+	/// </summary>
+	/// <param name="filePath">OBJファイル</param>
+	/// <param name="mesh">読み込んだメッシュ</param>
+	/// <returns>読めたか(書式の誤りや範囲外のインデックスがあればfalse)</returns>
+	static bool LoadObj(const char* filePath, Mesh& mesh);
+
+	/// <summary>
+	/// MTLの読み込み(materialsの後ろに追加する)
+	/// </summary>
+	/// <param name="filePath">MTLファイル</param>
+	/// <param name="materials">マテリアル</param>
+	/// <returns>読めたか</returns>
+	static bool LoadMtl(const char* filePath, std::vector<Material>& materials);
+
+	/// <summary>
+	/// キャッシュの書き出し(一時ファイルに書いてから置き換える)
+	/// </summary>
+	/// <param name="cachePath">出力先</param>
+	/// <param name="sourcePath">元のOBJファイル(OBJとMTLのサイズと更新時刻で古くなったかを判定する)</param>
+	/// <param name="mesh">メッシュ</param>
+	/// <returns>書き出せたか</returns>
+	static bool WriteCache(const char* cachePath, const char* sourcePath, const Mesh& mesh);
+
+	/// <summary>
+	/// キャッシュの読み込み
+	/// </summary>
+	/// <param name="cachePath">キャッシュ</param>
+	/// <param name="sourcePath">元のOBJファイル</param>
+	/// <param name="mesh">読み込んだメッシュ</param>
+	/// <returns>読めたか(元のOBJ・MTLと合わないときや、範囲外のインデックスがあるときもfalse)</returns>
+	static bool LoadCache(const char* cachePath, const char* sourcePath, Mesh& mesh);
+public://定数
+	//マテリアルがないことを表す番号
+	static inline const uint32_t kNoMaterial = UINT32_MAX;
+	//キャッシュの拡張子(OBJのパスの後ろに付ける)
+	static inline const char kCacheExtension[] = ".meshcache";
+	//キャッシュの識別子
+	static inline const uint32_t kCacheMagic = 0x434D544D; //"MTMC"
+	//キャッシュの版
+	static inline const uint32_t kCacheVersion = 2;
+	//並列に解析する1区間の最小バイト数
+	static inline const size_t kMinChunkBytes = 64 * 1024;
+};
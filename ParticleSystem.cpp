@@ -0,0 +1,391 @@
+#include "ParticleSystem.h"
+#include "MemoryTracker.h"
+#include "JobSystem.h"
+#include "RenderStats.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace {
+	//描画するクリップ座標のwの最小(カメラのすぐ前と後ろは描かない)
+	const float kMinClipW = 1.0e-3f;
+
+	/// <summary>
+	/// 1軸分の速度と位置
+	/// </summary>
+	/// <remarks>__restrictは引数に付けないと効かないので、成分ごとの配列を引数で受け取る</remarks>
+	void IntegrateAxis(float* __restrict position, float* __restrict velocity, float acceleration, float dampingScale, float deltaTime, size_t begin, size_t end) {
+		const float impulse = acceleration * deltaTime;
+		for (size_t i = begin; i < end; i++) {
+			velocity[i] = (velocity[i] + impulse) * dampingScale;
+			position[i] += velocity[i] * deltaTime;
+		}
+	}
+
+	/// <summary>
+	/// 寿命を減らす
+	/// </summary>
+	void AgeParticles(float* __restrict life, float deltaTime, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			life[i] -= deltaTime;
+		}
+	}
+
+	/// <summary>
+	/// 位置をクリップ座標のx,y,wにし、残りの寿命の割合で大きさとアルファを決める(行ベクトルなので列との内積)
+	/// </summary>
+	void BuildRecords(const float* __restrict x, const float* __restrict y, const float* __restrict z,
+		const float* __restrict life, const float* __restrict inverseLifeTime, const float* __restrict startSize, const float* __restrict endSize,
+		const uint32_t* __restrict color, ParticleSystem::DrawRecord* __restrict records, const Matrix4x4& matrix, size_t begin, size_t end) {
+		const float m00 = matrix.m[0][0], m10 = matrix.m[1][0], m20 = matrix.m[2][0], m30 = matrix.m[3][0];
+		const float m01 = matrix.m[0][1], m11 = matrix.m[1][1], m21 = matrix.m[2][1], m31 = matrix.m[3][1];
+		const float m03 = matrix.m[0][3], m13 = matrix.m[1][3], m23 = matrix.m[2][3], m33 = matrix.m[3][3];
+		for (size_t i = begin; i < end; i++) {
+			const float t = life[i] * inverseLifeTime[i];
+			records[i].clipX = x[i] * m00 + y[i] * m10 + z[i] * m20 + m30;
+			records[i].clipY = x[i] * m01 + y[i] * m11 + z[i] * m21 + m31;
+			records[i].clipW = x[i] * m03 + y[i] * m13 + z[i] * m23 + m33;
+			records[i].size = endSize[i] + (startSize[i] - endSize[i]) * t;
+			records[i].color = (color[i] & 0xFFFFFF00u) | static_cast<uint32_t>(static_cast<float>(color[i] & 0xFFu) * t);
+		}
+	}
+
+	/// <summary>
+	/// 方向(w=0)をクリップ座標のx,y,wにする
+	/// </summary>
+	void ProjectDirection(const Vector3& direction, const Matrix4x4& matrix, float clip[3]) {
+		clip[0] = direction.x * matrix.m[0][0] + direction.y * matrix.m[1][0] + direction.z * matrix.m[2][0];
+		clip[1] = direction.x * matrix.m[0][1] + direction.y * matrix.m[1][1] + direction.z * matrix.m[2][1];
+		clip[2] = direction.x * matrix.m[0][3] + direction.y * matrix.m[1][3] + direction.z * matrix.m[2][3];
+	}
+
+	/// <summary>
+	/// 寿命として使える値(負の値と無限大・NaNは0にする)
+	/// </summary>
+	float SanitizeLifeTime(float lifeTime) {
+		return std::isfinite(lifeTime) && lifeTime > 0.0f ? lifeTime : 0.0f;
+	}
+
+	/// <summary>
+	/// floatのビット列(正の数ならビット列の大小と値の大小が一致する)
+	/// </summary>
+	uint32_t FloatBits(float value) {
+		uint32_t bits = 0;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+}
+
+//初期化
+void ParticleSystem::Initialize(size_t capacity, uint32_t seed) {
+	for (int i = 0; i < 3; i++) {
+		position_[i].assign(capacity, 0.0f);
+		velocity_[i].assign(capacity, 0.0f);
+	}
+	life_.assign(capacity, 0.0f);
+	inverseLifeTime_.assign(capacity, 0.0f);
+	startSize_.assign(capacity, 0.0f);
+	endSize_.assign(capacity, 0.0f);
+	color_.assign(capacity, 0u);
+	drawRecords_.assign(capacity, {});
+	sortedRecords_.assign(capacity, {});
+	sortKey_.assign(capacity, 0u);
+	sortKeyTemp_.assign(capacity, 0u);
+	order_.assign(capacity, 0u);
+	orderTemp_.assign(capacity, 0u);
+	engine_.seed(seed);
+	count_ = 0;
+}
+
+//発生源の追加
+size_t ParticleSystem::AddEmitter(const Emitter& emitter) {
+	emitters_.push_back(emitter);
+	return emitters_.size() - 1;
+}
+
+//発生源からまとめて発生させる
+void ParticleSystem::Emit(size_t emitterIndex, size_t count) {
+	assert(emitterIndex < emitters_.size());
+	const Emitter& emitter = emitters_[emitterIndex];
+	const size_t capacity = GetCapacity();
+	const size_t end = count_ + count < capacity ? count_ + count : capacity;
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	//発生源はGetEmitterで書き換えられるので、最小と最大が逆でも分布の前提(最小<=最大)を崩さない
+	const float minLifeTime = SanitizeLifeTime(emitter.minLifeTime);
+	const float maxLifeTime = SanitizeLifeTime(emitter.maxLifeTime);
+	std::uniform_real_distribution<float> lifeTime(std::min(minLifeTime, maxLifeTime), std::max(minLifeTime, maxLifeTime));
+	for (size_t i = count_; i < end; i++) {
+		position_[0][i] = emitter.position.x + emitter.positionRange.x * unit(engine_);
+		position_[1][i] = emitter.position.y + emitter.positionRange.y * unit(engine_);
+		position_[2][i] = emitter.position.z + emitter.positionRange.z * unit(engine_);
+		velocity_[0][i] = emitter.velocity.x + emitter.velocityRange.x * unit(engine_);
+		velocity_[1][i] = emitter.velocity.y + emitter.velocityRange.y * unit(engine_);
+		velocity_[2][i] = emitter.velocity.z + emitter.velocityRange.z * unit(engine_);
+		float life = lifeTime(engine_);
+		life_[i] = life;
+		inverseLifeTime_[i] = life > 0.0f ? 1.0f / life : 0.0f;
+		startSize_[i] = emitter.startSize;
+		endSize_[i] = emitter.endSize;
+		color_[i] = emitter.color;
+	}
+	count_ = end;
+}
+
+//更新
+void ParticleSystem::Update(float deltaTime, bool isParallel) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kPhysics);
+	//移動と寿命は1つずつ独立しているので分担できる
+	auto updateRange = [this, deltaTime](size_t begin, size_t end) {
+		UpdateRange(begin, end, deltaTime);
+		};
+	if (!isParallel || count_ < kMinBatchSize * 2) {
+		updateRange(0, count_);
+	} else {
+		JobSystem::GetInstance()->ParallelFor(count_, kMinBatchSize, updateRange);
+	}
+	Compact();
+
+	//発生は移動の後にして、発生したフレームは発生位置に置く
+	for (size_t i = 0; i < emitters_.size(); i++) {
+		Emitter& emitter = emitters_[i];
+		if (!emitter.isActive) {
+			continue;
+		}
+		emitter.accumulator += emitter.rate * emissionScale_ * deltaTime;
+		size_t count = static_cast<size_t>(emitter.accumulator);
+		emitter.accumulator -= static_cast<float>(count);
+		Emit(i, count);
+	}
+}
+
+//[begin, end)のパーティクルを移動させ、寿命を減らす
+void ParticleSystem::UpdateRange(size_t begin, size_t end, float deltaTime) {
+	const float acceleration[3] = { gravity_.x,gravity_.y,gravity_.z };
+	const float dampingScale = 1.0f / (1.0f + deltaTime * damping_);
+	for (int axis = 0; axis < 3; axis++) {
+		IntegrateAxis(position_[axis].data(), velocity_[axis].data(), acceleration[axis], dampingScale, deltaTime, begin, end);
+	}
+	AgeParticles(life_.data(), deltaTime, begin, end);
+}
+
+//寿命が尽きたパーティクルを末尾のもので埋めて消す
+void ParticleSystem::Compact() {
+	//詰め直すと消えた位置より後ろを全部動かすことになるので、動かすのは消えた数だけにする
+	size_t count = count_;
+	for (size_t i = 0; i < count; i++) {
+		if (life_[i] > 0.0f) {
+			continue;
+		}
+		//末尾の寿命が尽きたものは先に落とす
+		while (count > i + 1 && life_[count - 1] <= 0.0f) {
+			count--;
+		}
+		count--;
+		if (i == count) {
+			break;
+		}
+		for (int axis = 0; axis < 3; axis++) {
+			position_[axis][i] = position_[axis][count];
+			velocity_[axis][i] = velocity_[axis][count];
+		}
+		life_[i] = life_[count];
+		inverseLifeTime_[i] = inverseLifeTime_[count];
+		startSize_[i] = startSize_[count];
+		endSize_[i] = endSize_[count];
+		color_[i] = color_[count];
+	}
+	count_ = count;
+}
+
+//全パーティクルの描画用の情報を作る
+void ParticleSystem::BuildDrawRecords(const Matrix4x4& viewProjectionMatrix) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	auto buildRange = [this, &viewProjectionMatrix](size_t begin, size_t end) {
+		BuildRecords(position_[0].data(), position_[1].data(), position_[2].data(), life_.data(), inverseLifeTime_.data(),
+			startSize_.data(), endSize_.data(), color_.data(), drawRecords_.data(), viewProjectionMatrix, begin, end);
+		};
+	if (count_ < kMinBatchSize * 2) {
+		buildRange(0, count_);
+	} else {
+		JobSystem::GetInstance()->ParallelFor(count_, kMinBatchSize, buildRange);
+	}
+}
+
+//描画する順番を深度の大きい順に並べる
+uint32_t ParticleSystem::SortByDepth() {
+	//カメラの前にあるものだけを、wのビット列を反転した鍵で昇順に並べる(=奥から)
+	uint32_t visibleCount = 0;
+	for (uint32_t i = 0; i < count_; i++) {
+		if (drawRecords_[i].clipW > kMinClipW) {
+			sortKey_[visibleCount] = ~FloatBits(drawRecords_[i].clipW);
+			order_[visibleCount] = i;
+			visibleCount++;
+		}
+	}
+
+	//全桁のヒストグラムを1回で数える
+	const uint32_t kBucketCount = 1u << kRadixBits;
+	const uint32_t kPassCount = 32 / kRadixBits;
+	uint32_t histogram[kPassCount][kBucketCount] = {};
+	for (uint32_t i = 0; i < visibleCount; i++) {
+		for (uint32_t pass = 0; pass < kPassCount; pass++) {
+			histogram[pass][(sortKey_[i] >> (pass * kRadixBits)) & (kBucketCount - 1)]++;
+		}
+	}
+
+	uint32_t* keys = sortKey_.data();
+	uint32_t* keysTemp = sortKeyTemp_.data();
+	uint32_t* order = order_.data();
+	uint32_t* orderTemp = orderTemp_.data();
+	for (uint32_t pass = 0; pass < kPassCount; pass++) {
+		const uint32_t shift = pass * kRadixBits;
+		//全部同じ桁なら並べ替えなくてよい(上の桁は深度が近いとほぼ同じになる)
+		if (visibleCount == 0 || histogram[pass][(keys[0] >> shift) & (kBucketCount - 1)] == visibleCount) {
+			continue;
+		}
+		uint32_t offset = 0;
+		for (uint32_t bucket = 0; bucket < kBucketCount; bucket++) {
+			uint32_t bucketCount = histogram[pass][bucket];
+			histogram[pass][bucket] = offset;
+			offset += bucketCount;
+		}
+		for (uint32_t i = 0; i < visibleCount; i++) {
+			uint32_t destination = histogram[pass][(keys[i] >> shift) & (kBucketCount - 1)]++;
+			keysTemp[destination] = keys[i];
+			orderTemp[destination] = order[i];
+		}
+		std::swap(keys, keysTemp);
+		std::swap(order, orderTemp);
+	}
+	//奇数回入れ替えたら結果は作業用の配列にある
+	if (order != order_.data()) {
+		std::memcpy(order_.data(), order, sizeof(uint32_t) * visibleCount);
+	}
+	//描画で飛び飛びに読むとキャッシュミスのたびに止まるので、先に並べた順に集めておく
+	for (uint32_t k = 0; k < visibleCount; k++) {
+		sortedRecords_[k] = drawRecords_[order_[k]];
+	}
+	return visibleCount;
+}
+
+//描画
+void ParticleSystem::Draw(const Matrix4x4& cameraWorldMatrix, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, DrawBackend& backend) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kDraw);
+	if (count_ == 0) {
+		return;
+	}
+	BuildDrawRecords(viewProjectionMatrix);
+
+	//カメラの右と上の向きは全パーティクルで同じなので、クリップ座標にするのは1回だけ
+	float rightClip[3] = {};
+	float upClip[3] = {};
+	ProjectDirection({ cameraWorldMatrix.m[0][0],cameraWorldMatrix.m[0][1],cameraWorldMatrix.m[0][2] }, viewProjectionMatrix, rightClip);
+	ProjectDirection({ cameraWorldMatrix.m[1][0],cameraWorldMatrix.m[1][1],cameraWorldMatrix.m[1][2] }, viewProjectionMatrix, upClip);
+
+	//ビューポートは拡大と平行移動だけなので、係数を取り出して使う
+	const float scaleX = viewportMatrix.m[0][0];
+	const float scaleY = viewportMatrix.m[1][1];
+	const float offsetX = viewportMatrix.m[3][0];
+	const float offsetY = viewportMatrix.m[3][1];
+	const float left = offsetX - std::fabs(scaleX);
+	const float right = offsetX + std::fabs(scaleX);
+	const float top = offsetY - std::fabs(scaleY);
+	const float bottom = offsetY + std::fabs(scaleY);
+
+	uint64_t culledCount = 0;
+	uint64_t lineCount = 0;
+	uint64_t triangleCount = 0;
+	auto drawParticle = [&](const DrawRecord& record, uint32_t i) {
+		const float clipX = record.clipX;
+		const float clipY = record.clipY;
+		const float clipW = record.clipW;
+		const uint32_t color = record.color;
+		if (clipW <= kMinClipW) {
+			culledCount++;
+			return;
+		}
+
+		if (drawMode_ == DrawMode::kBillboard) {
+			const float size = record.size;
+			const float rx = rightClip[0] * size, ry = rightClip[1] * size, rw = rightClip[2] * size;
+			const float ux = upClip[0] * size, uy = upClip[1] * size, uw = upClip[2] * size;
+			const float cornerW[4] = { clipW + rw + uw,clipW - rw + uw,clipW - rw - uw,clipW + rw - uw };
+			if (cornerW[0] <= kMinClipW || cornerW[1] <= kMinClipW || cornerW[2] <= kMinClipW || cornerW[3] <= kMinClipW) {
+				culledCount++;
+				return;
+			}
+			const float cornerX[4] = { clipX + rx + ux,clipX - rx + ux,clipX - rx - ux,clipX + rx - ux };
+			const float cornerY[4] = { clipY + ry + uy,clipY - ry + uy,clipY - ry - uy,clipY + ry - uy };
+			float screenX[4] = {};
+			float screenY[4] = {};
+			float minX = right, maxX = left, minY = bottom, maxY = top;
+			for (int k = 0; k < 4; k++) {
+				const float inverseW = 1.0f / cornerW[k];
+				screenX[k] = cornerX[k] * inverseW * scaleX + offsetX;
+				screenY[k] = cornerY[k] * inverseW * scaleY + offsetY;
+				minX = screenX[k] < minX ? screenX[k] : minX;
+				maxX = screenX[k] > maxX ? screenX[k] : maxX;
+				minY = screenY[k] < minY ? screenY[k] : minY;
+				maxY = screenY[k] > maxY ? screenY[k] : maxY;
+			}
+			if (maxX < left || minX > right || maxY < top || minY > bottom) {
+				culledCount++;
+				return;
+			}
+			const int32_t x[4] = { static_cast<int32_t>(screenX[0]),static_cast<int32_t>(screenX[1]),static_cast<int32_t>(screenX[2]),static_cast<int32_t>(screenX[3]) };
+			const int32_t y[4] = { static_cast<int32_t>(screenY[0]),static_cast<int32_t>(screenY[1]),static_cast<int32_t>(screenY[2]),static_cast<int32_t>(screenY[3]) };
+			backend.DrawTriangle(x[0], y[0], x[1], y[1], x[2], y[2], color);
+			backend.DrawTriangle(x[0], y[0], x[2], y[2], x[3], y[3], color);
+			triangleCount += 2;
+			return;
+		}
+
+		const float inverseW = 1.0f / clipW;
+		const float screenX = clipX * inverseW * scaleX + offsetX;
+		const float screenY = clipY * inverseW * scaleY + offsetY;
+		if (drawMode_ == DrawMode::kPoint) {
+			if (screenX < left || screenX > right || screenY < top || screenY > bottom) {
+				culledCount++;
+				return;
+			}
+			backend.DrawLine(static_cast<int32_t>(screenX), static_cast<int32_t>(screenY), static_cast<int32_t>(screenX) + 1, static_cast<int32_t>(screenY), color);
+			lineCount++;
+			return;
+		}
+
+		//線は速度の逆向きに伸ばす
+		float tail[3] = {};
+		ProjectDirection({ velocity_[0][i],velocity_[1][i],velocity_[2][i] }, viewProjectionMatrix, tail);
+		const float tailW = clipW - tail[2] * kLineTime;
+		if (tailW <= kMinClipW) {
+			culledCount++;
+			return;
+		}
+		const float tailX = (clipX - tail[0] * kLineTime) / tailW * scaleX + offsetX;
+		const float tailY = (clipY - tail[1] * kLineTime) / tailW * scaleY + offsetY;
+		if ((screenX < left && tailX < left) || (screenX > right && tailX > right) || (screenY < top && tailY < top) || (screenY > bottom && tailY > bottom)) {
+			culledCount++;
+			return;
+		}
+		backend.DrawLine(static_cast<int32_t>(screenX), static_cast<int32_t>(screenY), static_cast<int32_t>(tailX), static_cast<int32_t>(tailY), color);
+		lineCount++;
+		};
+
+	if (isSortEnabled_) {
+		uint32_t visibleCount = SortByDepth();
+		culledCount += count_ - visibleCount;
+		for (uint32_t k = 0; k < visibleCount; k++) {
+			drawParticle(sortedRecords_[k], order_[k]);
+		}
+	} else {
+		for (uint32_t i = 0; i < count_; i++) {
+			drawParticle(drawRecords_[i], i);
+		}
+	}
+
+	//統計はパーティクルごとではなくまとめて足す
+	RenderStats::Add(RenderStats::Counter::kCulled, culledCount);
+	RenderStats::Add(RenderStats::Counter::kDrawLine, lineCount);
+	RenderStats::Add(RenderStats::Counter::kDrawTriangle, triangleCount);
+}
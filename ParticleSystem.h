@@ -0,0 +1,201 @@
+#pragma once
+#include "MathData.h"
+#include "DrawBackend.h"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/// <summary>
+/// パーティクル(成分ごとの配列に持ち、まとめて更新・描画する)
+/// </summary>
+/// <remarks>
+/// 配列はInitializeで最大数まで確保し、寿命が尽きたパーティクルは末尾のもので埋めて消すので、
+/// 更新中に確保し直すことはない(並び順は保たない)。描画はカメラの右と上の向きを1回だけクリップ座標にして、
+/// 各パーティクルの中心に足すだけで四角形の頂点を作る
+/// </remarks>
+class ParticleSystem {
+public://列挙型
+	/// <summary>
+	/// 描画の仕方
+	/// </summary>
+	enum class DrawMode : uint32_t {
+		kBillboard, //カメラを向いた四角形(三角形2枚)
+		kLine,      //速度の向きに伸ばした線
+		kPoint,     //1ピクセルの点
+	};
+public://構造体
+	/// <summary>
+	/// 発生源
+	/// </summary>
+	struct Emitter {
+		Vector3 position = { 0.0f,0.0f,0.0f }; //発生位置
+		Vector3 positionRange = { 0.0f,0.0f,0.0f }; //発生位置のばらつき(各軸±)
+		Vector3 velocity = { 0.0f,1.0f,0.0f }; //初速度
+		Vector3 velocityRange = { 0.5f,0.5f,0.5f }; //初速度のばらつき(各軸±)
+		float minLifeTime = 1.0f; //寿命の最小(秒。最大と逆なら入れ替え、負なら0として扱う)
+		float maxLifeTime = 2.0f; //寿命の最大(秒)
+		float startSize = 0.1f; //発生時の大きさ(四角形の幅の半分)
+		float endSize = 0.0f; //寿命が尽きるときの大きさ
+		uint32_t color = 0xFFFFFFFF; //色(RGBA、アルファは寿命に合わせて0に近づける)
+		float rate = 100.0f; //1秒あたりの発生数
+		bool isActive = true; //発生させるか
+		float accumulator = 0.0f; //発生しきれなかった端数
+	};
+
+	/// <summary>
+	/// 描画用の情報(奥から順に描くときに飛び飛びに読むので、1か所にまとめる)
+	/// </summary>
+	struct DrawRecord {
+		float clipX; //中心のクリップ座標x
+		float clipY; //中心のクリップ座標y
+		float clipW; //中心のクリップ座標w(深度)
+		float size; //今の大きさ
+		uint32_t color; //今の色
+	};
+public://メンバ関数
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="capacity">同時に存在できる最大数</param>
+	/// <param name="seed">乱数の種</param>
+	void Initialize(size_t capacity, uint32_t seed = 0);
+
+	/// <summary>
+	/// 発生源の追加
+	/// </summary>
+	/// <returns>発生源の番号</returns>
+	size_t AddEmitter(const Emitter& emitter);
+
+	/// <summary>
+	/// 発生源のゲッター(位置や発生数を書き換えるのに使う)
+	/// </summary>
+	Emitter& GetEmitter(size_t index) { return emitters_[index]; }
+
+	/// <summary>
+	/// 発生源からまとめて発生させる(最大数を超えた分は発生しない)
+	/// </summary>
+	/// <param name="emitterIndex">発生源の番号</param>
+	/// <param name="count">数</param>
+	void Emit(size_t emitterIndex, size_t count);
+
+	/// <summary>
+	/// 更新(発生、移動、寿命の尽きたものの削除)
+	/// </summary>
+	/// <param name="deltaTime">経過時間(秒)</param>
+	/// <param name="isParallel">移動をJobSystemで分担するか</param>
+	void Update(float deltaTime, bool isParallel = true);
+
+	/// <summary>
+	/// 描画
+	/// </summary>
+	/// <param name="cameraWorldMatrix">カメラのワールド行列(ビルボードの向きに使う)</param>
+	/// <param name="viewProjectionMatrix">ビュー射影行列</param>
+	/// <param name="viewportMatrix">ビューポート行列</param>
+	/// <param name="backend">描画先</param>
+	void Draw(const Matrix4x4& cameraWorldMatrix, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, DrawBackend& backend);
+
+	/// <summary>
+	/// 全削除(発生源は残す)
+	/// </summary>
+	void Clear() { count_ = 0; }
+
+	/// <summary>
+	/// 描画の仕方のセッター
+	/// </summary>
+	void SetDrawMode(DrawMode drawMode) { drawMode_ = drawMode; }
+
+	/// <summary>
+	/// 奥から順に描画するかのセッター(半透明を重ねるときに使う)
+	/// </summary>
+	void SetSortEnabled(bool isSortEnabled) { isSortEnabled_ = isSortEnabled; }
+
+	/// <summary>
+	/// 重力のセッター
+	/// </summary>
+	void SetGravity(const Vector3& gravity) { gravity_ = gravity; }
+
+	/// <summary>
+	/// 速度の減衰(1秒あたり)のセッター
+	/// </summary>
+	void SetDamping(float damping) { damping_ = damping; }
+
+	/// <summary>
+	/// 発生数の倍率のセッター(発生源のrateに掛ける。QualityGovernorで負荷に合わせて減らすのに使う)
+	/// </summary>
+	void SetEmissionScale(float emissionScale) { emissionScale_ = emissionScale; }
+
+	/// <summary>
+	/// 発生数の倍率のゲッター
+	/// </summary>
+	float GetEmissionScale() const { return emissionScale_; }
+
+	/// <summary>
+	/// 生きている数のゲッター
+	/// </summary>
+	size_t GetCount() const { return count_; }
+
+	/// <summary>
+	/// 最大数のゲッター
+	/// </summary>
+	size_t GetCapacity() const { return life_.size(); }
+
+	/// <summary>
+	/// 位置のゲッター
+	/// </summary>
+	Vector3 GetPosition(size_t index) const { return { position_[0][index],position_[1][index],position_[2][index] }; }
+public://定数
+	//1区間の最小のパーティクル数
+	static inline const size_t kMinBatchSize = 16384;
+	//線で描くときに伸ばす時間(秒)
+	static inline const float kLineTime = 0.05f;
+	//ソートの桁あたりのビット数
+	static inline const uint32_t kRadixBits = 8;
+private://メンバ関数
+	/// <summary>
+	/// [begin, end)のパーティクルを移動させ、寿命を減らす
+	/// </summary>
+	void UpdateRange(size_t begin, size_t end, float deltaTime);
+
+	/// <summary>
+	/// 寿命が尽きたパーティクルを末尾のもので埋めて消す
+	/// </summary>
+	void Compact();
+
+	/// <summary>
+	/// 全パーティクルの描画用の情報を作る
+	/// </summary>
+	void BuildDrawRecords(const Matrix4x4& viewProjectionMatrix);
+
+	/// <summary>
+	/// カメラの前にあるものを深度の大きい順に並べる(基数ソート)
+	/// </summary>
+	/// <returns>並べた数(order_とsortedRecords_の先頭から)</returns>
+	uint32_t SortByDepth();
+private://メンバ変数
+	Vector3 gravity_ = { 0.0f,-9.8f,0.0f }; //重力加速度
+	float damping_ = 0.0f; //速度の減衰
+	float emissionScale_ = 1.0f; //発生数の倍率
+	DrawMode drawMode_ = DrawMode::kBillboard; //描画の仕方
+	bool isSortEnabled_ = false; //奥から順に描画するか
+	std::vector<Emitter> emitters_; //発生源
+	std::mt19937 engine_; //発生に使う乱数
+	size_t count_ = 0; //生きている数
+
+	//成分ごとの配列(番号は生きているものを前に詰めた順)
+	std::vector<float> position_[3]; //位置(x,y,z)
+	std::vector<float> velocity_[3]; //速度(x,y,z)
+	std::vector<float> life_; //残りの寿命(秒)
+	std::vector<float> inverseLifeTime_; //寿命の逆数
+	std::vector<float> startSize_; //発生時の大きさ
+	std::vector<float> endSize_; //寿命が尽きるときの大きさ
+	std::vector<uint32_t> color_; //色
+
+	//描画用の作業配列(最大数で確保して使い回す)
+	std::vector<DrawRecord> drawRecords_; //描画用の情報
+	std::vector<DrawRecord> sortedRecords_; //奥から並べた描画用の情報
+	std::vector<uint32_t> sortKey_; //深度のビット列
+	std::vector<uint32_t> sortKeyTemp_; //基数ソートの作業用
+	std::vector<uint32_t> order_; //描画する順番
+	std::vector<uint32_t> orderTemp_; //基数ソートの作業用
+};
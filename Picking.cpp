@@ -0,0 +1,288 @@
+#include "Picking.h"
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+	//平行とみなす値
+	const float kParallelEpsilon = 1.0e-12f;
+
+	/// <summary>
+	/// 正規化した方向の半直線
+	/// </summary>
+	struct UnitRay {
+		Vector3 origin;
+		Vector3 direction;
+
+		explicit UnitRay(const Ray& ray) : origin(ray.origin), direction(ray.diff) {
+			float lengthSquared = ray.diff.Dot(ray.diff);
+			if (lengthSquared > kParallelEpsilon) {
+				direction = ray.diff * (1.0f / std::sqrt(lengthSquared));
+			}
+		}
+	};
+
+	/// <summary>
+	/// 球(距離の上限まで)
+	/// </summary>
+	bool RayCastSphere(const UnitRay& ray, const Vector3& center, float radius, float maxDistance, Picking::RayHit& hit) {
+		Vector3 m = ray.origin - center;
+		float b = m.Dot(ray.direction);
+		float c = m.Dot(m) - radius * radius;
+		//始点が中にある
+		if (c <= 0.0f) {
+			hit = { .distance = 0.0f,.point = ray.origin,.normal = -ray.direction };
+			return true;
+		}
+		//外にあって離れていく
+		if (b > 0.0f) {
+			return false;
+		}
+		float discriminant = b * b - c;
+		if (discriminant < 0.0f) {
+			return false;
+		}
+		float distance = -b - std::sqrt(discriminant);
+		if (distance > maxDistance) {
+			return false;
+		}
+		Vector3 point = ray.origin + ray.direction * distance;
+		hit = { .distance = distance,.point = point,.normal = (point - center) * (1.0f / radius) };
+		return true;
+	}
+
+	/// <summary>
+	/// 原点中心の箱(ローカル座標、距離の上限まで)
+	/// </summary>
+	/// <param name="localNormal">当たった面の法線(ローカル座標)</param>
+	bool RayCastLocalBox(const Vector3& origin, const Vector3& direction, const Vector3& halfSize, float maxDistance,
+		float& distance, Vector3& localNormal) {
+		const float origins[3] = { origin.x,origin.y,origin.z };
+		const float directions[3] = { direction.x,direction.y,direction.z };
+		const float sizes[3] = { halfSize.x,halfSize.y,halfSize.z };
+		float tNear = 0.0f;
+		float tFar = maxDistance;
+		int nearAxis = -1;
+		float nearSign = 0.0f;
+		for (int i = 0; i < 3; i++) {
+			if (std::fabs(directions[i]) < kParallelEpsilon) {
+				if (origins[i] < -sizes[i] || sizes[i] < origins[i]) {
+					return false;
+				}
+				continue;
+			}
+			float inverse = 1.0f / directions[i];
+			float t1 = (-sizes[i] - origins[i]) * inverse;
+			float t2 = (sizes[i] - origins[i]) * inverse;
+			//入る面は方向と逆向き
+			float sign = -1.0f;
+			if (t1 > t2) {
+				std::swap(t1, t2);
+				sign = 1.0f;
+			}
+			if (t1 > tNear) {
+				tNear = t1;
+				nearAxis = i;
+				nearSign = sign;
+			}
+			tFar = t2 < tFar ? t2 : tFar;
+			if (tNear > tFar) {
+				return false;
+			}
+		}
+		distance = tNear;
+		if (nearAxis < 0) {
+			//始点が中にある
+			localNormal = -direction;
+		} else {
+			float normals[3] = {};
+			normals[nearAxis] = nearSign;
+			localNormal = { normals[0],normals[1],normals[2] };
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// AABB(距離の上限まで)
+	/// </summary>
+	bool RayCastAABB(const UnitRay& ray, const AABB& aabb, float maxDistance, Picking::RayHit& hit) {
+		Vector3 center = (aabb.min + aabb.max) * 0.5f;
+		Vector3 halfSize = (aabb.max - aabb.min) * 0.5f;
+		float distance = 0.0f;
+		Vector3 normal = {};
+		if (!RayCastLocalBox(ray.origin - center, ray.direction, halfSize, maxDistance, distance, normal)) {
+			return false;
+		}
+		hit = { .distance = distance,.point = ray.origin + ray.direction * distance,.normal = normal };
+		return true;
+	}
+
+	/// <summary>
+	/// OBB(距離の上限まで)
+	/// </summary>
+	bool RayCastOBB(const UnitRay& ray, const Vector3& center, const Vector3 orientations[3], const Vector3& size,
+		float maxDistance, Picking::RayHit& hit) {
+		Vector3 d = ray.origin - center;
+		Vector3 localOrigin = { d.Dot(orientations[0]), d.Dot(orientations[1]), d.Dot(orientations[2]) };
+		Vector3 localDirection = { ray.direction.Dot(orientations[0]), ray.direction.Dot(orientations[1]), ray.direction.Dot(orientations[2]) };
+		float distance = 0.0f;
+		Vector3 localNormal = {};
+		if (!RayCastLocalBox(localOrigin, localDirection, size, maxDistance, distance, localNormal)) {
+			return false;
+		}
+		Vector3 normal = orientations[0] * localNormal.x + orientations[1] * localNormal.y + orientations[2] * localNormal.z;
+		hit = { .distance = distance,.point = ray.origin + ray.direction * distance,.normal = normal };
+		return true;
+	}
+
+	/// <summary>
+	/// 木の半直線探索で、葉ごとの判定を近い順に上限を縮めながら行う
+	/// </summary>
+	/// <param name="rayCast">bool(uint32_t index, float maxDistance, RayHit& hit)</param>
+	template<class RayCastFunction>
+	uint32_t PickInTree(const UnitRay& ray, float maxDistance, const DynamicAABBTree& tree, Picking::RayHit& hit, RayCastFunction rayCast) {
+		if (maxDistance <= 0.0f) {
+			return Picking::kNoHit;
+		}
+		uint32_t hitIndex = Picking::kNoHit;
+		Segment segment = { .origin = ray.origin,.diff = ray.direction * maxDistance };
+		tree.RayCast(segment, 1.0f, [&](int32_t proxyId, float maxFraction) {
+			uint32_t index = tree.GetUserData(proxyId);
+			Picking::RayHit candidate = {};
+			if (!rayCast(index, maxFraction * maxDistance, candidate)) {
+				return maxFraction;
+			}
+			hitIndex = index;
+			hit = candidate;
+			return candidate.distance / maxDistance;
+			});
+		return hitIndex;
+	}
+}
+
+//半直線と球
+bool Picking::RayCast(const Ray& ray, const SphereData& sphere, RayHit& hit) {
+	return RayCastSphere(UnitRay(ray), sphere.center, sphere.radius, std::numeric_limits<float>::infinity(), hit);
+}
+
+//半直線と平面
+bool Picking::RayCast(const Ray& ray, const Plane& plane, RayHit& hit) {
+	UnitRay unitRay(ray);
+	float dot = plane.normal.Dot(unitRay.direction);
+	if (std::fabs(dot) < kParallelEpsilon) {
+		return false;
+	}
+	float distance = (plane.distance - plane.normal.Dot(unitRay.origin)) / dot;
+	if (distance < 0.0f) {
+		return false;
+	}
+	hit = { .distance = distance,.point = unitRay.origin + unitRay.direction * distance,.normal = dot < 0.0f ? plane.normal : -plane.normal };
+	return true;
+}
+
+//半直線とAABB
+bool Picking::RayCast(const Ray& ray, const AABB& aabb, RayHit& hit) {
+	return RayCastAABB(UnitRay(ray), aabb, std::numeric_limits<float>::infinity(), hit);
+}
+
+//半直線とOBB
+bool Picking::RayCast(const Ray& ray, const OBB& obb, RayHit& hit) {
+	return RayCastOBB(UnitRay(ray), obb.center, obb.orientations, obb.size, std::numeric_limits<float>::infinity(), hit);
+}
+
+//半直線と球の集合
+uint32_t Picking::RayCastBatch(const Ray& ray, const SphereSet& spheres, RayHit& hit) {
+	const UnitRay unitRay(ray);
+	const size_t count = spheres.Size();
+	const float* cx = spheres.center[0].data();
+	const float* cy = spheres.center[1].data();
+	const float* cz = spheres.center[2].data();
+	const float* radius = spheres.radius.data();
+	const float ox = unitRay.origin.x, oy = unitRay.origin.y, oz = unitRay.origin.z;
+	const float vx = unitRay.direction.x, vy = unitRay.direction.y, vz = unitRay.direction.z;
+	const float kInfinity = std::numeric_limits<float>::infinity();
+
+	//ブロックごとに距離を分岐なしで並べ(ベクトル化される)、最小のブロックだけ番号を探す
+	//負でない浮動小数点数はビット列を整数として比べても大小が同じなので、最小値は整数で求める(浮動小数点の最小値の集計はベクトル化されない)
+	uint32_t distanceBits[kBatchBlockSize];
+	uint32_t bestBits = std::bit_cast<uint32_t>(kInfinity);
+	size_t bestIndex = 0;
+	for (size_t begin = 0; begin < count; begin += kBatchBlockSize) {
+		const size_t blockCount = count - begin < kBatchBlockSize ? count - begin : kBatchBlockSize;
+		const float* blockX = cx + begin;
+		const float* blockY = cy + begin;
+		const float* blockZ = cz + begin;
+		const float* blockRadius = radius + begin;
+		for (size_t i = 0; i < blockCount; i++) {
+			float mx = ox - blockX[i], my = oy - blockY[i], mz = oz - blockZ[i];
+			float b = mx * vx + my * vy + mz * vz;
+			float c = mx * mx + my * my + mz * mz - blockRadius[i] * blockRadius[i];
+			float discriminant = b * b - c;
+			float distance = -b - std::sqrt(discriminant > 0.0f ? discriminant : 0.0f);
+			//始点が中なら0、後ろにあるか外れていれば無限遠
+			distance = c <= 0.0f ? 0.0f : distance;
+			distance = discriminant >= 0.0f && distance >= 0.0f ? distance : kInfinity;
+			distanceBits[i] = std::bit_cast<uint32_t>(distance);
+		}
+		uint32_t blockBest = bestBits;
+		for (size_t i = 0; i < blockCount; i++) {
+			blockBest = distanceBits[i] < blockBest ? distanceBits[i] : blockBest;
+		}
+		if (blockBest < bestBits) {
+			bestBits = blockBest;
+			for (size_t i = 0; i < blockCount; i++) {
+				if (distanceBits[i] == blockBest) {
+					bestIndex = begin + i;
+					break;
+				}
+			}
+		}
+	}
+	const float bestDistance = std::bit_cast<float>(bestBits);
+	if (bestDistance == kInfinity) {
+		return kNoHit;
+	}
+
+	//法線と点は一番近い要素だけで求める
+	Vector3 center = { cx[bestIndex], cy[bestIndex], cz[bestIndex] };
+	Vector3 point = unitRay.origin + unitRay.direction * bestDistance;
+	Vector3 normal = bestDistance > 0.0f ? (point - center) * (1.0f / radius[bestIndex]) : -unitRay.direction;
+	hit = { .distance = bestDistance,.point = point,.normal = normal };
+	return static_cast<uint32_t>(bestIndex);
+}
+
+//木で絞り込んで球の集合
+uint32_t Picking::Pick(const Ray& ray, float maxDistance, const DynamicAABBTree& tree, const SphereSet& spheres, RayHit& hit) {
+	const UnitRay unitRay(ray);
+	return PickInTree(unitRay, maxDistance, tree, hit, [&](uint32_t index, float distanceLimit, RayHit& candidate) {
+		Vector3 center = { spheres.center[0][index], spheres.center[1][index], spheres.center[2][index] };
+		return RayCastSphere(unitRay, center, spheres.radius[index], distanceLimit, candidate);
+		});
+}
+
+//木で絞り込んでAABBの集合
+uint32_t Picking::Pick(const Ray& ray, float maxDistance, const DynamicAABBTree& tree, const AABBSet& aabbs, RayHit& hit) {
+	const UnitRay unitRay(ray);
+	return PickInTree(unitRay, maxDistance, tree, hit, [&](uint32_t index, float distanceLimit, RayHit& candidate) {
+		AABB aabb = {
+			.min{ aabbs.min[0][index], aabbs.min[1][index], aabbs.min[2][index] },
+			.max{ aabbs.max[0][index], aabbs.max[1][index], aabbs.max[2][index] },
+		};
+		return RayCastAABB(unitRay, aabb, distanceLimit, candidate);
+		});
+}
+
+//木で絞り込んでOBBの集合
+uint32_t Picking::Pick(const Ray& ray, float maxDistance, const DynamicAABBTree& tree, const OBBSet& obbs, RayHit& hit) {
+	const UnitRay unitRay(ray);
+	return PickInTree(unitRay, maxDistance, tree, hit, [&](uint32_t index, float distanceLimit, RayHit& candidate) {
+		Vector3 center = { obbs.center[0][index], obbs.center[1][index], obbs.center[2][index] };
+		Vector3 orientations[3];
+		for (int axis = 0; axis < 3; axis++) {
+			orientations[axis] = { obbs.orientations[axis][0][index], obbs.orientations[axis][1][index], obbs.orientations[axis][2][index] };
+		}
+		Vector3 size = { obbs.size[0][index], obbs.size[1][index], obbs.size[2][index] };
+		return RayCastOBB(unitRay, center, orientations, size, distanceLimit, candidate);
+		});
+}
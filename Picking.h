@@ -0,0 +1,81 @@
+#pragma once
+#include "Shape.h"
+#include "DynamicAABBTree.h"
+#include <cstdint>
+
+/// <summary>
+/// 半直線での最近接の当たり(マウスでのピッキング)
+/// </summary>
+/// <remarks>
+/// 距離は半直線の方向を正規化した長さで測る。始点が形状の中にあるときは距離0、法線は方向の逆向きになる
+/// </remarks>
+class Picking {
+public://構造体
+	/// <summary>
+	/// 当たりの結果
+	/// </summary>
+	struct RayHit {
+		float distance; //始点からの距離
+		Vector3 point;  //当たった点
+		Vector3 normal; //当たった面の外向きの法線
+	};
+public://メンバ関数
+	/// <summary>
+	/// 半直線と球
+	/// </summary>
+	/// <param name="ray">半直線</param>
+	/// <param name="sphere">球</param>
+	/// <param name="hit">結果(当たったときだけ書き込む)</param>
+	/// <returns>当たったか</returns>
+	static bool RayCast(const Ray& ray, const SphereData& sphere, RayHit& hit);
+
+	/// <summary>
+	/// 半直線と平面(法線は半直線に向いている側)
+	/// </summary>
+	static bool RayCast(const Ray& ray, const Plane& plane, RayHit& hit);
+
+	/// <summary>
+	/// 半直線とAABB
+	/// </summary>
+	static bool RayCast(const Ray& ray, const AABB& aabb, RayHit& hit);
+
+	/// <summary>
+	/// 半直線とOBB
+	/// </summary>
+	static bool RayCast(const Ray& ray, const OBB& obb, RayHit& hit);
+
+	/// <summary>
+	/// 半直線と球の集合の全要素(成分ごとの配列をまとめて計算する)
+	/// </summary>
+	/// <param name="ray">半直線</param>
+	/// <param name="spheres">球の集合</param>
+	/// <param name="hit">一番近い当たりの結果</param>
+	/// <returns>一番近い要素の番号(当たらなければkNoHit)</returns>
+	static uint32_t RayCastBatch(const Ray& ray, const SphereSet& spheres, RayHit& hit);
+
+	/// <summary>
+	/// 木で絞り込んで、半直線と球の集合の一番近い当たりを探す
+	/// </summary>
+	/// <param name="ray">半直線</param>
+	/// <param name="maxDistance">探す距離の上限(カメラの遠平面など)</param>
+	/// <param name="tree">集合の各要素を囲む木(ユーザーデータは集合での番号)</param>
+	/// <param name="spheres">球の集合</param>
+	/// <param name="hit">一番近い当たりの結果</param>
+	/// <returns>一番近い要素の番号(当たらなければkNoHit)</returns>
+	static uint32_t Pick(const Ray& ray, float maxDistance, const DynamicAABBTree& tree, const SphereSet& spheres, RayHit& hit);
+
+	/// <summary>
+	/// 木で絞り込んで、半直線とAABBの集合の一番近い当たりを探す
+	/// </summary>
+	static uint32_t Pick(const Ray& ray, float maxDistance, const DynamicAABBTree& tree, const AABBSet& aabbs, RayHit& hit);
+
+	/// <summary>
+	/// 木で絞り込んで、半直線とOBBの集合の一番近い当たりを探す
+	/// </summary>
+	static uint32_t Pick(const Ray& ray, float maxDistance, const DynamicAABBTree& tree, const OBBSet& obbs, RayHit& hit);
+public://定数
+	//当たらなかったことを表す番号
+	static inline const uint32_t kNoHit = 0xFFFFFFFFu;
+	//一括計算で一度に距離を並べる要素数
+	static inline const size_t kBatchBlockSize = 256;
+};
@@ -0,0 +1,81 @@
+#include "PoolAllocator.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+//コンストラクタ
+PoolAllocator::PoolAllocator(size_t blockSize, size_t blockAlignment, size_t blocksPerChunk)
+	: blockAlignment_(std::max(blockAlignment, alignof(FreeBlock))), blocksPerChunk_(std::max<size_t>(blocksPerChunk, 1)) {
+	assert(std::has_single_bit(blockAlignment) && "blockAlignment must be a power of two");
+	//空きリストを書けるように大きさを揃える
+	blockSize_ = (std::max(blockSize, sizeof(FreeBlock)) + blockAlignment_ - 1) & ~(blockAlignment_ - 1);
+}
+
+//デストラクタ
+PoolAllocator::~PoolAllocator() {
+	assert(usedCount_ == 0 && "PoolAllocator destroyed while blocks are still in use");
+	for (uint8_t* chunk : chunks_) {
+		::operator delete(chunk, std::align_val_t(blockAlignment_));
+	}
+}
+
+//ブロックを1つ確保する
+void* PoolAllocator::Allocate() {
+	if (freeList_ == nullptr) {
+		AddChunk();
+	}
+	FreeBlock* block = freeList_;
+	assert(block->mark == kFreeMark && "PoolAllocator free block was written after Free()");
+	freeList_ = block->next;
+	block->mark = 0;
+	usedCount_++;
+	return block;
+}
+
+//ブロックを解放する
+void PoolAllocator::Free(void* pointer) {
+	if (pointer == nullptr) {
+		return;
+	}
+	assert(IsOwned(pointer) && "PoolAllocator::Free() called with a block from another allocator");
+	FreeBlock* block = static_cast<FreeBlock*>(pointer);
+	assert(block->mark != kFreeMark && "PoolAllocator block freed twice");
+#ifndef NDEBUG
+	std::memset(static_cast<uint8_t*>(pointer) + sizeof(FreeBlock), kFreedByte, blockSize_ - sizeof(FreeBlock));
+#endif
+	block->next = freeList_;
+	block->mark = kFreeMark;
+	freeList_ = block;
+	usedCount_--;
+}
+
+//確保する前に塊を用意しておく
+void PoolAllocator::Reserve(size_t blockCount) {
+	while (GetCapacity() < blockCount) {
+		AddChunk();
+	}
+}
+
+//塊を1つ足す
+void PoolAllocator::AddChunk() {
+	uint8_t* chunk = static_cast<uint8_t*>(::operator new(blockSize_ * blocksPerChunk_, std::align_val_t(blockAlignment_)));
+	chunks_.push_back(chunk);
+	//先頭のブロックから使うように後ろからつなぐ
+	for (size_t i = blocksPerChunk_; i-- > 0;) {
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize_);
+		block->next = freeList_;
+		block->mark = kFreeMark;
+		freeList_ = block;
+	}
+}
+
+//このプールのブロックか
+bool PoolAllocator::IsOwned(const void* pointer) const {
+	const uint8_t* address = static_cast<const uint8_t*>(pointer);
+	for (const uint8_t* chunk : chunks_) {
+		if (address >= chunk && address < chunk + blockSize_ * blocksPerChunk_) {
+			return (static_cast<size_t>(address - chunk) % blockSize_) == 0;
+		}
+	}
+	return false;
+}
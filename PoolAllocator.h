@@ -0,0 +1,147 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// 同じ大きさのブロックを使い回す確保
+/// </summary>
+/// <remarks>
+/// ブロックはまとめて確保した塊から切り出し、解放したブロックは空きリストにつないで次の確保で使い回す。
+/// 塊は解放しないので、数が落ち着けばヒープからは確保しなくなる。
+/// デバッグビルドでは解放したブロックに印を付け、二重解放と別のプールのブロックの解放をassertで止める
+/// </remarks>
+class PoolAllocator {
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="blockSize">ブロックのバイト数</param>
+	/// <param name="blockAlignment">ブロックを揃えるバイト数(2のべき乗)</param>
+	/// <param name="blocksPerChunk">1つの塊のブロック数</param>
+	PoolAllocator(size_t blockSize, size_t blockAlignment, size_t blocksPerChunk = kDefaultBlocksPerChunk);
+
+	/// <summary>
+	/// デストラクタ(塊をすべて解放する)
+	/// </summary>
+	~PoolAllocator();
+
+	//コピーの禁止
+	PoolAllocator(const PoolAllocator&) = delete;
+	PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+	/// <summary>
+	/// ブロックを1つ確保する
+	/// </summary>
+	void* Allocate();
+
+	/// <summary>
+	/// ブロックを解放する
+	/// </summary>
+	/// <param name="pointer">Allocateで確保したブロック(nullptrなら何もしない)</param>
+	void Free(void* pointer);
+
+	/// <summary>
+	/// 確保する前に塊を用意しておく
+	/// </summary>
+	/// <param name="blockCount">用意するブロック数</param>
+	void Reserve(size_t blockCount);
+
+	/// <summary>
+	/// 使っているブロック数のゲッター
+	/// </summary>
+	size_t GetUsedCount() const { return usedCount_; }
+
+	/// <summary>
+	/// 用意したブロック数のゲッター
+	/// </summary>
+	size_t GetCapacity() const { return chunks_.size() * blocksPerChunk_; }
+
+	/// <summary>
+	/// ブロックのバイト数のゲッター
+	/// </summary>
+	size_t GetBlockSize() const { return blockSize_; }
+public://定数
+	//1つの塊のブロック数の既定値
+	static inline const size_t kDefaultBlocksPerChunk = 64;
+private://構造体
+	/// <summary>
+	/// 空いているブロック(ブロックの先頭に書く)
+	/// </summary>
+	struct FreeBlock {
+		FreeBlock* next; //次の空いているブロック
+		uint64_t mark; //解放した印(デバッグビルドで二重解放を調べる)
+	};
+private://定数
+	//解放した印
+	static inline const uint64_t kFreeMark = 0xDEADF4EEB10C4A11ull;
+	//解放したブロックの残りを埋める値
+	static inline const uint8_t kFreedByte = 0xDD;
+private://メンバ関数
+	/// <summary>
+	/// 塊を1つ足す
+	/// </summary>
+	void AddChunk();
+
+	/// <summary>
+	/// このプールのブロックか(デバッグビルドだけ)
+	/// </summary>
+	bool IsOwned(const void* pointer) const;
+private://メンバ変数
+	size_t blockSize_; //ブロックのバイト数(FreeBlock以上、揃える倍数に切り上げる)
+	size_t blockAlignment_; //ブロックを揃えるバイト数
+	size_t blocksPerChunk_; //1つの塊のブロック数
+	size_t usedCount_ = 0; //使っているブロック数
+	FreeBlock* freeList_ = nullptr; //空いているブロック
+	std::vector<uint8_t*> chunks_; //確保した塊
+};
+
+/// <summary>
+/// Tを使い回すプール(シーンのオブジェクトなど、数が増減するもの用)
+/// </summary>
+template<class T>
+class ObjectPool {
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="objectsPerChunk">1つの塊のオブジェクト数</param>
+	explicit ObjectPool(size_t objectsPerChunk = PoolAllocator::kDefaultBlocksPerChunk)
+		: pool_(sizeof(T), alignof(T), objectsPerChunk) {}
+
+	/// <summary>
+	/// 作る
+	/// </summary>
+	/// <param name="...args">コンストラクタの引数</param>
+	template<class... Args>
+	T* Create(Args&&... args) {
+		return new(pool_.Allocate()) T(std::forward<Args>(args)...);
+	}
+
+	/// <summary>
+	/// 壊す
+	/// </summary>
+	/// <param name="object">Createで作ったもの(nullptrなら何もしない)</param>
+	void Destroy(T* object) {
+		if (object == nullptr) {
+			return;
+		}
+		object->~T();
+		pool_.Free(object);
+	}
+
+	/// <summary>
+	/// 作る前に塊を用意しておく
+	/// </summary>
+	void Reserve(size_t count) { pool_.Reserve(count); }
+
+	/// <summary>
+	/// 作ってあるオブジェクト数のゲッター
+	/// </summary>
+	size_t GetUsedCount() const { return pool_.GetUsedCount(); }
+private://メンバ変数
+	PoolAllocator pool_; //ブロックの確保
+};
@@ -0,0 +1,187 @@
+#include "Primitive.h"
+#include "Rendering.h"
+#include "RenderStats.h"
+#include <cmath>
+#include <numbers>
+
+namespace {
+	/// <summary>
+	/// 画面外判定用の領域コード
+	/// </summary>
+	/// <param name="x">スクリーン座標x</param>
+	/// <param name="y">スクリーン座標y</param>
+	/// <param name="viewportMatrix">ビューポート行列</param>
+	/// <returns>領域コード(画面内なら0)</returns>
+	uint32_t ComputeOutCode(float x, float y, const Matrix4x4& viewportMatrix) {
+		//ビューポート行列から画面の範囲を求める
+		float left = viewportMatrix.m[3][0] - viewportMatrix.m[0][0];
+		float right = viewportMatrix.m[3][0] + viewportMatrix.m[0][0];
+		float top = viewportMatrix.m[3][1] + viewportMatrix.m[1][1];
+		float bottom = viewportMatrix.m[3][1] - viewportMatrix.m[1][1];
+
+		uint32_t code = 0;
+		if (x < left) {
+			code |= 1;
+		} else if (x > right) {
+			code |= 2;
+		}
+		if (y < top) {
+			code |= 4;
+		} else if (y > bottom) {
+			code |= 8;
+		}
+		return code;
+	}
+}
+
+//線の描画
+void Primitive::DrawLine(const Vector3& screenStartPos, const Vector3& screenEndPos, uint32_t color, const Matrix4x4& viewportMatrix, DrawBackend& backend) {
+	uint32_t startCode = ComputeOutCode(screenStartPos.x, screenStartPos.y, viewportMatrix);
+	uint32_t endCode = ComputeOutCode(screenEndPos.x, screenEndPos.y, viewportMatrix);
+
+	//両端が同じ側の画面外にあれば描画しない
+	if ((startCode & endCode) != 0) {
+		RenderStats::Add(RenderStats::Counter::kCulled);
+		return;
+	}
+	//片側だけ画面外なら画面端で切られる
+	if ((startCode | endCode) != 0) {
+		RenderStats::Add(RenderStats::Counter::kClipped);
+	}
+
+	RenderStats::AddLine(screenStartPos.x, screenStartPos.y, screenEndPos.x, screenEndPos.y);
+	backend.DrawLine(
+		static_cast<int32_t>(screenStartPos.x),
+		static_cast<int32_t>(screenStartPos.y),
+		static_cast<int32_t>(screenEndPos.x),
+		static_cast<int32_t>(screenEndPos.y),
+		color
+	);
+}
+
+//折れ線の描画
+void Primitive::DrawPolyline(std::span<const Vector3> points, uint32_t color, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, DrawBackend& backend) {
+	if (points.size() < 2) {
+		return;
+	}
+	//隣り合う線で共有する点は前の線の終点を使い回す
+	const Matrix4x4 viewProjectionViewportMatrix = viewProjectionMatrix * viewportMatrix;
+	Vector3 screenStart = Rendering::Transform(points[0], viewProjectionViewportMatrix);
+	for (size_t i = 1; i < points.size(); i++) {
+		const Vector3 screenEnd = Rendering::Transform(points[i], viewProjectionViewportMatrix);
+		DrawLine(screenStart, screenEnd, color, viewportMatrix, backend);
+		screenStart = screenEnd;
+	}
+}
+
+//グリッドの描画
+void Primitive::DrawGrid(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, DrawBackend& backend, uint32_t subdivision) {
+	const float kGridHalfWidth = 2.0f;//グリッドの半分の幅
+	const uint32_t kSubdivision = subdivision > 0 ? subdivision : 1;//分割数
+	const float kGridEvery = (kGridHalfWidth * 2.0f) / static_cast<float>(kSubdivision);//1つ分の長さ
+
+	//奥から手前ヘの線を順々に引いていく
+	for (uint32_t xIndex = 0; xIndex <= kSubdivision; xIndex++) {
+		//ローカル座標を求める
+		float z = -kGridHalfWidth + kGridEvery * static_cast<float>(xIndex);
+		Vector3 localStartPos = { -kGridHalfWidth, 0.0f, z };
+		Vector3 localEndPos = { kGridHalfWidth, 0.0f, z };
+
+		//スクリーン座標に変換
+		Vector3 screenStartPos = Rendering::Transform(localStartPos, viewProjectionMatrix);
+		screenStartPos = Rendering::Transform(screenStartPos, viewportMatrix);
+		Vector3 screenEndPos = Rendering::Transform(localEndPos, viewProjectionMatrix);
+		screenEndPos = Rendering::Transform(screenEndPos, viewportMatrix);
+
+		//色の設定
+		uint32_t color = kGridColor;
+		if (kSubdivision % 2 == 0 && xIndex == kSubdivision / 2) {
+			color = kBlack; // 中央の線は黒色にする
+		}
+
+		//描画
+		DrawLine(screenStartPos, screenEndPos, color, viewportMatrix, backend);
+	}
+
+	//左から右も同じように順々に引いていく
+	for (uint32_t zIndex = 0; zIndex <= kSubdivision; zIndex++) {
+		//ローカル座標を求める
+		float x = -kGridHalfWidth + kGridEvery * static_cast<float>(zIndex);
+		Vector3 localStartPos = { x, 0.0f, -kGridHalfWidth };
+		Vector3 localEndPos = { x, 0.0f, kGridHalfWidth };
+
+		//スクリーン座標に変換
+		Vector3 screenStartPos = Rendering::Transform(localStartPos, viewProjectionMatrix);
+		screenStartPos = Rendering::Transform(screenStartPos, viewportMatrix);
+		Vector3 screenEndPos = Rendering::Transform(localEndPos, viewProjectionMatrix);
+		screenEndPos = Rendering::Transform(screenEndPos, viewportMatrix);
+
+		//色の設定
+		uint32_t color = kGridColor;
+		if (kSubdivision % 2 == 0 && zIndex == kSubdivision / 2) {
+			color = kBlack; // 中央の線は黒色にする
+		}
+
+		//描画
+		DrawLine(screenStartPos, screenEndPos, color, viewportMatrix, backend);
+	}
+
+}
+
+//スフィアの描画
+void Primitive::DrawSphere(const SphereData& sphereData, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix, DrawBackend& backend, uint32_t color, uint32_t subdivision) {
+	const uint32_t kSubdivision = subdivision > 2 ? subdivision : 2;//分割数(2未満だと線にならない)
+	const float kPi = std::numbers::pi_v<float>;//円周率
+	const float kLonEvery = 2.0f * kPi / static_cast<float>(kSubdivision);//経度分割1つ分の長さ
+	const float kLatEvery = kPi / static_cast<float>(kSubdivision);//緯度分割1つ分の長さ
+
+	//緯度の方向に分割 -π/2 ~ π/2
+	for (uint32_t latIndex = 0; latIndex < kSubdivision; latIndex++) {
+		float lat = -kPi / 2.0f + kLatEvery * static_cast<float>(latIndex);
+
+		//経度方向に分割 0 ~ 2π
+		for (uint32_t lonIndex = 0; lonIndex < kSubdivision; lonIndex++) {
+			float lon = static_cast<float>(lonIndex) * kLonEvery;
+
+			// 球面座標からワールド座標に変換
+			Vector3 a = {
+				std::cos(lat) * std::cos(lon),
+				std::sin(lat),
+				std::cos(lat) * std::sin(lon)
+			};
+
+			Vector3 b = {
+				std::cos(lat + kLatEvery) * std::cos(lon),
+				std::sin(lat + kLatEvery),
+				std::cos(lat + kLatEvery) * std::sin(lon)
+			};
+
+			Vector3 c = {
+				std::cos(lat) * std::cos(lon + kLonEvery),
+				std::sin(lat),
+				std::cos(lat) * std::sin(lon + kLonEvery)
+			};
+
+			//球の半径と中心を考慮して座標を調整
+			a = a * sphereData.radius + sphereData.center;
+			b = b * sphereData.radius + sphereData.center;
+			c = c * sphereData.radius + sphereData.center;
+
+			//スクリーン座標に変換
+			Vector3 screenA = Rendering::Transform(a, viewProjection);
+			screenA = Rendering::Transform(screenA, viewportMatrix);
+
+			Vector3 screenB = Rendering::Transform(b, viewProjection);
+			screenB = Rendering::Transform(screenB, viewportMatrix);
+
+			Vector3 screenC = Rendering::Transform(c, viewProjection);
+			screenC = Rendering::Transform(screenC, viewportMatrix);
+
+			// 経度線
+			DrawLine(screenA, screenB, color, viewportMatrix, backend);
+
+			// 緯度線
+			DrawLine(screenA, screenC, color, viewportMatrix, backend);
+		}
+	}
+}
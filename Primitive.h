@@ -0,0 +1,61 @@
+#pragma once
+#include "MathData.h"
+#include "Shape.h"
+#include "DrawBackend.h"
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// プリミティブの描画
+/// </summary>
+class Primitive {
+public://メンバ関数
+	/// <summary>
+	/// 線の描画(画面外の線はカリングし、描画した線は統計に記録する)
+	/// </summary>
+	/// <param name="screenStartPos">始点のスクリーン座標</param>
+	/// <param name="screenEndPos">終点のスクリーン座標</param>
+	/// <param name="color">色</param>
+	/// <param name="viewportMatrix">ビューポート行列(画面の範囲の計算に使う)</param>
+	/// <param name="backend">描画先</param>
+	static void DrawLine(const Vector3& screenStartPos, const Vector3& screenEndPos, uint32_t color, const Matrix4x4& viewportMatrix, DrawBackend& backend);
+
+	/// <summary>
+	/// 折れ線の描画(各点は1回だけ変換する)
+	/// </summary>
+	/// <param name="points">点のワールド座標(Spline::SamplePointsで取ったものなど)</param>
+	/// <param name="color">色</param>
+	/// <param name="viewProjectionMatrix">ビュー射影行列</param>
+	/// <param name="viewportMatrix">ビューポート行列</param>
+	/// <param name="backend">描画先</param>
+	static void DrawPolyline(std::span<const Vector3> points, uint32_t color, const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, DrawBackend& backend);
+
+	/// <summary>
+	/// グリッドの描画
+	/// </summary>
+	/// <param name="viewProjectionMatrix">ビュー射影行列</param>
+	/// <param name="viewportMatrix">ビューポート行列</param>
+	/// <param name="backend">描画先</param>
+	/// <param name="subdivision">分割数(偶数なら中央の線を黒にする)</param>
+	static void DrawGrid(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix, DrawBackend& backend, uint32_t subdivision = kGridSubdivision);
+
+	/// <summary>
+	/// スフィアの描画
+	/// </summary>
+	/// <param name="sphereData">球のデータ</param>
+	/// <param name="viewProjection">ビュー射影行列</param>
+	/// <param name="viewportMatrix">ビューポート行列</param>
+	/// <param name="backend">描画先</param>
+	/// <param name="color">色</param>
+	/// <param name="subdivision">緯度・経度の分割数(線の数はこの2乗の2倍)</param>
+	static void DrawSphere(const SphereData& sphereData, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix, DrawBackend& backend, uint32_t color = kBlack, uint32_t subdivision = kSphereSubdivision);
+public://定数
+	//黒
+	static inline const uint32_t kBlack = 0x000000FF;
+	//グリッドの線の色
+	static inline const uint32_t kGridColor = 0xAAAAAAFF;
+	//グリッドの分割数
+	static inline const uint32_t kGridSubdivision = 10;
+	//スフィアの分割数
+	static inline const uint32_t kSphereSubdivision = 10;
+};
@@ -0,0 +1,104 @@
+#include "QualityGovernor.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace {
+	//理由の名前
+	const char* const kReasonNames[] = {
+		"none",
+		"over budget",
+		"under budget",
+		"manual",
+		"replay",
+	};
+}
+
+//フレームの計測の開始
+void QualityGovernor::BeginFrame() {
+	frameStart_ = std::chrono::steady_clock::now();
+}
+
+//フレームの計測の終了
+void QualityGovernor::EndFrame() {
+	const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - frameStart_;
+	Update(elapsed.count());
+}
+
+//1フレーム分の時間で段を見直す
+void QualityGovernor::Update(float frameMilliseconds) {
+	frame_++;
+	lastMilliseconds_ = frameMilliseconds;
+	//最初のフレームはそのまま平均にする
+	averageMilliseconds_ = frame_ == 1 ? frameMilliseconds : averageMilliseconds_ + (frameMilliseconds - averageMilliseconds_) * kAverageWeight;
+
+	//固定したフレームは次のフレームの再生で合わせ直すので、続けて数えない
+	const bool isPinned = isPinned_;
+	isPinned_ = false;
+	if (!isAdaptive_ || isPinned) {
+		overBudgetFrames_ = 0;
+		underBudgetFrames_ = 0;
+		return;
+	}
+	//変えた直後は前の段の時間が平均に残っているので見直さない
+	if (cooldownFrames_ > 0) {
+		cooldownFrames_--;
+		return;
+	}
+
+	overBudgetFrames_ = averageMilliseconds_ > budgetMilliseconds_ * kDowngradeRatio ? overBudgetFrames_ + 1 : 0;
+	underBudgetFrames_ = averageMilliseconds_ < budgetMilliseconds_ * kUpgradeRatio ? underBudgetFrames_ + 1 : 0;
+
+	if (overBudgetFrames_ >= kDowngradeFrames && level_ + 1 < kLevelCount) {
+		//上げてすぐ下げ直したなら、上げた段は重すぎるので次に上げるまで長く待つ
+		const bool isOscillating = hasUpgraded_ && frame_ - lastUpgradeFrame_ <= kOscillationFrames;
+		upgradeFrames_ = isOscillating ? std::min(upgradeFrames_ * 2, kMaxUpgradeFrames) : kMinUpgradeFrames;
+		ChangeLevel(level_ + 1, Reason::kOverBudget);
+	} else if (underBudgetFrames_ >= upgradeFrames_ && level_ > 0) {
+		ChangeLevel(level_ - 1, Reason::kUnderBudget);
+		lastUpgradeFrame_ = frame_;
+		hasUpgraded_ = true;
+	}
+}
+
+//段のセッター
+void QualityGovernor::SetLevel(uint32_t level) {
+	level = std::min(level, kLevelCount - 1);
+	if (level != level_) {
+		ChangeLevel(level, Reason::kManual);
+	}
+}
+
+//そのフレームの段を固定する
+void QualityGovernor::PinLevel(uint32_t level) {
+	level = std::min(level, kLevelCount - 1);
+	if (level != level_) {
+		ChangeLevel(level, Reason::kReplay);
+	}
+	isPinned_ = true;
+}
+
+//理由の名前のゲッター
+const char* QualityGovernor::GetReasonName(Reason reason) {
+	assert(static_cast<size_t>(reason) < std::size(kReasonNames));
+	return kReasonNames[static_cast<size_t>(reason)];
+}
+
+//段を変えて記録する
+void QualityGovernor::ChangeLevel(uint32_t level, Reason reason) {
+	if (changes_.size() >= kMaxChangeHistory) {
+		changes_.erase(changes_.begin());
+	}
+	changes_.push_back({
+		.frame = frame_,
+		.fromLevel = level_,
+		.toLevel = level,
+		.reason = reason,
+		.averageMilliseconds = averageMilliseconds_,
+		.budgetMilliseconds = budgetMilliseconds_,
+		});
+	level_ = level;
+	overBudgetFrames_ = 0;
+	underBudgetFrames_ = 0;
+	cooldownFrames_ = kCooldownFrames;
+}
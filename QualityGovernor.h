@@ -0,0 +1,183 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 計測したフレーム時間に合わせて描画の品質を上げ下げする
+/// </summary>
+/// <remarks>
+/// BeginFrameからEndFrameまでのCPU時間(垂直同期の待ちを含めないよう、Novice::EndFrameの前で止める)を指数移動平均でならし、
+/// 予算を超えた状態が続けば1段下げ、十分に余裕のある状態がより長く続けば1段上げる。
+/// 変えた直後は平均が落ち着くまで待ち、上げてすぐ下げ直したときは次に上げるまでの待ちを倍にして、行ったり来たりしないようにする。
+/// 各段の設定はkLevelsにまとめてあり、描画する側がGetSettingsで読んで使う。
+/// 入力を再生している間はPinLevelで記録したときの段に合わせ、フレーム時間では変えない(同じ描画を繰り返すため)
+/// </remarks>
+class QualityGovernor {
+public://列挙型
+	/// <summary>
+	/// 段を変えた理由
+	/// </summary>
+	enum class Reason : uint32_t {
+		kNone,        //まだ変えていない
+		kOverBudget,  //予算を超えた状態が続いた
+		kUnderBudget, //予算に余裕のある状態が続いた
+		kManual,      //SetLevelで変えた
+		kReplay,      //PinLevelで記録した段に合わせた
+	};
+public://構造体
+	/// <summary>
+	/// 1段分の品質の設定
+	/// </summary>
+	struct Settings {
+		uint32_t sphereSubdivision; //スフィアの分割数(Primitive::DrawSphere)
+		uint32_t gridSubdivision; //グリッドの分割数(Primitive::DrawGrid)
+		float particleEmissionScale; //パーティクルの発生数の倍率(ParticleSystem::SetEmissionScale)
+		uint32_t maxDebugOverlayCount; //表示するデバッグ表示の数(優先度の高いものから)
+	};
+
+	/// <summary>
+	/// 段を変えた記録
+	/// </summary>
+	struct Change {
+		uint64_t frame; //変えたフレーム
+		uint32_t fromLevel; //変える前の段
+		uint32_t toLevel; //変えた後の段
+		Reason reason; //理由
+		float averageMilliseconds; //そのときの平均のフレーム時間(ミリ秒)
+		float budgetMilliseconds; //そのときの予算(ミリ秒)
+	};
+public://メンバ関数
+	/// <summary>
+	/// フレームの計測の開始
+	/// </summary>
+	void BeginFrame();
+
+	/// <summary>
+	/// フレームの計測の終了(BeginFrameからの時間で段を見直す)
+	/// </summary>
+	void EndFrame();
+
+	/// <summary>
+	/// 1フレーム分の時間で段を見直す(記録した時間を流し込むときなど)
+	/// </summary>
+	/// <param name="frameMilliseconds">フレーム時間(ミリ秒)</param>
+	void Update(float frameMilliseconds);
+
+	/// <summary>
+	/// 段のセッター(理由はkManualになる。自動で変えないときはSetAdaptiveでfalseにする)
+	/// </summary>
+	/// <param name="level">段(0が最高品質。kLevelCount以上は最低品質になる)</param>
+	void SetLevel(uint32_t level);
+
+	/// <summary>
+	/// そのフレームの段を固定する(入力の再生中に毎フレーム呼ぶ。呼んだフレームは自動で変えない)
+	/// </summary>
+	/// <param name="level">段(記録したときの段)</param>
+	void PinLevel(uint32_t level);
+
+	/// <summary>
+	/// 段のゲッター
+	/// </summary>
+	uint32_t GetLevel() const { return level_; }
+
+	/// <summary>
+	/// 今の段の設定のゲッター
+	/// </summary>
+	const Settings& GetSettings() const { return kLevels[level_]; }
+
+	/// <summary>
+	/// フレーム時間の予算(ミリ秒)のセッター
+	/// </summary>
+	void SetBudgetMilliseconds(float budgetMilliseconds) { budgetMilliseconds_ = budgetMilliseconds; }
+
+	/// <summary>
+	/// フレーム時間の予算(ミリ秒)のゲッター
+	/// </summary>
+	float GetBudgetMilliseconds() const { return budgetMilliseconds_; }
+
+	/// <summary>
+	/// 自動で段を変えるかのセッター
+	/// </summary>
+	void SetAdaptive(bool isAdaptive) { isAdaptive_ = isAdaptive; }
+
+	/// <summary>
+	/// 自動で段を変えるかのゲッター
+	/// </summary>
+	bool IsAdaptive() const { return isAdaptive_; }
+
+	/// <summary>
+	/// 直前のフレーム時間(ミリ秒)のゲッター
+	/// </summary>
+	float GetLastMilliseconds() const { return lastMilliseconds_; }
+
+	/// <summary>
+	/// 平均のフレーム時間(ミリ秒)のゲッター
+	/// </summary>
+	float GetAverageMilliseconds() const { return averageMilliseconds_; }
+
+	/// <summary>
+	/// 段を変えた記録のゲッター(古い順に最大kMaxChangeHistory件)
+	/// </summary>
+	const std::vector<Change>& GetChanges() const { return changes_; }
+
+	/// <summary>
+	/// 理由の名前のゲッター
+	/// </summary>
+	static const char* GetReasonName(Reason reason);
+public://定数
+	//段の数
+	static inline const uint32_t kLevelCount = 5;
+	//デバッグ表示の数を絞らないときの値
+	static inline const uint32_t kUnlimitedDebugOverlays = UINT32_MAX;
+	//各段の設定(0が最高品質で、PrimitiveやParticleSystemの既定値と同じ)
+	static inline const Settings kLevels[kLevelCount] = {
+		{ 10, 10, 1.0f, kUnlimitedDebugOverlays },
+		{ 8, 10, 0.75f, kUnlimitedDebugOverlays },
+		{ 6, 8, 0.5f, kUnlimitedDebugOverlays },
+		{ 4, 4, 0.25f, 1 },
+		{ 3, 2, 0.1f, 0 },
+	};
+	//フレーム時間の予算の既定値(60fps)
+	static inline const float kDefaultBudgetMilliseconds = 1000.0f / 60.0f;
+	//平均に今のフレームを混ぜる割合
+	static inline const float kAverageWeight = 0.1f;
+	//下げる平均のフレーム時間(予算に対する比)
+	static inline const float kDowngradeRatio = 0.95f;
+	//上げる平均のフレーム時間(予算に対する比。1段上げても予算に収まるだけの余裕)
+	static inline const float kUpgradeRatio = 0.7f;
+	//下げるまでに続けて超えるフレーム数
+	static inline const uint32_t kDowngradeFrames = 15;
+	//上げるまでに続けて余裕のあるフレーム数の最小
+	static inline const uint32_t kMinUpgradeFrames = 120;
+	//上げるまでに続けて余裕のあるフレーム数の最大
+	static inline const uint32_t kMaxUpgradeFrames = 1920;
+	//上げてからこのフレーム数のうちに下げ直したら、次に上げるまでの待ちを倍にする
+	static inline const uint32_t kOscillationFrames = 240;
+	//変えてから平均が落ち着くまで見直さないフレーム数
+	static inline const uint32_t kCooldownFrames = 30;
+	//残す記録の数
+	static inline const size_t kMaxChangeHistory = 8;
+private://メンバ関数
+	/// <summary>
+	/// 段を変えて記録する
+	/// </summary>
+	void ChangeLevel(uint32_t level, Reason reason);
+private://メンバ変数
+	std::chrono::steady_clock::time_point frameStart_ = {}; //フレームの開始時刻
+	float budgetMilliseconds_ = kDefaultBudgetMilliseconds; //フレーム時間の予算
+	bool isAdaptive_ = true; //自動で段を変えるか
+	bool isPinned_ = false; //このフレームはPinLevelで段を固定したか
+	uint32_t level_ = 0; //今の段
+	uint64_t frame_ = 0; //見直したフレーム数
+	float lastMilliseconds_ = 0.0f; //直前のフレーム時間
+	float averageMilliseconds_ = 0.0f; //平均のフレーム時間
+	uint32_t overBudgetFrames_ = 0; //続けて予算を超えたフレーム数
+	uint32_t underBudgetFrames_ = 0; //続けて余裕のあったフレーム数
+	uint32_t cooldownFrames_ = 0; //見直さない残りのフレーム数
+	uint32_t upgradeFrames_ = kMinUpgradeFrames; //上げるまでに続けて余裕のあるフレーム数
+	uint64_t lastUpgradeFrame_ = 0; //最後に上げたフレーム
+	bool hasUpgraded_ = false; //上げたことがあるか
+	std::vector<Change> changes_; //段を変えた記録
+};
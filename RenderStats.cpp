@@ -0,0 +1,165 @@
+#include "RenderStats.h"
+#include <cassert>
+#include <cmath>
+
+namespace {
+	//登録されたスレッドのカウンタ
+	struct Registration {
+		RenderStats::ThreadCounters* counters = nullptr;
+		uint64_t prevCounts[RenderStats::kCounterCount] = {}; //前回集計した時点の値
+		double prevLineLength = 0.0;
+	};
+
+	//スレッド終了時に登録を解除するための入れ物
+	struct ThreadSlot {
+		RenderStats::ThreadCounters counters;
+		bool isAttached = false;
+		~ThreadSlot() {
+			if (isAttached) {
+				RenderStats::DetachThread(&counters);
+			}
+		}
+	};
+
+	std::mutex registryMutex; //登録の排他
+	std::vector<Registration> registry; //登録されたスレッド
+	uint64_t retiredCounts[RenderStats::kCounterCount] = {}; //終了したスレッドの未集計分
+	double retiredLineLength = 0.0;
+	thread_local ThreadSlot threadSlot;
+
+	//カウンタの名前
+	const char* const kCounterNames[RenderStats::kCounterCount] = {
+		"transform",
+		"matrixMultiply",
+		"matrixInverse",
+		"drawLine",
+		"drawTriangle",
+		"culled",
+		"clipped",
+		"screenPrintf",
+	};
+}
+
+//インスタンスのゲッター
+RenderStats* RenderStats::GetInstance() {
+	assert(!isFinalize && "GetInstance() called after Finalize()");
+	if (instance == nullptr) {
+		instance = new RenderStats();
+	}
+	return instance;
+}
+
+//描画した線の記録
+void RenderStats::AddLine(float x1, float y1, float x2, float y2) {
+	ThreadCounters& counters = GetThreadCounters();
+	std::atomic<uint64_t>& drawLine = counters.counts[static_cast<size_t>(Counter::kDrawLine)];
+	drawLine.store(drawLine.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	double length = std::hypot(static_cast<double>(x2 - x1), static_cast<double>(y2 - y1));
+	counters.lineLength.store(counters.lineLength.load(std::memory_order_relaxed) + length, std::memory_order_relaxed);
+}
+
+//カウンタの名前のゲッター
+const char* RenderStats::GetCounterName(Counter counter) {
+	assert(counter < Counter::kCount);
+	return kCounterNames[static_cast<size_t>(counter)];
+}
+
+//フレームの終了
+void RenderStats::EndFrame() {
+	FrameStats stats = {};
+	stats.frame = frame_++;
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		//各スレッドの前回からの差分を足し込む
+		for (Registration& registration : registry) {
+			for (size_t i = 0; i < kCounterCount; i++) {
+				uint64_t value = registration.counters->counts[i].load(std::memory_order_relaxed);
+				stats.counts[i] += value - registration.prevCounts[i];
+				registration.prevCounts[i] = value;
+			}
+			double lineLength = registration.counters->lineLength.load(std::memory_order_relaxed);
+			stats.lineLength += lineLength - registration.prevLineLength;
+			registration.prevLineLength = lineLength;
+		}
+		//終了したスレッドの分
+		for (size_t i = 0; i < kCounterCount; i++) {
+			stats.counts[i] += retiredCounts[i];
+			retiredCounts[i] = 0;
+		}
+		stats.lineLength += retiredLineLength;
+		retiredLineLength = 0.0;
+	}
+	frameStats_ = stats;
+
+	if (log_.is_open()) {
+		WriteLog();
+	}
+}
+
+//直前のフレームの集計結果のゲッター
+const RenderStats::FrameStats& RenderStats::GetFrameStats() const {
+	return frameStats_;
+}
+
+//ログの出力を開始
+bool RenderStats::OpenLog(const char* filePath) {
+	CloseLog();
+	log_.open(filePath, std::ios::out | std::ios::trunc);
+	return log_.is_open();
+}
+
+//ログの出力を終了
+void RenderStats::CloseLog() {
+	if (log_.is_open()) {
+		log_.close();
+	}
+}
+
+//終了
+void RenderStats::Finalize() {
+	CloseLog();
+	delete instance;
+	instance = nullptr;
+	isFinalize = true;
+}
+
+//スレッドのカウンタの登録
+RenderStats::ThreadCounters* RenderStats::AttachThread() {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	if (!threadSlot.isAttached) {
+		Registration registration;
+		registration.counters = &threadSlot.counters;
+		registry.push_back(registration);
+		threadSlot.isAttached = true;
+	}
+	return &threadSlot.counters;
+}
+
+//スレッドのカウンタの登録解除
+void RenderStats::DetachThread(ThreadCounters* counters) {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	for (size_t index = 0; index < registry.size(); index++) {
+		Registration& registration = registry[index];
+		if (registration.counters != counters) {
+			continue;
+		}
+		//未集計の分は次のEndFrameに回す
+		for (size_t i = 0; i < kCounterCount; i++) {
+			retiredCounts[i] += counters->counts[i].load(std::memory_order_relaxed) - registration.prevCounts[i];
+		}
+		retiredLineLength += counters->lineLength.load(std::memory_order_relaxed) - registration.prevLineLength;
+		registry[index] = registry.back();
+		registry.pop_back();
+		break;
+	}
+	threadCounters = nullptr;
+}
+
+//ログへの書き込み
+void RenderStats::WriteLog() {
+	log_ << "{\"frame\":" << frameStats_.frame;
+	for (size_t i = 0; i < kCounterCount; i++) {
+		log_ << ",\"" << kCounterNames[i] << "\":" << frameStats_.counts[i];
+	}
+	log_ << ",\"lineLengthPx\":" << frameStats_.lineLength << "}\n";
+}
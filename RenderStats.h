@@ -0,0 +1,180 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+/// <summary>
+/// 描画統計
+/// </summary>
+/// <remarks>
+/// 数学の関数(行列の乗算・逆行列・Transform)の回数は呼び出しのたびに数えると計測がゆがむので、
+/// MT_MATH_STATSを定義したビルド(DebugとDevelop)だけAddMathで数え、定義しないビルドでは0のままになる
+/// </remarks>
+class RenderStats {
+public://列挙型
+	/// <summary>
+	/// カウンタの種類
+	/// </summary>
+	enum class Counter : uint32_t {
+		kTransform,      //Rendering::Transformの呼び出し回数(MT_MATH_STATSのときだけ)
+		kMatrixMultiply, //行列の乗算回数(MT_MATH_STATSのときだけ)
+		kMatrixInverse,  //逆行列の計算回数(MT_MATH_STATSのときだけ)
+		kDrawLine,       //Novice::DrawLineの呼び出し回数
+		kDrawTriangle,   //Novice::DrawTriangleの呼び出し回数
+		kCulled,         //画面外でカリングされたプリミティブ数
+		kClipped,        //画面端で切られたプリミティブ数
+		kScreenPrintf,   //Novice::ScreenPrintfの呼び出し回数
+		kCount
+	};
+
+	//カウンタの数
+	static inline const size_t kCounterCount = static_cast<size_t>(Counter::kCount);
+
+public://構造体
+	/// <summary>
+	/// 1フレーム分の集計結果
+	/// </summary>
+	struct FrameStats {
+		uint64_t frame = 0; //フレーム番号
+		uint64_t counts[kCounterCount] = {}; //カウンタの値
+		double lineLength = 0.0; //投影後の線の総延長(ピクセル)
+
+		/// <summary>
+		/// カウンタの値のゲッター
+		/// </summary>
+		/// <param name="counter">カウンタの種類</param>
+		/// <returns>カウンタの値</returns>
+		uint64_t Get(Counter counter) const { return counts[static_cast<size_t>(counter)]; }
+	};
+
+	/// <summary>
+	/// スレッドごとのカウンタ
+	/// </summary>
+	/// <remarks>書き込むのは所有スレッドだけなので、relaxedのload/storeで足りる</remarks>
+	struct ThreadCounters {
+		std::atomic<uint64_t> counts[kCounterCount] = {};
+		std::atomic<double> lineLength = 0.0;
+	};
+
+public://メンバ関数
+	/// <summary>
+	/// インスタンスのゲッター
+	/// </summary>
+	/// <returns></returns>
+	static RenderStats* GetInstance();
+
+	/// <summary>
+	/// カウンタの加算(呼び出したスレッドのカウンタに積む)
+	/// </summary>
+	/// <param name="counter">カウンタの種類</param>
+	/// <param name="n">加算する値</param>
+	static void Add(Counter counter, uint64_t n = 1) {
+		std::atomic<uint64_t>& value = GetThreadCounters().counts[static_cast<size_t>(counter)];
+		value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// 数学の関数の呼び出し回数の加算(MT_MATH_STATSを定義しないビルドでは何もしない)
+	/// </summary>
+	/// <param name="counter">カウンタの種類</param>
+	static void AddMath([[maybe_unused]] Counter counter) {
+#ifdef MT_MATH_STATS
+		Add(counter);
+#endif
+	}
+
+	/// <summary>
+	/// 描画した線の記録
+	/// </summary>
+	/// <param name="x1">始点x</param>
+	/// <param name="y1">始点y</param>
+	/// <param name="x2">終点x</param>
+	/// <param name="y2">終点y</param>
+	static void AddLine(float x1, float y1, float x2, float y2);
+
+	/// <summary>
+	/// カウンタの名前のゲッター
+	/// </summary>
+	/// <param name="counter">カウンタの種類</param>
+	/// <returns>名前</returns>
+	static const char* GetCounterName(Counter counter);
+
+	/// <summary>
+	/// フレームの終了(全スレッドのカウンタを集計する)
+	/// </summary>
+	void EndFrame();
+
+	/// <summary>
+	/// 直前のフレームの集計結果のゲッター
+	/// </summary>
+	/// <returns>集計結果</returns>
+	const FrameStats& GetFrameStats() const;
+
+	/// <summary>
+	/// フレームごとのログの出力を開始(1行1フレームのJSON)
+	/// </summary>
+	/// <param name="filePath">出力先</param>
+	/// <returns>開けたかどうか</returns>
+	bool OpenLog(const char* filePath);
+
+	/// <summary>
+	/// ログの出力を終了
+	/// </summary>
+	void CloseLog();
+
+	/// <summary>
+	/// 終了
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// スレッドのカウンタの登録(スレッド初回の呼び出し時のみ)
+	/// </summary>
+	/// <returns>スレッドのカウンタ</returns>
+	static ThreadCounters* AttachThread();
+
+	/// <summary>
+	/// スレッドのカウンタの登録解除(スレッド終了時)
+	/// </summary>
+	/// <param name="counters">スレッドのカウンタ</param>
+	static void DetachThread(ThreadCounters* counters);
+private://静的メンバ変数
+	//インスタンス
+	static inline RenderStats* instance = nullptr;
+	//解放したかどうか
+	static inline bool isFinalize = false;
+	//スレッドのカウンタ
+	static inline thread_local ThreadCounters* threadCounters = nullptr;
+private://メンバ関数
+	//コンストラクタの封印
+	RenderStats() = default;
+	//デストラクタの封印
+	~RenderStats() = default;
+	//コピーコンストラクタの封印
+	RenderStats(const RenderStats&) = delete;
+	//代入演算子の封印
+	RenderStats& operator=(const RenderStats&) = delete;
+
+	/// <summary>
+	/// 呼び出したスレッドのカウンタのゲッター
+	/// </summary>
+	/// <returns>スレッドのカウンタ</returns>
+	static ThreadCounters& GetThreadCounters() {
+		if (threadCounters == nullptr) {
+			threadCounters = AttachThread();
+		}
+		return *threadCounters;
+	}
+
+	/// <summary>
+	/// ログへの書き込み
+	/// </summary>
+	void WriteLog();
+private://メンバ変数
+	FrameStats frameStats_ = {}; //直前のフレームの集計結果
+	uint64_t frame_ = 0; //フレーム番号
+	std::ofstream log_; //フレームごとのログ
+};
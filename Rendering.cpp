@@ -1,4 +1,6 @@
 #include "Rendering.h"
+#include "RenderStats.h"
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 using namespace std;
@@ -29,6 +31,7 @@ Matrix4x4 Rendering::MakeTranslateMatrix(const Vector3& translate) {
 
 //同次座標系で計算しデカルト座標系に変換
 Vector3 Rendering::Transform(const Vector3& vector, const Matrix4x4& matrix) {
+	RenderStats::AddMath(RenderStats::Counter::kTransform);
 	Vector3 result{};
 	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
 	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
@@ -169,3 +172,78 @@ Matrix4x4 Rendering::MakeBillboardMatrix(const Matrix4x4& cameraWorldMatrix, con
 	billboardMatrix.m[3][2] = 0.0f; // Z座標を0に設定
 	return billboardMatrix;
 }
+
+//ある方向からある方向への回転行列
+Matrix4x4 Rendering::DirectionToDirection(const Vector3& from, const Vector3& to) {
+	Matrix4x4 result = Matrix4x4::Identity4x4();
+	Vector3 u = from.Normalize();
+	Vector3 v = to.Normalize();
+	Vector3 n = (u.Cross(v)).Normalize();
+	float cosTheta = u.Dot(v);
+	float sinTheta = u.Cross(v).Length();
+
+	if (cosTheta <= -1.0f) {
+		if (u.x != 0.0f || u.y != 0.0f) {
+			n = Vector3(u.y, -u.x, 0.0f).Normalize();
+		} else if (u.x != 0.0f || u.z != 0.0f) {
+			n = Vector3(u.z, 0.0f, -u.x).Normalize();
+		}
+	}
+
+	result.m[0][0] = std::pow(n.x, 2.0f) * (1.0f - cosTheta) + cosTheta;
+	result.m[0][1] = n.x * n.y * (1.0f - cosTheta) + n.z * sinTheta;
+	result.m[0][2] = n.x * n.z * (1.0f - cosTheta) - n.y * sinTheta;
+
+	result.m[1][0] = n.x * n.y * (1.0f - cosTheta) - n.z * sinTheta;
+	result.m[1][1] = std::pow(n.y, 2.0f) * (1.0f - cosTheta) + cosTheta;
+	result.m[1][2] = n.y * n.z * (1.0f - cosTheta) + n.x * sinTheta;
+
+	result.m[2][0] = n.x * n.z * (1.0f - cosTheta) + n.y * sinTheta;
+	result.m[2][1] = n.y * n.z * (1.0f - cosTheta) - n.x * sinTheta;
+	result.m[2][2] = std::pow(n.z, 2.0f) * (1.0f - cosTheta) + cosTheta;
+	return result;
+}
+
+//回転行列から角度を取り出す
+Vector3 Rendering::ExtractRotateXYZ(const Matrix4x4& rotateMatrix) {
+	//Rx*Ry*Rzの成分は m[0][0]=cosY*cosZ, m[0][1]=cosY*sinZ, m[0][2]=-sinY, m[1][2]=sinX*cosY, m[2][2]=cosX*cosY
+	//asinは±90度の近くで誤差が大きいので、yはcosYと合わせてatan2で求める
+	const float cosY = std::sqrt(rotateMatrix.m[0][0] * rotateMatrix.m[0][0] + rotateMatrix.m[0][1] * rotateMatrix.m[0][1]);
+	const float y = std::atan2(-rotateMatrix.m[0][2], cosY);
+	if (cosY > 1.0e-6f) {
+		return { std::atan2(rotateMatrix.m[1][2], rotateMatrix.m[2][2]),y,std::atan2(rotateMatrix.m[0][1], rotateMatrix.m[0][0]) };
+	}
+	//cosYが0だとxとzが同じ回りになるので、zを0としてxに寄せる(m[1][0]=sinX*sinY, m[1][1]=cosX)
+	const float sinY = -rotateMatrix.m[0][2] < 0.0f ? -1.0f : 1.0f;
+	return { std::atan2(rotateMatrix.m[1][0] * sinY, rotateMatrix.m[1][1]),y,0.0f };
+}
+
+//ビュー射影行列から視錐台を作成
+Frustum Rendering::MakeFrustum(const Matrix4x4& viewProjectionMatrix) {
+	const Matrix4x4& m = viewProjectionMatrix;
+	//クリップ座標の各成分は行列の列との内積になる
+	auto column = [&m](int index) {
+		return Vector3(m.m[0][index], m.m[1][index], m.m[2][index]);
+		};
+	Vector3 column0 = column(0), column1 = column(1), column2 = column(2), column3 = column(3);
+	float w0 = m.m[3][0], w1 = m.m[3][1], w2 = m.m[3][2], w3 = m.m[3][3];
+
+	//ax + by + cz + d >= 0 が内側になる平面
+	const Vector3 normals[6] = {
+		column3 + column0, column3 - column0,
+		column3 + column1, column3 - column1,
+		column2, column3 - column2,
+	};
+	const float ds[6] = { w3 + w0, w3 - w0, w3 + w1, w3 - w1, w2, w3 - w2 };
+
+	Frustum frustum = {};
+	for (int i = 0; i < 6; i++) {
+		Vector3 normal = normals[i];
+		float length = normal.Length();
+		if (length != 0.0f) {
+			frustum.planes[i].normal = normal / length;
+			frustum.planes[i].distance = -ds[i] / length;
+		}
+	}
+	return frustum;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "MathData.h"
+#include "Shape.h"
 
 /// <summary>
 /// レンダリング
@@ -129,5 +130,27 @@ public://メンバ関数
 	/// <param name="rotate">回転</param>
 	/// <returns>ビルボード行列</returns>
 	static Matrix4x4 MakeBillboardMatrix(const Matrix4x4& cameraWorldMatrix, const Vector3& rotate);
+
+	/// <summary>
+	/// ある方向からある方向への回転行列
+	/// </summary>
+	/// <param name="from">回転前の方向</param>
+	/// <param name="to">回転後の方向</param>
+	/// <returns>回転行列</returns>
+	static Matrix4x4 DirectionToDirection(const Vector3& from, const Vector3& to);
+
+	/// <summary>
+	/// 回転行列からx,y,z軸の角度を取り出す(MakeRotateXYZMatrixの逆)
+	/// </summary>
+	/// <param name="rotateMatrix">回転行列(行が各軸の向き)</param>
+	/// <returns>各軸の角度(ラジアン、y軸が±90度のときはz軸を0にする)</returns>
+	static Vector3 ExtractRotateXYZ(const Matrix4x4& rotateMatrix);
+
+	/// <summary>
+	/// ビュー射影行列から視錐台を作成
+	/// </summary>
+	/// <param name="viewProjectionMatrix">ビュー射影行列</param>
+	/// <returns>視錐台</returns>
+	static Frustum MakeFrustum(const Matrix4x4& viewProjectionMatrix);
 };
 
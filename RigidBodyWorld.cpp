@@ -0,0 +1,365 @@
+#include "RigidBodyWorld.h"
+#include "MemoryTracker.h"
+#include "JobSystem.h"
+#include <cassert>
+#include <cmath>
+
+namespace {
+	//空きスロットの終端
+	const uint32_t kNullSlot = 0xFFFFFFFFu;
+
+	/// <summary>
+	/// 0なら0、それ以外は逆数
+	/// </summary>
+	float InverseOrZero(float value) {
+		return value > 0.0f ? 1.0f / value : 0.0f;
+	}
+
+	/// <summary>
+	/// 1軸分の速度(眠っている剛体は力も重力も受けない)
+	/// </summary>
+	/// <remarks>__restrictは引数に付けないと効かないので、成分ごとの配列を引数で受け取る(ループは分岐なしでベクトル化される)</remarks>
+	void IntegrateVelocityAxis(float* __restrict velocity, float* __restrict force, const float* __restrict inverseMass,
+		const float* __restrict damping, const float* __restrict awake, float gravity, float deltaTime, size_t begin, size_t end) {
+		const float gravityImpulse = gravity * deltaTime;
+		for (size_t i = begin; i < end; i++) {
+			//動かない剛体には重力をかけない
+			const float isDynamic = inverseMass[i] > 0.0f ? 1.0f : 0.0f;
+			const float dampingScale = 1.0f / (1.0f + deltaTime * damping[i]);
+			velocity[i] = (velocity[i] + (gravityImpulse * isDynamic + force[i] * inverseMass[i] * deltaTime) * awake[i]) * dampingScale;
+			//加えた力は使い切る
+			force[i] = 0.0f;
+		}
+	}
+
+	/// <summary>
+	/// 1軸分の位置
+	/// </summary>
+	void IntegratePositionAxis(float* __restrict position, const float* __restrict velocity, float deltaTime, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			position[i] += velocity[i] * deltaTime;
+		}
+	}
+
+	/// <summary>
+	/// 1軸分の角速度
+	/// </summary>
+	void IntegrateAngularAxis(float* __restrict angularVelocity, float* __restrict torque, const float* __restrict inverseInertia,
+		const float* __restrict damping, const float* __restrict awake, float deltaTime, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			const float dampingScale = 1.0f / (1.0f + deltaTime * damping[i]);
+			angularVelocity[i] = (angularVelocity[i] + torque[i] * inverseInertia[i] * deltaTime * awake[i]) * dampingScale;
+			torque[i] = 0.0f;
+		}
+	}
+
+	/// <summary>
+	/// 姿勢(q += (ω,0) * q * dt / 2 の後に正規化)
+	/// </summary>
+	void IntegrateOrientation(float* __restrict qx, float* __restrict qy, float* __restrict qz, float* __restrict qw,
+		const float* __restrict wx, const float* __restrict wy, const float* __restrict wz, float deltaTime, size_t begin, size_t end) {
+		const float halfDeltaTime = deltaTime * 0.5f;
+		for (size_t i = begin; i < end; i++) {
+			const float x = qx[i], y = qy[i], z = qz[i], w = qw[i];
+			const float ax = wx[i], ay = wy[i], az = wz[i];
+			const float nx = x + (ax * w + ay * z - az * y) * halfDeltaTime;
+			const float ny = y + (-ax * z + ay * w + az * x) * halfDeltaTime;
+			const float nz = z + (ax * y - ay * x + az * w) * halfDeltaTime;
+			const float nw = w + (-ax * x - ay * y - az * z) * halfDeltaTime;
+			const float inverseLength = 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz + nw * nw);
+			qx[i] = nx * inverseLength;
+			qy[i] = ny * inverseLength;
+			qz[i] = nz * inverseLength;
+			qw[i] = nw * inverseLength;
+		}
+	}
+}
+
+//剛体の追加
+RigidBodyWorld::BodyHandle RigidBodyWorld::AddBody(const BodyDesc& desc) {
+	const uint32_t dense = static_cast<uint32_t>(inverseMass_.size());
+	const float positions[3] = { desc.position.x,desc.position.y,desc.position.z };
+	const float orientations[4] = { desc.orientation.x,desc.orientation.y,desc.orientation.z,desc.orientation.w };
+	const float velocities[3] = { desc.velocity.x,desc.velocity.y,desc.velocity.z };
+	const float angularVelocities[3] = { desc.angularVelocity.x,desc.angularVelocity.y,desc.angularVelocity.z };
+	for (int i = 0; i < 3; i++) {
+		position_[i].push_back(positions[i]);
+		velocity_[i].push_back(velocities[i]);
+		angularVelocity_[i].push_back(angularVelocities[i]);
+		force_[i].push_back(0.0f);
+		torque_[i].push_back(0.0f);
+	}
+	for (int i = 0; i < 4; i++) {
+		orientation_[i].push_back(orientations[i]);
+	}
+	inverseMass_.push_back(InverseOrZero(desc.mass));
+	//動かない剛体は回りもしない
+	inverseInertia_.push_back(desc.mass > 0.0f ? InverseOrZero(desc.inertia) : 0.0f);
+	linearDamping_.push_back(desc.linearDamping);
+	angularDamping_.push_back(desc.angularDamping);
+	awake_.push_back(1.0f);
+
+	//空きスロットがあれば使い回す
+	uint32_t slot = freeSlot_;
+	if (slot != kNullSlot) {
+		freeSlot_ = slotToDense_[slot];
+		slotToDense_[slot] = dense;
+	} else {
+		slot = static_cast<uint32_t>(slotToDense_.size());
+		slotToDense_.push_back(dense);
+		slotGeneration_.push_back(0);
+	}
+	denseToSlot_.push_back(slot);
+	return { .index = slot,.generation = slotGeneration_[slot] };
+}
+
+//剛体の削除
+void RigidBodyWorld::RemoveBody(BodyHandle handle) {
+	if (!IsValid(handle)) {
+		return;
+	}
+	//末尾の剛体を穴に移して詰める
+	const uint32_t dense = slotToDense_[handle.index];
+	const uint32_t last = static_cast<uint32_t>(inverseMass_.size() - 1);
+	auto moveLast = [dense](std::vector<float>& values) {
+		values[dense] = values.back();
+		values.pop_back();
+		};
+	for (int i = 0; i < 3; i++) {
+		moveLast(position_[i]);
+		moveLast(velocity_[i]);
+		moveLast(angularVelocity_[i]);
+		moveLast(force_[i]);
+		moveLast(torque_[i]);
+	}
+	for (std::vector<float>& orientation : orientation_) {
+		moveLast(orientation);
+	}
+	moveLast(inverseMass_);
+	moveLast(inverseInertia_);
+	moveLast(linearDamping_);
+	moveLast(angularDamping_);
+	moveLast(awake_);
+
+	const uint32_t lastSlot = denseToSlot_[last];
+	denseToSlot_[dense] = lastSlot;
+	slotToDense_[lastSlot] = dense;
+	denseToSlot_.pop_back();
+
+	//世代を進めて古いハンドルを無効にし、空きスロットにつなぐ
+	slotGeneration_[handle.index]++;
+	slotToDense_[handle.index] = freeSlot_;
+	freeSlot_ = handle.index;
+}
+
+//ハンドルが有効か
+bool RigidBodyWorld::IsValid(BodyHandle handle) const {
+	return handle.index < slotGeneration_.size() && slotGeneration_[handle.index] == handle.generation;
+}
+
+//全削除
+void RigidBodyWorld::Clear() {
+	//古いハンドルが無効になるように、スロットは世代を進めて空きにする
+	for (uint32_t dense = 0; dense < denseToSlot_.size(); dense++) {
+		uint32_t slot = denseToSlot_[dense];
+		slotGeneration_[slot]++;
+		slotToDense_[slot] = freeSlot_;
+		freeSlot_ = slot;
+	}
+	denseToSlot_.clear();
+	for (int i = 0; i < 3; i++) {
+		position_[i].clear();
+		velocity_[i].clear();
+		angularVelocity_[i].clear();
+		force_[i].clear();
+		torque_[i].clear();
+	}
+	for (std::vector<float>& orientation : orientation_) {
+		orientation.clear();
+	}
+	inverseMass_.clear();
+	inverseInertia_.clear();
+	linearDamping_.clear();
+	angularDamping_.clear();
+	awake_.clear();
+}
+
+//剛体を区間に分けて処理する
+template<class Function>
+void RigidBodyWorld::ForEachRange(bool isParallel, Function function) {
+	const size_t count = inverseMass_.size();
+	if (!isParallel || count < kMinBatchSize * 2) {
+		function(0, count);
+		return;
+	}
+	JobSystem::GetInstance()->ParallelFor(count, kMinBatchSize, function);
+}
+
+//時間を進める
+void RigidBodyWorld::Step(float deltaTime, bool isParallel) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kPhysics);
+	//区間ごとに速度と位置を続けて進める(配列がキャッシュにあるうちに使う)
+	ForEachRange(isParallel, [this, deltaTime](size_t begin, size_t end) {
+		IntegrateVelocityRange(begin, end, deltaTime);
+		IntegratePositionRange(begin, end, deltaTime);
+		});
+}
+
+//速度と角速度だけを進める
+void RigidBodyWorld::IntegrateVelocities(float deltaTime, bool isParallel) {
+	ForEachRange(isParallel, [this, deltaTime](size_t begin, size_t end) {
+		IntegrateVelocityRange(begin, end, deltaTime);
+		});
+}
+
+//位置と姿勢を進める
+void RigidBodyWorld::IntegratePositions(float deltaTime, bool isParallel) {
+	ForEachRange(isParallel, [this, deltaTime](size_t begin, size_t end) {
+		IntegratePositionRange(begin, end, deltaTime);
+		});
+}
+
+//[begin, end)の剛体の速度を積分する
+void RigidBodyWorld::IntegrateVelocityRange(size_t begin, size_t end, float deltaTime) {
+	const float gravity[3] = { gravity_.x,gravity_.y,gravity_.z };
+	//キャッシュに乗る大きさに区切って、成分ごとの処理を続けて行う
+	for (size_t blockBegin = begin; blockBegin < end; blockBegin += kBlockSize) {
+		const size_t blockEnd = end - blockBegin < kBlockSize ? end : blockBegin + kBlockSize;
+		for (int axis = 0; axis < 3; axis++) {
+			IntegrateVelocityAxis(velocity_[axis].data(), force_[axis].data(), inverseMass_.data(), linearDamping_.data(),
+				awake_.data(), gravity[axis], deltaTime, blockBegin, blockEnd);
+			IntegrateAngularAxis(angularVelocity_[axis].data(), torque_[axis].data(), inverseInertia_.data(), angularDamping_.data(),
+				awake_.data(), deltaTime, blockBegin, blockEnd);
+		}
+	}
+}
+
+//[begin, end)の剛体の位置を積分する
+void RigidBodyWorld::IntegratePositionRange(size_t begin, size_t end, float deltaTime) {
+	for (int axis = 0; axis < 3; axis++) {
+		IntegratePositionAxis(position_[axis].data(), velocity_[axis].data(), deltaTime, begin, end);
+	}
+	IntegrateOrientation(orientation_[0].data(), orientation_[1].data(), orientation_[2].data(), orientation_[3].data(),
+		angularVelocity_[0].data(), angularVelocity_[1].data(), angularVelocity_[2].data(), deltaTime, begin, end);
+}
+
+//起きているか
+bool RigidBodyWorld::IsAwake(BodyHandle handle) const {
+	return awake_[GetDenseIndex(handle)] != 0.0f;
+}
+
+//起こすか眠らせる
+void RigidBodyWorld::SetAwake(BodyHandle handle, bool isAwake) {
+	const uint32_t dense = GetDenseIndex(handle);
+	awake_[dense] = isAwake ? 1.0f : 0.0f;
+	if (!isAwake) {
+		for (int i = 0; i < 3; i++) {
+			velocity_[i][dense] = 0.0f;
+			angularVelocity_[i][dense] = 0.0f;
+		}
+	}
+}
+
+//力を加える
+void RigidBodyWorld::AddForce(BodyHandle handle, const Vector3& force) {
+	const uint32_t dense = GetDenseIndex(handle);
+	awake_[dense] = 1.0f;
+	force_[0][dense] += force.x;
+	force_[1][dense] += force.y;
+	force_[2][dense] += force.z;
+}
+
+//トルクを加える
+void RigidBodyWorld::AddTorque(BodyHandle handle, const Vector3& torque) {
+	const uint32_t dense = GetDenseIndex(handle);
+	awake_[dense] = 1.0f;
+	torque_[0][dense] += torque.x;
+	torque_[1][dense] += torque.y;
+	torque_[2][dense] += torque.z;
+}
+
+//位置のゲッター
+Vector3 RigidBodyWorld::GetPosition(BodyHandle handle) const {
+	const uint32_t dense = GetDenseIndex(handle);
+	return { position_[0][dense],position_[1][dense],position_[2][dense] };
+}
+
+//位置のセッター
+void RigidBodyWorld::SetPosition(BodyHandle handle, const Vector3& position) {
+	const uint32_t dense = GetDenseIndex(handle);
+	position_[0][dense] = position.x;
+	position_[1][dense] = position.y;
+	position_[2][dense] = position.z;
+}
+
+//姿勢のゲッター
+Quaternion RigidBodyWorld::GetOrientation(BodyHandle handle) const {
+	const uint32_t dense = GetDenseIndex(handle);
+	return { orientation_[0][dense],orientation_[1][dense],orientation_[2][dense],orientation_[3][dense] };
+}
+
+//姿勢のセッター
+void RigidBodyWorld::SetOrientation(BodyHandle handle, const Quaternion& orientation) {
+	const uint32_t dense = GetDenseIndex(handle);
+	Quaternion normalized = orientation.Normalize();
+	orientation_[0][dense] = normalized.x;
+	orientation_[1][dense] = normalized.y;
+	orientation_[2][dense] = normalized.z;
+	orientation_[3][dense] = normalized.w;
+}
+
+//速度のゲッター
+Vector3 RigidBodyWorld::GetVelocity(BodyHandle handle) const {
+	const uint32_t dense = GetDenseIndex(handle);
+	return { velocity_[0][dense],velocity_[1][dense],velocity_[2][dense] };
+}
+
+//速度のセッター
+void RigidBodyWorld::SetVelocity(BodyHandle handle, const Vector3& velocity) {
+	const uint32_t dense = GetDenseIndex(handle);
+	awake_[dense] = 1.0f;
+	velocity_[0][dense] = velocity.x;
+	velocity_[1][dense] = velocity.y;
+	velocity_[2][dense] = velocity.z;
+}
+
+//角速度のゲッター
+Vector3 RigidBodyWorld::GetAngularVelocity(BodyHandle handle) const {
+	const uint32_t dense = GetDenseIndex(handle);
+	return { angularVelocity_[0][dense],angularVelocity_[1][dense],angularVelocity_[2][dense] };
+}
+
+//角速度のセッター
+void RigidBodyWorld::SetAngularVelocity(BodyHandle handle, const Vector3& angularVelocity) {
+	const uint32_t dense = GetDenseIndex(handle);
+	awake_[dense] = 1.0f;
+	angularVelocity_[0][dense] = angularVelocity.x;
+	angularVelocity_[1][dense] = angularVelocity.y;
+	angularVelocity_[2][dense] = angularVelocity.z;
+}
+
+//質量の逆数のゲッター
+float RigidBodyWorld::GetInverseMass(BodyHandle handle) const {
+	return inverseMass_[GetDenseIndex(handle)];
+}
+
+//慣性モーメントの逆数のゲッター
+float RigidBodyWorld::GetInverseInertia(BodyHandle handle) const {
+	return inverseInertia_[GetDenseIndex(handle)];
+}
+
+//ワールド行列
+Matrix4x4 RigidBodyWorld::GetWorldMatrix(BodyHandle handle) const {
+	Matrix4x4 result = GetOrientation(handle).MakeRotateMatrix();
+	Vector3 position = GetPosition(handle);
+	result.m[3][0] = position.x;
+	result.m[3][1] = position.y;
+	result.m[3][2] = position.z;
+	return result;
+}
+
+//配列での番号
+uint32_t RigidBodyWorld::GetDenseIndex(BodyHandle handle) const {
+	assert(IsValid(handle));
+	return slotToDense_[handle.index];
+}
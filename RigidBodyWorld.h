@@ -0,0 +1,210 @@
+#pragma once
+#include "MathData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 剛体の集まり(成分ごとの配列に持ち、まとめて積分する)
+/// </summary>
+/// <remarks>
+/// 積分は半陰的オイラー法(速度を先に更新し、新しい速度で位置と姿勢を進める)。
+/// 削除は末尾の剛体で穴を埋めて配列を詰めるので、剛体はハンドルで指す
+/// </remarks>
+class RigidBodyWorld {
+public://構造体
+	/// <summary>
+	/// 剛体を指すハンドル(削除された剛体のハンドルは無効になる)
+	/// </summary>
+	struct BodyHandle {
+		uint32_t index = 0xFFFFFFFFu; //スロット番号
+		uint32_t generation = 0; //スロットを使い回した回数
+	};
+
+	/// <summary>
+	/// 追加する剛体の設定
+	/// </summary>
+	struct BodyDesc {
+		Vector3 position = { 0.0f,0.0f,0.0f }; //位置
+		Quaternion orientation = { 0.0f,0.0f,0.0f,1.0f }; //姿勢
+		Vector3 velocity = { 0.0f,0.0f,0.0f }; //速度
+		Vector3 angularVelocity = { 0.0f,0.0f,0.0f }; //角速度(ワールド座標、ラジアン/秒)
+		float mass = 1.0f; //質量(0で動かず回りもしない)
+		float inertia = 1.0f; //慣性モーメント(球のように全軸同じとみなす、0で回らない)
+		float linearDamping = 0.0f; //速度の減衰(1秒あたり)
+		float angularDamping = 0.0f; //角速度の減衰(1秒あたり)
+	};
+public://メンバ関数
+	/// <summary>
+	/// 剛体の追加
+	/// </summary>
+	/// <param name="desc">設定</param>
+	/// <returns>ハンドル</returns>
+	BodyHandle AddBody(const BodyDesc& desc);
+
+	/// <summary>
+	/// 剛体の削除
+	/// </summary>
+	/// <param name="handle">ハンドル(無効なハンドルなら何もしない)</param>
+	void RemoveBody(BodyHandle handle);
+
+	/// <summary>
+	/// ハンドルが有効か
+	/// </summary>
+	bool IsValid(BodyHandle handle) const;
+
+	/// <summary>
+	/// 全削除
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 時間を進める(IntegrateVelocitiesとIntegratePositionsを続けて行う)
+	/// </summary>
+	/// <param name="deltaTime">経過時間(秒)</param>
+	/// <param name="isParallel">JobSystemで分担するか</param>
+	void Step(float deltaTime, bool isParallel = true);
+
+	/// <summary>
+	/// 重力と加えた力で速度と角速度だけを進める(この後で拘束を解いてから位置を進める)
+	/// </summary>
+	void IntegrateVelocities(float deltaTime, bool isParallel = true);
+
+	/// <summary>
+	/// 今の速度と角速度で位置と姿勢を進める
+	/// </summary>
+	void IntegratePositions(float deltaTime, bool isParallel = true);
+
+	/// <summary>
+	/// 起きているか(眠っている剛体は力も重力も受けず動かない)
+	/// </summary>
+	bool IsAwake(BodyHandle handle) const;
+
+	/// <summary>
+	/// 起こすか眠らせる(眠らせると速度と角速度は0になる)
+	/// </summary>
+	void SetAwake(BodyHandle handle, bool isAwake);
+
+	/// <summary>
+	/// 力を加える(次のStepで使い、Stepの後に0に戻る。眠っていれば起こす)
+	/// </summary>
+	void AddForce(BodyHandle handle, const Vector3& force);
+
+	/// <summary>
+	/// トルクを加える(次のStepで使い、Stepの後に0に戻る。眠っていれば起こす)
+	/// </summary>
+	void AddTorque(BodyHandle handle, const Vector3& torque);
+
+	/// <summary>
+	/// 位置のゲッター
+	/// </summary>
+	Vector3 GetPosition(BodyHandle handle) const;
+
+	/// <summary>
+	/// 位置のセッター
+	/// </summary>
+	void SetPosition(BodyHandle handle, const Vector3& position);
+
+	/// <summary>
+	/// 姿勢のゲッター
+	/// </summary>
+	Quaternion GetOrientation(BodyHandle handle) const;
+
+	/// <summary>
+	/// 姿勢のセッター
+	/// </summary>
+	void SetOrientation(BodyHandle handle, const Quaternion& orientation);
+
+	/// <summary>
+	/// 速度のゲッター
+	/// </summary>
+	Vector3 GetVelocity(BodyHandle handle) const;
+
+	/// <summary>
+	/// 速度のセッター(眠っていれば起こす)
+	/// </summary>
+	void SetVelocity(BodyHandle handle, const Vector3& velocity);
+
+	/// <summary>
+	/// 角速度のゲッター
+	/// </summary>
+	Vector3 GetAngularVelocity(BodyHandle handle) const;
+
+	/// <summary>
+	/// 角速度のセッター(眠っていれば起こす)
+	/// </summary>
+	void SetAngularVelocity(BodyHandle handle, const Vector3& angularVelocity);
+
+	/// <summary>
+	/// 質量の逆数のゲッター(動かない剛体は0)
+	/// </summary>
+	float GetInverseMass(BodyHandle handle) const;
+
+	/// <summary>
+	/// 慣性モーメントの逆数のゲッター(回らない剛体は0)
+	/// </summary>
+	float GetInverseInertia(BodyHandle handle) const;
+
+	/// <summary>
+	/// ワールド行列(拡縮なし)
+	/// </summary>
+	Matrix4x4 GetWorldMatrix(BodyHandle handle) const;
+
+	/// <summary>
+	/// 重力のセッター
+	/// </summary>
+	void SetGravity(const Vector3& gravity) { gravity_ = gravity; }
+
+	/// <summary>
+	/// 剛体数のゲッター
+	/// </summary>
+	size_t GetBodyCount() const { return inverseMass_.size(); }
+
+	/// <summary>
+	/// 配列での番号(ハンドルが有効な間でも、削除で変わることがある)
+	/// </summary>
+	uint32_t GetDenseIndex(BodyHandle handle) const;
+public://定数
+	//1区間の最小の剛体数
+	static inline const size_t kMinBatchSize = 4096;
+	//続けて積分する剛体数(成分ごとの配列がキャッシュに乗る大きさ)
+	static inline const size_t kBlockSize = 1024;
+private://メンバ関数
+	/// <summary>
+	/// [begin, end)の剛体の速度を積分する
+	/// </summary>
+	void IntegrateVelocityRange(size_t begin, size_t end, float deltaTime);
+
+	/// <summary>
+	/// [begin, end)の剛体の位置を積分する
+	/// </summary>
+	void IntegratePositionRange(size_t begin, size_t end, float deltaTime);
+
+	/// <summary>
+	/// 剛体を区間に分けて処理する(少なければその場で処理する)
+	/// </summary>
+	/// <param name="function">void(size_t begin, size_t end) 区間の処理</param>
+	template<class Function>
+	void ForEachRange(bool isParallel, Function function);
+private://メンバ変数
+	Vector3 gravity_ = { 0.0f,-9.8f,0.0f }; //重力加速度
+
+	//成分ごとの配列(番号は詰めた順)
+	std::vector<float> position_[3]; //位置(x,y,z)
+	std::vector<float> orientation_[4]; //姿勢(x,y,z,w)
+	std::vector<float> velocity_[3]; //速度(x,y,z)
+	std::vector<float> angularVelocity_[3]; //角速度(x,y,z)
+	std::vector<float> force_[3]; //加えた力(x,y,z)
+	std::vector<float> torque_[3]; //加えたトルク(x,y,z)
+	std::vector<float> inverseMass_; //質量の逆数
+	std::vector<float> inverseInertia_; //慣性モーメントの逆数
+	std::vector<float> linearDamping_; //速度の減衰
+	std::vector<float> angularDamping_; //角速度の減衰
+	std::vector<float> awake_; //起きていれば1、眠っていれば0(掛けるだけで済むようにfloatで持つ)
+
+	//ハンドルと配列の番号の対応
+	std::vector<uint32_t> slotToDense_; //スロットから配列の番号(空きスロットは次の空きスロット)
+	std::vector<uint32_t> slotGeneration_; //スロットの世代
+	std::vector<uint32_t> denseToSlot_; //配列の番号からスロット
+	uint32_t freeSlot_ = 0xFFFFFFFFu; //空きスロットの先頭
+};
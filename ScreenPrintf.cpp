@@ -1,6 +1,37 @@
 ﻿#include "ScreenPrintf.h"
-#include <Novice.h>
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+
+namespace {
+	/// <summary>
+	/// 文字列を書き込む(入りきらない分は切り捨てる)
+	/// </summary>
+	/// <returns>書き込んだ末尾</returns>
+	char* WriteText(char* first, char* last, std::string_view text) {
+		return std::copy_n(text.data(), std::min(text.size(), static_cast<size_t>(last - first)), first);
+	}
+
+	/// <summary>
+	/// 名前と整数を書き込む(入りきらない分は切り捨てる)
+	/// </summary>
+	/// <returns>書き込んだ末尾</returns>
+	char* WriteField(char* first, char* last, std::string_view name, uint64_t value) {
+		first = WriteText(first, last, name);
+		const std::to_chars_result result = std::to_chars(first, last, value);
+		return result.ec == std::errc() ? result.ptr : first;
+	}
+
+	/// <summary>
+	/// 名前と小数(小数点以下なし)を書き込む(入りきらない分は切り捨てる)
+	/// </summary>
+	/// <returns>書き込んだ末尾</returns>
+	char* WriteField(char* first, char* last, std::string_view name, double value) {
+		first = WriteText(first, last, name);
+		const std::to_chars_result result = std::to_chars(first, last, value, std::chars_format::fixed, 0);
+		return result.ec == std::errc() ? result.ptr : first;
+	}
+}
 
 //インスタンスのゲッター
 ScreenPrintf* ScreenPrintf::GetInstance() {
@@ -11,21 +42,72 @@ ScreenPrintf* ScreenPrintf::GetInstance() {
 	return instance;
 }
 
+//フレームの開始
+void ScreenPrintf::BeginFrame() {
+	debugText_.BeginFrame();
+}
+
+//描画先の設定
+void ScreenPrintf::SetDrawBackend(DrawBackend* drawBackend) {
+	drawBackend_ = drawBackend != nullptr ? drawBackend : &noviceDrawBackend_;
+}
+
 //ベクトルのスクリーンプリント
 void ScreenPrintf::VectorScreenPrintf(int x, int y, const Vector3& vector, const char* label) {
-	Novice::ScreenPrintf(x, y, "%.02f", vector.x);
-	Novice::ScreenPrintf(x + kColumnWidth, y, "%.02f", vector.y);
-	Novice::ScreenPrintf(x + kColumnWidth * 2, y, "%.02f", vector.z);
-	Novice::ScreenPrintf(x + kColumnWidth * 3, y, "%s", label);
+	const size_t firstLine = debugText_.GetLines().size();
+	debugText_.AddVector(x, y, vector, label);
+	PrintLines(firstLine);
 }
 
 //行列のスクリーンプリント
 void ScreenPrintf::MatrixScreenPrintf(int x, int y, const Matrix4x4& matrix, const char* label){
-	Novice::ScreenPrintf(x, y, "%s", label);
-	for (int row = 0; row < 4; row++) {
-		for (int col = 0; col < 4; col++) {
-			Novice::ScreenPrintf(x + col * kColumnWidth, (y + row * kRowHeight) + 20, "%6.02f", matrix.m[row][col]);
-		}
+	const size_t firstLine = debugText_.GetLines().size();
+	debugText_.AddMatrix(x, y, matrix, label);
+	PrintLines(firstLine);
+}
+
+//ベクトルの表のスクリーンプリント
+void ScreenPrintf::VectorTableScreenPrintf(int x, int y, std::span<const Vector3> vectors, std::span<const char* const> labels) {
+	const size_t firstLine = debugText_.GetLines().size();
+	debugText_.AddVectorTable(x, y, vectors, labels);
+	PrintLines(firstLine);
+}
+
+//行列の表のスクリーンプリント
+void ScreenPrintf::MatrixTableScreenPrintf(int x, int y, std::span<const Matrix4x4> matrices, std::span<const char* const> labels, size_t columnCount) {
+	const size_t firstLine = debugText_.GetLines().size();
+	debugText_.AddMatrixTable(x, y, matrices, labels, columnCount);
+	PrintLines(firstLine);
+}
+
+//描画統計のスクリーンプリント
+void ScreenPrintf::RenderStatsScreenPrintf(int x, int y, const RenderStats::FrameStats& stats) {
+	using Counter = RenderStats::Counter;
+	const size_t firstLine = debugText_.GetLines().size();
+	char buffer[DebugText::kColumnWidth * 2];
+	char* const last = buffer + sizeof(buffer);
+	char* it = WriteField(buffer, last, "transform:", stats.Get(Counter::kTransform));
+	it = WriteField(it, last, " mul:", stats.Get(Counter::kMatrixMultiply));
+	it = WriteField(it, last, " inv:", stats.Get(Counter::kMatrixInverse));
+	debugText_.AddText(x, y, std::string_view(buffer, static_cast<size_t>(it - buffer)));
+	it = WriteField(buffer, last, "line:", stats.Get(Counter::kDrawLine));
+	it = WriteField(it, last, " tri:", stats.Get(Counter::kDrawTriangle));
+	it = WriteField(it, last, " length:", stats.lineLength);
+	it = WriteText(it, last, "px");
+	debugText_.AddText(x, y + kRowHeight, std::string_view(buffer, static_cast<size_t>(it - buffer)));
+	it = WriteField(buffer, last, "culled:", stats.Get(Counter::kCulled));
+	it = WriteField(it, last, " clipped:", stats.Get(Counter::kClipped));
+	it = WriteField(it, last, " printf:", stats.Get(Counter::kScreenPrintf));
+	debugText_.AddText(x, y + kRowHeight * 2, std::string_view(buffer, static_cast<size_t>(it - buffer)));
+	PrintLines(firstLine);
+}
+
+//追加した行を描画先に表示する
+void ScreenPrintf::PrintLines(size_t firstLine) {
+	const std::vector<DebugText::Line>& lines = debugText_.GetLines();
+	RenderStats::Add(RenderStats::Counter::kScreenPrintf, lines.size() - firstLine);
+	for (size_t i = firstLine; i < lines.size(); i++) {
+		drawBackend_->DrawString(lines[i].x, lines[i].y, debugText_.GetText(lines[i]));
 	}
 }
 
@@ -1,5 +1,9 @@
 #pragma once
 #include "MathData.h"
+#include "RenderStats.h"
+#include "DebugText.h"
+#include "NoviceDrawBackend.h"
+#include <span>
 
 //スクリーンプリント
 class ScreenPrintf {
@@ -10,6 +14,17 @@ public://メンバ変数
 	/// <returns></returns>
 	static ScreenPrintf* GetInstance();
 
+	/// <summary>
+	/// フレームの開始(Novice::BeginFrameの後に呼ぶ)
+	/// </summary>
+	void BeginFrame();
+
+	/// <summary>
+	/// 描画先の設定(DrawCaptureで記録するときなど)
+	/// </summary>
+	/// <param name="drawBackend">描画先(nullptrでNoviceに戻す)</param>
+	void SetDrawBackend(DrawBackend* drawBackend);
+
 	/// <summary>
 	/// ベクトルのスクリーンプリント
 	/// </summary>
@@ -28,6 +43,33 @@ public://メンバ変数
 	/// <param name="label">ラベル</param>
 	void MatrixScreenPrintf(int x, int y, const Matrix4x4& matrix, const char* label);
 
+	/// <summary>
+	/// ベクトルの表のスクリーンプリント(1行に1つ)
+	/// </summary>
+	/// <param name="x">x</param>
+	/// <param name="y">y</param>
+	/// <param name="vectors">ベクトル</param>
+	/// <param name="labels">ラベル</param>
+	void VectorTableScreenPrintf(int x, int y, std::span<const Vector3> vectors, std::span<const char* const> labels);
+
+	/// <summary>
+	/// 行列の表のスクリーンプリント
+	/// </summary>
+	/// <param name="x">x</param>
+	/// <param name="y">y</param>
+	/// <param name="matrices">行列</param>
+	/// <param name="labels">ラベル</param>
+	/// <param name="columnCount">横に並べる数</param>
+	void MatrixTableScreenPrintf(int x, int y, std::span<const Matrix4x4> matrices, std::span<const char* const> labels, size_t columnCount);
+
+	/// <summary>
+	/// 描画統計のスクリーンプリント
+	/// </summary>
+	/// <param name="x">x</param>
+	/// <param name="y">y</param>
+	/// <param name="stats">1フレーム分の集計結果</param>
+	void RenderStatsScreenPrintf(int x, int y, const RenderStats::FrameStats& stats);
+
 	/// <summary>
 	/// 終了
 	/// </summary>
@@ -46,10 +88,20 @@ private://メンバ関数
 	ScreenPrintf(const ScreenPrintf&) = delete;
 	//代入演算子の封印
 	ScreenPrintf& operator=(const ScreenPrintf&) = delete;
+
+	/// <summary>
+	/// 追加した行を描画先に表示する
+	/// </summary>
+	/// <param name="firstLine">今回追加した最初の行</param>
+	void PrintLines(size_t firstLine);
+private://メンバ変数
+	DebugText debugText_; //表示する文字列
+	NoviceDrawBackend noviceDrawBackend_; //Noviceへの描画先
+	DrawBackend* drawBackend_ = &noviceDrawBackend_; //描画先
 public://定数
 	//列の幅
-	static inline const int kColumnWidth = 60;
+	static inline const int kColumnWidth = DebugText::kColumnWidth;
 	//行の幅
-	static inline const int kRowHeight = 20;
+	static inline const int kRowHeight = DebugText::kRowHeight;
 };
 
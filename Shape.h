@@ -0,0 +1,183 @@
+#pragma once
+#include "MathData.h"
+#include <cstddef>
+#include <vector>
+
+//球のデータ
+struct SphereData {
+	Vector3 center; //中心座標
+	float radius;   //半径
+};
+
+//平面
+struct Plane {
+	Vector3 normal; //法線
+	float distance; //原点からの距離
+};
+
+//軸平行境界箱
+struct AABB {
+	Vector3 min; //最小点
+	Vector3 max; //最大点
+};
+
+//有向境界箱
+struct OBB {
+	Vector3 center;          //中心点
+	Vector3 orientations[3]; //座標軸(Rendering::MakeOBBRotateMatrixで作る)
+	Vector3 size;            //座標軸方向の長さの半分
+};
+
+//視錐台(法線は内側向き)
+struct Frustum {
+	Plane planes[6]; //左,右,下,上,近,遠
+};
+
+//半直線
+struct Ray {
+	Vector3 origin; //始点
+	Vector3 diff;   //方向
+};
+
+//線分
+struct Segment {
+	Vector3 origin; //始点
+	Vector3 diff;   //終点への差分ベクトル
+};
+
+//カプセル
+struct Capsule {
+	Segment segment; //中心の線分
+	float radius;    //半径
+};
+
+//円柱
+struct Cylinder {
+	Vector3 center;   //中心点
+	Vector3 axis;     //軸(正規化したもの)
+	float halfHeight; //軸方向の長さの半分
+	float radius;     //半径
+};
+
+//楕円体
+struct Ellipsoid {
+	Vector3 center;          //中心点
+	Vector3 orientations[3]; //座標軸(Rendering::MakeOBBRotateMatrixで作る)
+	Vector3 radius;          //座標軸方向の半径
+};
+
+//凸包
+struct ConvexHull {
+	std::vector<Vector3> vertices; //頂点(ワールド座標)
+};
+
+/// <summary>
+/// 球の集合(成分ごとに並べて一括判定に使う)
+/// </summary>
+struct SphereSet {
+	std::vector<float> center[3]; //中心座標(x,y,z)
+	std::vector<float> radius;    //半径
+
+	//追加
+	void Add(const SphereData& sphere) {
+		center[0].push_back(sphere.center.x);
+		center[1].push_back(sphere.center.y);
+		center[2].push_back(sphere.center.z);
+		radius.push_back(sphere.radius);
+	}
+	//全削除
+	void Clear() {
+		for (std::vector<float>& c : center) {
+			c.clear();
+		}
+		radius.clear();
+	}
+	//数
+	size_t Size() const { return radius.size(); }
+};
+
+/// <summary>
+/// 平面の集合
+/// </summary>
+struct PlaneSet {
+	std::vector<float> normal[3]; //法線(x,y,z)
+	std::vector<float> distance;  //原点からの距離
+
+	//追加
+	void Add(const Plane& plane) {
+		normal[0].push_back(plane.normal.x);
+		normal[1].push_back(plane.normal.y);
+		normal[2].push_back(plane.normal.z);
+		distance.push_back(plane.distance);
+	}
+	//全削除
+	void Clear() {
+		for (std::vector<float>& n : normal) {
+			n.clear();
+		}
+		distance.clear();
+	}
+	//数
+	size_t Size() const { return distance.size(); }
+};
+
+/// <summary>
+/// AABBの集合
+/// </summary>
+struct AABBSet {
+	std::vector<float> min[3]; //最小点(x,y,z)
+	std::vector<float> max[3]; //最大点(x,y,z)
+
+	//追加
+	void Add(const AABB& aabb) {
+		min[0].push_back(aabb.min.x);
+		min[1].push_back(aabb.min.y);
+		min[2].push_back(aabb.min.z);
+		max[0].push_back(aabb.max.x);
+		max[1].push_back(aabb.max.y);
+		max[2].push_back(aabb.max.z);
+	}
+	//全削除
+	void Clear() {
+		for (int i = 0; i < 3; i++) {
+			min[i].clear();
+			max[i].clear();
+		}
+	}
+	//数
+	size_t Size() const { return min[0].size(); }
+};
+
+/// <summary>
+/// OBBの集合
+/// </summary>
+struct OBBSet {
+	std::vector<float> center[3];          //中心点(x,y,z)
+	std::vector<float> orientations[3][3]; //座標軸([軸][x,y,z])
+	std::vector<float> size[3];            //座標軸方向の長さの半分
+
+	//追加
+	void Add(const OBB& obb) {
+		const float centers[3] = { obb.center.x,obb.center.y,obb.center.z };
+		const float sizes[3] = { obb.size.x,obb.size.y,obb.size.z };
+		for (int i = 0; i < 3; i++) {
+			center[i].push_back(centers[i]);
+			size[i].push_back(sizes[i]);
+			orientations[i][0].push_back(obb.orientations[i].x);
+			orientations[i][1].push_back(obb.orientations[i].y);
+			orientations[i][2].push_back(obb.orientations[i].z);
+		}
+	}
+	//全削除
+	void Clear() {
+		for (int i = 0; i < 3; i++) {
+			center[i].clear();
+			size[i].clear();
+			for (int j = 0; j < 3; j++) {
+				orientations[i][j].clear();
+			}
+		}
+	}
+	//数
+	size_t Size() const { return center[0].size(); }
+};
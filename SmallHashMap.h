@@ -0,0 +1,237 @@
+#pragma once
+#include "FrameAllocator.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+/// <summary>
+/// 小さなハッシュ表(開番地法・線形探索)
+/// </summary>
+/// <remarks>
+/// キーと値はコピーするだけでよい型(番号やポインタなど)に限り、要素の並びは1つの配列に置く。
+/// 配列はAllocatorで確保するので、FrameHashMapならフレーム用の領域だけを使う。
+/// 消すときは後ろの要素を詰めるので、墓標は残らない
+/// </remarks>
+template<class Key, class Value, class Hash = std::hash<Key>, class Allocator = std::allocator<std::pair<Key, Value>>>
+class SmallHashMap {
+	static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>,
+		"SmallHashMap only holds trivially copyable keys and values");
+private://構造体
+	/// <summary>
+	/// 表の1マス
+	/// </summary>
+	struct Slot {
+		Key key; //キー
+		Value value; //値
+		bool isUsed; //使っているか
+	};
+
+	using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+	using SlotTraits = std::allocator_traits<SlotAllocator>;
+public://メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="allocator">配列を確保するアロケータ</param>
+	explicit SmallHashMap(const Allocator& allocator = Allocator()) : allocator_(allocator) {}
+
+	/// <summary>
+	/// デストラクタ
+	/// </summary>
+	~SmallHashMap() { Deallocate(); }
+
+	//コピーの禁止
+	SmallHashMap(const SmallHashMap&) = delete;
+	SmallHashMap& operator=(const SmallHashMap&) = delete;
+
+	/// <summary>
+	/// 探す
+	/// </summary>
+	/// <returns>値(なければnullptr)</returns>
+	Value* Find(const Key& key) {
+		if (size_ == 0) {
+			return nullptr;
+		}
+		for (size_t i = Home(key);; i = (i + 1) & mask_) {
+			if (!slots_[i].isUsed) {
+				return nullptr;
+			}
+			if (slots_[i].key == key) {
+				return &slots_[i].value;
+			}
+		}
+	}
+
+	/// <summary>
+	/// 探す(const版)
+	/// </summary>
+	const Value* Find(const Key& key) const { return const_cast<SmallHashMap*>(this)->Find(key); }
+
+	/// <summary>
+	/// 入れる(あれば上書きする)
+	/// </summary>
+	/// <returns>入れた値</returns>
+	Value& Insert(const Key& key, const Value& value) {
+		Value& slotValue = (*this)[key];
+		slotValue = value;
+		return slotValue;
+	}
+
+	/// <summary>
+	/// 値のゲッター(なければ値を初期化して入れる)
+	/// </summary>
+	Value& operator[](const Key& key) {
+		//埋まっている割合をkMaxLoadPercent以下に保つ
+		if ((size_ + 1) * 100 > capacity_ * kMaxLoadPercent) {
+			Rehash(capacity_ == 0 ? kMinCapacity : capacity_ * 2);
+		}
+		size_t i = Home(key);
+		for (; slots_[i].isUsed; i = (i + 1) & mask_) {
+			if (slots_[i].key == key) {
+				return slots_[i].value;
+			}
+		}
+		slots_[i] = Slot{ key, Value{}, true };
+		size_++;
+		return slots_[i].value;
+	}
+
+	/// <summary>
+	/// 消す
+	/// </summary>
+	/// <returns>あったか</returns>
+	bool Erase(const Key& key) {
+		if (size_ == 0) {
+			return false;
+		}
+		size_t hole = Home(key);
+		for (;; hole = (hole + 1) & mask_) {
+			if (!slots_[hole].isUsed) {
+				return false;
+			}
+			if (slots_[hole].key == key) {
+				break;
+			}
+		}
+		//空いたマスより前に本来の位置がある要素を詰める
+		for (size_t i = (hole + 1) & mask_; slots_[i].isUsed; i = (i + 1) & mask_) {
+			const size_t home = Home(slots_[i].key);
+			if (((i - home) & mask_) >= ((i - hole) & mask_)) {
+				slots_[hole] = slots_[i];
+				hole = i;
+			}
+		}
+		slots_[hole].isUsed = false;
+		size_--;
+		return true;
+	}
+
+	/// <summary>
+	/// 入れる前に表を広げておく
+	/// </summary>
+	/// <param name="count">要素数</param>
+	void Reserve(size_t count) {
+		const size_t required = std::bit_ceil((count * 100 + kMaxLoadPercent - 1) / kMaxLoadPercent + 1);
+		if (required > capacity_) {
+			Rehash(required < kMinCapacity ? kMinCapacity : required);
+		}
+	}
+
+	/// <summary>
+	/// すべて消す(表の大きさはそのまま)
+	/// </summary>
+	void Clear() {
+		for (size_t i = 0; i < capacity_; i++) {
+			slots_[i].isUsed = false;
+		}
+		size_ = 0;
+	}
+
+	/// <summary>
+	/// すべての要素に対して呼ぶ
+	/// </summary>
+	/// <param name="function">function(const Key&, Value&)</param>
+	template<class Function>
+	void ForEach(Function&& function) {
+		for (size_t i = 0; i < capacity_; i++) {
+			if (slots_[i].isUsed) {
+				function(static_cast<const Key&>(slots_[i].key), slots_[i].value);
+			}
+		}
+	}
+
+	/// <summary>
+	/// 要素数のゲッター
+	/// </summary>
+	size_t GetSize() const { return size_; }
+
+	/// <summary>
+	/// 表の大きさのゲッター
+	/// </summary>
+	size_t GetCapacity() const { return capacity_; }
+public://定数
+	//表の最小の大きさ
+	static inline const size_t kMinCapacity = 16;
+	//埋まっている割合の上限(%)
+	static inline const size_t kMaxLoadPercent = 75;
+private://メンバ関数
+	/// <summary>
+	/// キーの本来の位置
+	/// </summary>
+	size_t Home(const Key& key) const {
+		//弱いハッシュ(整数そのままなど)でも散らばるように混ぜる
+		return static_cast<size_t>((static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+	}
+
+	/// <summary>
+	/// 表を作り直す
+	/// </summary>
+	/// <param name="capacity">新しい大きさ(2のべき乗)</param>
+	void Rehash(size_t capacity) {
+		Slot* oldSlots = slots_;
+		const size_t oldCapacity = capacity_;
+		slots_ = SlotTraits::allocate(allocator_, capacity);
+		capacity_ = capacity;
+		mask_ = capacity - 1;
+		for (size_t i = 0; i < capacity_; i++) {
+			slots_[i].isUsed = false;
+		}
+		for (size_t i = 0; i < oldCapacity; i++) {
+			if (oldSlots[i].isUsed) {
+				size_t j = Home(oldSlots[i].key);
+				while (slots_[j].isUsed) {
+					j = (j + 1) & mask_;
+				}
+				slots_[j] = oldSlots[i];
+			}
+		}
+		if (oldSlots != nullptr) {
+			SlotTraits::deallocate(allocator_, oldSlots, oldCapacity);
+		}
+	}
+
+	/// <summary>
+	/// 表を解放する
+	/// </summary>
+	void Deallocate() {
+		if (slots_ != nullptr) {
+			SlotTraits::deallocate(allocator_, slots_, capacity_);
+			slots_ = nullptr;
+		}
+	}
+private://メンバ変数
+	SlotAllocator allocator_; //表を確保するアロケータ
+	Slot* slots_ = nullptr; //表
+	size_t capacity_ = 0; //表の大きさ(2のべき乗)
+	size_t mask_ = 0; //表の大きさ-1
+	size_t size_ = 0; //要素数
+};
+
+/// <summary>
+/// フレーム用の領域から確保するハッシュ表
+/// </summary>
+template<class Key, class Value, class Hash = std::hash<Key>>
+using FrameHashMap = SmallHashMap<Key, Value, Hash, ArenaAllocator<std::pair<Key, Value>>>;
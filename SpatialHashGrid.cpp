@@ -0,0 +1,213 @@
+#include "SpatialHashGrid.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+//作り直し
+void SpatialHashGrid::Build(const SphereSet& spheres, float cellSize, bool isParallel) {
+	const size_t count = spheres.Size();
+	assert(count <= UINT32_MAX);
+
+	//セルの大きさと探索範囲
+	maxRadius_ = 0.0f;
+	for (float radius : spheres.radius) {
+		maxRadius_ = std::max(maxRadius_, radius);
+	}
+	cellSize_ = cellSize > 0.0f ? cellSize : ComputeCellSize(spheres);
+	inverseCellSize_ = 1.0f / cellSize_;
+	int32_t searchRange = std::max(static_cast<int32_t>(std::ceil(2.0f * maxRadius_ * inverseCellSize_)), 1);
+	if (searchRange != searchRange_ || forwardRows_.empty()) {
+		//辞書順で(0,0,0)より後ろのセルだけ見れば組は1回ずつ見つかる
+		//x方向に並んだセルはハッシュ表でも隣り合うので、行ごとにまとめて走査する
+		searchRange_ = searchRange;
+		forwardRows_.clear();
+		forwardRows_.push_back({ 0, 0, 1, searchRange_ });
+		for (int32_t z = 0; z <= searchRange_; z++) {
+			for (int32_t y = z == 0 ? 1 : -searchRange_; y <= searchRange_; y++) {
+				forwardRows_.push_back({ y, z, -searchRange_, searchRange_ });
+			}
+		}
+	}
+
+	//ハッシュ表は要素数以上の2のべき乗(上限を超える数なら1つの添字に複数のセルが入るだけで、結果は変わらない)
+	const uint32_t bucketCount = static_cast<uint32_t>(std::bit_ceil(std::clamp<size_t>(count, 1, kMaxBucketCount)));
+	bucketMask_ = bucketCount - 1;
+
+	//区間ごとに個数を数え、区間の順に並べることで並列でも結果が同じになる
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	const size_t taskCount = isParallel && count >= kParallelThreshold ? jobSystem->GetThreadCount() : 1;
+	const size_t taskSize = (count + taskCount - 1) / taskCount;
+	auto runTasks = [&](FunctionRef<void(size_t)> task) {
+		if (taskCount == 1) {
+			task(0);
+			return;
+		}
+		jobSystem->ParallelFor(taskCount, 1, [&](size_t begin, size_t end) {
+			for (size_t t = begin; t < end; t++) {
+				task(t);
+			}
+			});
+		};
+
+	bucketOfElement_.resize(count);
+	taskHistograms_.assign(taskCount * bucketCount, 0);
+	const float* centerX = spheres.center[0].data();
+	const float* centerY = spheres.center[1].data();
+	const float* centerZ = spheres.center[2].data();
+
+	//添字を求めて数える
+	runTasks([&](size_t task) {
+		uint32_t* histogram = taskHistograms_.data() + task * bucketCount;
+		size_t end = std::min(count, (task + 1) * taskSize);
+		for (size_t i = task * taskSize; i < end; i++) {
+			uint32_t bucket = HashCell(ToCell(centerX[i]), ToCell(centerY[i]), ToCell(centerZ[i]));
+			bucketOfElement_[i] = bucket;
+			histogram[bucket]++;
+		}
+		});
+
+	//添字ごとの先頭と、区間ごとの書き込み位置
+	bucketStart_.resize(bucketCount + 1);
+	uint32_t offset = 0;
+	for (uint32_t bucket = 0; bucket < bucketCount; bucket++) {
+		bucketStart_[bucket] = offset;
+		for (size_t task = 0; task < taskCount; task++) {
+			uint32_t& histogram = taskHistograms_[task * bucketCount + bucket];
+			uint32_t n = histogram;
+			histogram = offset;
+			offset += n;
+		}
+	}
+	bucketStart_[bucketCount] = offset;
+
+	//並べ替え
+	sortedIndex_.resize(count);
+	sortedRadius_.resize(count);
+	for (int axis = 0; axis < 3; axis++) {
+		sortedCenter_[axis].resize(count);
+		sortedCell_[axis].resize(count);
+	}
+	runTasks([&](size_t task) {
+		uint32_t* writeOffset = taskHistograms_.data() + task * bucketCount;
+		size_t end = std::min(count, (task + 1) * taskSize);
+		for (size_t i = task * taskSize; i < end; i++) {
+			uint32_t to = writeOffset[bucketOfElement_[i]]++;
+			sortedIndex_[to] = static_cast<uint32_t>(i);
+			sortedRadius_[to] = spheres.radius[i];
+			sortedCenter_[0][to] = centerX[i];
+			sortedCenter_[1][to] = centerY[i];
+			sortedCenter_[2][to] = centerZ[i];
+			sortedCell_[0][to] = ToCell(centerX[i]);
+			sortedCell_[1][to] = ToCell(centerY[i]);
+			sortedCell_[2][to] = ToCell(centerZ[i]);
+		}
+		});
+}
+
+//重なっている組をすべて求める
+void SpatialHashGrid::FindPairs(std::vector<NeighborPair>& pairs, bool isParallel) {
+	pairs.clear();
+	const size_t count = sortedIndex_.size();
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	if (!isParallel || count < kParallelThreshold || jobSystem->GetThreadCount() == 1) {
+		FindPairsInRange(0, count, pairs);
+		return;
+	}
+
+	//区間ごとに書き込んでからつなげる
+	const size_t taskCount = jobSystem->GetThreadCount() * 4;
+	const size_t taskSize = (count + taskCount - 1) / taskCount;
+	taskPairs_.resize(taskCount);
+	jobSystem->ParallelFor(taskCount, 1, [&](size_t begin, size_t end) {
+		for (size_t task = begin; task < end; task++) {
+			taskPairs_[task].clear();
+			FindPairsInRange(std::min(count, task * taskSize), std::min(count, (task + 1) * taskSize), taskPairs_[task]);
+		}
+		});
+	for (const std::vector<NeighborPair>& taskPairs : taskPairs_) {
+		pairs.insert(pairs.end(), taskPairs.begin(), taskPairs.end());
+	}
+}
+
+//セルの大きさを決める
+float SpatialHashGrid::ComputeCellSize(const SphereSet& spheres) {
+	float maxRadius = 0.0f;
+	for (float radius : spheres.radius) {
+		maxRadius = std::max(maxRadius, radius);
+	}
+	return maxRadius > 0.0f ? 2.0f * maxRadius : 1.0f;
+}
+
+//セル座標
+int32_t SpatialHashGrid::ToCell(float position) const {
+	//NaNは原点のセルに、範囲外は端のセルにまとめる(そのままキャストすると未定義動作になる)
+	const float cell = std::floor(position * inverseCellSize_);
+	if (std::isnan(cell)) {
+		return 0;
+	}
+	return static_cast<int32_t>(std::clamp(cell, -kMaxCellCoordinate, kMaxCellCoordinate));
+}
+
+//セル座標からハッシュ表の添字を求める
+uint32_t SpatialHashGrid::HashCell(int32_t x, int32_t y, int32_t z) const {
+	uint32_t hash = static_cast<uint32_t>(x) + static_cast<uint32_t>(y) * 0x9E3779B1u + static_cast<uint32_t>(z) * 0x85EBCA77u;
+	return hash & bucketMask_;
+}
+
+//セル順に並べた区間の要素の組を探す
+void SpatialHashGrid::FindPairsInRange(size_t begin, size_t end, std::vector<NeighborPair>& pairs) const {
+	//距離を調べて組を追加する
+	auto test = [&](size_t i, size_t j) {
+		float dx = sortedCenter_[0][j] - sortedCenter_[0][i];
+		float dy = sortedCenter_[1][j] - sortedCenter_[1][i];
+		float dz = sortedCenter_[2][j] - sortedCenter_[2][i];
+		float r = sortedRadius_[i] + sortedRadius_[j];
+		if (dx * dx + dy * dy + dz * dz <= r * r) {
+			uint32_t a = sortedIndex_[i];
+			uint32_t b = sortedIndex_[j];
+			pairs.push_back({ std::min(a, b), std::max(a, b) });
+		}
+		};
+
+	const uint32_t bucketCount = bucketMask_ + 1;
+	for (size_t i = begin; i < end; i++) {
+		const int32_t cellX = sortedCell_[0][i], cellY = sortedCell_[1][i], cellZ = sortedCell_[2][i];
+
+		//同じセルで後ろにある要素
+		uint32_t bucket = HashCell(cellX, cellY, cellZ);
+		for (size_t j = i + 1; j < bucketStart_[bucket + 1]; j++) {
+			if (sortedCell_[0][j] == cellX && sortedCell_[1][j] == cellY && sortedCell_[2][j] == cellZ) {
+				test(i, j);
+			}
+		}
+
+		//前方の行の要素
+		for (const ForwardRow& row : forwardRows_) {
+			const int32_t y = cellY + row.offsetY;
+			const int32_t z = cellZ + row.offsetZ;
+			const int32_t minX = cellX + row.minOffsetX;
+			const int32_t maxX = cellX + row.maxOffsetX;
+			auto scan = [&](uint32_t firstBucket, uint32_t lastBucket) {
+				for (size_t j = bucketStart_[firstBucket]; j < bucketStart_[lastBucket + 1]; j++) {
+					if (sortedCell_[1][j] == y && sortedCell_[2][j] == z && minX <= sortedCell_[0][j] && sortedCell_[0][j] <= maxX) {
+						test(i, j);
+					}
+				}
+				};
+			uint32_t firstBucket = HashCell(minX, y, z);
+			uint32_t lastBucket = firstBucket + static_cast<uint32_t>(maxX - minX);
+			if (static_cast<uint32_t>(maxX - minX) >= bucketMask_) {
+				//行がハッシュ表より長ければ全体を1回だけ見る
+				scan(0, bucketMask_);
+			} else if (lastBucket < bucketCount) {
+				scan(firstBucket, lastBucket);
+			} else {
+				//ハッシュ表の端で折り返す
+				scan(firstBucket, bucketCount - 1);
+				scan(0, lastBucket - bucketCount);
+			}
+		}
+	}
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include "Shape.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 一様グリッド(ハッシュ)による近傍探索
+/// </summary>
+/// <remarks>
+/// 半径のそろった大量の球向け。毎フレーム計数ソートで作り直し、セル順に並べた配列を走査する。
+/// セルの座標をハッシュ表の添字にするので、空間の広さには制限がない
+/// </remarks>
+class SpatialHashGrid {
+public://構造体
+	/// <summary>
+	/// 重なっている球の組
+	/// </summary>
+	struct NeighborPair {
+		uint32_t indexA; //小さい方の番号
+		uint32_t indexB; //大きい方の番号
+	};
+public://メンバ関数
+	/// <summary>
+	/// 作り直し
+	/// </summary>
+	/// <param name="spheres">球の集合(番号は集合での順番)</param>
+	/// <param name="cellSize">セルの大きさ(0以下ならComputeCellSizeで決める)</param>
+	/// <param name="isParallel">JobSystemで並列に作るか</param>
+	void Build(const SphereSet& spheres, float cellSize = 0.0f, bool isParallel = true);
+
+	/// <summary>
+	/// 球と重なる要素を探す
+	/// </summary>
+	/// <param name="center">中心</param>
+	/// <param name="radius">半径</param>
+	/// <param name="callback">void(uint32_t index)</param>
+	template<class Callback>
+	void QueryRadius(const Vector3& center, float radius, Callback callback) const;
+
+	/// <summary>
+	/// 重なっている組をすべて求める
+	/// </summary>
+	/// <param name="pairs">組の書き込み先(クリアしてから書き込む、重複なし)</param>
+	/// <param name="isParallel">JobSystemで並列に探すか</param>
+	void FindPairs(std::vector<NeighborPair>& pairs, bool isParallel = true);
+
+	/// <summary>
+	/// セルの大きさを決める(一番大きい球の直径、近傍のセルだけ見れば済む)
+	/// </summary>
+	static float ComputeCellSize(const SphereSet& spheres);
+
+	/// <summary>
+	/// セルの大きさのゲッター
+	/// </summary>
+	float GetCellSize() const { return cellSize_; }
+
+	/// <summary>
+	/// 要素数のゲッター
+	/// </summary>
+	size_t GetCount() const { return sortedIndex_.size(); }
+private://構造体
+	//組を探すときに見るx方向のセルの並び
+	struct ForwardRow {
+		int32_t offsetY; //y方向のずれ
+		int32_t offsetZ; //z方向のずれ
+		int32_t minOffsetX; //x方向のずれの最小
+		int32_t maxOffsetX; //x方向のずれの最大
+	};
+private://定数
+	//並列にする最小の要素数
+	static inline const size_t kParallelThreshold = 4096;
+	//ハッシュ表の大きさの上限(区間ごとの個数を区間数×この数だけ持つので、要素が多くても大きくしすぎない)
+	static inline const size_t kMaxBucketCount = size_t(1) << 24;
+	//セル座標の絶対値の上限(探索範囲を足しても溢れないようにint32_tの範囲より狭くする)
+	static inline const float kMaxCellCoordinate = 1073741824.0f;
+private://メンバ関数
+	//セル座標
+	int32_t ToCell(float position) const;
+	//セル座標からハッシュ表の添字を求める
+	uint32_t HashCell(int32_t x, int32_t y, int32_t z) const;
+	//セル順に並べた区間[begin, end)の要素の組を探す
+	void FindPairsInRange(size_t begin, size_t end, std::vector<NeighborPair>& pairs) const;
+private://メンバ変数
+	float cellSize_ = 1.0f; //セルの大きさ
+	float inverseCellSize_ = 1.0f; //セルの大きさの逆数
+	float maxRadius_ = 0.0f; //一番大きい半径
+	int32_t searchRange_ = 1; //組を探すときに見る周囲のセル数
+	uint32_t bucketMask_ = 0; //ハッシュ表の大きさ-1
+
+	std::vector<uint32_t> bucketStart_; //ハッシュ表の添字ごとの先頭(大きさ+1個)
+	std::vector<uint32_t> sortedIndex_; //セル順に並べた元の番号
+	std::vector<float> sortedCenter_[3]; //セル順に並べた中心座標(x,y,z)
+	std::vector<float> sortedRadius_; //セル順に並べた半径
+	std::vector<int32_t> sortedCell_[3]; //セル順に並べたセル座標(ハッシュの衝突を見分ける)
+	std::vector<ForwardRow> forwardRows_; //組を探すときに見る前方の行
+
+	//作り直しの作業用
+	std::vector<uint32_t> bucketOfElement_; //要素ごとのハッシュ表の添字
+	std::vector<uint32_t> taskHistograms_; //区間ごとの個数(区間数×ハッシュ表の大きさ)
+	std::vector<std::vector<NeighborPair>> taskPairs_; //区間ごとの組
+};
+
+//球と重なる要素を探す
+template<class Callback>
+void SpatialHashGrid::QueryRadius(const Vector3& center, float radius, Callback callback) const {
+	if (sortedIndex_.empty()) {
+		return;
+	}
+	const float reach = radius + maxRadius_;
+	const int32_t minX = ToCell(center.x - reach), maxX = ToCell(center.x + reach);
+	const int32_t minY = ToCell(center.y - reach), maxY = ToCell(center.y + reach);
+	const int32_t minZ = ToCell(center.z - reach), maxZ = ToCell(center.z + reach);
+	for (int32_t z = minZ; z <= maxZ; z++) {
+		for (int32_t y = minY; y <= maxY; y++) {
+			for (int32_t x = minX; x <= maxX; x++) {
+				uint32_t bucket = HashCell(x, y, z);
+				for (uint32_t i = bucketStart_[bucket]; i < bucketStart_[bucket + 1]; i++) {
+					//同じ添字に入った別のセルの要素は飛ばす
+					if (sortedCell_[0][i] != x || sortedCell_[1][i] != y || sortedCell_[2][i] != z) {
+						continue;
+					}
+					float dx = sortedCenter_[0][i] - center.x;
+					float dy = sortedCenter_[1][i] - center.y;
+					float dz = sortedCenter_[2][i] - center.z;
+					float r = sortedRadius_[i] + radius;
+					if (dx * dx + dy * dy + dz * dz <= r * r) {
+						callback(sortedIndex_[i]);
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,230 @@
+#include "Spline.h"
+#include "MemoryTracker.h"
+#include "Rendering.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+	//向きを決められないとみなす長さの2乗
+	const float kDegenerateLengthSquared = 1.0e-12f;
+
+	/// <summary>
+	/// 長さ
+	/// </summary>
+	float Length(const Vector3& v) {
+		return std::sqrt(v.Dot(v));
+	}
+
+	/// <summary>
+	/// 正規化する(長さがなければfallback)
+	/// </summary>
+	Vector3 NormalizeOr(const Vector3& v, const Vector3& fallback) {
+		const float lengthSquared = v.Dot(v);
+		return lengthSquared > kDegenerateLengthSquared ? v / std::sqrt(lengthSquared) : fallback;
+	}
+
+	/// <summary>
+	/// vからaxis方向の成分を除いて正規化する(残らなければfallback)
+	/// </summary>
+	Vector3 Orthonormalize(const Vector3& v, const Vector3& axis, const Vector3& fallback) {
+		return NormalizeOr(v - axis * v.Dot(axis), fallback);
+	}
+
+	/// <summary>
+	/// axisに垂直な向きを1つ選ぶ
+	/// </summary>
+	Vector3 AnyPerpendicular(const Vector3& axis) {
+		const Vector3 reference = std::abs(axis.y) < 0.9f ? Vector3{ 0.0f,1.0f,0.0f } : Vector3{ 1.0f,0.0f,0.0f };
+		return axis.Cross(reference).Cross(axis).Normalize();
+	}
+}
+
+//初期化
+void Spline::Initialize(Type type, std::span<const Vector3> controlPoints) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kMath);
+	segments_.clear();
+	const size_t count = controlPoints.size();
+	switch (type) {
+	case Type::kCatmullRom:
+		assert(count >= 2);
+		for (size_t i = 0; i + 1 < count; i++) {
+			//両端は端の点を繰り返して、端の点で止まるようにする
+			const Vector3& p0 = controlPoints[i == 0 ? 0 : i - 1];
+			const Vector3& p1 = controlPoints[i];
+			const Vector3& p2 = controlPoints[i + 1];
+			const Vector3& p3 = controlPoints[std::min(i + 2, count - 1)];
+			segments_.push_back({
+				.a = (-p0 + p1 * 3.0f - p2 * 3.0f + p3) * 0.5f,
+				.b = (p0 * 2.0f - p1 * 5.0f + p2 * 4.0f - p3) * 0.5f,
+				.c = (-p0 + p2) * 0.5f,
+				.d = p1,
+				});
+		}
+		break;
+	case Type::kBezier:
+		assert(count >= 4 && (count - 1) % 3 == 0);
+		for (size_t i = 0; i + 3 < count; i += 3) {
+			const Vector3& p0 = controlPoints[i];
+			const Vector3& p1 = controlPoints[i + 1];
+			const Vector3& p2 = controlPoints[i + 2];
+			const Vector3& p3 = controlPoints[i + 3];
+			segments_.push_back({
+				.a = -p0 + p1 * 3.0f - p2 * 3.0f + p3,
+				.b = (p0 - p1 * 2.0f + p2) * 3.0f,
+				.c = (p1 - p0) * 3.0f,
+				.d = p0,
+				});
+		}
+		break;
+	case Type::kBSpline:
+		assert(count >= 4);
+		for (size_t i = 0; i + 3 < count; i++) {
+			const Vector3& p0 = controlPoints[i];
+			const Vector3& p1 = controlPoints[i + 1];
+			const Vector3& p2 = controlPoints[i + 2];
+			const Vector3& p3 = controlPoints[i + 3];
+			segments_.push_back({
+				.a = (-p0 + p1 * 3.0f - p2 * 3.0f + p3) / 6.0f,
+				.b = (p0 - p1 * 2.0f + p2) * 0.5f,
+				.c = (p2 - p0) * 0.5f,
+				.d = (p0 + p1 * 4.0f + p2) / 6.0f,
+				});
+		}
+		break;
+	}
+	BuildDistanceTable();
+}
+
+//媒介変数での位置
+Vector3 Spline::Evaluate(float parameter) const {
+	float t = 0.0f;
+	const Segment& segment = FindSegment(parameter, t);
+	return ((segment.a * t + segment.b) * t + segment.c) * t + segment.d;
+}
+
+//媒介変数での微分
+Vector3 Spline::EvaluateDerivative(float parameter) const {
+	float t = 0.0f;
+	const Segment& segment = FindSegment(parameter, t);
+	return (segment.a * (3.0f * t) + segment.b * 2.0f) * t + segment.c;
+}
+
+//道のりを媒介変数にする
+float Spline::DistanceToParameter(float distance) const {
+	if (length_ <= 0.0f) {
+		return 0.0f;
+	}
+	//表は等間隔なので、割り算で番号が決まる
+	const float position = std::clamp(distance, 0.0f, length_) / tableStep_;
+	const size_t lastIndex = parameterTable_.size() - 2;
+	const size_t index = std::min(static_cast<size_t>(position), lastIndex);
+	const float fraction = position - static_cast<float>(index);
+	return parameterTable_[index] + (parameterTable_[index + 1] - parameterTable_[index]) * fraction;
+}
+
+//等間隔に点を取る
+void Spline::SamplePoints(std::span<Vector3> points) const {
+	if (points.empty()) {
+		return;
+	}
+	const float step = points.size() > 1 ? length_ / static_cast<float>(points.size() - 1) : 0.0f;
+	for (size_t i = 0; i < points.size(); i++) {
+		points[i] = EvaluateByDistance(step * static_cast<float>(i));
+	}
+}
+
+//等間隔に位置と向きを取る
+void Spline::MakeFrames(std::span<Frame> frames, FrameMode mode, const Vector3& up) const {
+	if (frames.empty()) {
+		return;
+	}
+	const float step = frames.size() > 1 ? length_ / static_cast<float>(frames.size() - 1) : 0.0f;
+	Vector3 previousTangent = { 0.0f,0.0f,1.0f };
+	for (size_t i = 0; i < frames.size(); i++) {
+		const float parameter = DistanceToParameter(step * static_cast<float>(i));
+		Frame& frame = frames[i];
+		frame.position = Evaluate(parameter);
+		//止まっている点では前の向きを使う
+		frame.tangent = NormalizeOr(EvaluateDerivative(parameter), previousTangent);
+		previousTangent = frame.tangent;
+
+		if (i == 0) {
+			frame.normal = Orthonormalize(up, frame.tangent, AnyPerpendicular(frame.tangent));
+		} else if (mode == FrameMode::kParallelTransport) {
+			//二重反射法:前の点から今の点への反射で法線を運び、接線を合わせる反射でもう一度直す
+			const Frame& previous = frames[i - 1];
+			const Vector3 v1 = frame.position - previous.position;
+			const float c1 = v1.Dot(v1);
+			Vector3 normal = previous.normal;
+			Vector3 tangent = previous.tangent;
+			if (c1 > kDegenerateLengthSquared) {
+				normal = normal - v1 * (2.0f / c1 * v1.Dot(normal));
+				tangent = tangent - v1 * (2.0f / c1 * v1.Dot(tangent));
+			}
+			const Vector3 v2 = frame.tangent - tangent;
+			const float c2 = v2.Dot(v2);
+			if (c2 > kDegenerateLengthSquared) {
+				normal = normal - v2 * (2.0f / c2 * v2.Dot(normal));
+			}
+			frame.normal = Orthonormalize(normal, frame.tangent, AnyPerpendicular(frame.tangent));
+		} else {
+			//曲がる向き(2階微分の接線に垂直な成分)を法線にし、まっすぐな所では前の法線を使う
+			float t = 0.0f;
+			const Segment& segment = FindSegment(parameter, t);
+			const Vector3 secondDerivative = segment.a * (6.0f * t) + segment.b * 2.0f;
+			const Vector3 previousNormal = Orthonormalize(frames[i - 1].normal, frame.tangent, AnyPerpendicular(frame.tangent));
+			frame.normal = Orthonormalize(secondDerivative, frame.tangent, previousNormal);
+		}
+		frame.binormal = frame.normal.Cross(frame.tangent);
+	}
+}
+
+//向きをカメラの回転にする
+Vector3 Spline::FrameToRotate(const Frame& frame) {
+	Matrix4x4 rotateMatrix = Matrix4x4::Identity4x4();
+	const Vector3 rows[3] = { frame.binormal,frame.normal,frame.tangent };
+	for (int row = 0; row < 3; row++) {
+		rotateMatrix.m[row][0] = rows[row].x;
+		rotateMatrix.m[row][1] = rows[row].y;
+		rotateMatrix.m[row][2] = rows[row].z;
+	}
+	return Rendering::ExtractRotateXYZ(rotateMatrix);
+}
+
+//道のりの表を作る
+void Spline::BuildDistanceTable() {
+	//細かく分けた折れ線で、媒介変数ごとの道のりを求める
+	const size_t sampleCount = segments_.size() * kTableResolution;
+	std::vector<float> distances(sampleCount + 1, 0.0f);
+	Vector3 previous = Evaluate(0.0f);
+	for (size_t i = 1; i <= sampleCount; i++) {
+		const Vector3 current = Evaluate(static_cast<float>(i) / static_cast<float>(kTableResolution));
+		distances[i] = distances[i - 1] + Length(current - previous);
+		previous = current;
+	}
+	length_ = distances.back();
+
+	//道のりを等間隔に区切って、それぞれの媒介変数を引けるようにする
+	parameterTable_.assign(sampleCount + 1, 0.0f);
+	tableStep_ = length_ / static_cast<float>(sampleCount);
+	size_t sample = 0;
+	for (size_t i = 0; i <= sampleCount; i++) {
+		const float distance = tableStep_ * static_cast<float>(i);
+		while (sample + 1 < sampleCount && distances[sample + 1] < distance) {
+			sample++;
+		}
+		const float sampleLength = distances[sample + 1] - distances[sample];
+		const float fraction = sampleLength > 0.0f ? std::clamp((distance - distances[sample]) / sampleLength, 0.0f, 1.0f) : 0.0f;
+		parameterTable_[i] = (static_cast<float>(sample) + fraction) / static_cast<float>(kTableResolution);
+	}
+}
+
+//媒介変数を区間の番号と区間内の位置に分ける
+const Spline::Segment& Spline::FindSegment(float parameter, float& t) const {
+	assert(!segments_.empty());
+	const float clamped = std::clamp(parameter, 0.0f, static_cast<float>(segments_.size()));
+	const size_t index = std::min(static_cast<size_t>(clamped), segments_.size() - 1);
+	t = clamped - static_cast<float>(index);
+	return segments_[index];
+}
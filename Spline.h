@@ -0,0 +1,131 @@
+#pragma once
+#include "MathData.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// 制御点を通る(または制御点に引かれる)3次曲線
+/// </summary>
+/// <remarks>
+/// Initializeで区間ごとの3次式の係数と、道のりから媒介変数を引く表を作る。
+/// 道のりでの評価は表を1回引いて隣との補間をするだけなので、一定の速さで動かしても探索はしない
+/// </remarks>
+class Spline {
+public://列挙型
+	/// <summary>
+	/// 曲線の種類
+	/// </summary>
+	enum class Type : uint32_t {
+		kCatmullRom, //全ての制御点を通る(両端は端の点を繰り返す)
+		kBezier,     //3次ベジェをつないだもの(制御点は3n+1個で、3つおきの点を通る)
+		kBSpline,    //一様3次Bスプライン(制御点は通らないが、つなぎ目の曲率まで滑らか)
+	};
+
+	/// <summary>
+	/// 向きの決め方
+	/// </summary>
+	enum class FrameMode : uint32_t {
+		kFrenet,            //曲がる向きを法線にする(直線や変曲点で向きが飛ぶ)
+		kParallelTransport, //前の法線をねじらずに運ぶ(カメラを向けるのに使う)
+	};
+public://構造体
+	/// <summary>
+	/// 曲線上の点の位置と向き(行にするとright,up,forwardがカメラのワールド行列と同じ並び)
+	/// </summary>
+	struct Frame {
+		Vector3 position; //位置
+		Vector3 tangent; //進む向き(前)
+		Vector3 normal; //法線(上)
+		Vector3 binormal; //従法線(右)
+	};
+public://メンバ関数
+	/// <summary>
+	/// 初期化(係数と道のりの表を作る)
+	/// </summary>
+	/// <param name="type">曲線の種類</param>
+	/// <param name="controlPoints">制御点(Catmull-Romは2個以上、ほかは4個以上)</param>
+	void Initialize(Type type, std::span<const Vector3> controlPoints);
+
+	/// <summary>
+	/// 媒介変数での位置
+	/// </summary>
+	/// <param name="parameter">媒介変数(0～区間数、整数部が区間の番号)</param>
+	Vector3 Evaluate(float parameter) const;
+
+	/// <summary>
+	/// 媒介変数での微分(正規化していない接線)
+	/// </summary>
+	/// <param name="parameter">媒介変数(0～区間数)</param>
+	Vector3 EvaluateDerivative(float parameter) const;
+
+	/// <summary>
+	/// 始点からの道のりを媒介変数にする
+	/// </summary>
+	/// <param name="distance">道のり(0～GetLength、範囲外は端)</param>
+	float DistanceToParameter(float distance) const;
+
+	/// <summary>
+	/// 始点からの道のりでの位置(一定の速さで動かすときに使う)
+	/// </summary>
+	/// <param name="distance">道のり(0～GetLength)</param>
+	Vector3 EvaluateByDistance(float distance) const { return Evaluate(DistanceToParameter(distance)); }
+
+	/// <summary>
+	/// 始点から終点まで等間隔に点を取る(Primitive::DrawPolylineで描画する)
+	/// </summary>
+	/// <param name="points">出力(要素数の分だけ取る)</param>
+	void SamplePoints(std::span<Vector3> points) const;
+
+	/// <summary>
+	/// 始点から終点まで等間隔に位置と向きを取る
+	/// </summary>
+	/// <param name="frames">出力(要素数の分だけ取る)</param>
+	/// <param name="mode">向きの決め方</param>
+	/// <param name="up">始点の法線を決めるときの上の向き</param>
+	void MakeFrames(std::span<Frame> frames, FrameMode mode, const Vector3& up = { 0.0f,1.0f,0.0f }) const;
+
+	/// <summary>
+	/// 向きをカメラの回転にする(Camera::SetRotateに渡す)
+	/// </summary>
+	static Vector3 FrameToRotate(const Frame& frame);
+
+	/// <summary>
+	/// 長さのゲッター
+	/// </summary>
+	float GetLength() const { return length_; }
+
+	/// <summary>
+	/// 区間数のゲッター
+	/// </summary>
+	size_t GetSegmentCount() const { return segments_.size(); }
+public://定数
+	//道のりの表の1区間あたりの分割数
+	static inline const uint32_t kTableResolution = 128;
+private://構造体
+	/// <summary>
+	/// 1区間の3次式(a*t^3 + b*t^2 + c*t + d)
+	/// </summary>
+	struct Segment {
+		Vector3 a; //3次の係数
+		Vector3 b; //2次の係数
+		Vector3 c; //1次の係数
+		Vector3 d; //定数
+	};
+private://メンバ関数
+	/// <summary>
+	/// 道のりの表を作る
+	/// </summary>
+	void BuildDistanceTable();
+
+	/// <summary>
+	/// 媒介変数を区間の番号と区間内の位置に分ける
+	/// </summary>
+	const Segment& FindSegment(float parameter, float& t) const;
+private://メンバ変数
+	std::vector<Segment> segments_; //区間の係数
+	std::vector<float> parameterTable_; //等間隔の道のりでの媒介変数(分割数+1個)
+	float length_ = 0.0f; //長さ
+	float tableStep_ = 0.0f; //表の道のりの間隔
+};
@@ -0,0 +1,105 @@
+#include "SupportShape.h"
+#include <cassert>
+#include <cmath>
+
+namespace {
+	//方向が0とみなす長さの2乗
+	const float kZeroDirectionSquared = 1.0e-24f;
+
+	/// <summary>
+	/// 正規化(0ベクトルならx軸を返す)
+	/// </summary>
+	Vector3 SafeNormalize(const Vector3& v) {
+		float lengthSquared = v.Dot(v);
+		if (lengthSquared < kZeroDirectionSquared) {
+			return { 1.0f,0.0f,0.0f };
+		}
+		return v * (1.0f / std::sqrt(lengthSquared));
+	}
+}
+
+//球
+Vector3 SphereSupport::Support(const Vector3& direction) const {
+	return sphere_.center + SafeNormalize(direction) * sphere_.radius;
+}
+
+//OBB
+Vector3 OBBSupport::Support(const Vector3& direction) const {
+	const float sizes[3] = { obb_.size.x,obb_.size.y,obb_.size.z };
+	Vector3 result = obb_.center;
+	for (int i = 0; i < 3; i++) {
+		float sign = direction.Dot(obb_.orientations[i]) >= 0.0f ? 1.0f : -1.0f;
+		result += obb_.orientations[i] * (sign * sizes[i]);
+	}
+	return result;
+}
+
+//カプセル
+Vector3 CapsuleSupport::Support(const Vector3& direction) const {
+	return SupportCore(direction) + SafeNormalize(direction) * capsule_.radius;
+}
+
+//カプセルの芯(線分)
+Vector3 CapsuleSupport::SupportCore(const Vector3& direction) const {
+	if (direction.Dot(capsule_.segment.diff) >= 0.0f) {
+		return capsule_.segment.origin + capsule_.segment.diff;
+	}
+	return capsule_.segment.origin;
+}
+
+//円柱
+Vector3 CylinderSupport::Support(const Vector3& direction) const {
+	//軸方向は端の円、軸と垂直な方向は円周上の点
+	float axial = direction.Dot(cylinder_.axis);
+	Vector3 result = cylinder_.center + cylinder_.axis * (axial >= 0.0f ? cylinder_.halfHeight : -cylinder_.halfHeight);
+	Vector3 radial = direction - cylinder_.axis * axial;
+	float radialSquared = radial.Dot(radial);
+	if (radialSquared > kZeroDirectionSquared) {
+		result += radial * (cylinder_.radius / std::sqrt(radialSquared));
+	}
+	return result;
+}
+
+//楕円体
+Vector3 EllipsoidSupport::Support(const Vector3& direction) const {
+	//単位球に写した方向で求めて、元の空間に戻す
+	const float radius[3] = { ellipsoid_.radius.x,ellipsoid_.radius.y,ellipsoid_.radius.z };
+	float scaled[3] = {};
+	float lengthSquared = 0.0f;
+	for (int i = 0; i < 3; i++) {
+		scaled[i] = direction.Dot(ellipsoid_.orientations[i]) * radius[i];
+		lengthSquared += scaled[i] * scaled[i];
+	}
+	if (lengthSquared < kZeroDirectionSquared) {
+		return ellipsoid_.center + ellipsoid_.orientations[0] * radius[0];
+	}
+	float inverseLength = 1.0f / std::sqrt(lengthSquared);
+	Vector3 result = ellipsoid_.center;
+	for (int i = 0; i < 3; i++) {
+		result += ellipsoid_.orientations[i] * (radius[i] * scaled[i] * inverseLength);
+	}
+	return result;
+}
+
+//凸包
+ConvexHullSupport::ConvexHullSupport(const ConvexHull& hull) : hull_(hull), center_{} {
+	assert(!hull.vertices.empty());
+	for (const Vector3& vertex : hull.vertices) {
+		center_ += vertex;
+	}
+	center_ = center_ * (1.0f / static_cast<float>(hull.vertices.size()));
+}
+
+//凸包
+Vector3 ConvexHullSupport::Support(const Vector3& direction) const {
+	const Vector3* best = &hull_.vertices[0];
+	float bestDot = direction.Dot(*best);
+	for (const Vector3& vertex : hull_.vertices) {
+		float dot = direction.Dot(vertex);
+		if (dot > bestDot) {
+			bestDot = dot;
+			best = &vertex;
+		}
+	}
+	return *best;
+}
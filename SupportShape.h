@@ -0,0 +1,113 @@
+#pragma once
+#include "Shape.h"
+
+/// <summary>
+/// サポート写像で表した凸形状(GJK/EPAで使う)
+/// </summary>
+class SupportShape {
+public://メンバ関数
+	/// <summary>
+	/// デストラクタ
+	/// </summary>
+	virtual ~SupportShape() = default;
+
+	/// <summary>
+	/// 指定した方向に一番遠い点
+	/// </summary>
+	/// <param name="direction">方向(正規化しなくてよい)</param>
+	/// <returns>形状上の点</returns>
+	virtual Vector3 Support(const Vector3& direction) const = 0;
+
+	/// <summary>
+	/// 内部の点(探索の初期方向に使う)
+	/// </summary>
+	virtual Vector3 GetCenter() const = 0;
+
+	/// <summary>
+	/// 丸みを除いた芯の形状のサポート点(Supportの点 = 芯の点 + 方向 * GetMargin())
+	/// </summary>
+	/// <remarks>球は点、カプセルは線分を芯にすると、GJKが曲面で遅く収束するのを避けられる</remarks>
+	virtual Vector3 SupportCore(const Vector3& direction) const { return Support(direction); }
+
+	/// <summary>
+	/// 芯のまわりの丸みの半径
+	/// </summary>
+	virtual float GetMargin() const { return 0.0f; }
+};
+
+/// <summary>
+/// 球
+/// </summary>
+class SphereSupport : public SupportShape {
+public://メンバ関数
+	explicit SphereSupport(const SphereData& sphere) : sphere_(sphere) {}
+	Vector3 Support(const Vector3& direction) const override;
+	Vector3 GetCenter() const override { return sphere_.center; }
+	Vector3 SupportCore(const Vector3&) const override { return sphere_.center; }
+	float GetMargin() const override { return sphere_.radius; }
+private://メンバ変数
+	SphereData sphere_;
+};
+
+/// <summary>
+/// OBB
+/// </summary>
+class OBBSupport : public SupportShape {
+public://メンバ関数
+	explicit OBBSupport(const OBB& obb) : obb_(obb) {}
+	Vector3 Support(const Vector3& direction) const override;
+	Vector3 GetCenter() const override { return obb_.center; }
+private://メンバ変数
+	OBB obb_;
+};
+
+/// <summary>
+/// カプセル
+/// </summary>
+class CapsuleSupport : public SupportShape {
+public://メンバ関数
+	explicit CapsuleSupport(const Capsule& capsule) : capsule_(capsule) {}
+	Vector3 Support(const Vector3& direction) const override;
+	Vector3 GetCenter() const override { return capsule_.segment.origin + capsule_.segment.diff * 0.5f; }
+	Vector3 SupportCore(const Vector3& direction) const override;
+	float GetMargin() const override { return capsule_.radius; }
+private://メンバ変数
+	Capsule capsule_;
+};
+
+/// <summary>
+/// 円柱
+/// </summary>
+class CylinderSupport : public SupportShape {
+public://メンバ関数
+	explicit CylinderSupport(const Cylinder& cylinder) : cylinder_(cylinder) {}
+	Vector3 Support(const Vector3& direction) const override;
+	Vector3 GetCenter() const override { return cylinder_.center; }
+private://メンバ変数
+	Cylinder cylinder_;
+};
+
+/// <summary>
+/// 楕円体
+/// </summary>
+class EllipsoidSupport : public SupportShape {
+public://メンバ関数
+	explicit EllipsoidSupport(const Ellipsoid& ellipsoid) : ellipsoid_(ellipsoid) {}
+	Vector3 Support(const Vector3& direction) const override;
+	Vector3 GetCenter() const override { return ellipsoid_.center; }
+private://メンバ変数
+	Ellipsoid ellipsoid_;
+};
+
+/// <summary>
+/// 凸包(頂点は参照するだけなので、使い終わるまで凸包を残しておくこと)
+/// </summary>
+class ConvexHullSupport : public SupportShape {
+public://メンバ関数
+	explicit ConvexHullSupport(const ConvexHull& hull);
+	Vector3 Support(const Vector3& direction) const override;
+	Vector3 GetCenter() const override { return center_; }
+private://メンバ変数
+	const ConvexHull& hull_;
+	Vector3 center_; //頂点の平均
+};
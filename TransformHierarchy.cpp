@@ -0,0 +1,326 @@
+#include "TransformHierarchy.h"
+#include "MemoryTracker.h"
+#include "JobSystem.h"
+#include "Rendering.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace {
+	//空きスロットの終端
+	const uint32_t kNullSlot = 0xFFFFFFFFu;
+
+	/// <summary>
+	/// 新しい順番に合わせて並べ替える
+	/// </summary>
+	template<typename T>
+	void Permute(std::vector<T>& values, const std::vector<uint32_t>& newToOld) {
+		std::vector<T> sorted(newToOld.size());
+		for (size_t i = 0; i < newToOld.size(); i++) {
+			sorted[i] = values[newToOld[i]];
+		}
+		values.swap(sorted);
+	}
+}
+
+//節点の追加
+TransformHierarchy::NodeHandle TransformHierarchy::CreateNode(NodeHandle parent, const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
+	assert(parent.index == kNullSlot || IsValid(parent));
+	const uint32_t dense = static_cast<uint32_t>(scale_.size());
+	const uint32_t parentDense = IsValid(parent) ? slotToDense_[parent.index] : kNoParent;
+	scale_.push_back(scale);
+	rotate_.push_back(rotate);
+	translate_.push_back(translate);
+	worldMatrix_.push_back(Matrix4x4{});
+	parent_.push_back(parentDense);
+	subtreeEnd_.push_back(dense + 1);
+	isDirty_.push_back(1);
+	isAlive_.push_back(1);
+
+	if (parentDense == kNoParent) {
+		//根は末尾に足しても深さ優先の順のまま
+		roots_.push_back(dense);
+	} else if (!isOrderDirty_ && subtreeEnd_[parentDense] == dense) {
+		//親の子孫が末尾で終わっていれば、祖先の範囲を伸ばすだけで済む(深さ優先に作ったときはいつもこちら)
+		for (uint32_t ancestor = parentDense; ancestor != kNoParent; ancestor = parent_[ancestor]) {
+			subtreeEnd_[ancestor] = dense + 1;
+		}
+	} else {
+		isOrderDirty_ = true;
+	}
+
+	//空きスロットがあれば使い回す
+	uint32_t slot = freeSlot_;
+	if (slot != kNullSlot) {
+		freeSlot_ = slotToDense_[slot];
+		slotToDense_[slot] = dense;
+	} else {
+		slot = static_cast<uint32_t>(slotToDense_.size());
+		slotToDense_.push_back(dense);
+		slotGeneration_.push_back(0);
+	}
+	denseToSlot_.push_back(slot);
+	nodeCount_++;
+	return { .index = slot,.generation = slotGeneration_[slot] };
+}
+
+//節点を子孫ごと削除
+void TransformHierarchy::DestroyNode(NodeHandle handle) {
+	if (!IsValid(handle)) {
+		return;
+	}
+	//子孫の範囲を使うので並びを直しておく
+	if (isOrderDirty_) {
+		RebuildOrder();
+	}
+	//スロットは世代を進めて空きにし、配列からは次に並べ直すときに取り除く
+	const uint32_t dense = slotToDense_[handle.index];
+	const uint32_t end = subtreeEnd_[dense];
+	for (uint32_t i = dense; i < end; i++) {
+		const uint32_t slot = denseToSlot_[i];
+		slotGeneration_[slot]++;
+		slotToDense_[slot] = freeSlot_;
+		freeSlot_ = slot;
+		isAlive_[i] = 0;
+	}
+	nodeCount_ -= end - dense;
+	isOrderDirty_ = true;
+}
+
+//ハンドルが有効か
+bool TransformHierarchy::IsValid(NodeHandle handle) const {
+	return handle.index < slotGeneration_.size() && slotGeneration_[handle.index] == handle.generation;
+}
+
+//全削除
+void TransformHierarchy::Clear() {
+	//古いハンドルが無効になるように、スロットは世代を進めて空きにする
+	for (uint32_t dense = 0; dense < denseToSlot_.size(); dense++) {
+		if (!isAlive_[dense]) {
+			continue;
+		}
+		const uint32_t slot = denseToSlot_[dense];
+		slotGeneration_[slot]++;
+		slotToDense_[slot] = freeSlot_;
+		freeSlot_ = slot;
+	}
+	scale_.clear();
+	rotate_.clear();
+	translate_.clear();
+	worldMatrix_.clear();
+	parent_.clear();
+	subtreeEnd_.clear();
+	isDirty_.clear();
+	isAlive_.clear();
+	denseToSlot_.clear();
+	roots_.clear();
+	nodeCount_ = 0;
+	updatedCount_ = 0;
+	isOrderDirty_ = false;
+}
+
+//親の付け替え
+void TransformHierarchy::SetParent(NodeHandle handle, NodeHandle parent) {
+	assert(parent.index == kNullSlot || IsValid(parent));
+	const uint32_t dense = GetDenseIndex(handle);
+	const uint32_t parentDense = IsValid(parent) ? slotToDense_[parent.index] : kNoParent;
+	//自分の子孫を親にすると輪になる
+	for (uint32_t ancestor = parentDense; ancestor != kNoParent; ancestor = parent_[ancestor]) {
+		assert(ancestor != dense);
+		if (ancestor == dense) {
+			return;
+		}
+	}
+	if (parent_[dense] == parentDense) {
+		return;
+	}
+	parent_[dense] = parentDense;
+	isDirty_[dense] = 1;
+	isOrderDirty_ = true;
+}
+
+//親のゲッター
+TransformHierarchy::NodeHandle TransformHierarchy::GetParent(NodeHandle handle) const {
+	const uint32_t parentDense = parent_[GetDenseIndex(handle)];
+	if (parentDense == kNoParent) {
+		return {};
+	}
+	const uint32_t slot = denseToSlot_[parentDense];
+	return { .index = slot,.generation = slotGeneration_[slot] };
+}
+
+//拡縮のセッター
+void TransformHierarchy::SetScale(NodeHandle handle, const Vector3& scale) {
+	const uint32_t dense = GetDenseIndex(handle);
+	scale_[dense] = scale;
+	isDirty_[dense] = 1;
+}
+
+//回転のセッター
+void TransformHierarchy::SetRotate(NodeHandle handle, const Vector3& rotate) {
+	const uint32_t dense = GetDenseIndex(handle);
+	rotate_[dense] = rotate;
+	isDirty_[dense] = 1;
+}
+
+//移動のセッター
+void TransformHierarchy::SetTranslate(NodeHandle handle, const Vector3& translate) {
+	const uint32_t dense = GetDenseIndex(handle);
+	translate_[dense] = translate;
+	isDirty_[dense] = 1;
+}
+
+//拡縮のゲッター
+Vector3 TransformHierarchy::GetScale(NodeHandle handle) const {
+	return scale_[GetDenseIndex(handle)];
+}
+
+//回転のゲッター
+Vector3 TransformHierarchy::GetRotate(NodeHandle handle) const {
+	return rotate_[GetDenseIndex(handle)];
+}
+
+//移動のゲッター
+Vector3 TransformHierarchy::GetTranslate(NodeHandle handle) const {
+	return translate_[GetDenseIndex(handle)];
+}
+
+//ワールド行列のゲッター
+const Matrix4x4& TransformHierarchy::GetWorldMatrix(NodeHandle handle) const {
+	return worldMatrix_[GetDenseIndex(handle)];
+}
+
+//ワールド行列の更新
+void TransformHierarchy::UpdateWorldMatrices(bool isParallel) {
+	MemoryTracker::Scope memoryScope(MemoryTracker::Tag::kMath);
+	if (isOrderDirty_) {
+		RebuildOrder();
+	}
+	const uint32_t count = static_cast<uint32_t>(scale_.size());
+	if (!isParallel || count < kMinParallelNodeCount || roots_.size() < 2) {
+		updatedCount_ = UpdateRange(0, count);
+		return;
+	}
+	//根ごとの部分木は配列の連続した範囲で、ほかの部分木を読まない
+	std::atomic<size_t> updatedCount = 0;
+	JobSystem::GetInstance()->ParallelFor(roots_.size(), 1, [this, &updatedCount](size_t begin, size_t end) {
+		size_t updated = 0;
+		for (size_t i = begin; i < end; i++) {
+			updated += UpdateRange(roots_[i], subtreeEnd_[roots_[i]]);
+		}
+		updatedCount.fetch_add(updated, std::memory_order_relaxed);
+		});
+	updatedCount_ = updatedCount.load(std::memory_order_relaxed);
+}
+
+//深さ優先の順に並べ直す
+void TransformHierarchy::RebuildOrder() {
+	const uint32_t count = static_cast<uint32_t>(scale_.size());
+
+	//親ごとに子を集める(数えてから詰めると、childStart_[p]はpの子の終わりになる)
+	childStart_.assign(count, 0);
+	uint32_t childCount = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (isAlive_[i] && parent_[i] != kNoParent) {
+			childStart_[parent_[i]]++;
+			childCount++;
+		}
+	}
+	uint32_t offset = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		const uint32_t start = offset;
+		offset += childStart_[i];
+		childStart_[i] = start;
+	}
+	children_.resize(childCount);
+	for (uint32_t i = 0; i < count; i++) {
+		if (isAlive_[i] && parent_[i] != kNoParent) {
+			children_[childStart_[parent_[i]]++] = i;
+		}
+	}
+
+	//根を今の順に、子は追加した順にたどる
+	newToOld_.clear();
+	for (uint32_t root = 0; root < count; root++) {
+		if (!isAlive_[root] || parent_[root] != kNoParent) {
+			continue;
+		}
+		stack_.push_back(root);
+		while (!stack_.empty()) {
+			const uint32_t node = stack_.back();
+			stack_.pop_back();
+			newToOld_.push_back(node);
+			const uint32_t begin = node == 0 ? 0 : childStart_[node - 1];
+			for (uint32_t child = childStart_[node]; child > begin; child--) {
+				stack_.push_back(children_[child - 1]);
+			}
+		}
+	}
+
+	//親の番号を付け替えてから、配列を新しい順に並べる
+	oldToNew_.assign(count, kNoParent);
+	for (uint32_t i = 0; i < newToOld_.size(); i++) {
+		oldToNew_[newToOld_[i]] = i;
+	}
+	for (uint32_t& parent : parent_) {
+		if (parent != kNoParent) {
+			parent = oldToNew_[parent];
+		}
+	}
+	Permute(scale_, newToOld_);
+	Permute(rotate_, newToOld_);
+	Permute(translate_, newToOld_);
+	Permute(worldMatrix_, newToOld_);
+	Permute(parent_, newToOld_);
+	Permute(isDirty_, newToOld_);
+	Permute(denseToSlot_, newToOld_);
+
+	//子孫の終わりは後ろから親へ伝える
+	const uint32_t aliveCount = static_cast<uint32_t>(newToOld_.size());
+	isAlive_.assign(aliveCount, 1);
+	subtreeEnd_.resize(aliveCount);
+	for (uint32_t i = 0; i < aliveCount; i++) {
+		subtreeEnd_[i] = i + 1;
+	}
+	roots_.clear();
+	for (uint32_t i = aliveCount; i > 0; i--) {
+		const uint32_t node = i - 1;
+		const uint32_t parent = parent_[node];
+		if (parent != kNoParent) {
+			subtreeEnd_[parent] = std::max(subtreeEnd_[parent], subtreeEnd_[node]);
+		}
+	}
+	for (uint32_t i = 0; i < aliveCount; i++) {
+		slotToDense_[denseToSlot_[i]] = i;
+		if (parent_[i] == kNoParent) {
+			roots_.push_back(i);
+		}
+	}
+	isOrderDirty_ = false;
+}
+
+//範囲内のワールド行列を作り直す
+size_t TransformHierarchy::UpdateRange(uint32_t begin, uint32_t end) {
+	size_t updated = 0;
+	for (uint32_t i = begin; i < end; i++) {
+		//親は前にあるので、親の印はもう子孫へ伝わる形になっている
+		const uint32_t parent = parent_[i];
+		if (parent != kNoParent) {
+			isDirty_[i] |= isDirty_[parent];
+		}
+		if (!isDirty_[i]) {
+			continue;
+		}
+		const Matrix4x4 localMatrix = Rendering::MakeAffineMatrix(scale_[i], rotate_[i], translate_[i]);
+		worldMatrix_[i] = parent == kNoParent ? localMatrix : localMatrix * worldMatrix_[parent];
+		updated++;
+	}
+	std::fill(isDirty_.begin() + begin, isDirty_.begin() + end, static_cast<uint8_t>(0));
+	return updated;
+}
+
+//配列での番号
+uint32_t TransformHierarchy::GetDenseIndex(NodeHandle handle) const {
+	assert(IsValid(handle));
+	return slotToDense_[handle.index];
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include "MathData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 親子関係のあるトランスフォームの集まり(親が子より前に来るように並べた配列に持つ)
+/// </summary>
+/// <remarks>
+/// 配列は深さ優先の順に並べるので、ある節点の子孫は[自分, subtreeEnd)に続けて入っている。
+/// 拡縮・回転・移動を変えた節点には変更の印を付け、UpdateWorldMatricesの1回の走査で
+/// 印の付いた節点とその子孫のワールド行列だけを作り直す。根ごとの部分木は互いに独立なので並列に処理する。
+/// 親の付け替えや追加・削除で並びが崩れたら、次の更新の最初に並べ直す
+/// </remarks>
+class TransformHierarchy {
+public://構造体
+	/// <summary>
+	/// 節点を指すハンドル(削除された節点のハンドルは無効になる)
+	/// </summary>
+	struct NodeHandle {
+		uint32_t index = 0xFFFFFFFFu; //スロット番号
+		uint32_t generation = 0; //スロットを使い回した回数
+	};
+public://メンバ関数
+	/// <summary>
+	/// 節点の追加
+	/// </summary>
+	/// <param name="parent">親(無効なハンドルなら根)</param>
+	/// <param name="scale">拡縮</param>
+	/// <param name="rotate">回転</param>
+	/// <param name="translate">移動</param>
+	/// <returns>ハンドル</returns>
+	NodeHandle CreateNode(NodeHandle parent = { 0xFFFFFFFFu,0 }, const Vector3& scale = { 1.0f,1.0f,1.0f }, const Vector3& rotate = { 0.0f,0.0f,0.0f }, const Vector3& translate = { 0.0f,0.0f,0.0f });
+
+	/// <summary>
+	/// 節点を子孫ごと削除
+	/// </summary>
+	/// <param name="handle">ハンドル(無効なハンドルなら何もしない)</param>
+	void DestroyNode(NodeHandle handle);
+
+	/// <summary>
+	/// ハンドルが有効か
+	/// </summary>
+	bool IsValid(NodeHandle handle) const;
+
+	/// <summary>
+	/// 全削除
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 親の付け替え(ローカルの値はそのままで、ワールド行列は新しい親に付いて変わる)
+	/// </summary>
+	/// <param name="handle">節点</param>
+	/// <param name="parent">新しい親(無効なハンドルなら根にする。自分の子孫は指定できない)</param>
+	void SetParent(NodeHandle handle, NodeHandle parent);
+
+	/// <summary>
+	/// 親のゲッター(根なら無効なハンドル)
+	/// </summary>
+	NodeHandle GetParent(NodeHandle handle) const;
+
+	/// <summary>
+	/// 拡縮のセッター
+	/// </summary>
+	void SetScale(NodeHandle handle, const Vector3& scale);
+
+	/// <summary>
+	/// 回転のセッター
+	/// </summary>
+	void SetRotate(NodeHandle handle, const Vector3& rotate);
+
+	/// <summary>
+	/// 移動のセッター
+	/// </summary>
+	void SetTranslate(NodeHandle handle, const Vector3& translate);
+
+	/// <summary>
+	/// 拡縮のゲッター
+	/// </summary>
+	Vector3 GetScale(NodeHandle handle) const;
+
+	/// <summary>
+	/// 回転のゲッター
+	/// </summary>
+	Vector3 GetRotate(NodeHandle handle) const;
+
+	/// <summary>
+	/// 移動のゲッター
+	/// </summary>
+	Vector3 GetTranslate(NodeHandle handle) const;
+
+	/// <summary>
+	/// ワールド行列のゲッター(最後のUpdateWorldMatricesの時点の値)
+	/// </summary>
+	const Matrix4x4& GetWorldMatrix(NodeHandle handle) const;
+
+	/// <summary>
+	/// 変更のあった節点とその子孫のワールド行列を作り直す
+	/// </summary>
+	/// <param name="isParallel">根ごとの部分木をJobSystemで分担するか</param>
+	void UpdateWorldMatrices(bool isParallel = true);
+
+	/// <summary>
+	/// 節点数のゲッター
+	/// </summary>
+	size_t GetNodeCount() const { return nodeCount_; }
+
+	/// <summary>
+	/// 前回のUpdateWorldMatricesで作り直した行列の数のゲッター
+	/// </summary>
+	size_t GetUpdatedCount() const { return updatedCount_; }
+public://定数
+	//根の親の番号
+	static inline const uint32_t kNoParent = 0xFFFFFFFFu;
+	//並列に処理する最小の節点数
+	static inline const size_t kMinParallelNodeCount = 4096;
+private://メンバ関数
+	/// <summary>
+	/// 深さ優先の順に並べ直し、削除した節点を取り除く
+	/// </summary>
+	void RebuildOrder();
+
+	/// <summary>
+	/// [begin, end)の節点のワールド行列を作り直す(begin以前の親は更新済みであること)
+	/// </summary>
+	/// <returns>作り直した数</returns>
+	size_t UpdateRange(uint32_t begin, uint32_t end);
+
+	/// <summary>
+	/// 配列での番号
+	/// </summary>
+	uint32_t GetDenseIndex(NodeHandle handle) const;
+private://メンバ変数
+	//節点ごとの配列(深さ優先の順。並べ直すまでは末尾に追加し、削除した節点も残る)
+	std::vector<Vector3> scale_; //拡縮
+	std::vector<Vector3> rotate_; //回転
+	std::vector<Vector3> translate_; //移動
+	std::vector<Matrix4x4> worldMatrix_; //ワールド行列
+	std::vector<uint32_t> parent_; //親の配列での番号(根はkNoParent)
+	std::vector<uint32_t> subtreeEnd_; //子孫の終わりの配列での番号
+	std::vector<uint8_t> isDirty_; //変更があったか
+	std::vector<uint8_t> isAlive_; //削除されていないか
+	std::vector<uint32_t> denseToSlot_; //配列の番号からスロット
+
+	//ハンドルと配列の番号の対応
+	std::vector<uint32_t> slotToDense_; //スロットから配列の番号(空きスロットは次の空きスロット)
+	std::vector<uint32_t> slotGeneration_; //スロットの世代
+	uint32_t freeSlot_ = 0xFFFFFFFFu; //空きスロットの先頭
+
+	std::vector<uint32_t> roots_; //根の配列での番号(並べ直したときに作る)
+	size_t nodeCount_ = 0; //生きている節点数
+	size_t updatedCount_ = 0; //前回作り直した行列の数
+	bool isOrderDirty_ = false; //並べ直しが必要か
+
+	//並べ直しの作業用
+	std::vector<uint32_t> childStart_; //子の一覧の始まり
+	std::vector<uint32_t> children_; //親ごとに並べた子
+	std::vector<uint32_t> stack_; //深さ優先の探索に使う
+	std::vector<uint32_t> newToOld_; //並べ直した後の番号から前の番号
+	std::vector<uint32_t> oldToNew_; //前の番号から並べ直した後の番号
+};
@@ -3,234 +3,124 @@
 #include "Rendering.h"
 #include "Camera.h"
 #include "ScreenPrintf.h"
+#include "Primitive.h"
+#include "NoviceDrawBackend.h"
+#include "RenderStats.h"
+#include "EntityManager.h"
+#include "Input.h"
+#include "InputRecorder.h"
+#include "DrawCapture.h"
+#include "FrameAllocator.h"
+#include "JobSystem.h"
+#include "MemoryTracker.h"
+#include "QualityGovernor.h"
 #include <cstdint>
-#include <numbers>
-#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <span>
 #ifdef USE_IMGUI
 #include <imgui.h>
 #endif // USE_IMGUI
 
 const char kWindowTitle[] = "GSManager";
-
-//球のデータ
-struct SphereData {
-	Vector3 center; //中心座標
-	float radius;   //半径
-};
+const int kWindowWidth = 1280;//画面の幅
+const int kWindowHeight = 720;//画面の高さ
 
 struct Matrix3x3 {
 	float m[3][3];
 };
 
-/// <summary>
-/// グリッドの描画
-/// </summary>
-/// <param name="viewProjectionMatrix">ビュー射影行列</param>
-/// <param name="viewportMatrix">ビューポート行列</param>
-void DrawGrid(const Matrix4x4& viewProjectionMatrix, const Matrix4x4& viewportMatrix) {
-	const float kGridHalfWidth = 2.0f;//グリッドの半分の幅
-	const uint32_t kSubdivision = 10;//分割数
-	const float kGridEvery = (kGridHalfWidth * 2.0f) / static_cast<float>(kSubdivision);//1つ分の長さ
-
-	//奥から手前ヘの線を順々に引いていく
-	for (uint32_t xIndex = 0; xIndex <= kSubdivision; xIndex++) {
-		//ローカル座標を求める
-		float z = -kGridHalfWidth + kGridEvery * static_cast<float>(xIndex);
-		Vector3 localStartPos = { -kGridHalfWidth, 0.0f, z };
-		Vector3 localEndPos = { kGridHalfWidth, 0.0f, z };
-
-		//スクリーン座標に変換
-		Vector3 screenStartPos = Rendering::Transform(localStartPos, viewProjectionMatrix);
-		screenStartPos = Rendering::Transform(screenStartPos, viewportMatrix);
-		Vector3 screenEndPos = Rendering::Transform(localEndPos, viewProjectionMatrix);
-		screenEndPos = Rendering::Transform(screenEndPos, viewportMatrix);
-
-		//色の設定
-		uint32_t color = 0xAAAAAAFF;
-		if (xIndex == kSubdivision / 2) {
-			color = BLACK; // 中央の線は黒色にする
-		}
-
-		//描画
-		Novice::DrawLine(
-			static_cast<int32_t>(screenStartPos.x),
-			static_cast<int32_t>(screenStartPos.y),
-			static_cast<int32_t>(screenEndPos.x),
-			static_cast<int32_t>(screenEndPos.y),
-			color
-		);
-	}
-
-	//左から右も同じように順々に引いていく
-	for (uint32_t zIndex = 0; zIndex <= kSubdivision; zIndex++) {
-		//ローカル座標を求める
-		float x = -kGridHalfWidth + kGridEvery * static_cast<float>(zIndex);
-		Vector3 localStartPos = { x, 0.0f, -kGridHalfWidth };
-		Vector3 localEndPos = { x, 0.0f, kGridHalfWidth };
-
-		//スクリーン座標に変換
-		Vector3 screenStartPos = Rendering::Transform(localStartPos, viewProjectionMatrix);
-		screenStartPos = Rendering::Transform(screenStartPos, viewportMatrix);
-		Vector3 screenEndPos = Rendering::Transform(localEndPos, viewProjectionMatrix);
-		screenEndPos = Rendering::Transform(screenEndPos, viewportMatrix);
-
-		//色の設定
-		uint32_t color = 0xAAAAAAFF;
-		if (zIndex == kSubdivision / 2) {
-			color = BLACK; // 中央の線は黒色にする
-		}
-
-		//描画
-		Novice::DrawLine(
-			static_cast<int32_t>(screenStartPos.x),
-			static_cast<int32_t>(screenStartPos.y),
-			static_cast<int32_t>(screenEndPos.x),
-			static_cast<int32_t>(screenEndPos.y),
-			color
-		);
-	}
-
-}
-
-/// <summary>
-/// スフィアの描画
-/// </summary>
-/// <param name="viewProjection">ビュー射影行列</param>
-/// <param name="viewportMatrix">ビューポート行列</param>
-void DrawSphere(const SphereData& sphereData, const Matrix4x4& viewProjection, const Matrix4x4& viewportMatrix) {
-	const uint32_t kSubdivision = 10;//分割数
-	const float kPi = std::numbers::pi_v<float>;//円周率
-	const float kLonEvery = 2.0f * kPi / static_cast<float>(kSubdivision);//経度分割1つ分の長さ
-	const float kLatEvery = kPi / static_cast<float>(kSubdivision);//緯度分割1つ分の長さ
-
-	//緯度の方向に分割 -π/2 ~ π/2
-	for (uint32_t latIndex = 0; latIndex < kSubdivision; latIndex++) {
-		float lat = -kPi / 2.0f + kLatEvery * static_cast<float>(latIndex);
-
-		//経度方向に分割 0 ~ 2π
-		for (uint32_t lonIndex = 0; lonIndex < kSubdivision; lonIndex++) {
-			float lon = static_cast<float>(lonIndex) * kLonEvery;
-
-			// 球面座標からワールド座標に変換
-			Vector3 a = {
-				std::cos(lat) * std::cos(lon),
-				std::sin(lat),
-				std::cos(lat) * std::sin(lon)
-			};
-
-			Vector3 b = {
-				std::cos(lat + kLatEvery) * std::cos(lon),
-				std::sin(lat + kLatEvery),
-				std::cos(lat + kLatEvery) * std::sin(lon)
-			};
-
-			Vector3 c = {
-				std::cos(lat) * std::cos(lon + kLonEvery),
-				std::sin(lat),
-				std::cos(lat) * std::sin(lon + kLonEvery)
-			};
-
-			//球の半径と中心を考慮して座標を調整
-			a = a * sphereData.radius + sphereData.center;
-			b = b * sphereData.radius + sphereData.center;
-			c = c * sphereData.radius + sphereData.center;
-
-			//スクリーン座標に変換
-			Vector3 screenA = Rendering::Transform(a, viewProjection);
-			screenA = Rendering::Transform(screenA, viewportMatrix);
-
-			Vector3 screenB = Rendering::Transform(b, viewProjection);
-			screenB = Rendering::Transform(screenB, viewportMatrix);
-
-			Vector3 screenC = Rendering::Transform(c, viewProjection);
-			screenC = Rendering::Transform(screenC, viewportMatrix);
-
-			// 経度線
-			Novice::DrawLine(
-				static_cast<int32_t>(screenA.x),
-				static_cast<int32_t>(screenA.y),
-				static_cast<int32_t>(screenB.x),
-				static_cast<int32_t>(screenB.y),
-				BLACK
-			);
-
-			// 緯度線
-			Novice::DrawLine(
-				static_cast<int32_t>(screenA.x),
-				static_cast<int32_t>(screenA.y),
-				static_cast<int32_t>(screenC.x),
-				static_cast<int32_t>(screenC.y),
-				BLACK
-			);
-		}
-	}
-}
-
-Matrix4x4 DirectionToDirection(const Vector3& from, const Vector3& to) {
-	Matrix4x4 result = Matrix4x4::Identity4x4();
-	Vector3 u = from.Normalize();
-	Vector3 v = to.Normalize();
-	Vector3 n = (u.Cross(v)).Normalize();
-	float cosTheta = u.Dot(v);
-	float sinTheta = u.Cross(v).Length();
-
-	if (cosTheta <= -1.0f) {
-		if (u.x != 0.0f || u.y != 0.0f) {
-			n = Vector3(u.y, -u.x, 0.0f).Normalize();
-		} else if (u.x != 0.0f || u.z != 0.0f) {
-			n = Vector3(u.z, 0.0f, -u.x).Normalize();
-		}
-	}
-
-	result.m[0][0] = std::pow(n.x, 2.0f) * (1.0f - cosTheta) + cosTheta;
-	result.m[0][1] = n.x * n.y * (1.0f - cosTheta) + n.z * sinTheta;
-	result.m[0][2] = n.x * n.z * (1.0f - cosTheta) - n.y * sinTheta;
-
-	result.m[1][0] = n.x * n.y * (1.0f - cosTheta) - n.z * sinTheta;
-	result.m[1][1] = std::pow(n.y, 2.0f) * (1.0f - cosTheta) + cosTheta;
-	result.m[1][2] = n.y * n.z * (1.0f - cosTheta) + n.x * sinTheta;
-
-	result.m[2][0] = n.x * n.z * (1.0f - cosTheta) + n.y * sinTheta;
-	result.m[2][1] = n.y * n.z * (1.0f - cosTheta) - n.x * sinTheta;
-	result.m[2][2] = std::pow(n.z, 2.0f) * (1.0f - cosTheta) + cosTheta;
-	return result;
-}
+//ImGuiで動かす値(InputRecorderで記録・再生するのでfloatだけを並べる)
+struct SceneParameters {
+	Vector3 cameraRotate;
+	Vector3 cameraTranslate;
+	Vector3 sphereTranslate;
+	float sphereRadius;
+	float qualityLevel; //描画の品質の段(再生で同じ段にするため記録する)
+};
+static_assert(sizeof(SceneParameters) == sizeof(float) * 11, "SceneParametersはfloatだけを隙間なく並べる");
 
 // Windowsアプリでのエントリーポイント(main関数)
 int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 
 	// ライブラリの初期化
-	Novice::Initialize(kWindowTitle, 1280, 720);
+	Novice::Initialize(kWindowTitle, kWindowWidth, kWindowHeight);
 
-	// キー入力結果を受け取る箱
-	char keys[256] = { 0 };
-	char preKeys[256] = { 0 };
+	//キーは別スレッドで読み、フレームの途中で押して離したキーも取りこぼさないようにする
+	Input::GetInstance()->StartPolling();
 
 	//カメラの生成と初期化
 	Camera* camera = new Camera();
-	camera->Initialize(1280.0f, 720.0f);
-	Vector3 cameraRotate = { 0.26f,0.0f,0.0f };
-	Vector3 cameraTranslate = { 0.0f,1.9f,-6.49f };
-
-	//球
-	SphereData sphereData = { .center{},.radius = 1.0f };
+	camera->Initialize(static_cast<float>(kWindowWidth), static_cast<float>(kWindowHeight));
+	SceneParameters sceneParameters = {
+		.cameraRotate = { 0.26f,0.0f,0.0f },
+		.cameraTranslate = { 0.0f,1.9f,-6.49f },
+		.sphereTranslate = { 0.0f,0.0f,0.0f },
+		.sphereRadius = 1.0f,
+		.qualityLevel = 0.0f,
+	};
+	const std::span<float> sceneParameterValues(reinterpret_cast<float*>(&sceneParameters), sizeof(SceneParameters) / sizeof(float));
+
+	//Noviceへの描画先
+	NoviceDrawBackend noviceDrawBackend;
+	//描画命令の記録(F5で切り替え。記録していないときはNoviceに渡すだけ)
+	DrawCapture drawCapture(noviceDrawBackend);
+	//記録するたびに番号を進め、前の記録を上書きしない(起動し直したときも、あるファイルは飛ばす)
+	uint32_t drawCaptureNumber = 0;
+	ScreenPrintf::GetInstance()->SetDrawBackend(&drawCapture);
+
+	//シーンのオブジェクト
+	EntityManager entityManager;
+
+	//球(拡縮のxを半径に使う)
+	EntityManager::Entity sphere = entityManager.CreateEntity(EntityManager::kTransform | EntityManager::kRender);
+	entityManager.GetRender(sphere).color = Primitive::kBlack;
 
 	Vector3 from0 = Vector3(1.0f, 0.7f, 0.5f).Normalize();
 	Vector3 to0 = -from0;
 	Vector3 from1 = Vector3(-0.6f, 0.9f, 0.2f);
 	Vector3 to1 = Vector3(0.4f, 0.7f, -0.5f);
-	Matrix4x4 rotateMatrix0 = DirectionToDirection(Vector3(1.0f, 0.0f, 0.0f).Normalize(), Vector3(-1.0f, 0.0f, 0.0f).Normalize());
-	Matrix4x4 rotateMatrix1 = DirectionToDirection(from0, to0);
-	Matrix4x4 rotateMatrix2 = DirectionToDirection(from1, to1);
+	Matrix4x4 rotateMatrix0 = Rendering::DirectionToDirection(Vector3(1.0f, 0.0f, 0.0f).Normalize(), Vector3(-1.0f, 0.0f, 0.0f).Normalize());
+	Matrix4x4 rotateMatrix1 = Rendering::DirectionToDirection(from0, to0);
+	Matrix4x4 rotateMatrix2 = Rendering::DirectionToDirection(from1, to1);
+	const Matrix4x4 rotateMatrices[] = { rotateMatrix0,rotateMatrix1,rotateMatrix2 };
+	const char* const rotateMatrixLabels[] = { "rotateMatrix0","rotateMatrix1","rotateMatrix2" };
+
+	//描画統計のログを出力しているか
+	bool isRenderStatsLogging = false;
+
+	//キー入力と調整値の記録・再生(F3で記録、F4で再生)
+	InputRecorder inputRecorder;
+	const char kInputRecordFilePath[] = "input_record.bin";
+
+	//フレーム時間に合わせて描画の品質を上げ下げする
+	QualityGovernor qualityGovernor;
 
 	// ウィンドウの×ボタンが押されるまでループ
 	while (Novice::ProcessMessage() == 0) {
 		// フレームの開始
 		Novice::BeginFrame();
+		ScreenPrintf::GetInstance()->BeginFrame();
+		qualityGovernor.BeginFrame();
 
 		// キー入力を受け取る
-		memcpy(preKeys, keys, 256);
-		Novice::GetHitKeyStateAll(keys);
+		Input::GetInstance()->Update();
+
+		// F3キーで記録、F4キーで再生を切り替える(再生で上書きする前の、実際の入力で判定する)
+		if (Input::GetInstance()->GetTriggerKeys(DIK_F3)) {
+			if (inputRecorder.GetMode() == InputRecorder::Mode::kRecord) {
+				inputRecorder.Stop();
+			} else {
+				inputRecorder.StartRecording(kInputRecordFilePath, sceneParameterValues.size());
+			}
+		}
+		if (Input::GetInstance()->GetTriggerKeys(DIK_F4)) {
+			if (inputRecorder.GetMode() == InputRecorder::Mode::kReplay) {
+				inputRecorder.Stop();
+			} else {
+				inputRecorder.StartReplay(kInputRecordFilePath, sceneParameterValues.size());
+			}
+		}
 
 		///
 		/// ↓更新処理ここから
@@ -238,17 +128,72 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 
 		//カメラの更新 
 		camera->Update();
-		camera->SetRotate(cameraRotate);
-		camera->SetTranslate(cameraTranslate);
+		camera->SetRotate(sceneParameters.cameraRotate);
+		camera->SetTranslate(sceneParameters.cameraTranslate);
 
 #ifdef USE_IMGUI
-		ImGui::DragFloat3("camera.rotate", &cameraRotate.x, 0.1f);
-		ImGui::DragFloat3("camera.translate", &cameraTranslate.x, 0.1f);
+		ImGui::DragFloat3("camera.rotate", &sceneParameters.cameraRotate.x, 0.1f);
+		ImGui::DragFloat3("camera.translate", &sceneParameters.cameraTranslate.x, 0.1f);
 		ImGui::Separator();
-		ImGui::DragFloat3("sphere.translate", &sphereData.center.x, 0.1f);
-		ImGui::DragFloat("sphere.radius", &sphereData.radius, 0.1f, 0.0f, 10.0f);
+		ImGui::DragFloat3("sphere.translate", &sceneParameters.sphereTranslate.x, 0.1f);
+		ImGui::DragFloat("sphere.radius", &sceneParameters.sphereRadius, 0.1f, 0.0f, 10.0f);
+
+#ifdef MT_MEMORY_TRACKING
+		//サブシステムごとのヒープの使用量(前フレームの集計結果)
+		if (ImGui::CollapsingHeader("memory")) {
+			const MemoryTracker::FrameStats& memoryStats = MemoryTracker::GetFrameStats();
+			ImGui::Text("%-8s %8s %10s %10s %10s", "tag", "allocs/f", "KiB/f", "live KiB", "peak KiB");
+			for (size_t i = 0; i <= MemoryTracker::kTagCount; i++) {
+				const MemoryTracker::TagStats& tagStats = i < MemoryTracker::kTagCount ? memoryStats.tags[i] : memoryStats.total;
+				ImGui::Text("%-8s %8llu %10.1f %10.1f %10.1f",
+					i < MemoryTracker::kTagCount ? MemoryTracker::GetTagName(static_cast<MemoryTracker::Tag>(i)) : "total",
+					static_cast<unsigned long long>(tagStats.frameAllocationCount), static_cast<double>(tagStats.frameAllocationBytes) / 1024.0,
+					static_cast<double>(tagStats.liveBytes) / 1024.0, static_cast<double>(tagStats.peakLiveBytes) / 1024.0);
+			}
+			//呼び出し履歴を残す間隔(0で残さない。終了時にmemory_report.txtへ書き出す)
+			int stackSampleInterval = static_cast<int>(MemoryTracker::GetStackSampleInterval());
+			if (ImGui::InputInt("stack sample interval", &stackSampleInterval)) {
+				MemoryTracker::SetStackSampleInterval(stackSampleInterval > 0 ? static_cast<uint32_t>(stackSampleInterval) : 0);
+			}
+		}
+#endif // MT_MEMORY_TRACKING
+
+		//描画の品質の段と、段を変えた理由
+		if (ImGui::CollapsingHeader("quality")) {
+			ImGui::Text("level %u / %u  frame %.2f ms (avg %.2f ms)", qualityGovernor.GetLevel(), QualityGovernor::kLevelCount - 1,
+				qualityGovernor.GetLastMilliseconds(), qualityGovernor.GetAverageMilliseconds());
+			float budgetMilliseconds = qualityGovernor.GetBudgetMilliseconds();
+			if (ImGui::DragFloat("budget ms", &budgetMilliseconds, 0.1f, 1.0f, 100.0f)) {
+				qualityGovernor.SetBudgetMilliseconds(budgetMilliseconds);
+			}
+			bool isAdaptive = qualityGovernor.IsAdaptive();
+			if (ImGui::Checkbox("adaptive", &isAdaptive)) {
+				qualityGovernor.SetAdaptive(isAdaptive);
+			}
+			int level = static_cast<int>(qualityGovernor.GetLevel());
+			if (ImGui::SliderInt("level", &level, 0, static_cast<int>(QualityGovernor::kLevelCount) - 1)) {
+				qualityGovernor.SetLevel(static_cast<uint32_t>(level));
+			}
+			for (const QualityGovernor::Change& change : qualityGovernor.GetChanges()) {
+				ImGui::Text("frame %llu: %u -> %u %s (avg %.2f / %.2f ms)", static_cast<unsigned long long>(change.frame),
+					change.fromLevel, change.toLevel, QualityGovernor::GetReasonName(change.reason), change.averageMilliseconds, change.budgetMilliseconds);
+			}
+		}
 #endif // USE_IMGUI
 
+		//記録中は書き出し、再生中はキーと調整値を記録した値で上書きする
+		//品質の段も記録し、再生中はフレーム時間ではなく記録した段で描画する
+		KeyBitset keys = Input::GetInstance()->GetKeys();
+		sceneParameters.qualityLevel = static_cast<float>(qualityGovernor.GetLevel());
+		if (inputRecorder.ProcessFrame(keys, sceneParameterValues)) {
+			Input::GetInstance()->SetKeys(keys);
+			qualityGovernor.PinLevel(static_cast<uint32_t>(sceneParameters.qualityLevel));
+		}
+
+		EntityManager::TransformComponent& sphereTransform = entityManager.GetTransform(sphere);
+		sphereTransform.translate = sceneParameters.sphereTranslate;
+		sphereTransform.scale.x = sceneParameters.sphereRadius;
+
 		///
 		/// ↑更新処理ここまで
 		///
@@ -257,32 +202,101 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 		/// ↓描画処理ここから
 		///
 
+		drawCapture.BeginFrame(*camera);
+		const QualityGovernor::Settings& qualitySettings = qualityGovernor.GetSettings();
+
 		//グリッドの描画
-		DrawGrid(camera->GetViewProjectionMatrix(), camera->GetViewportMatrix());
+		Primitive::DrawGrid(camera->GetViewProjectionMatrix(), camera->GetViewportMatrix(), drawCapture, qualitySettings.gridSubdivision);
 
 		//球の描画
-		DrawSphere(sphereData, camera->GetViewProjectionMatrix(), camera->GetViewportMatrix());
-
+		entityManager.Query(EntityManager::kTransform | EntityManager::kRender, [&](const EntityManager::ChunkView& view) {
+			for (size_t i = 0; i < view.count; i++) {
+				if (!view.renders[i].isVisible) {
+					continue;
+				}
+				const SphereData sphereData = { .center = view.transforms[i].translate,.radius = view.transforms[i].scale.x };
+				Primitive::DrawSphere(sphereData, camera->GetViewProjectionMatrix(), camera->GetViewportMatrix(), drawCapture, view.renders[i].color, qualitySettings.sphereSubdivision);
+			}
+			});
+
+		//デバッグ表示は品質の段に合わせて、優先度の高いものから表示する
 		const int kRowHeight = 20;
-		ScreenPrintf::GetInstance()->MatrixScreenPrintf(0, 0, rotateMatrix0, "rotateMatrix0");
-		ScreenPrintf::GetInstance()->MatrixScreenPrintf(0, kRowHeight * 5, rotateMatrix1, "rotateMatrix1");
-		ScreenPrintf::GetInstance()->MatrixScreenPrintf(0, kRowHeight * 10, rotateMatrix2, "rotateMatrix2");
+		//描画統計の表示(前フレームの集計結果)
+		if (qualitySettings.maxDebugOverlayCount > 0) {
+			ScreenPrintf::GetInstance()->RenderStatsScreenPrintf(0, kWindowHeight - kRowHeight * 3, RenderStats::GetInstance()->GetFrameStats());
+		}
+		//値は変わらないので、2フレーム目からはキャッシュした文字列を表示するだけになる
+		if (qualitySettings.maxDebugOverlayCount > 1) {
+			ScreenPrintf::GetInstance()->MatrixTableScreenPrintf(0, 0, rotateMatrices, rotateMatrixLabels, 1);
+		}
+
+		drawCapture.EndFrame();
 		///
 		/// ↑描画処理ここまで
 		///
 
+		//描画統計の集計
+		RenderStats::GetInstance()->EndFrame();
+		//ヒープの確保の集計
+		MemoryTracker::EndFrame();
+		//品質の見直し(垂直同期の待ちを含めないよう、Novice::EndFrameの前で計測を止める)
+		qualityGovernor.EndFrame();
+
 		// フレームの終了
 		Novice::EndFrame();
 
+		//フレーム用の領域をまとめて解放する(FrameVectorなどはここで使えなくなる)
+		FrameAllocator::GetInstance()->EndFrame();
+
+		// F2キーで描画統計のログ出力を切り替える
+		if (Input::GetInstance()->GetTriggerKeys(DIK_F2)) {
+			if (isRenderStatsLogging) {
+				RenderStats::GetInstance()->CloseLog();
+				isRenderStatsLogging = false;
+			} else {
+				isRenderStatsLogging = RenderStats::GetInstance()->OpenLog("render_stats.jsonl");
+			}
+		}
+
+		// F5キーで描画命令の記録を切り替える(MT_Study_capture_replayで再生できる)
+		if (Input::GetInstance()->GetTriggerKeys(DIK_F5)) {
+			if (drawCapture.IsCapturing()) {
+				drawCapture.Stop();
+			} else {
+				char drawCaptureFilePath[32];
+				do {
+					std::snprintf(drawCaptureFilePath, sizeof(drawCaptureFilePath), "draw_capture_%03u.bin", drawCaptureNumber++);
+				} while (std::filesystem::exists(drawCaptureFilePath));
+				drawCapture.Start(drawCaptureFilePath);
+			}
+		}
+
 		// ESCキーが押されたらループを抜ける
-		if (preKeys[DIK_ESCAPE] == 0 && keys[DIK_ESCAPE] != 0) {
+		if (Input::GetInstance()->GetTriggerKeys(DIK_ESCAPE)) {
 			break;
 		}
 	}
 
+	//別スレッドがNoviceからキーを読まないよう、先に止める
+	Input::GetInstance()->StopPolling();
+
 	// ライブラリの終了
 	Novice::Finalize();
 
+	inputRecorder.Stop();
+	drawCapture.Stop();
+	ScreenPrintf::GetInstance()->SetDrawBackend(nullptr);
+	//文字列のキャッシュも描画のタグで数えているので、集計を書き出す前に解放する
+	ScreenPrintf::GetInstance()->Finalize();
+	RenderStats::GetInstance()->Finalize();
+	Input::GetInstance()->Finalize();
+	//ワーカーもそれぞれのフレーム用の領域を持つので、スレッドを止めてから領域を解放する
+	JobSystem::GetInstance()->Finalize();
+	FrameAllocator::GetInstance()->Finalize();
+
+	//ヒープの確保の集計を書き出す(MT_MEMORY_TRACKINGを定義したビルドだけ)
+	MemoryTracker::WriteReport("memory_report.txt");
+
 	delete camera;
 	return 0;
 }